@@ -0,0 +1,277 @@
+///////////////////////////////////////////////////////////////////////////////
+// BenchmarkRunner.cpp
+// ============
+// render a fixed number of frames offscreen and report the frame times
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// frames drawn after the textures are loaded and before timing
+	const int g_WarmupFrames = 10;
+
+	/***********************************************************
+	 *  ElapsedMilliseconds()
+	 *
+	 *  Get the milliseconds between two clock readings.
+	 ***********************************************************/
+	double ElapsedMilliseconds(
+		std::chrono::steady_clock::time_point start,
+		std::chrono::steady_clock::time_point end)
+	{
+		return(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+
+	/***********************************************************
+	 *  Average()
+	 *
+	 *  Get the average of a list of values.
+	 ***********************************************************/
+	template<typename T>
+	double Average(const std::vector<T>& values)
+	{
+		double total = 0.0;
+		for (int i = 0; i < values.size(); i++)
+		{
+			total += values[i];
+		}
+
+		return((values.size() > 0) ? total / values.size() : 0.0);
+	}
+}
+
+/***********************************************************
+ *  BenchmarkRunner()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BenchmarkRunner::BenchmarkRunner(int frameCount)
+{
+	m_frameCount = std::max(frameCount, 1);
+	m_warmupFrames = g_WarmupFrames;
+	m_framebuffer = 0;
+	m_renderbuffers[0] = 0;
+	m_renderbuffers[1] = 0;
+	m_width = 0;
+	m_height = 0;
+	m_startTime = CLOCK::now();
+	m_frameStart = m_startTime;
+	m_startupMilliseconds = -1.0;
+	m_texturesReadyMilliseconds = -1.0;
+	m_frameMilliseconds.reserve(m_frameCount);
+	m_drawCalls.reserve(m_frameCount);
+	m_triangles.reserve(m_frameCount);
+}
+
+/***********************************************************
+ *  ~BenchmarkRunner()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+BenchmarkRunner::~BenchmarkRunner()
+{
+	DestroyTarget();
+}
+
+/***********************************************************
+ *  CreateTarget()
+ *
+ *  This method is used for creating the offscreen framebuffer
+ *  with a color and a depth renderbuffer.
+ ***********************************************************/
+bool BenchmarkRunner::CreateTarget(int width, int height)
+{
+	m_width = width;
+	m_height = height;
+
+	glGenRenderbuffers(2, m_renderbuffers);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[0]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[1]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_renderbuffers[0]);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_renderbuffers[1]);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (GL_FRAMEBUFFER_COMPLETE != status)
+	{
+		std::cout << "Benchmark framebuffer is not complete" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyTarget()
+ *
+ *  This method is used for freeing the offscreen framebuffer.
+ ***********************************************************/
+void BenchmarkRunner::DestroyTarget()
+{
+	if (0 != m_framebuffer)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (0 != m_renderbuffers[0])
+	{
+		glDeleteRenderbuffers(2, m_renderbuffers);
+		m_renderbuffers[0] = 0;
+		m_renderbuffers[1] = 0;
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting the timing of a frame
+ *  and binding the offscreen render target.
+ ***********************************************************/
+void BenchmarkRunner::BeginFrame()
+{
+	m_frameStart = CLOCK::now();
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_width, m_height);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for waiting for the GPU to finish the
+ *  frame and recording it.  Frames are only timed once the
+ *  textures are loaded and the warm up frames are drawn, so
+ *  every run times the same frames.
+ ***********************************************************/
+void BenchmarkRunner::EndFrame(bool bTexturesLoading, int drawCalls, int triangles)
+{
+	glFinish();
+
+	CLOCK::time_point frameEnd = CLOCK::now();
+	if (m_startupMilliseconds < 0.0)
+	{
+		m_startupMilliseconds = ElapsedMilliseconds(m_startTime, frameEnd);
+	}
+
+	if (bTexturesLoading == true)
+	{
+		return;
+	}
+	if (m_texturesReadyMilliseconds < 0.0)
+	{
+		m_texturesReadyMilliseconds = ElapsedMilliseconds(m_startTime, frameEnd);
+	}
+	if (m_warmupFrames > 0)
+	{
+		m_warmupFrames--;
+		return;
+	}
+
+	if (IsFinished() == false)
+	{
+		m_frameMilliseconds.push_back(ElapsedMilliseconds(m_frameStart, frameEnd));
+		m_drawCalls.push_back(drawCalls);
+		m_triangles.push_back(triangles);
+	}
+}
+
+/***********************************************************
+ *  IsFinished()
+ *
+ *  This method is used for checking whether all of the
+ *  frames are timed.
+ ***********************************************************/
+bool BenchmarkRunner::IsFinished() const
+{
+	return(m_frameMilliseconds.size() >= m_frameCount);
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ *
+ *  This method is used for getting the number of frames
+ *  that are timed.
+ ***********************************************************/
+int BenchmarkRunner::GetFrameCount() const
+{
+	return(m_frameCount);
+}
+
+/***********************************************************
+ *  GetTimedFrames()
+ *
+ *  This method is used for getting the number of frames that
+ *  have been timed so far.
+ ***********************************************************/
+int BenchmarkRunner::GetTimedFrames() const
+{
+	return((int)m_frameMilliseconds.size());
+}
+
+/***********************************************************
+ *  WriteJSON()
+ *
+ *  This method is used for writing the startup time, the
+ *  min, average, 99th percentile and max frame times and the
+ *  average counts per frame as JSON.
+ ***********************************************************/
+bool BenchmarkRunner::WriteJSON(const std::string& filename) const
+{
+	std::vector<double> sorted = m_frameMilliseconds;
+	std::sort(sorted.begin(), sorted.end());
+
+	double minimum = (sorted.size() > 0) ? sorted.front() : 0.0;
+	double maximum = (sorted.size() > 0) ? sorted.back() : 0.0;
+	double p99 = 0.0;
+	if (sorted.size() > 0)
+	{
+		size_t index = (size_t)(0.99 * (sorted.size() - 1) + 0.5);
+		p99 = sorted[index];
+	}
+
+	FILE* file = stdout;
+	if (filename.empty() == false)
+	{
+		file = fopen(filename.c_str(), "w");
+		if (NULL == file)
+		{
+			std::cout << "Could not open benchmark output:" << filename << std::endl;
+			return(false);
+		}
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"frames\": %d,\n", (int)m_frameMilliseconds.size());
+	fprintf(file, "  \"width\": %d,\n", m_width);
+	fprintf(file, "  \"height\": %d,\n", m_height);
+	fprintf(file, "  \"startup_ms\": %.3f,\n", m_startupMilliseconds);
+	fprintf(file, "  \"textures_ready_ms\": %.3f,\n", m_texturesReadyMilliseconds);
+	fprintf(file, "  \"frame_ms\": {\n");
+	fprintf(file, "    \"min\": %.4f,\n", minimum);
+	fprintf(file, "    \"avg\": %.4f,\n", Average(m_frameMilliseconds));
+	fprintf(file, "    \"p99\": %.4f,\n", p99);
+	fprintf(file, "    \"max\": %.4f\n", maximum);
+	fprintf(file, "  },\n");
+	fprintf(file, "  \"draws_per_frame\": %.2f,\n", Average(m_drawCalls));
+	fprintf(file, "  \"triangles_per_frame\": %.2f\n", Average(m_triangles));
+	fprintf(file, "}\n");
+
+	if (stdout != file)
+	{
+		fclose(file);
+	}
+
+	return(true);
+}
@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////
+// BenchmarkRunner.h
+// ============
+// render a fixed number of frames offscreen and report the frame times
+//
+//  In benchmark mode the window stays hidden and every frame is drawn into
+//  an offscreen framebuffer while the camera follows a scripted path, so
+//  two runs on the same machine draw exactly the same frames.  Each frame
+//  is finished on the GPU before it is timed, and the results are written
+//  as JSON.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  BenchmarkRunner
+ *
+ *  This class contains the code for the offscreen render
+ *  target and the frame statistics of a benchmark run.
+ ***********************************************************/
+class BenchmarkRunner
+{
+public:
+	// constructor - the startup time is measured from here
+	BenchmarkRunner(int frameCount);
+	// destructor
+	~BenchmarkRunner();
+
+private:
+	typedef std::chrono::steady_clock CLOCK;
+
+	// number of frames to time and warm up frames before them
+	int m_frameCount;
+	int m_warmupFrames;
+	// offscreen render target
+	GLuint m_framebuffer;
+	GLuint m_renderbuffers[2];
+	int m_width;
+	int m_height;
+	// time the runner was created and the frame was started
+	CLOCK::time_point m_startTime;
+	CLOCK::time_point m_frameStart;
+	// milliseconds until the first frame and until all textures
+	// were loaded, negative until they happen
+	double m_startupMilliseconds;
+	double m_texturesReadyMilliseconds;
+	// values of each timed frame
+	std::vector<double> m_frameMilliseconds;
+	std::vector<int> m_drawCalls;
+	std::vector<int> m_triangles;
+
+public:
+	// create the offscreen render target
+	bool CreateTarget(int width, int height);
+	// free the offscreen render target
+	void DestroyTarget();
+
+	// start a frame by binding the offscreen render target
+	void BeginFrame();
+	// finish a frame on the GPU and record its time and counts
+	void EndFrame(bool bTexturesLoading, int drawCalls, int triangles);
+
+	// true once all of the frames are timed
+	bool IsFinished() const;
+	// get the number of frames the camera path is spread over
+	int GetFrameCount() const;
+	// get the number of frames timed so far, which is the
+	// position of the next frame along the camera path
+	int GetTimedFrames() const;
+
+	// write the statistics as JSON to a file, or the console
+	// when the filename is empty
+	bool WriteJSON(const std::string& filename) const;
+};
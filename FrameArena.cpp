@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////////
+// FrameArena.cpp
+// ============
+// hand out the memory for data that only lives until the end of a frame
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameArena.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// debug builds count the global heap allocations
+#if !defined(NDEBUG) && !defined(FRAME_ARENA_NO_HEAP_COUNT)
+#define FRAME_ARENA_COUNT_HEAP
+#endif
+
+// declaration of global variables
+namespace
+{
+	// global heap allocations made by any thread
+	std::atomic<unsigned long long> g_HeapAllocations(0);
+	// extra room given to the block when it grows, so a frame
+	// a little larger than the last does not overflow again
+	const size_t g_GrowthNumerator = 3;
+	const size_t g_GrowthDenominator = 2;
+
+	/***********************************************************
+	 *  AlignOffset()
+	 *
+	 *  Round an offset up to a power of two alignment.
+	 ***********************************************************/
+	size_t AlignOffset(size_t offset, size_t alignment)
+	{
+		return((offset + alignment - 1) & ~(alignment - 1));
+	}
+
+	/***********************************************************
+	 *  CountedMalloc()
+	 *
+	 *  Get memory from the heap, counting the allocation when
+	 *  the heap allocations are counted.
+	 ***********************************************************/
+	void* CountedMalloc(size_t bytes)
+	{
+#ifdef FRAME_ARENA_COUNT_HEAP
+		g_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+		return(std::malloc((bytes > 0) ? bytes : 1));
+	}
+}
+
+#ifdef FRAME_ARENA_COUNT_HEAP
+// every new and delete in the program goes through these, so the
+// allocations can be counted - delete must match the malloc below
+void* operator new(std::size_t size)
+{
+	void* pMemory = CountedMalloc(size);
+	if (NULL == pMemory)
+	{
+		throw std::bad_alloc();
+	}
+	return(pMemory);
+}
+void* operator new[](std::size_t size)
+{
+	return(operator new(size));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return(CountedMalloc(size));
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return(CountedMalloc(size));
+}
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+void operator delete[](void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+void operator delete[](void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+void operator delete(void* pMemory, const std::nothrow_t&) noexcept
+{
+	std::free(pMemory);
+}
+void operator delete[](void* pMemory, const std::nothrow_t&) noexcept
+{
+	std::free(pMemory);
+}
+#endif
+
+/***********************************************************
+ *  FrameArena()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameArena::FrameArena(size_t initialBytes)
+{
+	m_capacity = initialBytes;
+	m_block = static_cast<unsigned char*>(CountedMalloc(m_capacity));
+	m_used = 0;
+	m_frameBytes = 0;
+}
+
+/***********************************************************
+ *  ~FrameArena()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameArena::~FrameArena()
+{
+	Reset();
+	std::free(m_block);
+	m_block = NULL;
+	m_capacity = 0;
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used for taking the next aligned piece of
+ *  the block.  The alignment must be a power of two.
+ ***********************************************************/
+void* FrameArena::Allocate(size_t bytes, size_t alignment)
+{
+	size_t start = AlignOffset(m_used, alignment);
+	m_frameBytes += (start - m_used) + bytes;
+
+	if ((NULL != m_block) && (start + bytes <= m_capacity))
+	{
+		m_used = start + bytes;
+		return(m_block + start);
+	}
+
+	return(AllocateOverflow(bytes, alignment));
+}
+
+/***********************************************************
+ *  AllocateOverflow()
+ *
+ *  This method is used for getting an allocation that did not
+ *  fit in the block from the heap.  It is kept until the next
+ *  reset, which grows the block so it fits next time.
+ ***********************************************************/
+void* FrameArena::AllocateOverflow(size_t bytes, size_t alignment)
+{
+	void* pBlock = CountedMalloc(bytes + alignment);
+	if (NULL == pBlock)
+	{
+		throw std::bad_alloc();
+	}
+	m_overflowBlocks.push_back(pBlock);
+
+	return(reinterpret_cast<void*>(AlignOffset(reinterpret_cast<uintptr_t>(pBlock), alignment)));
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for giving back everything allocated
+ *  during the frame.  When the frame did not fit, the block is
+ *  replaced with one that holds all of it with room to spare.
+ ***********************************************************/
+void FrameArena::Reset()
+{
+	for (size_t i = 0; i < m_overflowBlocks.size(); i++)
+	{
+		std::free(m_overflowBlocks[i]);
+	}
+	m_overflowBlocks.clear();
+
+	if (m_frameBytes > m_capacity)
+	{
+		std::free(m_block);
+		m_capacity = m_frameBytes * g_GrowthNumerator / g_GrowthDenominator;
+		m_block = static_cast<unsigned char*>(CountedMalloc(m_capacity));
+	}
+
+	m_used = 0;
+	m_frameBytes = 0;
+}
+
+/***********************************************************
+ *  GetUsedBytes()
+ *
+ *  This method is used for getting the bytes allocated from
+ *  the block since the last reset.
+ ***********************************************************/
+size_t FrameArena::GetUsedBytes() const
+{
+	return(m_used);
+}
+
+/***********************************************************
+ *  GetCapacity()
+ *
+ *  This method is used for getting the size of the block.
+ ***********************************************************/
+size_t FrameArena::GetCapacity() const
+{
+	return(m_capacity);
+}
+
+/***********************************************************
+ *  GetHeapAllocationCount()
+ *
+ *  This method is used for getting the number of global heap
+ *  allocations made by every thread so far.  Only debug
+ *  builds count the allocations made with new.
+ ***********************************************************/
+unsigned long long FrameArena::GetHeapAllocationCount()
+{
+	return(g_HeapAllocations.load(std::memory_order_relaxed));
+}
+
+/***********************************************************
+ *  IsCountingHeapAllocations()
+ *
+ *  This method is used for checking whether new is counted,
+ *  so a steady frame can be checked for heap allocations.
+ ***********************************************************/
+bool FrameArena::IsCountingHeapAllocations()
+{
+#ifdef FRAME_ARENA_COUNT_HEAP
+	return(true);
+#else
+	return(false);
+#endif
+}
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// FrameArena.h
+// ============
+// hand out the memory for data that only lives until the end of a frame
+//
+//  Allocations just move an offset through one block, and the whole block
+//  is given back at once when the frame ends, so the render path never
+//  has to free anything.  A frame that needs more than the block holds
+//  gets extra blocks from the heap, and the block is grown to fit at the
+//  next reset, so after the first few frames the arena stops using the
+//  heap at all.  In debug builds every global operator new is counted,
+//  which lets the main loop check that settled frames make none.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/***********************************************************
+ *  FrameArena
+ *
+ *  This class contains the code for the linear allocator of
+ *  the transient render data.  It is only used from the
+ *  thread drawing the frames.
+ ***********************************************************/
+class FrameArena
+{
+public:
+	// constructor
+	FrameArena(size_t initialBytes);
+	// destructor
+	~FrameArena();
+
+private:
+	// the block the allocations come from and how much of it
+	// is used so far this frame
+	unsigned char* m_block;
+	size_t m_capacity;
+	size_t m_used;
+	// blocks for the allocations that did not fit, which are
+	// freed at the next reset
+	std::vector<void*> m_overflowBlocks;
+	// bytes asked for this frame, including the ones that did
+	// not fit in the block
+	size_t m_frameBytes;
+
+	// get a heap block for an allocation that does not fit
+	void* AllocateOverflow(size_t bytes, size_t alignment);
+
+public:
+	// get memory that stays valid until the next reset
+	void* Allocate(size_t bytes, size_t alignment);
+	// get an array that stays valid until the next reset - the
+	// items are not constructed, and are never destroyed
+	template <typename T>
+	T* AllocateArray(size_t count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "frame arena items are never destroyed");
+		return(static_cast<T*>(Allocate(count * sizeof(T), alignof(T))));
+	}
+	// give back everything allocated since the last reset, and
+	// grow the block when the frame did not fit in it
+	void Reset();
+
+	// get the bytes used this frame and the size of the block
+	size_t GetUsedBytes() const;
+	size_t GetCapacity() const;
+
+	// get the number of global heap allocations made so far,
+	// which stays 0 when they are not counted
+	static unsigned long long GetHeapAllocationCount();
+	// true when the global heap allocations are counted
+	static bool IsCountingHeapAllocations();
+};
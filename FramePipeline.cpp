@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////////////
+// FramePipeline.cpp
+// ============
+// run the rendering of each frame on its own thread
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FramePipeline.h"
+
+#include <iostream>
+
+/***********************************************************
+ *  FramePipeline()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FramePipeline::FramePipeline()
+{
+	m_snapshots[0] = FRAME_SNAPSHOT();
+	m_snapshots[1] = FRAME_SNAPSHOT();
+	m_frontIndex = 0;
+	m_bPending = false;
+	m_bStopping = false;
+	m_pWindow = NULL;
+}
+
+/***********************************************************
+ *  ~FramePipeline()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FramePipeline::~FramePipeline()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for releasing the OpenGL context of
+ *  the window on the calling thread and starting the render
+ *  thread, which makes the context current on its side.
+ ***********************************************************/
+bool FramePipeline::Start(GLFWwindow* window, RENDER_FUNCTION renderFrame)
+{
+	if ((NULL == window) || m_renderThread.joinable())
+	{
+		std::cout << "Could not start the render thread" << std::endl;
+		return(false);
+	}
+
+	m_pWindow = window;
+	m_renderFrame = renderFrame;
+	m_bPending = false;
+	m_bStopping = false;
+
+	glfwMakeContextCurrent(NULL);
+	m_renderThread = std::thread(&FramePipeline::RenderLoop, this);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for waking the render thread so it
+ *  finishes its frame and exits, and then making the OpenGL
+ *  context current again on the calling thread.
+ ***********************************************************/
+void FramePipeline::Stop()
+{
+	if (m_renderThread.joinable() == false)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+	}
+	m_published.notify_one();
+	m_renderThread.join();
+
+	glfwMakeContextCurrent(m_pWindow);
+}
+
+/***********************************************************
+ *  GetBackSnapshot()
+ *
+ *  This method is used for getting the snapshot that the
+ *  main thread fills in.  The render thread only reads the
+ *  front snapshot, and only while holding the lock, so the
+ *  back one can be written without locking.
+ ***********************************************************/
+FramePipeline::FRAME_SNAPSHOT& FramePipeline::GetBackSnapshot()
+{
+	return(m_snapshots[1 - m_frontIndex]);
+}
+
+/***********************************************************
+ *  Publish()
+ *
+ *  This method is used for swapping the back snapshot to the
+ *  front.  A snapshot the render thread did not get to yet is
+ *  replaced, so it always draws the newest tick.
+ ***********************************************************/
+void FramePipeline::Publish()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_frontIndex = 1 - m_frontIndex;
+		m_bPending = true;
+	}
+	m_published.notify_one();
+
+	// start the next snapshot from the one just published
+	m_snapshots[1 - m_frontIndex] = m_snapshots[m_frontIndex];
+}
+
+/***********************************************************
+ *  RenderLoop()
+ *
+ *  This method is run on the render thread.  It copies out
+ *  the newest snapshot and draws it outside of the lock, so
+ *  the main thread is never held up by a frame.
+ ***********************************************************/
+void FramePipeline::RenderLoop()
+{
+	glfwMakeContextCurrent(m_pWindow);
+
+	while (true)
+	{
+		FRAME_SNAPSHOT snapshot;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_published.wait(lock, [this]() { return((m_bPending == true) || (m_bStopping == true)); });
+			if (m_bStopping == true)
+			{
+				break;
+			}
+			snapshot = m_snapshots[m_frontIndex];
+			m_bPending = false;
+		}
+
+		m_renderFrame(snapshot);
+	}
+
+	glfwMakeContextCurrent(NULL);
+}
@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+// FramePipeline.h
+// ============
+// run the rendering of each frame on its own thread
+//
+//  The main thread keeps polling input and ticking the camera at a fixed
+//  rate, and after every tick it writes a snapshot of the view into the
+//  back slot of a double-buffered pair and publishes it.  The render
+//  thread owns the OpenGL context, takes the newest published snapshot
+//  and draws it, so a slow frame delays the picture but never the input,
+//  and the main thread can build frame N+1 while the GPU finishes frame N.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLFW/glfw3.h"
+#include "ViewManager.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/***********************************************************
+ *  FramePipeline
+ *
+ *  This class contains the code for handing the view state
+ *  from the main thread to the render thread.
+ ***********************************************************/
+class FramePipeline
+{
+public:
+	// constructor
+	FramePipeline();
+	// destructor
+	~FramePipeline();
+
+	// the state of one simulation tick that a frame is drawn from
+	struct FRAME_SNAPSHOT
+	{
+		// cameras and viewports of the views the frame is drawn from
+		ViewManager::FRAME_VIEWS views;
+		// number of the tick the snapshot was taken after
+		unsigned int tick;
+		// size of the window's framebuffer in pixels
+		int framebufferWidth;
+		int framebufferHeight;
+	};
+
+	// draws one frame from a snapshot on the render thread
+	typedef std::function<void(const FRAME_SNAPSHOT&)> RENDER_FUNCTION;
+
+private:
+	// the published snapshot and the one being written
+	FRAME_SNAPSHOT m_snapshots[2];
+	int m_frontIndex;
+	// true when the front snapshot has not been drawn yet
+	bool m_bPending;
+	// true when the render thread has been asked to finish
+	bool m_bStopping;
+	std::mutex m_mutex;
+	std::condition_variable m_published;
+
+	GLFWwindow* m_pWindow;
+	RENDER_FUNCTION m_renderFrame;
+	std::thread m_renderThread;
+
+	// wait for snapshots and draw them until stopped
+	void RenderLoop();
+
+public:
+	// hand the OpenGL context of the window to a new render thread
+	bool Start(GLFWwindow* window, RENDER_FUNCTION renderFrame);
+	// finish the render thread and take the context back
+	void Stop();
+
+	// get the back snapshot, which only the main thread touches
+	FRAME_SNAPSHOT& GetBackSnapshot();
+	// make the back snapshot the newest one to draw
+	void Publish();
+};
@@ -0,0 +1,472 @@
+///////////////////////////////////////////////////////////////////////////////
+// FrameProfiler.cpp
+// ============
+// time the parts of each frame on the CPU and the GPU
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameProfiler.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+// declaration of global variables
+namespace
+{
+	// column names of the counters, in the order of COUNTER
+	const char* g_CounterNames[] = { "draw_calls", "triangles", "uniform_uploads", "state_changes_skipped", "objects_culled" };
+
+	// seconds between updates of the window title
+	const double g_OverlaySeconds = 0.5;
+
+	/***********************************************************
+	 *  ElapsedMilliseconds()
+	 *
+	 *  Get the milliseconds between two clock readings.
+	 ***********************************************************/
+	double ElapsedMilliseconds(
+		std::chrono::steady_clock::time_point start,
+		std::chrono::steady_clock::time_point end)
+	{
+		return(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+}
+
+/***********************************************************
+ *  FrameProfiler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameProfiler::FrameProfiler()
+{
+	for (int i = 0; i < TOTAL_COUNTERS; i++)
+	{
+		m_counters[i] = 0;
+	}
+	m_frameCount = 0;
+	m_frameMilliseconds = 0.0;
+	m_gpuFrameMilliseconds = 0.0;
+	m_gpuScope = -1;
+	m_csvFile = NULL;
+	m_csvScopes = -1;
+	m_overlayWindow = NULL;
+	m_frameStart = CLOCK::now();
+	m_lastOverlayTime = m_frameStart;
+	m_bOverlayChanged = false;
+}
+
+/***********************************************************
+ *  ~FrameProfiler()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameProfiler::~FrameProfiler()
+{
+	for (int i = 0; i < m_scopes.size(); i++)
+	{
+		glDeleteQueries(QUERY_FRAMES, m_scopes[i].queries);
+	}
+	m_scopes.clear();
+
+	if (NULL != m_csvFile)
+	{
+		fclose(m_csvFile);
+		m_csvFile = NULL;
+	}
+}
+
+/***********************************************************
+ *  ScopedTimer()
+ *
+ *  The constructor for the scoped timer, which starts timing
+ *  the named scope.
+ ***********************************************************/
+FrameProfiler::ScopedTimer::ScopedTimer(FrameProfiler* pProfiler, const char* name)
+{
+	m_pProfiler = pProfiler;
+	m_scope = -1;
+	if (NULL != m_pProfiler)
+	{
+		m_scope = m_pProfiler->BeginScope(name);
+	}
+}
+
+/***********************************************************
+ *  ~ScopedTimer()
+ *
+ *  The destructor for the scoped timer, which stops timing
+ *  the named scope.
+ ***********************************************************/
+FrameProfiler::ScopedTimer::~ScopedTimer()
+{
+	if (NULL != m_pProfiler)
+	{
+		m_pProfiler->EndScope(m_scope);
+	}
+}
+
+/***********************************************************
+ *  FindScope()
+ *
+ *  This method is used for finding a scope by name.  A new
+ *  scope gets its GPU queries created here.
+ ***********************************************************/
+int FrameProfiler::FindScope(const char* name)
+{
+	for (int i = 0; i < m_scopes.size(); i++)
+	{
+		if (m_scopes[i].name == name)
+		{
+			return(i);
+		}
+	}
+
+	SCOPE scope;
+	scope.name = name;
+	scope.cpuMilliseconds = 0.0;
+	scope.gpuMilliseconds = 0.0;
+	glGenQueries(QUERY_FRAMES, scope.queries);
+	for (int i = 0; i < QUERY_FRAMES; i++)
+	{
+		scope.bQueryIssued[i] = false;
+	}
+	m_scopes.push_back(scope);
+
+	return((int)m_scopes.size() - 1);
+}
+
+/***********************************************************
+ *  ReadGpuTimes()
+ *
+ *  This method is used for reading the GPU times that were
+ *  queried in the passed in buffer slot.  A result that is
+ *  not available yet is skipped instead of waited on.
+ ***********************************************************/
+void FrameProfiler::ReadGpuTimes(int slot)
+{
+	double gpuMilliseconds = 0.0;
+	bool bRead = false;
+
+	for (int i = 0; i < m_scopes.size(); i++)
+	{
+		SCOPE& scope = m_scopes[i];
+
+		if (scope.bQueryIssued[slot] == false)
+		{
+			continue;
+		}
+
+		GLint bAvailable = GL_FALSE;
+		glGetQueryObjectiv(scope.queries[slot], GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		if (GL_TRUE == bAvailable)
+		{
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(scope.queries[slot], GL_QUERY_RESULT, &nanoseconds);
+			scope.gpuMilliseconds = nanoseconds / 1000000.0;
+			scope.bQueryIssued[slot] = false;
+			gpuMilliseconds += scope.gpuMilliseconds;
+			bRead = true;
+		}
+	}
+
+	if (bRead == true)
+	{
+		m_gpuFrameMilliseconds = gpuMilliseconds;
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting the timing of a frame.
+ *  The GPU times from the last use of this buffer slot are
+ *  read before the slot is reused.
+ ***********************************************************/
+void FrameProfiler::BeginFrame()
+{
+	ReadGpuTimes(m_frameCount % QUERY_FRAMES);
+
+	for (int i = 0; i < TOTAL_COUNTERS; i++)
+	{
+		m_counters[i] = 0;
+	}
+	m_frameStart = CLOCK::now();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for ending the timing of a frame and
+ *  reporting it.
+ ***********************************************************/
+void FrameProfiler::EndFrame()
+{
+	m_frameMilliseconds = ElapsedMilliseconds(m_frameStart, CLOCK::now());
+	m_frameCount++;
+
+	if (NULL != m_csvFile)
+	{
+		WriteCSV();
+	}
+	if (NULL != m_overlayWindow)
+	{
+		UpdateOverlay();
+	}
+}
+
+/***********************************************************
+ *  BeginScope()
+ *
+ *  This method is used for starting the timing of a named
+ *  scope.  A GPU query is only started when no other scope
+ *  is being timed on the GPU.
+ ***********************************************************/
+int FrameProfiler::BeginScope(const char* name)
+{
+	int index = FindScope(name);
+	SCOPE& scope = m_scopes[index];
+	int slot = m_frameCount % QUERY_FRAMES;
+
+	// a query still waiting for its result is left alone
+	if ((m_gpuScope < 0) && (scope.bQueryIssued[slot] == false))
+	{
+		glBeginQuery(GL_TIME_ELAPSED, scope.queries[slot]);
+		m_gpuScope = index;
+	}
+
+	scope.cpuStart = CLOCK::now();
+
+	return(index);
+}
+
+/***********************************************************
+ *  EndScope()
+ *
+ *  This method is used for ending the timing of a scope.
+ ***********************************************************/
+void FrameProfiler::EndScope(int scope)
+{
+	if ((scope < 0) || (scope >= m_scopes.size()))
+	{
+		return;
+	}
+
+	m_scopes[scope].cpuMilliseconds = ElapsedMilliseconds(m_scopes[scope].cpuStart, CLOCK::now());
+
+	if (m_gpuScope == scope)
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		m_scopes[scope].bQueryIssued[m_frameCount % QUERY_FRAMES] = true;
+		m_gpuScope = -1;
+	}
+}
+
+/***********************************************************
+ *  SetCounter()
+ *
+ *  This method is used for setting a counter of the current
+ *  frame.
+ ***********************************************************/
+void FrameProfiler::SetCounter(COUNTER counter, int value)
+{
+	m_counters[counter] = value;
+}
+
+/***********************************************************
+ *  OpenCSV()
+ *
+ *  This method is used for opening a CSV file that gets one
+ *  row of timings and counters for every frame.
+ ***********************************************************/
+bool FrameProfiler::OpenCSV(const char* filename)
+{
+	m_csvFile = fopen(filename, "w");
+	if (NULL == m_csvFile)
+	{
+		std::cout << "Could not open profile file:" << filename << std::endl;
+		return(false);
+	}
+
+	m_csvScopes = -1;
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteCSV()
+ *
+ *  This method is used for writing the timings of the frame
+ *  into the CSV file.  The columns are written with the first
+ *  frame, so scopes first used after it are not included.
+ ***********************************************************/
+void FrameProfiler::WriteCSV()
+{
+	if (m_csvScopes < 0)
+	{
+		m_csvScopes = (int)m_scopes.size();
+
+		fprintf(m_csvFile, "frame,frame_ms");
+		for (int i = 0; i < m_csvScopes; i++)
+		{
+			fprintf(m_csvFile, ",%s_cpu_ms,%s_gpu_ms", m_scopes[i].name.c_str(), m_scopes[i].name.c_str());
+		}
+		for (int i = 0; i < TOTAL_COUNTERS; i++)
+		{
+			fprintf(m_csvFile, ",%s", g_CounterNames[i]);
+		}
+		fprintf(m_csvFile, "\n");
+	}
+
+	fprintf(m_csvFile, "%d,%.4f", m_frameCount, m_frameMilliseconds);
+	for (int i = 0; i < m_csvScopes; i++)
+	{
+		fprintf(m_csvFile, ",%.4f,%.4f", m_scopes[i].cpuMilliseconds, m_scopes[i].gpuMilliseconds);
+	}
+	for (int i = 0; i < TOTAL_COUNTERS; i++)
+	{
+		fprintf(m_csvFile, ",%d", m_counters[i]);
+	}
+	fprintf(m_csvFile, "\n");
+}
+
+/***********************************************************
+ *  ShowOverlay()
+ *
+ *  This method is used for showing the frame timings in the
+ *  title of the passed in window.  The window title is the
+ *  only text the application can put on screen.
+ ***********************************************************/
+void FrameProfiler::ShowOverlay(GLFWwindow* window, const char* title)
+{
+	m_overlayWindow = window;
+	m_overlayTitle = title;
+}
+
+/***********************************************************
+ *  UpdateOverlay()
+ *
+ *  This method is used for writing the timings of the frame
+ *  into the overlay text twice a second.  The frame may run
+ *  on the render thread, so the title is set later on by
+ *  PresentOverlay().
+ ***********************************************************/
+void FrameProfiler::UpdateOverlay()
+{
+	CLOCK::time_point now = CLOCK::now();
+	if (ElapsedMilliseconds(m_lastOverlayTime, now) < g_OverlaySeconds * 1000.0)
+	{
+		return;
+	}
+	m_lastOverlayTime = now;
+
+	std::ostringstream text;
+	text << std::fixed << std::setprecision(2);
+	text << m_overlayTitle << " | " << m_frameMilliseconds << " ms";
+	for (int i = 0; i < m_scopes.size(); i++)
+	{
+		text << " | " << m_scopes[i].name << " " << m_scopes[i].cpuMilliseconds << "/" << m_scopes[i].gpuMilliseconds;
+	}
+	text << " | draws " << m_counters[DRAW_CALLS] << ", tris " << m_counters[TRIANGLES]
+		<< ", uniforms " << m_counters[UNIFORM_UPLOADS] << ", culled " << m_counters[OBJECTS_CULLED];
+
+	std::lock_guard<std::mutex> lock(m_overlayMutex);
+	m_overlayText = text.str();
+	m_bOverlayChanged = true;
+}
+
+/***********************************************************
+ *  PresentOverlay()
+ *
+ *  This method is used for setting the window title to the
+ *  newest overlay text, when it changed since the last call.
+ ***********************************************************/
+void FrameProfiler::PresentOverlay()
+{
+	if (NULL == m_overlayWindow)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_overlayMutex);
+	if (m_bOverlayChanged == true)
+	{
+		glfwSetWindowTitle(m_overlayWindow, m_overlayText.c_str());
+		m_bOverlayChanged = false;
+	}
+}
+
+/***********************************************************
+ *  GetFrameMilliseconds()
+ *
+ *  This method is used for getting the CPU time of the last
+ *  finished frame.
+ ***********************************************************/
+double FrameProfiler::GetFrameMilliseconds() const
+{
+	return(m_frameMilliseconds);
+}
+
+/***********************************************************
+ *  GetScopeCount()
+ *
+ *  This method is used for getting the number of scopes.
+ ***********************************************************/
+int FrameProfiler::GetScopeCount() const
+{
+	return((int)m_scopes.size());
+}
+
+/***********************************************************
+ *  GetScopeName()
+ *
+ *  This method is used for getting the name of a scope.
+ ***********************************************************/
+const std::string& FrameProfiler::GetScopeName(int scope) const
+{
+	return(m_scopes[scope].name);
+}
+
+/***********************************************************
+ *  GetScopeCpuMilliseconds()
+ *
+ *  This method is used for getting the last CPU time of a
+ *  scope.
+ ***********************************************************/
+double FrameProfiler::GetScopeCpuMilliseconds(int scope) const
+{
+	return(m_scopes[scope].cpuMilliseconds);
+}
+
+/***********************************************************
+ *  GetScopeGpuMilliseconds()
+ *
+ *  This method is used for getting the last GPU time read
+ *  for a scope, which is from two frames earlier.
+ ***********************************************************/
+double FrameProfiler::GetScopeGpuMilliseconds(int scope) const
+{
+	return(m_scopes[scope].gpuMilliseconds);
+}
+
+/***********************************************************
+ *  GetGpuFrameMilliseconds()
+ *
+ *  This method is used for getting the GPU time of the last
+ *  frame whose queries were read, which is from two frames
+ *  earlier.  Only the time inside the scopes is counted.
+ ***********************************************************/
+double FrameProfiler::GetGpuFrameMilliseconds() const
+{
+	return(m_gpuFrameMilliseconds);
+}
+
+/***********************************************************
+ *  GetCounter()
+ *
+ *  This method is used for getting a counter of the last
+ *  frame.
+ ***********************************************************/
+int FrameProfiler::GetCounter(COUNTER counter) const
+{
+	return(m_counters[counter]);
+}
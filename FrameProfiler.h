@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// FrameProfiler.h
+// ============
+// time the parts of each frame on the CPU and the GPU
+//
+//  Each named scope is timed on the CPU and, when it is not nested inside
+//  another timed scope, with a GL_TIME_ELAPSED query on the GPU.  The
+//  queries are double-buffered, so the results read for a frame are the
+//  ones issued two frames earlier and reading them never stalls.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include "GLFW/glfw3.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  FrameProfiler
+ *
+ *  This class contains the code for timing the scopes of a
+ *  frame, keeping the frame counters and reporting them in
+ *  the window title or a CSV file.
+ ***********************************************************/
+class FrameProfiler
+{
+public:
+	// constructor
+	FrameProfiler();
+	// destructor
+	~FrameProfiler();
+
+	// values counted over a frame
+	enum COUNTER
+	{
+		DRAW_CALLS = 0,
+		TRIANGLES,
+		UNIFORM_UPLOADS,
+		STATE_CHANGES_SKIPPED,
+		OBJECTS_CULLED,
+		TOTAL_COUNTERS
+	};
+
+	// times the enclosing block as a named scope and does
+	// nothing when the profiler is NULL
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer(FrameProfiler* pProfiler, const char* name);
+		~ScopedTimer();
+
+	private:
+		FrameProfiler* m_pProfiler;
+		int m_scope;
+	};
+
+private:
+	// number of frames a GPU query is given before it is read
+	static const int QUERY_FRAMES = 2;
+
+	typedef std::chrono::steady_clock CLOCK;
+
+	// the timings of one named scope
+	struct SCOPE
+	{
+		std::string name;
+		CLOCK::time_point cpuStart;
+		double cpuMilliseconds;
+		double gpuMilliseconds;
+		GLuint queries[QUERY_FRAMES];
+		bool bQueryIssued[QUERY_FRAMES];
+	};
+
+	// every scope that has been timed, in order of first use
+	std::vector<SCOPE> m_scopes;
+	// counter values of the current frame
+	int m_counters[TOTAL_COUNTERS];
+	// number of frames that have been started
+	int m_frameCount;
+	// start time and length of the current frame
+	CLOCK::time_point m_frameStart;
+	double m_frameMilliseconds;
+	// GPU time of all of the scopes of the last frame read back
+	double m_gpuFrameMilliseconds;
+	// scope whose GPU query is running, since they cannot nest
+	int m_gpuScope;
+	// file the frame timings are written to, if any
+	FILE* m_csvFile;
+	// number of scopes the CSV columns were written for
+	int m_csvScopes;
+	// window whose title shows the timings, if any
+	GLFWwindow* m_overlayWindow;
+	std::string m_overlayTitle;
+	CLOCK::time_point m_lastOverlayTime;
+	// text waiting to be shown, since only the main thread may
+	// set the window title
+	std::string m_overlayText;
+	bool m_bOverlayChanged;
+	std::mutex m_overlayMutex;
+
+	// find a scope by name, adding it when it is new
+	int FindScope(const char* name);
+	// read the GPU times issued for this buffer slot
+	void ReadGpuTimes(int slot);
+	// write the timings of the frame into the CSV file
+	void WriteCSV();
+	// show the timings of the frame in the window title
+	void UpdateOverlay();
+
+public:
+	// start and end the timing of a frame
+	void BeginFrame();
+	void EndFrame();
+
+	// start and end the timing of a named scope
+	int BeginScope(const char* name);
+	void EndScope(int scope);
+
+	// set a counter for the current frame
+	void SetCounter(COUNTER counter, int value);
+
+	// write the timings of every frame into a CSV file
+	bool OpenCSV(const char* filename);
+	// show the timings in the title of a window twice a second
+	void ShowOverlay(GLFWwindow* window, const char* title);
+	// set the window title to the newest timings, which must be
+	// called on the main thread
+	void PresentOverlay();
+
+	// get the timings of the last finished frame
+	double GetFrameMilliseconds() const;
+	int GetScopeCount() const;
+	const std::string& GetScopeName(int scope) const;
+	double GetScopeCpuMilliseconds(int scope) const;
+	double GetScopeGpuMilliseconds(int scope) const;
+	// get the GPU time of the last frame read back, which is the
+	// sum of its scopes since their GPU queries never nest
+	double GetGpuFrameMilliseconds() const;
+	int GetCounter(COUNTER counter) const;
+};
@@ -0,0 +1,352 @@
+///////////////////////////////////////////////////////////////////////////////
+// GpuDrivenRenderer.cpp
+// ============
+// cull the scene objects and build their draw commands on the GPU
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GpuDrivenRenderer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// declaration of global variables
+namespace
+{
+	// invocations per work group, matching cullCompute.glsl
+	const int g_WorkGroupSize = 64;
+}
+
+/***********************************************************
+ *  GpuDrivenRenderer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GpuDrivenRenderer::GpuDrivenRenderer()
+{
+	m_program = 0;
+	for (int i = 0; i < TOTAL_BUFFERS; i++)
+	{
+		m_buffers[i] = 0;
+	}
+	m_objectCount = 0;
+	m_bCompact = false;
+}
+
+/***********************************************************
+ *  ~GpuDrivenRenderer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GpuDrivenRenderer::~GpuDrivenRenderer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking that the driver has the
+ *  compute shaders, storage buffers and indirect draws with
+ *  a base instance that the GPU driven path needs.
+ ***********************************************************/
+bool GpuDrivenRenderer::IsSupported()
+{
+	return(GLEW_ARB_compute_shader &&
+		GLEW_ARB_shader_storage_buffer_object &&
+		GLEW_ARB_multi_draw_indirect &&
+		GLEW_ARB_base_instance);
+}
+
+/***********************************************************
+ *  LoadComputeShader()
+ *
+ *  This method is used for compiling and linking the culling
+ *  shader from its GLSL file.
+ ***********************************************************/
+bool GpuDrivenRenderer::LoadComputeShader(const char* filename)
+{
+	std::ifstream file(filename);
+	if (file.is_open() == false)
+	{
+		std::cout << "Could not open compute shader:" << filename << std::endl;
+		return(false);
+	}
+
+	std::stringstream source;
+	source << file.rdbuf();
+	std::string code = source.str();
+	const char* pCode = code.c_str();
+
+	GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(shader, 1, &pCode, NULL);
+	glCompileShader(shader);
+
+	GLint bSuccess = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &bSuccess);
+	if (GL_TRUE != bSuccess)
+	{
+		char log[1024];
+		glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+		std::cout << "Could not compile compute shader:" << filename << "\n" << log << std::endl;
+		glDeleteShader(shader);
+		return(false);
+	}
+
+	m_program = glCreateProgram();
+	glAttachShader(m_program, shader);
+	glLinkProgram(m_program);
+	glDeleteShader(shader);
+
+	glGetProgramiv(m_program, GL_LINK_STATUS, &bSuccess);
+	if (GL_TRUE != bSuccess)
+	{
+		char log[1024];
+		glGetProgramInfoLog(m_program, sizeof(log), NULL, log);
+		std::cout << "Could not link compute shader:" << filename << "\n" << log << std::endl;
+		glDeleteProgram(m_program);
+		m_program = 0;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for loading the culling shader and
+ *  writing where every level of every mesh sits in the
+ *  merged mesh buffers.
+ ***********************************************************/
+bool GpuDrivenRenderer::Initialize(const char* computeShaderFilename, const ShapeGeometry* pShapeGeometry)
+{
+	if (IsSupported() == false)
+	{
+		std::cout << "GPU driven rendering is not supported by this driver" << std::endl;
+		return(false);
+	}
+	if (LoadComputeShader(computeShaderFilename) == false)
+	{
+		return(false);
+	}
+
+	m_bCompact = GLEW_ARB_indirect_parameters;
+	glGenBuffers(TOTAL_BUFFERS, m_buffers);
+
+	std::vector<MESH_RANGE> ranges;
+	for (int mesh = 0; mesh < TOTAL_MESH_TYPES; mesh++)
+	{
+		for (int lod = 0; lod < ShapeGeometry::LOD_LEVELS; lod++)
+		{
+			const ShapeGeometry::POOL_RANGE& poolRange = pShapeGeometry->GetPoolRange((MESH_TYPE)mesh, lod);
+			MESH_RANGE range;
+
+			range.indexCount = poolRange.indexCount;
+			range.firstIndex = poolRange.firstIndex;
+			range.baseVertex = poolRange.baseVertex;
+			range.lodCount = pShapeGeometry->GetLodCount((MESH_TYPE)mesh);
+			ranges.push_back(range);
+		}
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[MESH_BUFFER]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, ranges.size() * sizeof(MESH_RANGE), &ranges[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the culling shader and
+ *  the buffers.
+ ***********************************************************/
+void GpuDrivenRenderer::Destroy()
+{
+	if (0 != m_program)
+	{
+		glDeleteProgram(m_program);
+		m_program = 0;
+	}
+	if (0 != m_buffers[0])
+	{
+		glDeleteBuffers(TOTAL_BUFFERS, m_buffers);
+		for (int i = 0; i < TOTAL_BUFFERS; i++)
+		{
+			m_buffers[i] = 0;
+		}
+	}
+	m_objectCount = 0;
+	m_sections.clear();
+}
+
+/***********************************************************
+ *  SetObjects()
+ *
+ *  This method is used for replacing every object and the
+ *  sections of the command buffer they are drawn in.
+ ***********************************************************/
+void GpuDrivenRenderer::SetObjects(const std::vector<OBJECT_DATA>& objects, const std::vector<SECTION>& sections)
+{
+	if (0 == m_program)
+	{
+		return;
+	}
+
+	m_objectCount = (int)objects.size();
+	m_sections = sections;
+
+	std::vector<GLuint> sectionStarts(m_sections.size() + 1, 0);
+	for (int i = 0; i < m_sections.size(); i++)
+	{
+		sectionStarts[i] = m_sections[i].firstCommand;
+	}
+
+	// the buffers always get at least one element so they can be bound
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[OBJECT_BUFFER]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, std::max(m_objectCount, 1) * sizeof(OBJECT_DATA), NULL, GL_DYNAMIC_DRAW);
+	if (m_objectCount > 0)
+	{
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_objectCount * sizeof(OBJECT_DATA), &objects[0]);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[COMMAND_BUFFER]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, std::max(m_objectCount, 1) * sizeof(DRAW_COMMAND), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[COUNT_BUFFER]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sectionStarts.size() * sizeof(GLuint), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[SECTION_BUFFER]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sectionStarts.size() * sizeof(GLuint), &sectionStarts[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  UpdateObject()
+ *
+ *  This method is used for rewriting one object after its
+ *  bounds changed.
+ ***********************************************************/
+void GpuDrivenRenderer::UpdateObject(int objectIndex, const OBJECT_DATA& object)
+{
+	if ((0 == m_program) || (objectIndex < 0) || (objectIndex >= m_objectCount))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[OBJECT_BUFFER]);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, objectIndex * sizeof(OBJECT_DATA), sizeof(OBJECT_DATA), &object);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for running the culling pass, which
+ *  writes the indirect commands for this frame.  The CPU work
+ *  is the same no matter how many objects are in the scene.
+ ***********************************************************/
+void GpuDrivenRenderer::Cull(const CULL_PARAMETERS& parameters)
+{
+	if ((0 == m_program) || (m_objectCount <= 0))
+	{
+		return;
+	}
+
+	// the packed commands are counted again from zero
+	if (m_bCompact == true)
+	{
+		std::vector<GLuint> zeros(m_sections.size() + 1, 0);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[COUNT_BUFFER]);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, zeros.size() * sizeof(GLuint), &zeros[0]);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+
+	m_viewFrustum.ExtractPlanes(parameters.viewProjection);
+	glm::vec4 planes[ViewFrustum::TOTAL_PLANES];
+	for (int i = 0; i < ViewFrustum::TOTAL_PLANES; i++)
+	{
+		planes[i] = m_viewFrustum.GetPlane(i);
+	}
+
+	GLint currentProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+	glUseProgram(m_program);
+
+	glUniform1ui(glGetUniformLocation(m_program, "objectCount"), (GLuint)m_objectCount);
+	glUniform4fv(glGetUniformLocation(m_program, "frustumPlanes"), ViewFrustum::TOTAL_PLANES, &planes[0].x);
+	glUniform3fv(glGetUniformLocation(m_program, "viewPosition"), 1, &parameters.viewPosition.x);
+	glUniform1f(glGetUniformLocation(m_program, "projectionScale"), parameters.projection[1][1]);
+	glUniform1i(glGetUniformLocation(m_program, "bPerspective"), parameters.projection[2][3] != 0.0f);
+	glUniform1i(glGetUniformLocation(m_program, "bCompact"), m_bCompact);
+	glUniform1i(glGetUniformLocation(m_program, "bUseCulling"), parameters.bUseCulling);
+	glUniform1i(glGetUniformLocation(m_program, "bUseLod"), parameters.bUseLod);
+	glUniform2fv(glGetUniformLocation(m_program, "lodScreenSizes"), 1, &parameters.lodScreenSizes.x);
+	glUniform1f(glGetUniformLocation(m_program, "lodHysteresis"), parameters.lodHysteresis);
+
+	for (int i = 0; i < TOTAL_BUFFERS; i++)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, m_buffers[i]);
+	}
+
+	glDispatchCompute((m_objectCount + g_WorkGroupSize - 1) / g_WorkGroupSize, 1, 1);
+
+	// the commands and counts are read by the draws that follow
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+	glUseProgram((GLuint)currentProgram);
+}
+
+/***********************************************************
+ *  DrawSection()
+ *
+ *  This method is used for drawing the commands of one
+ *  section with a single indirect call.  The merged mesh
+ *  buffers must be bound first.
+ ***********************************************************/
+int GpuDrivenRenderer::DrawSection(int section)
+{
+	if ((0 == m_program) || (section < 0) || (section >= m_sections.size()))
+	{
+		return(0);
+	}
+
+	const SECTION& drawSection = m_sections[section];
+	const void* offset = (const void*)(drawSection.firstCommand * sizeof(DRAW_COMMAND));
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_buffers[COMMAND_BUFFER]);
+	if (m_bCompact == true)
+	{
+		glBindBuffer(GL_PARAMETER_BUFFER_ARB, m_buffers[COUNT_BUFFER]);
+		glMultiDrawElementsIndirectCountARB(
+			GL_TRIANGLES,
+			GL_UNSIGNED_INT,
+			offset,
+			(GLintptr)(section * sizeof(GLuint)),
+			drawSection.commandCount,
+			sizeof(DRAW_COMMAND));
+		glBindBuffer(GL_PARAMETER_BUFFER_ARB, 0);
+	}
+	else
+	{
+		glMultiDrawElementsIndirect(
+			GL_TRIANGLES,
+			GL_UNSIGNED_INT,
+			offset,
+			drawSection.commandCount,
+			sizeof(DRAW_COMMAND));
+	}
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	return(1);
+}
+
+/***********************************************************
+ *  GetSections()
+ *
+ *  This method is used for getting the sections the objects
+ *  were split into.
+ ***********************************************************/
+const std::vector<GpuDrivenRenderer::SECTION>& GpuDrivenRenderer::GetSections() const
+{
+	return(m_sections);
+}
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// GpuDrivenRenderer.h
+// ============
+// cull the scene objects and build their draw commands on the GPU
+//
+//  Every object has its bounds, mesh and instance in a storage buffer
+//  that only changes when the object moves.  Each frame a compute shader
+//  tests all of them against the view planes, picks their level of
+//  detail and writes one indirect command per visible object, so the
+//  CPU only issues one glMultiDrawElementsIndirect call per texture
+//  array no matter how many objects there are.  With
+//  ARB_indirect_parameters the visible commands are packed and their
+//  count is read from the GPU as well.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ShapeGeometry.h"
+#include "ViewFrustum.h"
+
+#include <vector>
+
+/***********************************************************
+ *  GpuDrivenRenderer
+ *
+ *  This class contains the code for the compute culling pass
+ *  and the indirect draws of the scene objects.
+ ***********************************************************/
+class GpuDrivenRenderer
+{
+public:
+	// constructor
+	GpuDrivenRenderer();
+	// destructor
+	~GpuDrivenRenderer();
+
+	// one scene object as read by the culling shader, laid out
+	// with std430 rules to match cullCompute.glsl
+	struct OBJECT_DATA
+	{
+		glm::vec4 centerRadius;
+		glm::vec4 extents;
+		GLuint mesh;
+		GLuint lodLevel;
+		// section of the texture array the object is drawn with
+		GLuint section;
+		// position of the object in the instance buffer
+		GLuint instanceIndex;
+		// command written when the commands are not packed
+		GLuint commandSlot;
+		GLuint padding[3];
+	};
+	static_assert(sizeof(OBJECT_DATA) == 64, "OBJECT_DATA must match the std430 layout");
+
+	// the objects drawn with one texture array, which take up
+	// a contiguous range of the command buffer
+	struct SECTION
+	{
+		int textureArray;
+		int firstCommand;
+		int commandCount;
+	};
+
+	// values of the view that the culling pass needs
+	struct CULL_PARAMETERS
+	{
+		glm::mat4 viewProjection;
+		glm::mat4 projection;
+		glm::vec3 viewPosition;
+		bool bUseCulling;
+		bool bUseLod;
+		glm::vec2 lodScreenSizes;
+		float lodHysteresis;
+	};
+
+private:
+	// a level of detail of a mesh in the merged mesh buffers
+	struct MESH_RANGE
+	{
+		GLuint indexCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint lodCount;
+	};
+
+	// layout of one command in the indirect buffer
+	struct DRAW_COMMAND
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// storage buffers read and written by the culling shader
+	enum BUFFER
+	{
+		OBJECT_BUFFER = 0,
+		MESH_BUFFER,
+		COMMAND_BUFFER,
+		COUNT_BUFFER,
+		SECTION_BUFFER,
+		TOTAL_BUFFERS
+	};
+
+	GLuint m_program;
+	GLuint m_buffers[TOTAL_BUFFERS];
+	// number of objects and the sections they are drawn in
+	int m_objectCount;
+	std::vector<SECTION> m_sections;
+	// true when visible commands are packed and counted on the GPU
+	bool m_bCompact;
+	// planes of the view being culled against
+	ViewFrustum m_viewFrustum;
+
+	// compile and link the culling shader from a file
+	bool LoadComputeShader(const char* filename);
+
+public:
+	// true when the driver has what the GPU driven path needs
+	static bool IsSupported();
+
+	// load the culling shader and write the mesh ranges
+	bool Initialize(const char* computeShaderFilename, const ShapeGeometry* pShapeGeometry);
+	// free the shader and the buffers
+	void Destroy();
+
+	// replace every object and section
+	void SetObjects(const std::vector<OBJECT_DATA>& objects, const std::vector<SECTION>& sections);
+	// rewrite one object after it moved
+	void UpdateObject(int objectIndex, const OBJECT_DATA& object);
+
+	// run the culling pass and build the commands for this frame
+	void Cull(const CULL_PARAMETERS& parameters);
+	// draw the commands of one section, which returns the number
+	// of draw calls issued
+	int DrawSection(int section);
+
+	// get the sections the objects were split into
+	const std::vector<SECTION>& GetSections() const;
+};
@@ -0,0 +1,249 @@
+///////////////////////////////////////////////////////////////////////////////
+// JobSystem.cpp
+// ============
+// split loops over the scene into chunks run on a pool of worker threads
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+/***********************************************************
+ *  JobSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+JobSystem::JobSystem(int threadCount)
+{
+	m_pJob = NULL;
+	m_remainingTasks = 0;
+	m_generation = 0;
+	m_bStopping = false;
+
+	if (threadCount <= 0)
+	{
+		threadCount = (int)std::thread::hardware_concurrency() - 1;
+	}
+	if (threadCount < 0)
+	{
+		threadCount = 0;
+	}
+
+	for (int i = 0; i < threadCount + 1; i++)
+	{
+		m_queues.push_back(std::unique_ptr<WORKER_QUEUE>(new WORKER_QUEUE()));
+		m_queues.back()->first = 0;
+	}
+	for (int i = 0; i < threadCount; i++)
+	{
+		m_threads.push_back(std::thread(&JobSystem::WorkerLoop, this, i + 1));
+	}
+}
+
+/***********************************************************
+ *  ~JobSystem()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_bStopping = true;
+	}
+	m_wake.notify_all();
+
+	for (int i = 0; i < m_threads.size(); i++)
+	{
+		m_threads[i].join();
+	}
+	m_threads.clear();
+}
+
+/***********************************************************
+ *  ParallelFor()
+ *
+ *  This method is used for splitting a loop into chunks,
+ *  dealing them out to the worker queues and working on them
+ *  until every chunk is done.  A loop that fits in one chunk
+ *  is run right away on the calling thread.
+ ***********************************************************/
+void JobSystem::ParallelFor(int count, int chunkSize, const RANGE_JOB& job)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+	if (chunkSize < 1)
+	{
+		chunkSize = 1;
+	}
+	if ((count <= chunkSize) || (m_threads.size() == 0))
+	{
+		job(0, count, 0);
+		return;
+	}
+
+	int taskCount = (count + chunkSize - 1) / chunkSize;
+	m_pJob = &job;
+	m_remainingTasks = taskCount;
+
+	// neighbouring chunks go to different workers so each one
+	// starts with an even share
+	for (int i = 0; i < taskCount; i++)
+	{
+		TASK task;
+		task.begin = i * chunkSize;
+		task.end = std::min(task.begin + chunkSize, count);
+
+		WORKER_QUEUE& queue = *m_queues[i % m_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(task);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	RunTasks(0);
+
+	std::unique_lock<std::mutex> lock(m_wakeMutex);
+	m_done.wait(lock, [this]() { return(m_remainingTasks == 0); });
+	m_pJob = NULL;
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is run on each worker thread.  It sleeps until
+ *  a new loop is started and then works on its chunks.
+ ***********************************************************/
+void JobSystem::WorkerLoop(int worker)
+{
+	unsigned int generation = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_wakeMutex);
+			m_wake.wait(lock, [this, generation]() { return((m_bStopping == true) || (m_generation != generation)); });
+			if (m_bStopping == true)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		RunTasks(worker);
+	}
+}
+
+/***********************************************************
+ *  PopTask()
+ *
+ *  This method is used for taking the next chunk for a
+ *  worker.  The newest chunk of its own queue is taken first,
+ *  then the oldest chunk of the next queue that has any.
+ ***********************************************************/
+bool JobSystem::PopTask(int worker, TASK& task)
+{
+	{
+		WORKER_QUEUE& queue = *m_queues[worker];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.size() > queue.first)
+		{
+			task = queue.tasks.back();
+			queue.tasks.pop_back();
+			if (queue.tasks.size() == queue.first)
+			{
+				queue.tasks.clear();
+				queue.first = 0;
+			}
+			return(true);
+		}
+	}
+
+	for (int i = 1; i < m_queues.size(); i++)
+	{
+		WORKER_QUEUE& queue = *m_queues[(worker + i) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.size() > queue.first)
+		{
+			task = queue.tasks[queue.first++];
+			if (queue.tasks.size() == queue.first)
+			{
+				queue.tasks.clear();
+				queue.first = 0;
+			}
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  RunTasks()
+ *
+ *  This method is used for running chunks until every queue
+ *  is empty.  The worker finishing the last chunk wakes the
+ *  thread waiting in ParallelFor().
+ ***********************************************************/
+void JobSystem::RunTasks(int worker)
+{
+	TASK task;
+
+	while (PopTask(worker, task) == true)
+	{
+		(*m_pJob)(task.begin, task.end, worker);
+
+		if (--m_remainingTasks == 0)
+		{
+			std::lock_guard<std::mutex> lock(m_wakeMutex);
+			m_done.notify_all();
+		}
+	}
+}
+
+/***********************************************************
+ *  GetWorkerCount()
+ *
+ *  This method is used for getting the number of workers,
+ *  which includes the thread calling ParallelFor().
+ ***********************************************************/
+int JobSystem::GetWorkerCount() const
+{
+	return((int)m_queues.size());
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for running a loop on the passed in
+ *  job system, or as one chunk on the calling thread when the
+ *  job system is NULL.
+ ***********************************************************/
+void JobSystem::Run(JobSystem* pJobSystem, int count, int chunkSize, const RANGE_JOB& job)
+{
+	if (NULL != pJobSystem)
+	{
+		pJobSystem->ParallelFor(count, chunkSize, job);
+	}
+	else if (count > 0)
+	{
+		job(0, count, 0);
+	}
+}
+
+/***********************************************************
+ *  GetWorkerCount()
+ *
+ *  This method is used for getting the number of workers of
+ *  the passed in job system, which is 1 when it is NULL.
+ ***********************************************************/
+int JobSystem::GetWorkerCount(const JobSystem* pJobSystem)
+{
+	return((NULL != pJobSystem) ? pJobSystem->GetWorkerCount() : 1);
+}
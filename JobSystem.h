@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+// JobSystem.h
+// ============
+// split loops over the scene into chunks run on a pool of worker threads
+//
+//  Every worker has its own queue of chunks.  A worker takes chunks from
+//  the back of its own queue and, once that is empty, steals from the
+//  front of the others, so a chunk that runs long does not leave the
+//  rest of the pool idle.  The calling thread works on the chunks as
+//  well and is always worker 0, which lets jobs write into per-worker
+//  buffers without locking.  Starting a loop never uses the heap, so the
+//  frame loops can run on the pool every frame.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  JobSystem
+ *
+ *  This class contains the code for running the chunks of
+ *  a loop across the worker threads.
+ ***********************************************************/
+class JobSystem
+{
+public:
+	// constructor - zero threads leaves one core for the GL
+	// thread and uses the rest
+	JobSystem(int threadCount);
+	// destructor
+	~JobSystem();
+
+	// runs the items [begin, end) of a loop on a worker - it only
+	// refers to the function it was made from, which lives until
+	// the loop returns, so nothing is copied onto the heap
+	class RANGE_JOB
+	{
+	public:
+		template <typename FUNCTION>
+		RANGE_JOB(const FUNCTION& function)
+		{
+			m_pFunction = &function;
+			m_pCall = &CallFunction<FUNCTION>;
+		}
+
+		void operator()(int begin, int end, int worker) const
+		{
+			m_pCall(m_pFunction, begin, end, worker);
+		}
+
+	private:
+		template <typename FUNCTION>
+		static void CallFunction(const void* pFunction, int begin, int end, int worker)
+		{
+			(*static_cast<const FUNCTION*>(pFunction))(begin, end, worker);
+		}
+
+		const void* m_pFunction;
+		void (*m_pCall)(const void* pFunction, int begin, int end, int worker);
+	};
+
+private:
+	// one chunk of the running loop
+	struct TASK
+	{
+		int begin;
+		int end;
+	};
+
+	// the chunks waiting on one worker - the owner takes from the
+	// back and thieves from the front, which is at the first index,
+	// and the memory is kept for the next loop
+	struct WORKER_QUEUE
+	{
+		std::mutex mutex;
+		std::vector<TASK> tasks;
+		size_t first;
+	};
+
+	std::vector<std::thread> m_threads;
+	// one queue per worker, including the calling thread
+	std::vector<std::unique_ptr<WORKER_QUEUE>> m_queues;
+	// the loop being run and the chunks of it not finished yet
+	const RANGE_JOB* m_pJob;
+	std::atomic<int> m_remainingTasks;
+	// wakes the workers for a new loop and the caller once done
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	unsigned int m_generation;
+	bool m_bStopping;
+
+	// wait for loops and work on them until stopped
+	void WorkerLoop(int worker);
+	// take a chunk from the worker's own queue or steal one
+	bool PopTask(int worker, TASK& task);
+	// work on chunks until there are none left to take
+	void RunTasks(int worker);
+
+public:
+	// run a loop in chunks and return once all of them are done
+	void ParallelFor(int count, int chunkSize, const RANGE_JOB& job);
+	// get the number of workers, including the calling thread
+	int GetWorkerCount() const;
+
+	// run a loop on the job system, or on the calling thread as
+	// one chunk when the job system is NULL
+	static void Run(JobSystem* pJobSystem, int count, int chunkSize, const RANGE_JOB& job);
+	// get the number of workers, which is 1 when it is NULL
+	static int GetWorkerCount(const JobSystem* pJobSystem);
+};
@@ -0,0 +1,178 @@
+///////////////////////////////////////////////////////////////////////////////
+// KernelBenchmark.cpp
+// ============
+// time the vectorized kernels against the scalar code they replace
+///////////////////////////////////////////////////////////////////////////////
+
+#include "KernelBenchmark.h"
+#include "SimdKernels.h"
+#include "ViewFrustum.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// number of objects in each case
+	const int g_ObjectCounts[] = { 1000, 10000, 100000 };
+	// objects handled in total by the repeats of each case
+	const int g_ObjectsPerCase = 2000000;
+
+	typedef std::chrono::steady_clock CLOCK;
+
+	/***********************************************************
+	 *  NanosecondsPerObject()
+	 *
+	 *  Get the average time spent on each object.
+	 ***********************************************************/
+	double NanosecondsPerObject(CLOCK::time_point start, CLOCK::time_point end, long long objects)
+	{
+		return(std::chrono::duration<double, std::nano>(end - start).count() / (double)objects);
+	}
+
+	/***********************************************************
+	 *  PrintResult()
+	 *
+	 *  Write one timed kernel and its speedup to the console.
+	 ***********************************************************/
+	void PrintResult(const char* name, int count, double nanoseconds, double baseline)
+	{
+		char line[128];
+		snprintf(line, sizeof(line), "  %-24s %7d objects  %8.2f ns/object  %5.2fx",
+			name, count, nanoseconds, baseline / nanoseconds);
+		std::cout << line << std::endl;
+	}
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for timing each kernel on random
+ *  objects scattered around a camera looking down -Z.  The
+ *  checksums keep the compiler from dropping the results.
+ ***********************************************************/
+void KernelBenchmark::Run()
+{
+	std::cout << "Kernel benchmark using " << SimdKernels::GetInstructionSet()
+		<< " (" << SimdKernels::GetWidth() << " objects at once)" << std::endl;
+
+	std::mt19937 random(330);
+	std::uniform_real_distribution<float> positionRange(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> scaleRange(0.1f, 4.0f);
+	std::uniform_real_distribution<float> angleRange(-360.0f, 360.0f);
+
+	ViewFrustum viewFrustum;
+	viewFrustum.ExtractPlanes(
+		glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+		glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+	glm::vec4 planes[ViewFrustum::TOTAL_PLANES];
+	for (int plane = 0; plane < ViewFrustum::TOTAL_PLANES; plane++)
+	{
+		planes[plane] = viewFrustum.GetPlane(plane);
+	}
+
+	const BOUNDING_VOLUME cube = ViewFrustum::MakeBounds(glm::vec3(-0.5f), glm::vec3(0.5f));
+
+	for (int countIndex = 0; countIndex < (int)(sizeof(g_ObjectCounts) / sizeof(g_ObjectCounts[0])); countIndex++)
+	{
+		int count = g_ObjectCounts[countIndex];
+		int repeats = std::max(1, g_ObjectsPerCase / count);
+		long long objects = (long long)count * repeats;
+
+		std::vector<glm::vec3> scales(count);
+		std::vector<glm::vec3> rotations(count);
+		std::vector<glm::vec3> positions(count);
+		std::vector<glm::mat4> models(count);
+		std::vector<BOUNDING_VOLUME> bounds(count);
+		std::vector<uint8_t> results(count);
+		std::vector<int> indices(count);
+
+		for (int i = 0; i < count; i++)
+		{
+			scales[i] = glm::vec3(scaleRange(random), scaleRange(random), scaleRange(random));
+			rotations[i] = glm::vec3(angleRange(random), angleRange(random), angleRange(random));
+			positions[i] = glm::vec3(positionRange(random), positionRange(random), positionRange(random));
+			indices[i] = i;
+		}
+
+		std::cout << "Model matrices" << std::endl;
+		float checksum = 0.0f;
+
+		CLOCK::time_point start = CLOCK::now();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				models[i] =
+					glm::translate(positions[i]) *
+					glm::rotate(glm::radians(rotations[i].x), glm::vec3(1.0f, 0.0f, 0.0f)) *
+					glm::rotate(glm::radians(rotations[i].y), glm::vec3(0.0f, 1.0f, 0.0f)) *
+					glm::rotate(glm::radians(rotations[i].z), glm::vec3(0.0f, 0.0f, 1.0f)) *
+					glm::scale(scales[i]);
+			}
+			checksum += models[repeat % count][3].x;
+		}
+		double chainTime = NanosecondsPerObject(start, CLOCK::now(), objects);
+		PrintResult("glm matrix chain", count, chainTime, chainTime);
+
+		start = CLOCK::now();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			SimdKernels::ComposeModelMatricesScalar(&scales[0], &rotations[0], &positions[0], &indices[0], count, &models[0]);
+			checksum += models[repeat % count][3].x;
+		}
+		PrintResult("scalar composition", count, NanosecondsPerObject(start, CLOCK::now(), objects), chainTime);
+
+		start = CLOCK::now();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			SimdKernels::ComposeModelMatrices(&scales[0], &rotations[0], &positions[0], &indices[0], count, &models[0]);
+			checksum += models[repeat % count][3].x;
+		}
+		PrintResult("vectorized composition", count, NanosecondsPerObject(start, CLOCK::now(), objects), chainTime);
+
+		for (int i = 0; i < count; i++)
+		{
+			bounds[i] = ViewFrustum::TransformBounds(cube, models[i]);
+		}
+
+		std::cout << "View tests" << std::endl;
+		int visibleCount = 0;
+
+		start = CLOCK::now();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				visibleCount += (viewFrustum.TestBounds(bounds[i]) != ViewFrustum::OUTSIDE) ? 1 : 0;
+			}
+		}
+		double scalarTestTime = NanosecondsPerObject(start, CLOCK::now(), objects);
+		PrintResult("scalar bounds test", count, scalarTestTime, scalarTestTime);
+
+		start = CLOCK::now();
+		for (int repeat = 0; repeat < repeats; repeat++)
+		{
+			SimdKernels::TestSpheres(&bounds[0], count, planes, &results[0]);
+			for (int i = 0; i < count; i++)
+			{
+				bool bVisible = (SimdKernels::SPHERE_INSIDE == results[i]);
+				if (SimdKernels::SPHERE_CROSSING == results[i])
+				{
+					bVisible = (viewFrustum.TestBounds(bounds[i]) != ViewFrustum::OUTSIDE);
+				}
+				visibleCount += bVisible ? 1 : 0;
+			}
+		}
+		PrintResult("vectorized sphere test", count, NanosecondsPerObject(start, CLOCK::now(), objects), scalarTestTime);
+
+		std::cout << "  checksum " << checksum << " " << visibleCount << std::endl;
+	}
+}
@@ -0,0 +1,24 @@
+///////////////////////////////////////////////////////////////////////////////
+// KernelBenchmark.h
+// ============
+// time the vectorized kernels against the scalar code they replace
+//
+//  The model matrices and the view tests are timed on 1,000, 10,000 and
+//  100,000 random objects, so the cost per object can be compared as the
+//  data grows out of the caches.  No window or OpenGL context is needed.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/***********************************************************
+ *  KernelBenchmark
+ *
+ *  This class contains the code for the micro-benchmark of
+ *  the frame kernels.
+ ***********************************************************/
+class KernelBenchmark
+{
+public:
+	// run every case and write the times to the console
+	static void Run();
+};
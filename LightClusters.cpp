@@ -0,0 +1,325 @@
+///////////////////////////////////////////////////////////////////////////////
+// LightClusters.cpp
+// ============
+// bin the scene point lights into the clusters of the view on the GPU
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightClusters.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// declaration of global variables
+namespace
+{
+	// invocations per work group, matching lightClusterCompute.glsl
+	const int g_WorkGroupSize = 64;
+	// closest depth the slices start at, so an orthographic view
+	// with its near plane at or behind the camera still has slices
+	const float g_MinSliceDepth = 0.05f;
+
+	// names of the storage blocks, in the order of the buffers
+	const char* g_BlockNames[] =
+	{
+		"ClusterLights",
+		"ClusterGrid",
+		"ClusterIndices"
+	};
+}
+
+/***********************************************************
+ *  LightClusters()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightClusters::LightClusters()
+{
+	m_program = 0;
+	for (int i = 0; i < TOTAL_BUFFERS; i++)
+	{
+		m_buffers[i] = 0;
+	}
+	m_lightCount = 0;
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	m_viewport = glm::vec4(0.0f);
+	m_bDirty = true;
+}
+
+/***********************************************************
+ *  ~LightClusters()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LightClusters::~LightClusters()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking that the driver has the
+ *  compute shaders and storage buffers the binning pass and
+ *  the clustered lighting shader need.
+ ***********************************************************/
+bool LightClusters::IsSupported()
+{
+	return(GLEW_ARB_compute_shader &&
+		GLEW_ARB_shader_storage_buffer_object);
+}
+
+/***********************************************************
+ *  LoadComputeShader()
+ *
+ *  This method is used for compiling and linking the binning
+ *  shader from its GLSL file.
+ ***********************************************************/
+bool LightClusters::LoadComputeShader(const char* filename)
+{
+	std::ifstream file(filename);
+	if (file.is_open() == false)
+	{
+		std::cout << "Could not open compute shader:" << filename << std::endl;
+		return(false);
+	}
+
+	std::stringstream source;
+	source << file.rdbuf();
+	std::string code = source.str();
+	const char* pCode = code.c_str();
+
+	GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(shader, 1, &pCode, NULL);
+	glCompileShader(shader);
+
+	GLint bSuccess = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &bSuccess);
+	if (GL_TRUE != bSuccess)
+	{
+		char log[1024];
+		glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+		std::cout << "Could not compile compute shader:" << filename << "\n" << log << std::endl;
+		glDeleteShader(shader);
+		return(false);
+	}
+
+	m_program = glCreateProgram();
+	glAttachShader(m_program, shader);
+	glLinkProgram(m_program);
+	glDeleteShader(shader);
+
+	glGetProgramiv(m_program, GL_LINK_STATUS, &bSuccess);
+	if (GL_TRUE != bSuccess)
+	{
+		char log[1024];
+		glGetProgramInfoLog(m_program, sizeof(log), NULL, log);
+		std::cout << "Could not link compute shader:" << filename << "\n" << log << std::endl;
+		glDeleteProgram(m_program);
+		m_program = 0;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for loading the binning shader and
+ *  creating the grid and light index buffers, which keep a
+ *  fixed run of slots for every cluster.
+ ***********************************************************/
+bool LightClusters::Initialize(const char* computeShaderFilename)
+{
+	if (IsSupported() == false)
+	{
+		std::cout << "Clustered lighting is not supported by this driver" << std::endl;
+		return(false);
+	}
+	if (LoadComputeShader(computeShaderFilename) == false)
+	{
+		return(false);
+	}
+
+	glGenBuffers(TOTAL_BUFFERS, m_buffers);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[GRID_BUFFER]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GRID_HEADER) + TOTAL_CLUSTERS * sizeof(GLuint), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[INDEX_BUFFER]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, TOTAL_CLUSTERS * MAX_LIGHTS_PER_CLUSTER * sizeof(GLuint), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	// the light buffer always gets one light so it can be bound
+	SetLights(std::vector<POINT_LIGHT>());
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the binning shader and
+ *  the buffers.
+ ***********************************************************/
+void LightClusters::Destroy()
+{
+	if (0 != m_program)
+	{
+		glDeleteProgram(m_program);
+		m_program = 0;
+	}
+	if (0 != m_buffers[0])
+	{
+		glDeleteBuffers(TOTAL_BUFFERS, m_buffers);
+		for (int i = 0; i < TOTAL_BUFFERS; i++)
+		{
+			m_buffers[i] = 0;
+		}
+	}
+	m_lightCount = 0;
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for replacing every point light.  The
+ *  clusters are built again on the next update.
+ ***********************************************************/
+void LightClusters::SetLights(const std::vector<POINT_LIGHT>& lights)
+{
+	if (0 == m_program)
+	{
+		return;
+	}
+
+	m_lightCount = (int)lights.size();
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[LIGHT_BUFFER]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, std::max(m_lightCount, 1) * sizeof(POINT_LIGHT), NULL, GL_DYNAMIC_DRAW);
+	if (m_lightCount > 0)
+	{
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_lightCount * sizeof(POINT_LIGHT), &lights[0]);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	m_bDirty = true;
+}
+
+/***********************************************************
+ *  BindProgram()
+ *
+ *  This method is used for connecting each storage block in
+ *  a lighting program to the binding point of its buffer.
+ *  The binding points are set here, like the uniform blocks,
+ *  so the fragment shader needs no layout binding qualifier.
+ ***********************************************************/
+void LightClusters::BindProgram(GLuint programID)
+{
+	for (int i = 0; i < TOTAL_BUFFERS; i++)
+	{
+		GLuint blockIndex = glGetProgramResourceIndex(programID, GL_SHADER_STORAGE_BLOCK, g_BlockNames[i]);
+		if (GL_INVALID_INDEX != blockIndex)
+		{
+			glShaderStorageBlockBinding(programID, blockIndex, FIRST_BINDING + i);
+		}
+		else
+		{
+			std::cout << "Shader program does not use storage block:" << g_BlockNames[i] << std::endl;
+		}
+	}
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for binning the lights into the
+ *  clusters of the view.  The slices are spaced by the log of
+ *  the depth, so the clusters stay about as deep as they are
+ *  wide from the near plane to the far one.  Nothing is run
+ *  when the camera, viewport and lights are unchanged.
+ ***********************************************************/
+void LightClusters::Update(const glm::mat4& view, const glm::mat4& projection, const glm::vec4& viewport)
+{
+	if (0 == m_program)
+	{
+		return;
+	}
+
+	for (int i = 0; i < TOTAL_BUFFERS; i++)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, FIRST_BINDING + i, m_buffers[i]);
+	}
+
+	if ((m_bDirty == false) &&
+		(view == m_view) &&
+		(projection == m_projection) &&
+		(viewport == m_viewport))
+	{
+		return;
+	}
+	m_view = view;
+	m_projection = projection;
+	m_viewport = viewport;
+	m_bDirty = false;
+
+	// read the clip planes back out of the projection
+	float nearDepth = 0.0f;
+	float farDepth = 0.0f;
+	if (projection[2][3] != 0.0f)
+	{
+		nearDepth = projection[3][2] / (projection[2][2] - 1.0f);
+		farDepth = projection[3][2] / (projection[2][2] + 1.0f);
+	}
+	else
+	{
+		nearDepth = (projection[3][2] + 1.0f) / projection[2][2];
+		farDepth = (projection[3][2] - 1.0f) / projection[2][2];
+	}
+	nearDepth = std::max(nearDepth, g_MinSliceDepth);
+	farDepth = std::max(farDepth, nearDepth * 2.0f);
+
+	GRID_HEADER header;
+	float logRange = std::log(farDepth / nearDepth);
+	header.viewport = viewport;
+	header.depthSlicing = glm::vec4(
+		DEPTH_SLICES / logRange,
+		-DEPTH_SLICES * std::log(nearDepth) / logRange,
+		0.0f,
+		0.0f);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffers[GRID_BUFFER]);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GRID_HEADER), &header);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	GLint currentProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+	glUseProgram(m_program);
+
+	glm::mat4 inverseProjection = glm::inverse(projection);
+	glUniformMatrix4fv(glGetUniformLocation(m_program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+	glUniformMatrix4fv(glGetUniformLocation(m_program, "inverseProjection"), 1, GL_FALSE, glm::value_ptr(inverseProjection));
+	glUniform2f(glGetUniformLocation(m_program, "depthRange"), nearDepth, farDepth);
+	glUniform1ui(glGetUniformLocation(m_program, "lightCount"), (GLuint)m_lightCount);
+
+	glDispatchCompute((TOTAL_CLUSTERS + g_WorkGroupSize - 1) / g_WorkGroupSize, 1, 1);
+
+	// the cluster lists are read by the draws that follow
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	glUseProgram((GLuint)currentProgram);
+}
+
+/***********************************************************
+ *  GetLightCount()
+ *
+ *  This method is used for getting the number of point lights.
+ ***********************************************************/
+int LightClusters::GetLightCount() const
+{
+	return(m_lightCount);
+}
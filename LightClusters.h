@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+// LightClusters.h
+// ============
+// bin the scene point lights into the clusters of the view on the GPU
+//
+//  The view is split into a grid of screen tiles and depth slices.  Each
+//  frame the camera changes, a compute shader tests every point light
+//  against the bounds of every cluster and writes the lights that reach
+//  it, so a fragment only evaluates the lights of its own cluster instead
+//  of every light in the scene.  The point lights live in a storage
+//  buffer, so their number is not limited by the lights uniform block.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  LightClusters
+ *
+ *  This class contains the code for the light binning pass
+ *  and the storage buffers read by the lighting shader.
+ ***********************************************************/
+class LightClusters
+{
+public:
+	// constructor
+	LightClusters();
+	// destructor
+	~LightClusters();
+
+	// size of the cluster grid - these must match the defines in
+	// lightClusterCompute.glsl and fragmentShader.glsl
+	static const int TILES_X = 16;
+	static const int TILES_Y = 9;
+	static const int DEPTH_SLICES = 24;
+	static const int MAX_LIGHTS_PER_CLUSTER = 128;
+	static const int TOTAL_CLUSTERS = TILES_X * TILES_Y * DEPTH_SLICES;
+
+	// one point light as read by the shaders, laid out with
+	// std430 rules - a range of zero means the light never
+	// fades out and reaches every cluster
+	struct POINT_LIGHT
+	{
+		glm::vec4 positionRange;
+		glm::vec4 ambient;
+		glm::vec4 diffuse;
+		glm::vec4 specular;
+	};
+	static_assert(sizeof(POINT_LIGHT) == 64, "POINT_LIGHT must match the std430 layout");
+
+private:
+	// values at the start of the grid buffer that the fragments
+	// use to find their cluster
+	struct GRID_HEADER
+	{
+		// x, y, width and height of the viewport
+		glm::vec4 viewport;
+		// scale and bias from the log of the view depth to the slice
+		glm::vec4 depthSlicing;
+	};
+
+	// storage buffers of the binning pass, bound after the ones
+	// of the GPU culling pass
+	enum BUFFER
+	{
+		LIGHT_BUFFER = 0,
+		GRID_BUFFER,
+		INDEX_BUFFER,
+		TOTAL_BUFFERS
+	};
+	static const int FIRST_BINDING = 5;
+
+	GLuint m_program;
+	GLuint m_buffers[TOTAL_BUFFERS];
+	int m_lightCount;
+	// view the clusters were last built for, so frames with the
+	// same camera and lights skip the binning pass
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	glm::vec4 m_viewport;
+	bool m_bDirty;
+
+	// compile and link the binning shader from a file
+	bool LoadComputeShader(const char* filename);
+
+public:
+	// true when the driver has what the binning pass needs
+	static bool IsSupported();
+
+	// load the binning shader and create the buffers
+	bool Initialize(const char* computeShaderFilename);
+	// free the shader and the buffers
+	void Destroy();
+
+	// replace every point light
+	void SetLights(const std::vector<POINT_LIGHT>& lights);
+	// connect the storage blocks of a lighting program
+	void BindProgram(GLuint programID);
+
+	// bin the lights into the clusters of the view and bind the
+	// buffers for the draws of this frame
+	void Update(const glm::mat4& view, const glm::mat4& projection, const glm::vec4& viewport);
+
+	// get the number of point lights
+	int GetLightCount() const;
+};
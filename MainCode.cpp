@@ -1,199 +1,866 @@
-///////////////////////////////////////////////////////////////////////////////
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-// 
-// ***Code updated by Connie Knupp on 9/29/2024
-///////////////////////////////////////////////////////////////////////////////
-
-#include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
-
-#include <GL/glew.h>        // GLEW library
-#include "GLFW/glfw3.h"     // GLFW library
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-#include "ShapeMeshes.h"
-#include "ShaderManager.h"
-
-// Namespace for declaring global variables
-namespace
-{
-	// Macro for window title
-	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
-
-	// Main GLFW window
-	GLFWwindow* g_Window = nullptr;
-
-	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
-	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
-	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
-}
-
-// Function declarations - all functions that are called manually
-// need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
-
-
-/***********************************************************
- *  main(int, char*)
- *
- *  This function gets called after the application has been
- *  launched.
- ***********************************************************/
-int main(int argc, char* argv[])
-{
-	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
-	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
-
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"../shaders/vertexShader.glsl",
-		"../shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
-
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
-
-	//output navigational instructions for user
-	std::cout << "\n*** KEY FUNCTIONS: ***\n";
-	std::cout << "W - move forward\t" << "S - move backward\n";
-	std::cout << "A - pan left\t" << "D - pan right\n";
-	std::cout << "Q - pan up\t" << "E - pan down\n";
-	std::cout << "ESC - close the window and exit\n";
-
-	std::cout << "\n*** MOUSE FUNCTIONS: ***\n";
-	std::cout << "Moving the mouse rotates the camera\n";
-	std::cout << "Mouse scroll changes the speed of the camera's movement\n";
-	
-
-	//std::cout << "O - switch to front orthographic view\n";
-	//std::cout << "P - switch to perspective view\n";
-	
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
-
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
-
-
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
-	}
-
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
-
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
-}
-
-/***********************************************************
- *	InitializeGLFW()
- * 
- *  This function is used to initialize the GLFW library.   
- ***********************************************************/
-bool InitializeGLFW()
-{
-	// GLFW: initialize and configure library
-	// --------------------------------------
-	glfwInit();
-
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-	// GLFW: end -------------------------------
-
-	return(true);
-}
-
-/***********************************************************
- *	InitializeGLEW()
- *
- *  This function is used to initialize the GLEW library.
- ***********************************************************/
-bool InitializeGLEW()
-{
-	// GLEW: initialize
-	// -----------------------------------------
-	GLenum GLEWInitResult = GLEW_OK;
-
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
-	if (GLEW_OK != GLEWInitResult)
-	{
-		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
-		return false;
-	}
-	// GLEW: end -------------------------------
-
-	// Displays a successful OpenGL initialization message
-	std::cout << "INFO: OpenGL Successfully Initialized\n";
-	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
-
-	return(true);
+///////////////////////////////////////////////////////////////////////////////
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+// 
+// ***Code updated by Connie Knupp on 9/29/2024
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>         // error handling and output
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // strcmp
+#include <cassert>          // steady frame heap check
+#include <string>
+#include <algorithm>        // std::max
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShapeMeshes.h"
+#include "ShaderManager.h"
+#include "UniformBufferManager.h"
+#include "FrameProfiler.h"
+#include "BenchmarkRunner.h"
+#include "FramePipeline.h"
+#include "KernelBenchmark.h"
+#include "FrameArena.h"
+#include "ShaderCache.h"
+#include "RenderTargets.h"
+
+// Namespace for declaring global variables
+namespace
+{
+	// Macro for window title
+	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
+
+	// Main GLFW window
+	GLFWwindow* g_Window = nullptr;
+
+	// scene manager object for managing the 3D scene prepare and render
+	SceneManager* g_SceneManager = nullptr;
+	// shader manager object for dynamic interaction with the shader code
+	ShaderManager* g_ShaderManager = nullptr;
+	// view manager object for managing the 3D view setup and projection to 2D
+	ViewManager* g_ViewManager = nullptr;
+	// uniform buffer object for the camera, lights and materials blocks
+	UniformBufferManager* g_UniformBuffers = nullptr;
+
+	// true when the render counts are written to the console
+	bool g_bShowStats = false;
+	// frame profiler object, only created when profiling is requested
+	FrameProfiler* g_Profiler = nullptr;
+	// benchmark runner object, only created in benchmark mode
+	BenchmarkRunner* g_Benchmark = nullptr;
+	// file the benchmark results are written to, or the console
+	std::string g_BenchmarkOutput;
+	// number of frames timed when no count is passed in
+	const int DEFAULT_BENCHMARK_FRAMES = 600;
+	// time the render counts were last written
+	double g_LastStatsTime = 0.0;
+
+	// the input and camera are ticked at this fixed rate, and no
+	// more ticks than this are caught up after a stall
+	const double SIMULATION_TICK_SECONDS = 1.0 / 120.0;
+	const int MAX_TICKS_PER_FRAME = 8;
+	// true when the frames are drawn on their own render thread
+	bool g_bUseRenderThread = false;
+	// frame pipeline object, only created with the render thread
+	FramePipeline* g_FramePipeline = nullptr;
+
+	// GLSL files of the scene program and the directory its linked
+	// binaries are cached in
+	const char* const VERTEX_SHADER_FILENAME = "../shaders/vertexShader.glsl";
+	const char* const FRAGMENT_SHADER_FILENAME = "../shaders/fragmentShader.glsl";
+	const char* const SHADER_CACHE_DIRECTORY = "../shader_cache";
+	// program cache object for the scene program
+	ShaderCache* g_ShaderCache = nullptr;
+
+	// GLSL files of the pass that tonemaps the offscreen scene
+	const char* const PRESENT_VERTEX_SHADER_FILENAME = "../shaders/presentVertex.glsl";
+	const char* const PRESENT_FRAGMENT_SHADER_FILENAME = "../shaders/presentFragment.glsl";
+	// offscreen HDR scene targets, only created when requested
+	RenderTargets* g_RenderTargets = nullptr;
+
+	// true when a frame is only drawn once something changed
+	bool g_bRenderOnDemand = false;
+	// seconds between the frames when the frame rate is capped,
+	// 0 when the frames are drawn as fast as they can be
+	double g_TargetFrameSeconds = 0.0;
+	// longest sleep of the on demand mode before the scene is
+	// checked for changes again
+	const double IDLE_WAIT_SECONDS = 0.25;
+
+	// frames drawn since the textures finished loading, and how many
+	// must pass before a frame is expected to make no heap allocations
+	int g_SettledFrames = 0;
+	const int STEADY_STATE_FRAMES = 3;
+}
+
+// Function declarations - all functions that are called manually
+// need to be pre-declared at the beginning of the source code.
+bool InitializeGLFW();
+bool InitializeGLEW();
+void RenderFrame(const FramePipeline::FRAME_SNAPSHOT& snapshot);
+bool IsSameCamera(
+	const UniformBufferManager::CAMERA_DATA& first,
+	const UniformBufferManager::CAMERA_DATA& second);
+bool IsSameViews(
+	const ViewManager::FRAME_VIEWS& first,
+	const ViewManager::FRAME_VIEWS& second);
+
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	// the benchmark is set up before the window exists, so its
+	// startup time covers everything from here on
+	for (int i = 1; i < argc; i++)
+	{
+		// draw a scripted camera path offscreen and report the frame times
+		if ((strcmp(argv[i], "--benchmark") == 0) && (NULL == g_Benchmark))
+		{
+			int frameCount = DEFAULT_BENCHMARK_FRAMES;
+			if ((i + 1 < argc) && (atoi(argv[i + 1]) > 0))
+			{
+				frameCount = atoi(argv[++i]);
+			}
+			g_Benchmark = new BenchmarkRunner(frameCount);
+		}
+		// write the benchmark results into a JSON file
+		if ((strcmp(argv[i], "--benchmark-output") == 0) && (i + 1 < argc))
+		{
+			g_BenchmarkOutput = argv[++i];
+		}
+		// time the frame kernels on the CPU and exit without a window
+		if (strcmp(argv[i], "--kernel-benchmark") == 0)
+		{
+			KernelBenchmark::Run();
+			return(EXIT_SUCCESS);
+		}
+	}
+
+	// if GLFW fails initialization, then terminate the application
+	if (InitializeGLFW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// try to create a new shader manager object
+	g_ShaderManager = new ShaderManager();
+	// try to create a new uniform buffer object
+	g_UniformBuffers = new UniformBufferManager();
+	// try to create a new view manager object
+	g_ViewManager = new ViewManager(
+		g_ShaderManager,
+		g_UniformBuffers);
+	g_ViewManager->EnableScriptedCamera(NULL != g_Benchmark);
+	for (int i = 1; i < argc; i++)
+	{
+		// draw the perspective camera on the left half of the window
+		// and the front and top cameras on the right half
+		if (strcmp(argv[i], "--multi-view") == 0)
+		{
+			g_ViewManager->ClearViews();
+			g_ViewManager->AddView(ViewManager::PERSPECTIVE_CAMERA, glm::vec4(0.0f, 0.0f, 0.5f, 1.0f));
+			g_ViewManager->AddView(ViewManager::FRONT_CAMERA, glm::vec4(0.5f, 0.5f, 0.5f, 0.5f));
+			g_ViewManager->AddView(ViewManager::TOP_CAMERA, glm::vec4(0.5f, 0.0f, 0.5f, 0.5f));
+		}
+		// draw the left and right eyes side by side
+		if (strcmp(argv[i], "--stereo") == 0)
+		{
+			g_ViewManager->ClearViews();
+			g_ViewManager->AddView(ViewManager::LEFT_EYE_CAMERA, glm::vec4(0.0f, 0.0f, 0.5f, 1.0f));
+			g_ViewManager->AddView(ViewManager::RIGHT_EYE_CAMERA, glm::vec4(0.5f, 0.0f, 0.5f, 1.0f));
+		}
+	}
+
+	// try to create the main display window
+	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+
+	// if GLEW fails initialization, then terminate the application
+	if (InitializeGLEW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// load the linked shader program from the program cache, which
+	// builds it from the external GLSL files when it has no binary
+	g_ShaderCache = new ShaderCache(SHADER_CACHE_DIRECTORY);
+	GLuint shaderProgram = g_ShaderCache->LoadProgram(
+		VERTEX_SHADER_FILENAME,
+		FRAGMENT_SHADER_FILENAME);
+	if (0 != shaderProgram)
+	{
+		g_ShaderManager->m_programID = shaderProgram;
+	}
+	else
+	{
+		g_ShaderManager->LoadShaders(
+			VERTEX_SHADER_FILENAME,
+			FRAGMENT_SHADER_FILENAME);
+	}
+	g_ShaderManager->use();
+
+	// create the uniform buffers and bind the blocks of the active program
+	GLint programID = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	if (g_UniformBuffers->CreateBuffers(programID) == false)
+	{
+		std::cout << "Failed to create the uniform buffers" << std::endl;
+	}
+
+	// try to create a new scene manager object and prepare the 3D scene
+	g_SceneManager = new SceneManager(
+		g_ShaderManager,
+		g_UniformBuffers);
+	for (int i = 1; i < argc; i++)
+	{
+		// load the scene from another scene file
+		if ((strcmp(argv[i], "--scene") == 0) && (i + 1 < argc))
+		{
+			g_SceneManager->SetSceneFile(argv[++i]);
+		}
+		// report texture and material tags that are never resolved
+		if (strcmp(argv[i], "--check-tags") == 0)
+		{
+			g_SceneManager->EnableTagCheck(true);
+		}
+		// draw one object per draw call instead of instanced batches
+		if (strcmp(argv[i], "--no-instancing") == 0)
+		{
+			g_SceneManager->EnableInstancing(false);
+		}
+		// draw every object, even the ones outside of the view
+		if (strcmp(argv[i], "--no-culling") == 0)
+		{
+			g_SceneManager->EnableCulling(false);
+		}
+		// draw every shape at its full tessellation
+		if (strcmp(argv[i], "--no-lod") == 0)
+		{
+			g_SceneManager->EnableLod(false);
+		}
+		// draw the objects that never move as instances as well
+		if (strcmp(argv[i], "--no-static-batching") == 0)
+		{
+			g_SceneManager->EnableStaticBatching(false);
+		}
+		// run the per-object loops of each frame on one thread
+		if (strcmp(argv[i], "--no-parallel-recording") == 0)
+		{
+			g_SceneManager->EnableParallelRecording(false);
+		}
+		// cull on the GPU and draw with indirect commands
+		if (strcmp(argv[i], "--gpu-driven") == 0)
+		{
+			g_SceneManager->EnableGpuDriven(true);
+		}
+		// light every fragment with the lights block instead of the
+		// point lights binned into its cluster
+		if (strcmp(argv[i], "--no-clustered-lighting") == 0)
+		{
+			g_SceneManager->EnableClusteredLighting(false);
+		}
+		// draw the scene without the shadows of the directional light
+		if (strcmp(argv[i], "--no-shadows") == 0)
+		{
+			g_SceneManager->EnableShadows(false);
+		}
+		// upload the shape meshes with full float vertices
+		if (strcmp(argv[i], "--no-compact-vertices") == 0)
+		{
+			g_SceneManager->EnableCompactVertices(false);
+		}
+		// draw the depth of the opaque geometry before shading it
+		if (strcmp(argv[i], "--depth-prepass") == 0)
+		{
+			g_SceneManager->EnableDepthPrepass(true);
+		}
+		// keep the textures uncompressed and skip the texture cache
+		if (strcmp(argv[i], "--no-texture-cache") == 0)
+		{
+			g_SceneManager->EnableTextureCache(false);
+		}
+		// draw the frames on a render thread apart from the input
+		if (strcmp(argv[i], "--render-thread") == 0)
+		{
+			g_bUseRenderThread = true;
+		}
+		// only draw a frame when the view or the scene changed
+		if (strcmp(argv[i], "--render-on-demand") == 0)
+		{
+			g_bRenderOnDemand = true;
+		}
+		// swap the buffers every N refreshes of the display, 0 for never waiting
+		if ((strcmp(argv[i], "--vsync") == 0) && (i + 1 < argc))
+		{
+			glfwSwapInterval(atoi(argv[++i]));
+		}
+		// sleep between the frames to hold them to a frame rate
+		if ((strcmp(argv[i], "--target-fps") == 0) && (i + 1 < argc))
+		{
+			int framesPerSecond = atoi(argv[++i]);
+			g_TargetFrameSeconds = (framesPerSecond > 0) ? 1.0 / framesPerSecond : 0.0;
+		}
+		// rebuild the scene program whenever its GLSL files are saved
+		if ((strcmp(argv[i], "--watch-shaders") == 0) && (0 != shaderProgram))
+		{
+			g_ShaderCache->StartWatching();
+		}
+		// write the render counts to the console once a second
+		if (strcmp(argv[i], "--stats") == 0)
+		{
+			g_bShowStats = true;
+		}
+		// show the frame timings in the window title
+		if (strcmp(argv[i], "--profile") == 0)
+		{
+			if (NULL == g_Profiler)
+			{
+				g_Profiler = new FrameProfiler();
+			}
+			g_Profiler->ShowOverlay(g_Window, WINDOW_TITLE);
+		}
+		// write the frame timings of every frame into a CSV file
+		if ((strcmp(argv[i], "--profile-csv") == 0) && (i + 1 < argc))
+		{
+			if (NULL == g_Profiler)
+			{
+				g_Profiler = new FrameProfiler();
+			}
+			g_Profiler->OpenCSV(argv[++i]);
+		}
+		// draw the scene offscreen in HDR and tonemap it to the window
+		if (strcmp(argv[i], "--hdr") == 0)
+		{
+			if (NULL == g_RenderTargets)
+			{
+				g_RenderTargets = new RenderTargets();
+			}
+		}
+		// draw the offscreen scene with N samples per pixel
+		if ((strcmp(argv[i], "--msaa") == 0) && (i + 1 < argc))
+		{
+			if (NULL == g_RenderTargets)
+			{
+				g_RenderTargets = new RenderTargets();
+			}
+			g_RenderTargets->SetSamples(atoi(argv[++i]));
+		}
+		// draw the offscreen scene at a fraction of the window size
+		if ((strcmp(argv[i], "--render-scale") == 0) && (i + 1 < argc))
+		{
+			if (NULL == g_RenderTargets)
+			{
+				g_RenderTargets = new RenderTargets();
+			}
+			g_RenderTargets->SetScale((float)atof(argv[++i]));
+		}
+		// scale the offscreen scene to hold the GPU time of the
+		// frames to a budget in milliseconds
+		if ((strcmp(argv[i], "--dynamic-resolution") == 0) && (i + 1 < argc))
+		{
+			if (NULL == g_RenderTargets)
+			{
+				g_RenderTargets = new RenderTargets();
+			}
+			if (NULL == g_Profiler)
+			{
+				g_Profiler = new FrameProfiler();
+			}
+			g_RenderTargets->EnableDynamicResolution(true, atof(argv[++i]));
+		}
+		// multiply the offscreen scene by an exposure before tonemapping
+		if ((strcmp(argv[i], "--exposure") == 0) && (i + 1 < argc))
+		{
+			if (NULL == g_RenderTargets)
+			{
+				g_RenderTargets = new RenderTargets();
+			}
+			g_RenderTargets->SetExposure((float)atof(argv[++i]));
+		}
+	}
+	if (NULL != g_RenderTargets)
+	{
+		// without the present pass the scene is drawn to the window
+		if (g_RenderTargets->Initialize(
+			PRESENT_VERTEX_SHADER_FILENAME,
+			PRESENT_FRAGMENT_SHADER_FILENAME,
+			SHADER_CACHE_DIRECTORY) == false)
+		{
+			delete g_RenderTargets;
+			g_RenderTargets = NULL;
+		}
+		else
+		{
+			g_RenderTargets->SetProfiler(g_Profiler);
+		}
+	}
+	g_SceneManager->SetProfiler(g_Profiler);
+	g_SceneManager->SetShaderCache(g_ShaderCache);
+	g_SceneManager->PrepareScene();
+
+	// the benchmark is not held to the refresh rate of the display
+	if (NULL != g_Benchmark)
+	{
+		int width = 0;
+		int height = 0;
+		glfwSwapInterval(0);
+		glfwGetFramebufferSize(g_Window, &width, &height);
+		if (g_Benchmark->CreateTarget(width, height) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+	}
+
+	//output navigational instructions for user
+	std::cout << "\n*** KEY FUNCTIONS: ***\n";
+	std::cout << "W - move forward\t" << "S - move backward\n";
+	std::cout << "A - pan left\t" << "D - pan right\n";
+	std::cout << "Q - pan up\t" << "E - pan down\n";
+	std::cout << "ESC - close the window and exit\n";
+
+	std::cout << "\n*** MOUSE FUNCTIONS: ***\n";
+	std::cout << "Moving the mouse rotates the camera\n";
+	std::cout << "Mouse scroll changes the speed of the camera's movement\n";
+	
+
+	//std::cout << "O - switch to front orthographic view\n";
+	//std::cout << "P - switch to perspective view\n";
+	
+	g_LastStatsTime = glfwGetTime();
+
+	// the benchmark draws every frame, and the on demand mode asks the
+	// scene whether it changed, which only the drawing thread may do
+	if (NULL != g_Benchmark)
+	{
+		g_bRenderOnDemand = false;
+	}
+	if ((g_bRenderOnDemand == true) && (g_bUseRenderThread == true))
+	{
+		std::cout << "Render on demand draws on the main thread, so the render thread is not used" << std::endl;
+		g_bUseRenderThread = false;
+	}
+
+	// the benchmark path is stepped once per drawn frame, so it
+	// always draws on this thread
+	if ((g_bUseRenderThread == true) && (NULL == g_Benchmark))
+	{
+		g_FramePipeline = new FramePipeline();
+		if (g_FramePipeline->Start(g_Window, RenderFrame) == false)
+		{
+			delete g_FramePipeline;
+			g_FramePipeline = NULL;
+		}
+	}
+
+	// snapshot that is drawn when there is no render thread
+	FramePipeline::FRAME_SNAPSHOT serialSnapshot;
+	// simulation time not yet covered by a tick
+	double tickSeconds = 0.0;
+	double previousTime = glfwGetTime();
+	unsigned int tick = 0;
+	// time the next frame is due when the frame rate is capped
+	double nextFrameTime = previousTime;
+	// camera of the last frame drawn, to tell when it moved
+	ViewManager::FRAME_VIEWS drawnViews = {};
+	bool bDrawnFrame = false;
+
+	// loop will keep running until the application is closed 
+	// or until an error has occurred
+	while (!glfwWindowShouldClose(g_Window))
+	{
+		FramePipeline::FRAME_SNAPSHOT& snapshot = (NULL != g_FramePipeline) ?
+			g_FramePipeline->GetBackSnapshot() : serialSnapshot;
+
+		if (NULL != g_Benchmark)
+		{
+			// one tick per frame, so the path does not depend on time
+			g_ViewManager->SetScriptedCameraFrame(
+				g_Benchmark->GetTimedFrames(),
+				g_Benchmark->GetFrameCount());
+			g_ViewManager->UpdateCamera((float)SIMULATION_TICK_SECONDS);
+			tick++;
+		}
+		else
+		{
+			// move the camera in fixed ticks for the time that passed
+			double currentTime = glfwGetTime();
+			tickSeconds += currentTime - previousTime;
+			previousTime = currentTime;
+			if (tickSeconds > MAX_TICKS_PER_FRAME * SIMULATION_TICK_SECONDS)
+			{
+				tickSeconds = MAX_TICKS_PER_FRAME * SIMULATION_TICK_SECONDS;
+			}
+			while (tickSeconds >= SIMULATION_TICK_SECONDS)
+			{
+				g_ViewManager->UpdateCamera((float)SIMULATION_TICK_SECONDS);
+				tickSeconds -= SIMULATION_TICK_SECONDS;
+				tick++;
+			}
+		}
+
+		// convert from 3D object space to 2D view
+		g_ViewManager->GetFrameViews(snapshot.views);
+		g_ViewManager->GetFramebufferSize(snapshot.framebufferWidth, snapshot.framebufferHeight);
+		snapshot.tick = tick;
+
+		// on demand, a frame is only drawn once the camera moved, the
+		// scene or its shaders changed, or the window was damaged
+		bool bDraw = true;
+		if (g_bRenderOnDemand == true)
+		{
+			bool bRedrawRequested = g_ViewManager->TakeRedrawRequest();
+			bDraw = (bDrawnFrame == false) ||
+				(bRedrawRequested == true) ||
+				(IsSameViews(snapshot.views, drawnViews) == false) ||
+				(g_SceneManager->IsSceneChanging() == true) ||
+				(g_ShaderCache->IsUpdatePending() == true);
+		}
+
+		if (bDraw == true)
+		{
+			drawnViews = snapshot.views;
+			bDrawnFrame = true;
+			if (NULL != g_FramePipeline)
+			{
+				// hand the view to the render thread
+				g_FramePipeline->Publish();
+			}
+			else
+			{
+				RenderFrame(snapshot);
+			}
+		}
+
+		// only this thread may set the window title
+		if (NULL != g_Profiler)
+		{
+			g_Profiler->PresentOverlay();
+		}
+
+		// query the GLFW events, sleeping in the wait for them when
+		// there is time before the next tick or frame is due
+		if (NULL != g_Benchmark)
+		{
+			glfwPollEvents();
+		}
+		else if (NULL != g_FramePipeline)
+		{
+			// wait for input until the next tick is due
+			glfwWaitEventsTimeout(SIMULATION_TICK_SECONDS - tickSeconds);
+		}
+		else if (bDraw == false)
+		{
+			// nothing changed, so sleep until there is input or the
+			// scene is checked again - the time asleep is not caught
+			// up, and the camera gets one tick when the loop wakes
+			glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+			previousTime = glfwGetTime();
+			tickSeconds = SIMULATION_TICK_SECONDS;
+		}
+		else if (g_TargetFrameSeconds > 0.0)
+		{
+			// a frame that ran late moves the next one back instead of
+			// drawing the missed ones in a burst
+			double currentTime = glfwGetTime();
+			nextFrameTime = std::max(nextFrameTime + g_TargetFrameSeconds, currentTime);
+			while (currentTime < nextFrameTime)
+			{
+				glfwWaitEventsTimeout(nextFrameTime - currentTime);
+				currentTime = glfwGetTime();
+			}
+		}
+		else
+		{
+			glfwPollEvents();
+		}
+	}
+
+	// the render thread hands the OpenGL context back before the
+	// objects using it are freed
+	if (NULL != g_FramePipeline)
+	{
+		delete g_FramePipeline;
+		g_FramePipeline = NULL;
+	}
+
+	// clear the allocated manager objects from memory
+	if (NULL != g_Benchmark)
+	{
+		delete g_Benchmark;
+		g_Benchmark = NULL;
+	}
+	if (NULL != g_RenderTargets)
+	{
+		delete g_RenderTargets;
+		g_RenderTargets = NULL;
+	}
+	if (NULL != g_Profiler)
+	{
+		delete g_Profiler;
+		g_Profiler = NULL;
+	}
+	if (NULL != g_SceneManager)
+	{
+		delete g_SceneManager;
+		g_SceneManager = NULL;
+	}
+	if (NULL != g_ViewManager)
+	{
+		delete g_ViewManager;
+		g_ViewManager = NULL;
+	}
+	if (NULL != g_UniformBuffers)
+	{
+		delete g_UniformBuffers;
+		g_UniformBuffers = NULL;
+	}
+	if (NULL != g_ShaderManager)
+	{
+		delete g_ShaderManager;
+		g_ShaderManager = NULL;
+	}
+	if (NULL != g_ShaderCache)
+	{
+		delete g_ShaderCache;
+		g_ShaderCache = NULL;
+	}
+
+	// Terminates the program successfully
+	exit(EXIT_SUCCESS); 
+}
+
+/***********************************************************
+ *	RenderFrame()
+ *
+ *  This function is used to draw one frame from a snapshot
+ *  of the view.  It runs on the render thread when there is
+ *  one, and on the main thread otherwise.  Once the scene has
+ *  settled, a debug build checks that drawing the frame did
+ *  not use the heap - transient data goes in the frame arena.
+ *  The check is skipped with the render thread, since the main
+ *  thread keeps working while the frame is drawn.
+ ***********************************************************/
+void RenderFrame(const FramePipeline::FRAME_SNAPSHOT& snapshot)
+{
+	// switch to the scene program once an edited one is rebuilt
+	if (g_ShaderCache->Update() == true)
+	{
+		GLuint program = g_ShaderCache->GetProgram();
+		g_ShaderManager->m_programID = program;
+		g_ShaderManager->use();
+		g_UniformBuffers->BindProgramBlocks(program);
+		g_SceneManager->BindProgram(program);
+	}
+
+	unsigned long long heapAllocations = FrameArena::GetHeapAllocationCount();
+
+	if (NULL != g_Profiler)
+	{
+		g_Profiler->BeginFrame();
+	}
+	if (NULL != g_Benchmark)
+	{
+		g_Benchmark->BeginFrame();
+	}
+	else
+	{
+		// the window framebuffer follows the size of the window
+		glViewport(0, 0, snapshot.framebufferWidth, snapshot.framebufferHeight);
+	}
+
+	// the scene is drawn into the offscreen targets when there are
+	// any, and presented to the framebuffer bound above
+	bool bOffscreen = (NULL != g_RenderTargets) && (g_RenderTargets->BeginFrame() == true);
+
+	{
+		FrameProfiler::ScopedTimer timer(g_Profiler, "Clear");
+
+		// Enable z-depth
+		glEnable(GL_DEPTH_TEST);
+
+		// Clear the frame and z buffers
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	// write the camera of the snapshot for this frame
+	{
+		FrameProfiler::ScopedTimer timer(g_Profiler, "View");
+		g_ViewManager->PrepareSceneView(snapshot.views.cameras[0]);
+		g_SceneManager->SetViews(snapshot.views);
+	}
+
+	// refresh the 3D scene
+	g_SceneManager->RenderScene();
+
+	if (bOffscreen == true)
+	{
+		FrameProfiler::ScopedTimer timer(g_Profiler, "Present");
+		g_RenderTargets->EndFrame();
+	}
+
+	const SceneManager::RENDER_STATS& frameStats = g_SceneManager->GetRenderStats();
+	if (NULL != g_Profiler)
+	{
+		g_Profiler->SetCounter(FrameProfiler::DRAW_CALLS, frameStats.drawCalls);
+		g_Profiler->SetCounter(FrameProfiler::TRIANGLES, frameStats.triangles);
+		g_Profiler->SetCounter(FrameProfiler::UNIFORM_UPLOADS, frameStats.uniformUploads);
+		g_Profiler->SetCounter(FrameProfiler::STATE_CHANGES_SKIPPED, frameStats.stateChangesSkipped);
+		g_Profiler->SetCounter(FrameProfiler::OBJECTS_CULLED, frameStats.objectsCulled);
+	}
+
+	// write the render counts for this frame once a second
+	if ((g_bShowStats == true) && (glfwGetTime() - g_LastStatsTime >= 1.0))
+	{
+		std::cout << "draw calls:" << frameStats.drawCalls
+			<< ", triangles:" << frameStats.triangles
+			<< ", uniform uploads:" << frameStats.uniformUploads
+			<< ", state changes:" << frameStats.stateChanges
+			<< ", skipped:" << frameStats.stateChangesSkipped
+			<< ", culled:" << frameStats.objectsCulled << std::endl;
+		g_LastStatsTime = glfwGetTime();
+	}
+
+	g_SettledFrames = (g_SceneManager->IsLoadingTextures() == true) ? 0 : g_SettledFrames + 1;
+	if ((FrameArena::IsCountingHeapAllocations() == true) &&
+		(NULL == g_FramePipeline) &&
+		(g_SettledFrames > STEADY_STATE_FRAMES))
+	{
+		assert(FrameArena::GetHeapAllocationCount() == heapAllocations);
+	}
+
+	// Flips the the back buffer with the front buffer every frame.
+	// The benchmark window is hidden, so nothing is swapped.
+	if (NULL == g_Benchmark)
+	{
+		FrameProfiler::ScopedTimer timer(g_Profiler, "Swap");
+		glfwSwapBuffers(g_Window);
+	}
+	else
+	{
+		g_Benchmark->EndFrame(
+			g_SceneManager->IsLoadingTextures(),
+			frameStats.drawCalls,
+			frameStats.triangles);
+		if (g_Benchmark->IsFinished() == true)
+		{
+			g_Benchmark->WriteJSON(g_BenchmarkOutput);
+			glfwSetWindowShouldClose(g_Window, true);
+		}
+	}
+
+	// the transient data of the frame is not needed once it is swapped
+	g_SceneManager->EndFrame();
+
+	if (NULL != g_Profiler)
+	{
+		g_Profiler->EndFrame();
+	}
+}
+
+/***********************************************************
+ *	IsSameCamera()
+ *
+ *  This function is used to check whether two snapshots of
+ *  the camera would draw the same view.
+ ***********************************************************/
+bool IsSameCamera(
+	const UniformBufferManager::CAMERA_DATA& first,
+	const UniformBufferManager::CAMERA_DATA& second)
+{
+	return((first.view == second.view) &&
+		(first.projection == second.projection) &&
+		(first.viewPosition == second.viewPosition));
+}
+
+/***********************************************************
+ *	IsSameViews()
+ *
+ *  This function is used to check whether two snapshots of
+ *  the views would draw the same frame.
+ ***********************************************************/
+bool IsSameViews(
+	const ViewManager::FRAME_VIEWS& first,
+	const ViewManager::FRAME_VIEWS& second)
+{
+	if (first.viewCount != second.viewCount)
+	{
+		return(false);
+	}
+	for (int i = 0; i < first.viewCount; i++)
+	{
+		if ((first.viewports[i] != second.viewports[i]) ||
+			(IsSameCamera(first.cameras[i], second.cameras[i]) == false))
+		{
+			return(false);
+		}
+	}
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLFW()
+ * 
+ *  This function is used to initialize the GLFW library.   
+ ***********************************************************/
+bool InitializeGLFW()
+{
+	// GLFW: initialize and configure library
+	// --------------------------------------
+	glfwInit();
+
+#ifdef __APPLE__
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#else
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+	// GLFW: end -------------------------------
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLEW()
+ *
+ *  This function is used to initialize the GLEW library.
+ ***********************************************************/
+bool InitializeGLEW()
+{
+	// GLEW: initialize
+	// -----------------------------------------
+	GLenum GLEWInitResult = GLEW_OK;
+
+	// try to initialize the GLEW library
+	GLEWInitResult = glewInit();
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return false;
+	}
+	// GLEW: end -------------------------------
+
+	// Displays a successful OpenGL initialization message
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
+
+	return(true);
 }
\ No newline at end of file
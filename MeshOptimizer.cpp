@@ -0,0 +1,479 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshOptimizer.cpp
+// ============
+// reorder and compress the generated shape meshes for the GPU
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshOptimizer.h"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	// the cache the Forsyth scores are modelled on, and the weights
+	// from his write-up - vertices of the last triangle get a fixed
+	// score so the next triangle does not just reuse one edge
+	const int g_ScoreCacheSize = 32;
+	const float g_CacheDecayPower = 1.5f;
+	const float g_LastTriangleScore = 0.75f;
+	const float g_ValenceBoostScale = 2.0f;
+	const float g_ValenceBoostPower = 0.5f;
+
+	// fixed point steps per unit of the compact positions, which
+	// is also the w they are stored over, so the unit shapes can
+	// reach just short of 2 units from their center
+	const float g_PositionSteps = 16384.0f;
+	const int16_t g_PositionW = 16384;
+	const float g_NormalSteps = 32767.0f;
+
+	// one cluster of triangles and the value it is sorted by
+	struct CLUSTER_ORDER
+	{
+		float sortKey;
+		int cluster;
+	};
+
+	/***********************************************************
+	 *  ScoreVertex()
+	 *
+	 *  Score a vertex by where it is in the cache and by how many
+	 *  triangles still use it, so lonely vertices are finished
+	 *  off before they drop out of the cache.
+	 ***********************************************************/
+	float ScoreVertex(int cachePosition, int remainingTriangles)
+	{
+		if (remainingTriangles <= 0)
+		{
+			return(-1.0f);
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				score = g_LastTriangleScore;
+			}
+			else
+			{
+				float scale = 1.0f - (float)(cachePosition - 3) / (float)(g_ScoreCacheSize - 3);
+				score = std::pow(scale, g_CacheDecayPower);
+			}
+		}
+		score += g_ValenceBoostScale * std::pow((float)remainingTriangles, -g_ValenceBoostPower);
+
+		return(score);
+	}
+
+	/***********************************************************
+	 *  CountMisses()
+	 *
+	 *  Run the indices of one triangle through a FIFO cache kept
+	 *  as the time each vertex went in, and count the misses.
+	 ***********************************************************/
+	int CountMisses(const GLuint* triangle, std::vector<int>& timestamps, int& time)
+	{
+		int misses = 0;
+
+		for (int corner = 0; corner < 3; corner++)
+		{
+			GLuint vertex = triangle[corner];
+			if (time - timestamps[vertex] > MeshOptimizer::CACHE_SIZE)
+			{
+				timestamps[vertex] = time++;
+				misses++;
+			}
+		}
+		return(misses);
+	}
+
+	/***********************************************************
+	 *  EncodeOctahedral()
+	 *
+	 *  Fold a unit normal onto the octahedron and flatten it to
+	 *  two values from -1 to 1.
+	 ***********************************************************/
+	glm::vec2 EncodeOctahedral(glm::vec3 normal)
+	{
+		float sum = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+		if (sum <= 0.0f)
+		{
+			return(glm::vec2(0.0f, 0.0f));
+		}
+
+		glm::vec2 encoded(normal.x / sum, normal.y / sum);
+		if (normal.z < 0.0f)
+		{
+			glm::vec2 folded(
+				(1.0f - std::fabs(encoded.y)) * ((encoded.x >= 0.0f) ? 1.0f : -1.0f),
+				(1.0f - std::fabs(encoded.x)) * ((encoded.y >= 0.0f) ? 1.0f : -1.0f));
+			encoded = folded;
+		}
+		return(encoded);
+	}
+}
+
+/***********************************************************
+ *  OptimizeVertexCache()
+ *
+ *  This method is used for reordering the triangles with Tom
+ *  Forsyth's algorithm.  Each step takes the best scoring
+ *  triangle among the ones using cached vertices, so only
+ *  the triangles around the cache are scored again, and the
+ *  whole mesh is only searched when none of them are left.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexCache(std::vector<GLuint>& indices, int vertexCount)
+{
+	int triangleCount = (int)indices.size() / 3;
+	if (triangleCount <= 1)
+	{
+		return;
+	}
+
+	// the triangles of each vertex, where the first ones up to
+	// its remaining count are the ones not yet written out
+	std::vector<int> triangleStarts(vertexCount + 1, 0);
+	for (int i = 0; i < triangleCount * 3; i++)
+	{
+		triangleStarts[indices[i] + 1]++;
+	}
+	for (int vertex = 0; vertex < vertexCount; vertex++)
+	{
+		triangleStarts[vertex + 1] += triangleStarts[vertex];
+	}
+	std::vector<int> vertexTriangles(triangleCount * 3);
+	std::vector<int> remaining(vertexCount, 0);
+	for (int i = 0; i < triangleCount * 3; i++)
+	{
+		GLuint vertex = indices[i];
+		vertexTriangles[triangleStarts[vertex] + remaining[vertex]] = i / 3;
+		remaining[vertex]++;
+	}
+
+	std::vector<int> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (int vertex = 0; vertex < vertexCount; vertex++)
+	{
+		vertexScores[vertex] = ScoreVertex(-1, remaining[vertex]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<uint8_t> added(triangleCount, 0);
+	int bestTriangle = 0;
+	for (int triangle = 0; triangle < triangleCount; triangle++)
+	{
+		triangleScores[triangle] =
+			vertexScores[indices[triangle * 3]] +
+			vertexScores[indices[triangle * 3 + 1]] +
+			vertexScores[indices[triangle * 3 + 2]];
+		if (triangleScores[triangle] > triangleScores[bestTriangle])
+		{
+			bestTriangle = triangle;
+		}
+	}
+
+	std::vector<GLuint> output;
+	output.reserve(indices.size());
+	int cache[g_ScoreCacheSize + 3];
+	int cacheCount = 0;
+	while (output.size() < indices.size())
+	{
+		if (bestTriangle < 0)
+		{
+			float bestScore = -1.0f;
+			for (int triangle = 0; triangle < triangleCount; triangle++)
+			{
+				if ((added[triangle] == 0) && (triangleScores[triangle] > bestScore))
+				{
+					bestScore = triangleScores[triangle];
+					bestTriangle = triangle;
+				}
+			}
+		}
+
+		const GLuint* triangle = &indices[bestTriangle * 3];
+		added[bestTriangle] = 1;
+		output.insert(output.end(), triangle, triangle + 3);
+
+		// the vertices of the triangle move to the front of the cache
+		int newCache[g_ScoreCacheSize + 3];
+		int newCount = 0;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			int vertex = (int)triangle[corner];
+			int* pFirst = &vertexTriangles[triangleStarts[vertex]];
+			int* pLast = pFirst + remaining[vertex] - 1;
+			std::iter_swap(std::find(pFirst, pLast + 1, bestTriangle), pLast);
+			remaining[vertex]--;
+
+			if (std::find(newCache, newCache + newCount, vertex) == newCache + newCount)
+			{
+				newCache[newCount++] = vertex;
+			}
+		}
+		int triangleVertices = newCount;
+		for (int i = 0; i < cacheCount; i++)
+		{
+			if (std::find(newCache, newCache + triangleVertices, cache[i]) == newCache + triangleVertices)
+			{
+				newCache[newCount++] = cache[i];
+			}
+		}
+
+		// rescore the vertices that moved or fell out of the cache,
+		// then the triangles still using them
+		cacheCount = std::min(newCount, g_ScoreCacheSize);
+		for (int i = 0; i < newCount; i++)
+		{
+			int vertex = newCache[i];
+			cachePositions[vertex] = (i < cacheCount) ? i : -1;
+			vertexScores[vertex] = ScoreVertex(cachePositions[vertex], remaining[vertex]);
+			if (i < cacheCount)
+			{
+				cache[i] = vertex;
+			}
+		}
+
+		bestTriangle = -1;
+		float bestScore = -1.0f;
+		for (int i = 0; i < newCount; i++)
+		{
+			int vertex = newCache[i];
+			for (int j = 0; j < remaining[vertex]; j++)
+			{
+				int next = vertexTriangles[triangleStarts[vertex] + j];
+				triangleScores[next] =
+					vertexScores[indices[next * 3]] +
+					vertexScores[indices[next * 3 + 1]] +
+					vertexScores[indices[next * 3 + 2]];
+				if (triangleScores[next] > bestScore)
+				{
+					bestScore = triangleScores[next];
+					bestTriangle = next;
+				}
+			}
+		}
+	}
+
+	indices.swap(output);
+}
+
+/***********************************************************
+ *  OptimizeOverdraw()
+ *
+ *  This method is used for sorting the triangles so the ones
+ *  facing out from the center of the mesh are drawn first,
+ *  as described by Sander, Nehab and Barczak.  The cache
+ *  ordered triangles are split into clusters where the cache
+ *  starts over anyway, and again where a run already reuses
+ *  the cache within the threshold of the whole mesh, which
+ *  keeps the sorting from undoing the cache order.
+ ***********************************************************/
+void MeshOptimizer::OptimizeOverdraw(
+	std::vector<GLuint>& indices,
+	const std::vector<ShapeGeometry::VERTEX>& vertices,
+	float threshold)
+{
+	int triangleCount = (int)indices.size() / 3;
+	int vertexCount = (int)vertices.size();
+	if (triangleCount <= 1)
+	{
+		return;
+	}
+
+	// a triangle missing on all three vertices starts a cluster
+	std::vector<int> hardStarts;
+	std::vector<int> timestamps(vertexCount, 0);
+	int time = CACHE_SIZE + 1;
+	for (int triangle = 0; triangle < triangleCount; triangle++)
+	{
+		if (CountMisses(&indices[triangle * 3], timestamps, time) == 3)
+		{
+			hardStarts.push_back(triangle);
+		}
+	}
+	hardStarts.push_back(triangleCount);
+
+	float thresholdRatio = ComputeCacheMissRatio(indices, vertexCount) * threshold;
+	std::vector<int> clusterStarts;
+	for (int hard = 0; hard + 1 < hardStarts.size(); hard++)
+	{
+		int start = hardStarts[hard];
+		int end = hardStarts[hard + 1];
+		int misses = 0;
+
+		clusterStarts.push_back(start);
+		time += CACHE_SIZE + 1;
+		for (int triangle = start; triangle < end; triangle++)
+		{
+			misses += CountMisses(&indices[triangle * 3], timestamps, time);
+			if ((triangle + 1 < end) &&
+				((float)misses / (float)(triangle + 1 - clusterStarts.back()) <= thresholdRatio))
+			{
+				clusterStarts.push_back(triangle + 1);
+				misses = 0;
+				time += CACHE_SIZE + 1;
+			}
+		}
+	}
+	clusterStarts.push_back(triangleCount);
+
+	glm::vec3 meshCenter(0.0f);
+	for (int vertex = 0; vertex < vertexCount; vertex++)
+	{
+		meshCenter += vertices[vertex].position;
+	}
+	meshCenter *= 1.0f / (float)std::max(vertexCount, 1);
+
+	// sort by how far the area weighted center of a cluster sits
+	// out along its average normal
+	int clusterCount = (int)clusterStarts.size() - 1;
+	std::vector<CLUSTER_ORDER> order(clusterCount);
+	for (int cluster = 0; cluster < clusterCount; cluster++)
+	{
+		glm::vec3 center(0.0f);
+		glm::vec3 normal(0.0f);
+		float totalArea = 0.0f;
+		for (int triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; triangle++)
+		{
+			const glm::vec3& a = vertices[indices[triangle * 3]].position;
+			const glm::vec3& b = vertices[indices[triangle * 3 + 1]].position;
+			const glm::vec3& c = vertices[indices[triangle * 3 + 2]].position;
+			glm::vec3 faceNormal = glm::cross(b - a, c - a);
+			float area = glm::length(faceNormal);
+
+			center += (a + b + c) * (area / 3.0f);
+			normal += faceNormal;
+			totalArea += area;
+		}
+
+		order[cluster].cluster = cluster;
+		order[cluster].sortKey = 0.0f;
+		if ((totalArea > 0.0f) && (glm::length(normal) > 0.0f))
+		{
+			center *= 1.0f / totalArea;
+			order[cluster].sortKey = glm::dot(center - meshCenter, glm::normalize(normal));
+		}
+	}
+	std::stable_sort(order.begin(), order.end(),
+		[](const CLUSTER_ORDER& first, const CLUSTER_ORDER& second) { return(first.sortKey > second.sortKey); });
+
+	std::vector<GLuint> output;
+	output.reserve(indices.size());
+	for (int i = 0; i < clusterCount; i++)
+	{
+		int cluster = order[i].cluster;
+		output.insert(
+			output.end(),
+			indices.begin() + clusterStarts[cluster] * 3,
+			indices.begin() + clusterStarts[cluster + 1] * 3);
+	}
+	indices.swap(output);
+}
+
+/***********************************************************
+ *  OptimizeVertexFetch()
+ *
+ *  This method is used for renumbering the vertices in the
+ *  order the triangles first use them, so the vertex fetch
+ *  walks forward through the buffer.  Vertices that no
+ *  triangle uses are dropped.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexFetch(ShapeGeometry::MESH_DATA& mesh)
+{
+	const GLuint unused = ~(GLuint)0;
+	std::vector<GLuint> remap(mesh.vertices.size(), unused);
+	std::vector<ShapeGeometry::VERTEX> vertices;
+	vertices.reserve(mesh.vertices.size());
+
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+	{
+		GLuint vertex = mesh.indices[i];
+		if (unused == remap[vertex])
+		{
+			remap[vertex] = (GLuint)vertices.size();
+			vertices.push_back(mesh.vertices[vertex]);
+		}
+		mesh.indices[i] = remap[vertex];
+	}
+
+	mesh.vertices.swap(vertices);
+}
+
+/***********************************************************
+ *  OptimizeMesh()
+ *
+ *  This method is used for running every pass on a mesh, in
+ *  the order each one expects the one before it.
+ ***********************************************************/
+void MeshOptimizer::OptimizeMesh(ShapeGeometry::MESH_DATA& mesh)
+{
+	OptimizeVertexCache(mesh.indices, (int)mesh.vertices.size());
+	OptimizeOverdraw(mesh.indices, mesh.vertices, 1.05f);
+	OptimizeVertexFetch(mesh);
+}
+
+/***********************************************************
+ *  ComputeCacheMissRatio()
+ *
+ *  This method is used for counting the vertices a FIFO cache
+ *  of CACHE_SIZE misses per triangle, which is 3 with no reuse
+ *  at all and about 0.5 at best for a regular grid.
+ ***********************************************************/
+float MeshOptimizer::ComputeCacheMissRatio(const std::vector<GLuint>& indices, int vertexCount)
+{
+	int triangleCount = (int)indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return(0.0f);
+	}
+
+	std::vector<int> timestamps(vertexCount, 0);
+	int time = CACHE_SIZE + 1;
+	int misses = 0;
+	for (int triangle = 0; triangle < triangleCount; triangle++)
+	{
+		misses += CountMisses(&indices[triangle * 3], timestamps, time);
+	}
+
+	return((float)misses / (float)triangleCount);
+}
+
+/***********************************************************
+ *  CompressVertices()
+ *
+ *  This method is used for packing vertices into the compact
+ *  layout.  Dividing the position by its w gives the fixed
+ *  point value back, the normal is folded onto an octahedron
+ *  and the texture coordinate is rounded to half floats.
+ ***********************************************************/
+void MeshOptimizer::CompressVertices(
+	const std::vector<ShapeGeometry::VERTEX>& vertices,
+	std::vector<ShapeGeometry::COMPACT_VERTEX>& compactVertices)
+{
+	compactVertices.resize(vertices.size());
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		const ShapeGeometry::VERTEX& vertex = vertices[i];
+		ShapeGeometry::COMPACT_VERTEX& compact = compactVertices[i];
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float steps = glm::clamp(std::round(vertex.position[axis] * g_PositionSteps), -32767.0f, 32767.0f);
+			compact.position[axis] = (int16_t)steps;
+		}
+		compact.position[3] = g_PositionW;
+
+		glm::vec2 normal = EncodeOctahedral(vertex.normal);
+		compact.normal[0] = (int16_t)std::round(glm::clamp(normal.x, -1.0f, 1.0f) * g_NormalSteps);
+		compact.normal[1] = (int16_t)std::round(glm::clamp(normal.y, -1.0f, 1.0f) * g_NormalSteps);
+
+		compact.textureCoordinate[0] = glm::packHalf1x16(vertex.textureCoordinate.x);
+		compact.textureCoordinate[1] = glm::packHalf1x16(vertex.textureCoordinate.y);
+	}
+}
@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////////
+// MeshOptimizer.h
+// ============
+// reorder and compress the generated shape meshes for the GPU
+//
+//  The shapes are generated row by row, which leaves the post-transform
+//  vertex cache missing on most vertices.  The triangles are reordered
+//  with Tom Forsyth's linear-speed vertex cache optimization, the runs of
+//  triangles are then sorted so the outer facing ones are drawn first and
+//  hide the rest, and the vertices are finally put in the order the
+//  triangles first use them so they are fetched front to back.  The
+//  vertices can also be packed into a layout of half the size.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShapeGeometry.h"
+
+#include <vector>
+
+/***********************************************************
+ *  MeshOptimizer
+ *
+ *  This class contains the mesh processing passes run on the
+ *  shape meshes once they are generated.  None of them need
+ *  OpenGL, and the winding of every triangle is kept.
+ ***********************************************************/
+class MeshOptimizer
+{
+public:
+	// size of the FIFO cache the reordering is measured with,
+	// which is about what current GPUs reuse vertices across
+	static const int CACHE_SIZE = 16;
+
+	// reorder the triangles of a mesh for the vertex cache
+	static void OptimizeVertexCache(std::vector<GLuint>& indices, int vertexCount);
+	// sort runs of cache ordered triangles so the outer facing
+	// ones come first, keeping the cache misses within the
+	// threshold times those of the passed in order
+	static void OptimizeOverdraw(
+		std::vector<GLuint>& indices,
+		const std::vector<ShapeGeometry::VERTEX>& vertices,
+		float threshold);
+	// put the vertices in the order the triangles first use them
+	static void OptimizeVertexFetch(ShapeGeometry::MESH_DATA& mesh);
+	// run every pass above on a mesh
+	static void OptimizeMesh(ShapeGeometry::MESH_DATA& mesh);
+
+	// get the vertex cache misses per triangle of an index order
+	static float ComputeCacheMissRatio(const std::vector<GLuint>& indices, int vertexCount);
+
+	// pack vertices into the compact layout
+	static void CompressVertices(
+		const std::vector<ShapeGeometry::VERTEX>& vertices,
+		std::vector<ShapeGeometry::COMPACT_VERTEX>& compactVertices);
+};
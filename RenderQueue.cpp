@@ -0,0 +1,298 @@
+///////////////////////////////////////////////////////////////////////////////
+// RenderQueue.cpp
+// ============
+// collect and sort the draws for a frame by their render state
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// the farthest depth that fits in the depth field of a key
+	const float g_MaxSortDepth = 100.0f;
+	const uint64_t g_DepthMask = (1ull << 24) - 1;
+
+	// below this many draws a comparison sort is quicker than
+	// the passes of the radix sort
+	const int g_RadixSortThreshold = 256;
+	// draws handled by each chunk of a radix sort pass
+	const int g_RadixChunkSize = 4096;
+	// each pass sorts by one byte of the key
+	const int g_RadixDigits = 256;
+
+	/***********************************************************
+	 *  PackField()
+	 *
+	 *  Clamp a value into a key field of the passed in width.
+	 *  Negative values mean "none" and sort first.
+	 ***********************************************************/
+	uint64_t PackField(int value, int bits)
+	{
+		uint64_t maxValue = (1ull << bits) - 1;
+		uint64_t field = (value < 0) ? 0 : (uint64_t)value + 1;
+
+		return((field > maxValue) ? maxValue : field);
+	}
+}
+
+/***********************************************************
+ *  RenderQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderQueue::RenderQueue(FrameArena* pFrameArena)
+{
+	m_pFrameArena = pFrameArena;
+	m_slots = NULL;
+	m_slotCount = 0;
+	m_items = NULL;
+	m_itemCount = 0;
+}
+
+/***********************************************************
+ *  ~RenderQueue()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderQueue::~RenderQueue()
+{
+	m_pFrameArena = NULL;
+	Clear();
+}
+
+/***********************************************************
+ *  MakeSortKey()
+ *
+ *  This method is used for packing the render state of a
+ *  draw into a 64-bit key.  Sorting by the key groups draws
+ *  with the same state and orders each group near to far.
+ ***********************************************************/
+uint64_t RenderQueue::MakeSortKey(
+	int shaderIndex,
+	int meshIndex,
+	int textureSlot,
+	int materialIndex,
+	float depth)
+{
+	uint64_t key = 0;
+	float normalizedDepth = depth / g_MaxSortDepth;
+
+	if (normalizedDepth < 0.0f)
+		normalizedDepth = 0.0f;
+	if (normalizedDepth > 1.0f)
+		normalizedDepth = 1.0f;
+
+	key |= PackField(shaderIndex, 4) << 60;
+	key |= PackField(meshIndex, 8) << 52;
+	key |= PackField(textureSlot, 8) << 44;
+	key |= PackField(materialIndex, 8) << 36;
+	key |= (uint64_t)(normalizedDepth * g_DepthMask) & g_DepthMask;
+
+	return(key);
+}
+
+/***********************************************************
+ *  MakeDepthSortKey()
+ *
+ *  This method is used for packing the distance of a draw
+ *  above its mesh, so sorting by the key orders the draws
+ *  front to back and groups same mesh draws at equal depth.
+ ***********************************************************/
+uint64_t RenderQueue::MakeDepthSortKey(
+	int meshIndex,
+	float depth)
+{
+	uint64_t key = 0;
+	float normalizedDepth = depth / g_MaxSortDepth;
+
+	if (normalizedDepth < 0.0f)
+		normalizedDepth = 0.0f;
+	if (normalizedDepth > 1.0f)
+		normalizedDepth = 1.0f;
+
+	key |= ((uint64_t)(normalizedDepth * g_DepthMask) & g_DepthMask) << 40;
+	key |= PackField(meshIndex, 8) << 32;
+
+	return(key);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the queued draws.
+ ***********************************************************/
+void RenderQueue::Clear()
+{
+	m_slots = NULL;
+	m_slotCount = 0;
+	m_items = NULL;
+	m_itemCount = 0;
+}
+
+/***********************************************************
+ *  BeginRecording()
+ *
+ *  This method is used for removing all of the queued draws
+ *  and taking an empty slot from the frame arena for every
+ *  draw that might be recorded this frame.
+ ***********************************************************/
+void RenderQueue::BeginRecording(int slotCount)
+{
+	RENDER_ITEM empty;
+
+	empty.sortKey = 0;
+	empty.itemIndex = -1;
+
+	Clear();
+	m_slots = m_pFrameArena->AllocateArray<RENDER_ITEM>(slotCount);
+	m_slotCount = slotCount;
+	std::fill(m_slots, m_slots + slotCount, empty);
+}
+
+/***********************************************************
+ *  Push()
+ *
+ *  This method is used for queueing one draw into its slot.
+ *  Each slot is written by one worker at most, so workers
+ *  never write to the same memory.
+ ***********************************************************/
+void RenderQueue::Push(int slot, uint64_t sortKey, int itemIndex)
+{
+	m_slots[slot].sortKey = sortKey;
+	m_slots[slot].itemIndex = itemIndex;
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for packing the recorded slots into
+ *  one array from the frame arena and ordering the draws by
+ *  their sort keys.  Small queues use a comparison sort and
+ *  large ones the radix sort.
+ ***********************************************************/
+void RenderQueue::Sort(JobSystem* pJobSystem)
+{
+	m_items = m_pFrameArena->AllocateArray<RENDER_ITEM>(m_slotCount);
+	m_itemCount = 0;
+	for (int slot = 0; slot < m_slotCount; slot++)
+	{
+		if (m_slots[slot].itemIndex >= 0)
+		{
+			m_items[m_itemCount++] = m_slots[slot];
+		}
+	}
+
+	if (m_itemCount < g_RadixSortThreshold)
+	{
+		std::sort(m_items, m_items + m_itemCount, [](const RENDER_ITEM& a, const RENDER_ITEM& b)
+		{
+			return(a.sortKey < b.sortKey);
+		});
+		return;
+	}
+
+	RadixSort(pJobSystem);
+}
+
+/***********************************************************
+ *  RadixSort()
+ *
+ *  This method is used for sorting the queued draws from the
+ *  lowest byte of the key to the highest.  Each pass counts
+ *  the digits of every chunk in parallel, turns the counts
+ *  into the place each chunk writes to, and then scatters the
+ *  chunks in parallel.  Chunks keep their order, so every pass
+ *  is stable.  Bytes that are the same in every key, such as
+ *  the unused shader field, are skipped.  The other side of
+ *  each pass and the digit counts come from the frame arena.
+ ***********************************************************/
+void RenderQueue::RadixSort(JobSystem* pJobSystem)
+{
+	int count = m_itemCount;
+	int chunkCount = (count + g_RadixChunkSize - 1) / g_RadixChunkSize;
+
+	uint64_t differingBits = 0;
+	for (int i = 1; i < count; i++)
+	{
+		differingBits |= m_items[i].sortKey ^ m_items[0].sortKey;
+	}
+
+	RENDER_ITEM* sortScratch = m_pFrameArena->AllocateArray<RENDER_ITEM>(count);
+	uint32_t* digitCounts = m_pFrameArena->AllocateArray<uint32_t>(chunkCount * g_RadixDigits);
+
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		if (((differingBits >> shift) & 0xFF) == 0)
+		{
+			continue;
+		}
+
+		// count the digits of each chunk
+		JobSystem::Run(pJobSystem, chunkCount, 1, [this, count, shift, digitCounts](int begin, int end, int worker)
+		{
+			for (int chunk = begin; chunk < end; chunk++)
+			{
+				uint32_t* pCounts = &digitCounts[chunk * g_RadixDigits];
+				int last = std::min((chunk + 1) * g_RadixChunkSize, count);
+
+				std::fill(pCounts, pCounts + g_RadixDigits, 0);
+				for (int i = chunk * g_RadixChunkSize; i < last; i++)
+				{
+					pCounts[(m_items[i].sortKey >> shift) & 0xFF]++;
+				}
+			}
+		});
+
+		// every chunk writes each digit after the earlier chunks
+		uint32_t offset = 0;
+		for (int digit = 0; digit < g_RadixDigits; digit++)
+		{
+			for (int chunk = 0; chunk < chunkCount; chunk++)
+			{
+				uint32_t digitCount = digitCounts[chunk * g_RadixDigits + digit];
+				digitCounts[chunk * g_RadixDigits + digit] = offset;
+				offset += digitCount;
+			}
+		}
+
+		// move each chunk into its places
+		JobSystem::Run(pJobSystem, chunkCount, 1, [this, count, shift, digitCounts, sortScratch](int begin, int end, int worker)
+		{
+			for (int chunk = begin; chunk < end; chunk++)
+			{
+				uint32_t* pOffsets = &digitCounts[chunk * g_RadixDigits];
+				int last = std::min((chunk + 1) * g_RadixChunkSize, count);
+
+				for (int i = chunk * g_RadixChunkSize; i < last; i++)
+				{
+					sortScratch[pOffsets[(m_items[i].sortKey >> shift) & 0xFF]++] = m_items[i];
+				}
+			}
+		});
+
+		std::swap(m_items, sortScratch);
+	}
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method is used for getting the number of queued draws.
+ ***********************************************************/
+int RenderQueue::GetCount() const
+{
+	return(m_itemCount);
+}
+
+/***********************************************************
+ *  GetItem()
+ *
+ *  This method is used for getting a queued draw.
+ ***********************************************************/
+const RenderQueue::RENDER_ITEM& RenderQueue::GetItem(int index) const
+{
+	return(m_items[index]);
+}
@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////////
+// RenderQueue.h
+// ============
+// collect and sort the draws for a frame by their render state
+//
+//  Each draw is pushed with a 64-bit sort key so that draws sharing a
+//  shader, mesh, texture and material end up next to each other, which
+//  lets the submit loop skip setting state that is already current.
+//  Every draw that might be queued has its own slot, so workers of the
+//  job system record the slots of their chunks without locking, and the
+//  filled slots are packed and ordered by a radix sort that runs on the
+//  job system.  The slots and the sort buffers come from the frame arena,
+//  so the sorted draws are only valid until the arena is reset.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameArena.h"
+#include "JobSystem.h"
+
+#include <cstdint>
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class contains the code for collecting the draws of
+ *  a frame and sorting them by state.
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	// constructor - the arena must outlive the queue
+	RenderQueue(FrameArena* pFrameArena);
+	// destructor
+	~RenderQueue();
+
+	// one queued draw - itemIndex refers back to the caller's
+	// draw record or instance batch, and is negative in a slot
+	// that was not recorded
+	struct RENDER_ITEM
+	{
+		uint64_t sortKey;
+		int itemIndex;
+	};
+
+	// build a sort key, most significant field first:
+	//   shader   4 bits  (63-60)
+	//   mesh     8 bits  (59-52)
+	//   texture  8 bits  (51-44)
+	//   material 8 bits  (43-36)
+	//   depth   24 bits  (23-0), near to far
+	static uint64_t MakeSortKey(
+		int shaderIndex,
+		int meshIndex,
+		int textureSlot,
+		int materialIndex,
+		float depth);
+	// build a sort key that orders near to far first, for draws
+	// that gain more from early depth rejection than from state:
+	//   depth   24 bits  (63-40), near to far
+	//   mesh     8 bits  (39-32)
+	static uint64_t MakeDepthSortKey(
+		int meshIndex,
+		float depth);
+
+private:
+	// arena the slots and the sort buffers come from
+	FrameArena* m_pFrameArena;
+	// one slot per draw that might be recorded this frame
+	RENDER_ITEM* m_slots;
+	int m_slotCount;
+	// the recorded draws, packed and sorted
+	RENDER_ITEM* m_items;
+	int m_itemCount;
+
+	// sort the queued draws one byte of the key at a time
+	void RadixSort(JobSystem* pJobSystem);
+
+public:
+	// remove all queued draws
+	void Clear();
+	// clear the queue and make an empty slot for each draw
+	// that might be recorded
+	void BeginRecording(int slotCount);
+	// queue one draw into its slot - a worker only writes the
+	// slots of its own chunk, so it needs no lock
+	void Push(int slot, uint64_t sortKey, int itemIndex);
+	// pack the recorded slots and order the draws by their sort
+	// keys, using the job system when it is not NULL
+	void Sort(JobSystem* pJobSystem = NULL);
+
+	// get the number of queued draws
+	int GetCount() const;
+	// get a queued draw
+	const RENDER_ITEM& GetItem(int index) const;
+};
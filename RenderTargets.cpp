@@ -0,0 +1,514 @@
+///////////////////////////////////////////////////////////////////////////////
+// RenderTargets.cpp
+// ============
+// draw the scene offscreen in HDR and present it to the output framebuffer
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderTargets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// smallest and largest fraction of the output size the scene
+	// is drawn at
+	const float g_MinScale = 0.5f;
+	const float g_MaxScale = 1.0f;
+	// frames whose GPU times are averaged before the scale is moved,
+	// and frames skipped after a move, since the GPU times are read
+	// a couple of frames after they were drawn
+	const int g_ScaleIntervalFrames = 8;
+	const int g_ScaleSettleFrames = 2;
+	// fraction of the budget the GPU time is aimed at, which leaves
+	// room for the frames that run longer than the average
+	const double g_BudgetHeadroom = 0.9;
+	// smallest move of the scale, so the noise of the timings does
+	// not keep changing the resolution
+	const float g_MinScaleStep = 0.05f;
+
+	// names of the values set into the present program
+	const char* const g_ColorName = "sceneColor";
+	const char* const g_UVscaleName = "UVscale";
+	const char* const g_ExposureName = "exposure";
+}
+
+/***********************************************************
+ *  RenderTargets()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderTargets::RenderTargets()
+{
+	m_sceneFramebuffer = 0;
+	m_depthRenderbuffer = 0;
+	m_colorRenderbuffer = 0;
+	m_resolveFramebuffer = 0;
+	m_colorTexture = 0;
+	m_width = 0;
+	m_height = 0;
+	m_samples = 1;
+	m_requestedSamples = 1;
+	m_pShaderCache = NULL;
+	m_program = 0;
+	m_colorLocation = -1;
+	m_UVscaleLocation = -1;
+	m_exposureLocation = -1;
+	m_vertexArray = 0;
+	m_exposure = 1.0f;
+	m_scale = g_MaxScale;
+	m_renderWidth = 0;
+	m_renderHeight = 0;
+	m_bDynamicResolution = false;
+	m_frameBudgetMilliseconds = 0.0;
+	m_gpuMilliseconds = 0.0;
+	m_gpuFrames = 0;
+	m_pProfiler = NULL;
+	m_outputFramebuffer = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		m_outputViewport[i] = 0;
+	}
+	m_bFrameStarted = false;
+}
+
+/***********************************************************
+ *  ~RenderTargets()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderTargets::~RenderTargets()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for loading the present pass program,
+ *  which is kept in the program cache like the scene program.
+ *  The targets are created by the first frame, once the size
+ *  of the output is known.
+ ***********************************************************/
+bool RenderTargets::Initialize(const char* vertexFilename, const char* fragmentFilename, const char* cacheDirectory)
+{
+	m_pShaderCache = new ShaderCache(cacheDirectory);
+	m_program = m_pShaderCache->LoadProgram(vertexFilename, fragmentFilename);
+	if (0 == m_program)
+	{
+		std::cout << "Could not load the present shaders:" << vertexFilename << ", " << fragmentFilename << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	m_colorLocation = glGetUniformLocation(m_program, g_ColorName);
+	m_UVscaleLocation = glGetUniformLocation(m_program, g_UVscaleName);
+	m_exposureLocation = glGetUniformLocation(m_program, g_ExposureName);
+
+	// the triangle of the present pass is made from the vertex
+	// index, but a core profile draw still needs a vertex array
+	glGenVertexArrays(1, &m_vertexArray);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the targets and the
+ *  present pass program.
+ ***********************************************************/
+void RenderTargets::Destroy()
+{
+	DestroyTargets();
+
+	if (0 != m_vertexArray)
+	{
+		glDeleteVertexArrays(1, &m_vertexArray);
+		m_vertexArray = 0;
+	}
+	if (0 != m_program)
+	{
+		glDeleteProgram(m_program);
+		m_program = 0;
+	}
+	if (NULL != m_pShaderCache)
+	{
+		delete m_pShaderCache;
+		m_pShaderCache = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateTargets()
+ *
+ *  This method is used for creating the scene targets at the
+ *  size of the output.  The scene is drawn into a half float
+ *  color buffer and a depth buffer, which are multisampled
+ *  renderbuffers with MSAA.  The color is then resolved into
+ *  a single sampled texture of the same size, and without
+ *  MSAA the scene is drawn into that texture directly.
+ ***********************************************************/
+bool RenderTargets::CreateTargets(int width, int height)
+{
+	DestroyTargets();
+
+	// the driver may offer fewer samples than were asked for
+	GLint maxSamples = 1;
+	glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+	m_samples = std::max(1, std::min(m_requestedSamples, (int)maxSamples));
+
+	glGenTextures(1, &m_colorTexture);
+	glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenRenderbuffers(1, &m_depthRenderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+	if (m_samples > 1)
+	{
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, GL_DEPTH24_STENCIL8, width, height);
+
+		glGenRenderbuffers(1, &m_colorRenderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, m_colorRenderbuffer);
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, GL_RGBA16F, width, height);
+	}
+	else
+	{
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	}
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_sceneFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_sceneFramebuffer);
+	if (m_samples > 1)
+	{
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRenderbuffer);
+	}
+	else
+	{
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+	}
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+	if ((GL_FRAMEBUFFER_COMPLETE == status) && (m_samples > 1))
+	{
+		glGenFramebuffers(1, &m_resolveFramebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_resolveFramebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+		status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	}
+	else
+	{
+		m_resolveFramebuffer = m_sceneFramebuffer;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)m_outputFramebuffer);
+
+	if (GL_FRAMEBUFFER_COMPLETE != status)
+	{
+		std::cout << "Scene framebuffer is not complete with " << m_samples << " samples" << std::endl;
+		DestroyTargets();
+		return(false);
+	}
+
+	m_width = width;
+	m_height = height;
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyTargets()
+ *
+ *  This method is used for freeing the scene targets.
+ ***********************************************************/
+void RenderTargets::DestroyTargets()
+{
+	if ((0 != m_resolveFramebuffer) && (m_resolveFramebuffer != m_sceneFramebuffer))
+	{
+		glDeleteFramebuffers(1, &m_resolveFramebuffer);
+	}
+	m_resolveFramebuffer = 0;
+	if (0 != m_sceneFramebuffer)
+	{
+		glDeleteFramebuffers(1, &m_sceneFramebuffer);
+		m_sceneFramebuffer = 0;
+	}
+	if (0 != m_colorRenderbuffer)
+	{
+		glDeleteRenderbuffers(1, &m_colorRenderbuffer);
+		m_colorRenderbuffer = 0;
+	}
+	if (0 != m_depthRenderbuffer)
+	{
+		glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+		m_depthRenderbuffer = 0;
+	}
+	if (0 != m_colorTexture)
+	{
+		glDeleteTextures(1, &m_colorTexture);
+		m_colorTexture = 0;
+	}
+	m_width = 0;
+	m_height = 0;
+}
+
+/***********************************************************
+ *  SetSamples()
+ *
+ *  This method is used for setting the number of samples of
+ *  the scene targets, which are made again by the next frame.
+ ***********************************************************/
+void RenderTargets::SetSamples(int samples)
+{
+	m_requestedSamples = std::max(1, samples);
+	DestroyTargets();
+}
+
+/***********************************************************
+ *  SetScale()
+ *
+ *  This method is used for setting the fraction of the output
+ *  size the scene is drawn at.  With dynamic resolution it is
+ *  only the scale the first frames start at.
+ ***********************************************************/
+void RenderTargets::SetScale(float scale)
+{
+	m_scale = std::max(g_MinScale, std::min(scale, g_MaxScale));
+}
+
+/***********************************************************
+ *  EnableDynamicResolution()
+ *
+ *  This method is used for letting the scale follow the GPU
+ *  time of the frames, so they fit in the passed in budget.
+ ***********************************************************/
+void RenderTargets::EnableDynamicResolution(bool bEnable, double frameBudgetMilliseconds)
+{
+	m_bDynamicResolution = bEnable;
+	m_frameBudgetMilliseconds = frameBudgetMilliseconds;
+	m_gpuMilliseconds = 0.0;
+	m_gpuFrames = 0;
+}
+
+/***********************************************************
+ *  SetProfiler()
+ *
+ *  This method is used for setting the profiler whose GPU
+ *  times drive the dynamic resolution.
+ ***********************************************************/
+void RenderTargets::SetProfiler(FrameProfiler* pProfiler)
+{
+	m_pProfiler = pProfiler;
+}
+
+/***********************************************************
+ *  SetExposure()
+ *
+ *  This method is used for setting the exposure the HDR color
+ *  is multiplied by before it is tonemapped.
+ ***********************************************************/
+void RenderTargets::SetExposure(float exposure)
+{
+	m_exposure = exposure;
+}
+
+/***********************************************************
+ *  GetScale()
+ *
+ *  This method is used for getting the fraction of the output
+ *  size the scene is drawn at.
+ ***********************************************************/
+float RenderTargets::GetScale() const
+{
+	return(m_scale);
+}
+
+/***********************************************************
+ *  UpdateScale()
+ *
+ *  This method is used for moving the scale towards the one
+ *  whose GPU time fits the frame budget.  The GPU time grows
+ *  with the number of pixels drawn, which is the square of
+ *  the scale.  The scale drops at once when the frames run
+ *  over, and only climbs halfway back each time, so it does
+ *  not overshoot and swing back and forth.
+ ***********************************************************/
+void RenderTargets::UpdateScale()
+{
+	if ((m_bDynamicResolution == false) || (NULL == m_pProfiler) ||
+		(m_frameBudgetMilliseconds <= 0.0))
+	{
+		return;
+	}
+
+	// the frames right after a move were drawn at the old scale
+	m_gpuFrames++;
+	if (m_gpuFrames <= 0)
+	{
+		return;
+	}
+	m_gpuMilliseconds += m_pProfiler->GetGpuFrameMilliseconds();
+	if (m_gpuFrames < g_ScaleIntervalFrames)
+	{
+		return;
+	}
+
+	double averageMilliseconds = m_gpuMilliseconds / m_gpuFrames;
+	m_gpuMilliseconds = 0.0;
+	m_gpuFrames = 0;
+	if (averageMilliseconds <= 0.0)
+	{
+		return;
+	}
+
+	float scale = m_scale * (float)std::sqrt(
+		(m_frameBudgetMilliseconds * g_BudgetHeadroom) / averageMilliseconds);
+	if (scale > m_scale)
+	{
+		scale = m_scale + ((scale - m_scale) * 0.5f);
+	}
+	scale = std::max(g_MinScale, std::min(scale, g_MaxScale));
+
+	if (std::fabs(scale - m_scale) >= g_MinScaleStep)
+	{
+		m_scale = scale;
+		m_gpuFrames = -g_ScaleSettleFrames;
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for saving the framebuffer and viewport
+ *  the frame is presented to and binding the scene targets in
+ *  their place, at the scaled size of the output viewport.
+ *  The targets are made again when the output is resized.
+ *  It returns false when the scene is drawn straight into the
+ *  output instead.
+ ***********************************************************/
+bool RenderTargets::BeginFrame()
+{
+	m_bFrameStarted = false;
+	if (0 == m_program)
+	{
+		return(false);
+	}
+
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_outputFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, m_outputViewport);
+
+	int outputWidth = m_outputViewport[2];
+	int outputHeight = m_outputViewport[3];
+	if ((outputWidth <= 0) || (outputHeight <= 0))
+	{
+		return(false);
+	}
+	if ((outputWidth != m_width) || (outputHeight != m_height))
+	{
+		// the scene is drawn straight into the output from now on
+		if (CreateTargets(outputWidth, outputHeight) == false)
+		{
+			Destroy();
+			return(false);
+		}
+	}
+
+	UpdateScale();
+	m_renderWidth = std::max(1, (int)(outputWidth * m_scale + 0.5f));
+	m_renderHeight = std::max(1, (int)(outputHeight * m_scale + 0.5f));
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_sceneFramebuffer);
+	glViewport(0, 0, m_renderWidth, m_renderHeight);
+	m_bFrameStarted = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for resolving the scaled part of the
+ *  scene targets and drawing it over the output viewport with
+ *  one triangle, which filters it up to the output size and
+ *  tonemaps it.  The depth is not needed past this point, so
+ *  the driver is told it can be thrown away, and the state
+ *  the present pass touches is put back for the next frame.
+ ***********************************************************/
+void RenderTargets::EndFrame()
+{
+	if (m_bFrameStarted == false)
+	{
+		return;
+	}
+	m_bFrameStarted = false;
+
+	if (m_samples > 1)
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_sceneFramebuffer);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_resolveFramebuffer);
+		glBlitFramebuffer(
+			0, 0, m_renderWidth, m_renderHeight,
+			0, 0, m_renderWidth, m_renderHeight,
+			GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+
+	// the depth is not read again, and neither is the multisampled
+	// color once it is resolved
+	if (GLEW_ARB_invalidate_subdata)
+	{
+		const GLenum attachments[] = { GL_DEPTH_STENCIL_ATTACHMENT, GL_COLOR_ATTACHMENT0 };
+		glBindFramebuffer(GL_FRAMEBUFFER, m_sceneFramebuffer);
+		glInvalidateFramebuffer(GL_FRAMEBUFFER, (m_samples > 1) ? 2 : 1, attachments);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)m_outputFramebuffer);
+	glViewport(m_outputViewport[0], m_outputViewport[1], m_outputViewport[2], m_outputViewport[3]);
+
+	GLint currentProgram = 0;
+	GLint currentVertexArray = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &currentVertexArray);
+	GLboolean bDepthTest = glIsEnabled(GL_DEPTH_TEST);
+	GLboolean bBlend = glIsEnabled(GL_BLEND);
+	GLboolean bCullFace = glIsEnabled(GL_CULL_FACE);
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_BLEND);
+	glDisable(GL_CULL_FACE);
+
+	glUseProgram(m_program);
+	glUniform1i(m_colorLocation, TEXTURE_UNIT);
+	glUniform2f(m_UVscaleLocation,
+		(float)m_renderWidth / (float)m_width,
+		(float)m_renderHeight / (float)m_height);
+	glUniform1f(m_exposureLocation, m_exposure);
+
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+	glBindVertexArray(m_vertexArray);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture(GL_TEXTURE0);
+
+	glBindVertexArray((GLuint)currentVertexArray);
+	glUseProgram((GLuint)currentProgram);
+	if (bDepthTest == GL_TRUE)
+	{
+		glEnable(GL_DEPTH_TEST);
+	}
+	if (bBlend == GL_TRUE)
+	{
+		glEnable(GL_BLEND);
+	}
+	if (bCullFace == GL_TRUE)
+	{
+		glEnable(GL_CULL_FACE);
+	}
+}
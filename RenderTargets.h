@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////
+// RenderTargets.h
+// ============
+// draw the scene offscreen in HDR and present it to the output framebuffer
+//
+//  The scene is drawn into a half float color target with its own depth,
+//  so lighting above one is kept until the end of the frame.  With MSAA the
+//  targets are multisampled and are resolved by an explicit blit into a
+//  single sampled texture.  The scene only covers a scaled part of the
+//  targets, and with dynamic resolution the scale follows the GPU time of
+//  the frames against a frame budget, so a slow GPU on a large display
+//  draws fewer pixels instead of dropping frames.  A last pass upscales
+//  the scaled part to the output and tonemaps it.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameProfiler.h"
+#include "ShaderCache.h"
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  RenderTargets
+ *
+ *  This class contains the code for the offscreen scene
+ *  targets, the resolution scaling and the present pass.
+ ***********************************************************/
+class RenderTargets
+{
+public:
+	// constructor
+	RenderTargets();
+	// destructor
+	~RenderTargets();
+
+	// texture unit the scene color is read from by the present
+	// pass, apart from the units of the scene textures
+	static const int TEXTURE_UNIT = 14;
+
+private:
+	// framebuffer the scene is drawn into, and its depth and,
+	// with MSAA, its multisampled color
+	GLuint m_sceneFramebuffer;
+	GLuint m_depthRenderbuffer;
+	GLuint m_colorRenderbuffer;
+	// framebuffer of the single sampled color texture, which is
+	// the scene framebuffer itself without MSAA
+	GLuint m_resolveFramebuffer;
+	GLuint m_colorTexture;
+	// size the targets were created at and their sample count
+	int m_width;
+	int m_height;
+	int m_samples;
+	// sample count asked for, which is clamped to the driver's
+	int m_requestedSamples;
+
+	// present pass program, the values set into it and the empty
+	// vertex array its triangle is drawn with
+	ShaderCache* m_pShaderCache;
+	GLuint m_program;
+	GLint m_colorLocation;
+	GLint m_UVscaleLocation;
+	GLint m_exposureLocation;
+	GLuint m_vertexArray;
+	float m_exposure;
+
+	// fraction of the output size the scene is drawn at, and the
+	// size it covers in the targets this frame
+	float m_scale;
+	int m_renderWidth;
+	int m_renderHeight;
+	// true when the scale follows the GPU time of the frames, the
+	// budget it is held to and the GPU time gathered since the
+	// scale last changed
+	bool m_bDynamicResolution;
+	double m_frameBudgetMilliseconds;
+	double m_gpuMilliseconds;
+	int m_gpuFrames;
+	FrameProfiler* m_pProfiler;
+
+	// framebuffer and viewport the frame is presented to
+	GLint m_outputFramebuffer;
+	GLint m_outputViewport[4];
+	// true between a BeginFrame() that bound the scene targets
+	// and its EndFrame()
+	bool m_bFrameStarted;
+
+	// create the targets at a size, freeing the old ones
+	bool CreateTargets(int width, int height);
+	// free the targets
+	void DestroyTargets();
+	// move the scale towards the one that fits the frame budget
+	void UpdateScale();
+
+public:
+	// load the present pass program
+	bool Initialize(const char* vertexFilename, const char* fragmentFilename, const char* cacheDirectory);
+	// free the targets and the present pass program
+	void Destroy();
+
+	// set the number of MSAA samples, 1 for none
+	void SetSamples(int samples);
+	// draw the scene at a fixed fraction of the output size
+	void SetScale(float scale);
+	// hold the GPU time of the frames to a budget by scaling the
+	// resolution, which reads the GPU times of the profiler
+	void EnableDynamicResolution(bool bEnable, double frameBudgetMilliseconds);
+	void SetProfiler(FrameProfiler* pProfiler);
+	// set the exposure the HDR color is scaled by before tonemapping
+	void SetExposure(float exposure);
+
+	// start a frame by binding the scene targets at the scaled size
+	// of the framebuffer and viewport bound for the output
+	bool BeginFrame();
+	// resolve the scene and draw it upscaled and tonemapped into
+	// the output framebuffer
+	void EndFrame();
+
+	// get the fraction of the output size the scene is drawn at
+	float GetScale() const;
+};
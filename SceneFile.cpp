@@ -0,0 +1,841 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneFile.cpp
+// ============
+// load the textures, materials and objects of a scene from a file
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+#include "SimdKernels.h"
+#include "TextureCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// "SCNB" at the start of every cooked scene file
+	const uint32_t g_SceneMagic = 0x424E4353;
+	// changes whenever the layout of the cooked file changes
+	const uint32_t g_SceneVersion = 1;
+	// every section starts on a cache line, which also keeps the
+	// model matrices aligned for SIMD loads
+	const size_t g_SectionAlignment = 64;
+
+	// names of the meshes in the text form, in the order of MESH_TYPE
+	const char* g_MeshNames[TOTAL_MESH_TYPES] =
+	{
+		"box",
+		"cone",
+		"cylinder",
+		"half_sphere",
+		"plane",
+		"prism",
+		"sphere",
+		"tapered_cylinder",
+		"torus"
+	};
+
+	// the sections of a cooked file, in the order they are written
+	enum SECTION
+	{
+		TEXTURE_SECTION = 0,
+		MATERIAL_SECTION,
+		GROUP_SECTION,
+		// the object arrays, which all have one entry per object
+		SCALE_SECTION,
+		ROTATION_SECTION,
+		POSITION_SECTION,
+		MODEL_SECTION,
+		BOUNDS_SECTION,
+		MESH_SECTION,
+		MATERIAL_INDEX_SECTION,
+		GROUP_INDEX_SECTION,
+		LOD_SECTION,
+		VISIBLE_SECTION,
+		DIRTY_SECTION,
+		TEXTURE_INDEX_SECTION,
+		UV_SCALE_SECTION,
+		TOTAL_SECTIONS
+	};
+
+	// size of one entry of each section
+	const size_t g_SectionSizes[TOTAL_SECTIONS] =
+	{
+		sizeof(SceneFile::TEXTURE_ENTRY),
+		sizeof(SceneFile::MATERIAL_ENTRY),
+		sizeof(SceneFile::GROUP_ENTRY),
+		sizeof(glm::vec3),
+		sizeof(glm::vec3),
+		sizeof(glm::vec3),
+		sizeof(glm::mat4),
+		sizeof(BOUNDING_VOLUME),
+		sizeof(MESH_TYPE),
+		sizeof(int),
+		sizeof(int),
+		sizeof(int),
+		sizeof(uint8_t),
+		sizeof(uint8_t),
+		sizeof(int),
+		sizeof(glm::vec2)
+	};
+	static_assert(sizeof(MESH_TYPE) == sizeof(int32_t), "the cooked meshes are stored as 32-bit values");
+
+	// the values at the start of a cooked file - the source size
+	// and time tell when the text was edited, and the hash of the
+	// mesh bounds when the cooked bounds no longer fit the meshes
+	struct FILE_HEADER
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t fileSize;
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint64_t meshBoundsHash;
+		int32_t counts[TOTAL_SECTIONS];
+		uint64_t offsets[TOTAL_SECTIONS];
+	};
+
+	/***********************************************************
+	 *  AlignSection()
+	 *
+	 *  Round an offset up to the start of the next section.
+	 ***********************************************************/
+	size_t AlignSection(size_t offset)
+	{
+		return((offset + g_SectionAlignment - 1) & ~(g_SectionAlignment - 1));
+	}
+
+	/***********************************************************
+	 *  MakeDirectory()
+	 *
+	 *  Create the directory that holds a file if it is missing.
+	 ***********************************************************/
+	void MakeDirectory(const std::string& path)
+	{
+		size_t separator = path.find_last_of("/\\");
+		if (std::string::npos == separator)
+		{
+			return;
+		}
+
+		std::string directory = path.substr(0, separator);
+#ifdef _WIN32
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+	}
+
+	/***********************************************************
+	 *  CopyName()
+	 *
+	 *  Copy a tag or filename into a fixed size entry, failing
+	 *  when it does not fit.
+	 ***********************************************************/
+	bool CopyName(const std::string& value, char* name, int maxLength)
+	{
+		if (value.empty() || (value.size() >= (size_t)maxLength))
+		{
+			return(false);
+		}
+
+		memset(name, 0, maxLength);
+		memcpy(name, value.c_str(), value.size());
+		return(true);
+	}
+
+	/***********************************************************
+	 *  FindTag()
+	 *
+	 *  Find the entry with a tag, where a tag of "-" means no
+	 *  entry at all and gives -1.
+	 ***********************************************************/
+	template <typename ENTRY>
+	bool FindTag(const std::vector<ENTRY>& entries, const std::string& tag, int& index)
+	{
+		index = -1;
+		if (tag == "-")
+		{
+			return(true);
+		}
+
+		for (int i = 0; i < entries.size(); i++)
+		{
+			if (tag == entries[i].tag)
+			{
+				index = i;
+				return(true);
+			}
+		}
+		return(false);
+	}
+
+	/***********************************************************
+	 *  FindMesh()
+	 *
+	 *  Find the mesh with a name of the text form.
+	 ***********************************************************/
+	bool FindMesh(const std::string& name, MESH_TYPE& mesh)
+	{
+		for (int i = 0; i < TOTAL_MESH_TYPES; i++)
+		{
+			if (name == g_MeshNames[i])
+			{
+				mesh = (MESH_TYPE)i;
+				return(true);
+			}
+		}
+		return(false);
+	}
+}
+
+/***********************************************************
+ *  SceneFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneFile::SceneFile()
+{
+	m_pData = NULL;
+	m_dataSize = 0;
+	m_bMapped = false;
+	Close();
+}
+
+/***********************************************************
+ *  ~SceneFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneFile::~SceneFile()
+{
+	Close();
+}
+
+/***********************************************************
+ *  HashMeshBounds()
+ *
+ *  This method is used for hashing the bounds of every mesh,
+ *  so the cooked object bounds are built again if the meshes
+ *  are ever generated differently.
+ ***********************************************************/
+uint64_t SceneFile::HashMeshBounds(const ShapeGeometry* pGeometry)
+{
+	BOUNDING_VOLUME meshBounds[TOTAL_MESH_TYPES];
+
+	for (int mesh = 0; mesh < TOTAL_MESH_TYPES; mesh++)
+	{
+		meshBounds[mesh] = pGeometry->GetMeshBounds((MESH_TYPE)mesh);
+	}
+
+	return(TextureCache::HashData((const unsigned char*)meshBounds, sizeof(meshBounds)));
+}
+
+/***********************************************************
+ *  GetCookedPath()
+ *
+ *  This method is used for getting the cooked file of a scene
+ *  file.  The hash of the scene path keeps two scenes with the
+ *  same name in different directories apart.
+ ***********************************************************/
+std::string SceneFile::GetCookedPath(const std::string& directory, const std::string& filename)
+{
+	std::string name = filename;
+	size_t separator = name.find_last_of("/\\");
+	if (std::string::npos != separator)
+	{
+		name = name.substr(separator + 1);
+	}
+	size_t extension = name.find_last_of('.');
+	if (std::string::npos != extension)
+	{
+		name = name.substr(0, extension);
+	}
+
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), "_%016llx.bin",
+		(unsigned long long)TextureCache::HashData((const unsigned char*)filename.c_str(), filename.size()));
+
+	return(directory + "/" + name + suffix);
+}
+
+/***********************************************************
+ *  Parse()
+ *
+ *  This method is used for reading the text form of a scene.
+ *  Each line holds one of the following, and everything after
+ *  a # is a comment:
+ *
+ *    texture <tag> <image file>
+ *    material <tag> <diffuse r g b> <specular r g b> <shininess>
+ *    group <name>
+ *    object <mesh> <scale x y z> <rotation x y z> <position x y z>
+ *        <texture tag> <material tag> [<UV scale u v>]
+ *
+ *  An object belongs to the group above it, and a tag of "-"
+ *  leaves out the texture or material.
+ ***********************************************************/
+bool SceneFile::Parse(const std::string& filename, SCENE_SOURCE& source)
+{
+	std::ifstream file(filename.c_str());
+	if (file.is_open() == false)
+	{
+		std::cout << "Could not open scene file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::string line;
+	int lineNumber = 0;
+	int group = -1;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+
+		size_t comment = line.find('#');
+		if (std::string::npos != comment)
+		{
+			line.erase(comment);
+		}
+
+		std::istringstream fields(line);
+		std::string keyword;
+		if (!(fields >> keyword))
+		{
+			continue;
+		}
+
+		bool bValid = false;
+		if (keyword == "texture")
+		{
+			TEXTURE_ENTRY texture;
+			std::string tag;
+			std::string textureFilename;
+			bValid = (fields >> tag >> textureFilename) &&
+				CopyName(tag, texture.tag, MAX_TAG_LENGTH) &&
+				CopyName(textureFilename, texture.filename, MAX_FILENAME_LENGTH);
+			source.textures.push_back(texture);
+		}
+		else if (keyword == "material")
+		{
+			MATERIAL_ENTRY material;
+			std::string tag;
+			bValid = (fields >> tag >>
+				material.diffuseColor.r >> material.diffuseColor.g >> material.diffuseColor.b >>
+				material.specularColor.r >> material.specularColor.g >> material.specularColor.b >>
+				material.shininess) &&
+				CopyName(tag, material.tag, MAX_TAG_LENGTH);
+			source.materials.push_back(material);
+		}
+		else if (keyword == "group")
+		{
+			// the name is the rest of the line, spaces and all
+			GROUP_ENTRY entry;
+			std::string name;
+			std::getline(fields >> std::ws, name);
+			name.erase(name.find_last_not_of(" \t\r") + 1);
+			entry.firstObject = (int)source.objects.size();
+			entry.objectCount = 0;
+			entry.bounds = ViewFrustum::MakeBounds(glm::vec3(0.0f), glm::vec3(0.0f));
+			bValid = CopyName(name, entry.name, MAX_TAG_LENGTH);
+			group = (int)source.groups.size();
+			source.groups.push_back(entry);
+		}
+		else if (keyword == "object")
+		{
+			SOURCE_OBJECT object;
+			std::string meshName;
+			std::string textureTag;
+			std::string materialTag;
+			bValid = (fields >> meshName >>
+				object.scaleXYZ.x >> object.scaleXYZ.y >> object.scaleXYZ.z >>
+				object.rotationDegrees.x >> object.rotationDegrees.y >> object.rotationDegrees.z >>
+				object.positionXYZ.x >> object.positionXYZ.y >> object.positionXYZ.z >>
+				textureTag >> materialTag) &&
+				FindMesh(meshName, object.mesh) &&
+				FindTag(source.textures, textureTag, object.textureIndex) &&
+				FindTag(source.materials, materialTag, object.materialIndex);
+
+			object.UVscale = glm::vec2(1.0f, 1.0f);
+			glm::vec2 UVscale;
+			if (fields >> UVscale.x >> UVscale.y)
+			{
+				object.UVscale = UVscale;
+			}
+
+			object.group = group;
+			if (group >= 0)
+			{
+				source.groups[group].objectCount++;
+			}
+			source.objects.push_back(object);
+		}
+
+		if (bValid == false)
+		{
+			std::cout << "Could not read scene file line:" << filename << "(" << lineNumber << ") " << line << std::endl;
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Cook()
+ *
+ *  This method is used for laying out the cooked form of a
+ *  parsed scene.  The object values go into the sections the
+ *  way SceneObjects keeps them, and the model matrices and
+ *  world space bounds are built here, so nothing needs to be
+ *  done to them once the file is mapped.
+ ***********************************************************/
+bool SceneFile::Cook(
+	const SCENE_SOURCE& source,
+	const ShapeGeometry* pGeometry,
+	uint64_t sourceSize,
+	int64_t sourceTime,
+	uint64_t meshBoundsHash)
+{
+	int objectCount = (int)source.objects.size();
+
+	FILE_HEADER header;
+	memset(&header, 0, sizeof(header));
+	header.magic = g_SceneMagic;
+	header.version = g_SceneVersion;
+	header.sourceSize = sourceSize;
+	header.sourceTime = sourceTime;
+	header.meshBoundsHash = meshBoundsHash;
+
+	size_t offset = AlignSection(sizeof(FILE_HEADER));
+	for (int section = 0; section < TOTAL_SECTIONS; section++)
+	{
+		header.counts[section] = objectCount;
+		if (TEXTURE_SECTION == section)
+		{
+			header.counts[section] = (int32_t)source.textures.size();
+		}
+		else if (MATERIAL_SECTION == section)
+		{
+			header.counts[section] = (int32_t)source.materials.size();
+		}
+		else if (GROUP_SECTION == section)
+		{
+			header.counts[section] = (int32_t)source.groups.size();
+		}
+
+		header.offsets[section] = offset;
+		offset = AlignSection(offset + header.counts[section] * g_SectionSizes[section]);
+	}
+	header.fileSize = offset;
+
+	// the block from malloc is aligned well enough for the matrices
+	m_pData = (unsigned char*)calloc(1, offset);
+	if (NULL == m_pData)
+	{
+		std::cout << "Could not allocate the cooked scene" << std::endl;
+		return(false);
+	}
+	m_dataSize = offset;
+	m_bMapped = false;
+	memcpy(m_pData, &header, sizeof(header));
+
+	if (source.textures.size() > 0)
+	{
+		memcpy(m_pData + header.offsets[TEXTURE_SECTION], &source.textures[0], source.textures.size() * sizeof(TEXTURE_ENTRY));
+	}
+	if (source.materials.size() > 0)
+	{
+		memcpy(m_pData + header.offsets[MATERIAL_SECTION], &source.materials[0], source.materials.size() * sizeof(MATERIAL_ENTRY));
+	}
+
+	glm::vec3* scales = (glm::vec3*)(m_pData + header.offsets[SCALE_SECTION]);
+	glm::vec3* rotationsDegrees = (glm::vec3*)(m_pData + header.offsets[ROTATION_SECTION]);
+	glm::vec3* positions = (glm::vec3*)(m_pData + header.offsets[POSITION_SECTION]);
+	glm::mat4* models = (glm::mat4*)(m_pData + header.offsets[MODEL_SECTION]);
+	BOUNDING_VOLUME* bounds = (BOUNDING_VOLUME*)(m_pData + header.offsets[BOUNDS_SECTION]);
+	MESH_TYPE* meshes = (MESH_TYPE*)(m_pData + header.offsets[MESH_SECTION]);
+	int* materialIndices = (int*)(m_pData + header.offsets[MATERIAL_INDEX_SECTION]);
+	int* groups = (int*)(m_pData + header.offsets[GROUP_INDEX_SECTION]);
+	uint8_t* visible = (uint8_t*)(m_pData + header.offsets[VISIBLE_SECTION]);
+	int* textureIndices = (int*)(m_pData + header.offsets[TEXTURE_INDEX_SECTION]);
+	glm::vec2* UVscales = (glm::vec2*)(m_pData + header.offsets[UV_SCALE_SECTION]);
+
+	// the levels of detail and the dirty flags stay zero
+	std::vector<int> indices(objectCount);
+	for (int index = 0; index < objectCount; index++)
+	{
+		const SOURCE_OBJECT& object = source.objects[index];
+		scales[index] = object.scaleXYZ;
+		rotationsDegrees[index] = object.rotationDegrees;
+		positions[index] = object.positionXYZ;
+		meshes[index] = object.mesh;
+		materialIndices[index] = object.materialIndex;
+		groups[index] = object.group;
+		visible[index] = 1;
+		textureIndices[index] = object.textureIndex;
+		UVscales[index] = object.UVscale;
+		indices[index] = index;
+	}
+
+	if (objectCount > 0)
+	{
+		SimdKernels::ComposeModelMatrices(scales, rotationsDegrees, positions, &indices[0], objectCount, models);
+	}
+	for (int index = 0; index < objectCount; index++)
+	{
+		bounds[index] = ViewFrustum::TransformBounds(pGeometry->GetMeshBounds(meshes[index]), models[index]);
+	}
+
+	GROUP_ENTRY* groupEntries = (GROUP_ENTRY*)(m_pData + header.offsets[GROUP_SECTION]);
+	for (int group = 0; group < source.groups.size(); group++)
+	{
+		GROUP_ENTRY entry = source.groups[group];
+		for (int index = 0; index < entry.objectCount; index++)
+		{
+			const BOUNDING_VOLUME& objectBounds = bounds[entry.firstObject + index];
+			entry.bounds = (0 == index) ? objectBounds : ViewFrustum::MergeBounds(entry.bounds, objectBounds);
+		}
+		groupEntries[group] = entry;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Map()
+ *
+ *  This method is used for mapping a cooked file into memory.
+ *  The pages are copy on write, so the objects can be moved
+ *  in place without the file ever being changed, and only the
+ *  pages that are written get a private copy.
+ ***********************************************************/
+bool SceneFile::Map(const std::string& path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == file)
+	{
+		return(false);
+	}
+
+	LARGE_INTEGER fileSize;
+	if ((GetFileSizeEx(file, &fileSize) == FALSE) || (fileSize.QuadPart < (LONGLONG)sizeof(FILE_HEADER)))
+	{
+		CloseHandle(file);
+		return(false);
+	}
+
+	// the view keeps the mapping open once the handles are closed
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if (NULL == mapping)
+	{
+		return(false);
+	}
+	void* pView = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (NULL == pView)
+	{
+		return(false);
+	}
+
+	m_dataSize = (size_t)fileSize.QuadPart;
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return(false);
+	}
+
+	struct stat status;
+	if ((fstat(file, &status) != 0) || (status.st_size < (off_t)sizeof(FILE_HEADER)))
+	{
+		close(file);
+		return(false);
+	}
+
+	// the mapping stays valid once the file is closed
+	void* pView = mmap(NULL, (size_t)status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	close(file);
+	if (MAP_FAILED == pView)
+	{
+		return(false);
+	}
+
+	m_dataSize = (size_t)status.st_size;
+#endif
+
+	m_pData = (unsigned char*)pView;
+	m_bMapped = true;
+	return(true);
+}
+
+/***********************************************************
+ *  ReadSections()
+ *
+ *  This method is used for checking the header of the cooked
+ *  data against the scene file and the meshes, and pointing
+ *  at each section.  Only the header and the groups are
+ *  checked, since the objects are in a file this class wrote
+ *  itself and walking them would touch every page.
+ ***********************************************************/
+bool SceneFile::ReadSections(uint64_t sourceSize, int64_t sourceTime, uint64_t meshBoundsHash)
+{
+	if ((NULL == m_pData) || (m_dataSize < sizeof(FILE_HEADER)))
+	{
+		return(false);
+	}
+
+	const FILE_HEADER* pHeader = (const FILE_HEADER*)m_pData;
+	if ((pHeader->magic != g_SceneMagic) ||
+		(pHeader->version != g_SceneVersion) ||
+		(pHeader->fileSize != m_dataSize) ||
+		(pHeader->sourceSize != sourceSize) ||
+		(pHeader->sourceTime != sourceTime) ||
+		(pHeader->meshBoundsHash != meshBoundsHash))
+	{
+		return(false);
+	}
+
+	int objectCount = pHeader->counts[SCALE_SECTION];
+	for (int section = 0; section < TOTAL_SECTIONS; section++)
+	{
+		int count = pHeader->counts[section];
+		uint64_t offset = pHeader->offsets[section];
+		if ((count < 0) ||
+			(offset % g_SectionAlignment != 0) ||
+			(offset + count * g_SectionSizes[section] > m_dataSize) ||
+			((section >= SCALE_SECTION) && (count != objectCount)))
+		{
+			return(false);
+		}
+	}
+
+	m_textureCount = pHeader->counts[TEXTURE_SECTION];
+	m_materialCount = pHeader->counts[MATERIAL_SECTION];
+	m_groupCount = pHeader->counts[GROUP_SECTION];
+	m_objectCount = objectCount;
+
+	m_textures = (const TEXTURE_ENTRY*)(m_pData + pHeader->offsets[TEXTURE_SECTION]);
+	m_materials = (const MATERIAL_ENTRY*)(m_pData + pHeader->offsets[MATERIAL_SECTION]);
+	m_groups = (const GROUP_ENTRY*)(m_pData + pHeader->offsets[GROUP_SECTION]);
+	for (int group = 0; group < m_groupCount; group++)
+	{
+		if ((m_groups[group].firstObject < 0) ||
+			(m_groups[group].objectCount < 0) ||
+			(m_groups[group].firstObject + m_groups[group].objectCount > m_objectCount))
+		{
+			return(false);
+		}
+	}
+
+	m_objectArrays.scales = (glm::vec3*)(m_pData + pHeader->offsets[SCALE_SECTION]);
+	m_objectArrays.rotationsDegrees = (glm::vec3*)(m_pData + pHeader->offsets[ROTATION_SECTION]);
+	m_objectArrays.positions = (glm::vec3*)(m_pData + pHeader->offsets[POSITION_SECTION]);
+	m_objectArrays.models = (glm::mat4*)(m_pData + pHeader->offsets[MODEL_SECTION]);
+	m_objectArrays.bounds = (BOUNDING_VOLUME*)(m_pData + pHeader->offsets[BOUNDS_SECTION]);
+	m_objectArrays.meshes = (MESH_TYPE*)(m_pData + pHeader->offsets[MESH_SECTION]);
+	m_objectArrays.materialIndices = (int*)(m_pData + pHeader->offsets[MATERIAL_INDEX_SECTION]);
+	m_objectArrays.groups = (int*)(m_pData + pHeader->offsets[GROUP_INDEX_SECTION]);
+	m_objectArrays.lodLevels = (int*)(m_pData + pHeader->offsets[LOD_SECTION]);
+	m_objectArrays.visible = (uint8_t*)(m_pData + pHeader->offsets[VISIBLE_SECTION]);
+	m_objectArrays.transformDirty = (uint8_t*)(m_pData + pHeader->offsets[DIRTY_SECTION]);
+	m_objectArrays.textureIndices = (int*)(m_pData + pHeader->offsets[TEXTURE_INDEX_SECTION]);
+	m_objectArrays.UVscales = (glm::vec2*)(m_pData + pHeader->offsets[UV_SCALE_SECTION]);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for opening a scene file.  The cooked
+ *  file is mapped when it was made from the same text and
+ *  meshes, and otherwise the text is cooked again and written
+ *  out for the next run.
+ ***********************************************************/
+bool SceneFile::Open(
+	const std::string& filename,
+	const std::string& cacheDirectory,
+	const ShapeGeometry* pGeometry)
+{
+	Close();
+
+	struct stat status;
+	if (stat(filename.c_str(), &status) != 0)
+	{
+		std::cout << "Could not open scene file:" << filename << std::endl;
+		return(false);
+	}
+	uint64_t sourceSize = (uint64_t)status.st_size;
+	int64_t sourceTime = (int64_t)status.st_mtime;
+	uint64_t meshBoundsHash = HashMeshBounds(pGeometry);
+	std::string cookedPath = GetCookedPath(cacheDirectory, filename);
+
+	if ((Map(cookedPath) == true) &&
+		(ReadSections(sourceSize, sourceTime, meshBoundsHash) == true))
+	{
+		return(true);
+	}
+	Close();
+
+	SCENE_SOURCE source;
+	if ((Parse(filename, source) == false) ||
+		(Cook(source, pGeometry, sourceSize, sourceTime, meshBoundsHash) == false) ||
+		(ReadSections(sourceSize, sourceTime, meshBoundsHash) == false))
+	{
+		Close();
+		return(false);
+	}
+
+	// this run keeps using the cooked memory, and the next one
+	// maps the file
+	MakeDirectory(cookedPath);
+	FILE* file = fopen(cookedPath.c_str(), "wb");
+	if ((NULL == file) ||
+		(fwrite(m_pData, 1, m_dataSize, file) != m_dataSize))
+	{
+		std::cout << "Could not write cooked scene file:" << cookedPath << std::endl;
+	}
+	if (NULL != file)
+	{
+		fclose(file);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the cooked file, after
+ *  which the arrays handed out must no longer be used.
+ ***********************************************************/
+void SceneFile::Close()
+{
+	if (NULL != m_pData)
+	{
+		if (m_bMapped == true)
+		{
+#ifdef _WIN32
+			UnmapViewOfFile(m_pData);
+#else
+			munmap(m_pData, m_dataSize);
+#endif
+		}
+		else
+		{
+			free(m_pData);
+		}
+	}
+
+	m_pData = NULL;
+	m_dataSize = 0;
+	m_bMapped = false;
+	m_textures = NULL;
+	m_materials = NULL;
+	m_groups = NULL;
+	memset(&m_objectArrays, 0, sizeof(m_objectArrays));
+	m_textureCount = 0;
+	m_materialCount = 0;
+	m_groupCount = 0;
+	m_objectCount = 0;
+}
+
+/***********************************************************
+ *  GetTextureCount()
+ *
+ *  This method is used for getting the number of textures.
+ ***********************************************************/
+int SceneFile::GetTextureCount() const
+{
+	return(m_textureCount);
+}
+
+/***********************************************************
+ *  GetTexture()
+ *
+ *  This method is used for getting one texture of the scene.
+ ***********************************************************/
+const SceneFile::TEXTURE_ENTRY& SceneFile::GetTexture(int index) const
+{
+	return(m_textures[index]);
+}
+
+/***********************************************************
+ *  GetMaterialCount()
+ *
+ *  This method is used for getting the number of materials.
+ ***********************************************************/
+int SceneFile::GetMaterialCount() const
+{
+	return(m_materialCount);
+}
+
+/***********************************************************
+ *  GetMaterial()
+ *
+ *  This method is used for getting one material of the scene.
+ ***********************************************************/
+const SceneFile::MATERIAL_ENTRY& SceneFile::GetMaterial(int index) const
+{
+	return(m_materials[index]);
+}
+
+/***********************************************************
+ *  GetGroupCount()
+ *
+ *  This method is used for getting the number of groups.
+ ***********************************************************/
+int SceneFile::GetGroupCount() const
+{
+	return(m_groupCount);
+}
+
+/***********************************************************
+ *  GetGroup()
+ *
+ *  This method is used for getting one group of the scene.
+ ***********************************************************/
+const SceneFile::GROUP_ENTRY& SceneFile::GetGroup(int index) const
+{
+	return(m_groups[index]);
+}
+
+/***********************************************************
+ *  GetObjectCount()
+ *
+ *  This method is used for getting the number of objects.
+ ***********************************************************/
+int SceneFile::GetObjectCount() const
+{
+	return(m_objectCount);
+}
+
+/***********************************************************
+ *  GetObjectArrays()
+ *
+ *  This method is used for getting the object arrays, which
+ *  point into the cooked file.
+ ***********************************************************/
+const SceneFile::OBJECT_ARRAYS& SceneFile::GetObjectArrays() const
+{
+	return(m_objectArrays);
+}
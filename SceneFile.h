@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneFile.h
+// ============
+// load the textures, materials and objects of a scene from a file
+//
+//  A scene is written as a text file, with one texture, material, group or
+//  object on each line.  The first time it is opened, the text is parsed
+//  and cooked into a binary file in the cache directory that holds the
+//  object values already laid out as the parallel arrays of SceneObjects,
+//  with the model matrices and bounds built.  Later runs map the cooked
+//  file into memory and use its arrays in place, so opening a scene costs
+//  no parsing and no copying, only the page faults of the values that are
+//  read.  The cooked file is made again whenever the text is edited.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShapeGeometry.h"
+#include "ViewFrustum.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class contains the code for parsing, cooking and
+ *  mapping scene files.  The arrays it hands out point into
+ *  the mapped file, so it must stay open while they are used.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// constructor
+	SceneFile();
+	// destructor
+	~SceneFile();
+
+	// longest tag, group name and texture filename, including the
+	// terminating zero
+	static const int MAX_TAG_LENGTH = 32;
+	static const int MAX_FILENAME_LENGTH = 128;
+
+	// a texture image and the tag the objects use for it
+	struct TEXTURE_ENTRY
+	{
+		char tag[MAX_TAG_LENGTH];
+		char filename[MAX_FILENAME_LENGTH];
+	};
+
+	// the values of one object material
+	struct MATERIAL_ENTRY
+	{
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		char tag[MAX_TAG_LENGTH];
+	};
+
+	// a run of objects culled together, with the bounds around
+	// all of them
+	struct GROUP_ENTRY
+	{
+		int firstObject;
+		int objectCount;
+		BOUNDING_VOLUME bounds;
+		char name[MAX_TAG_LENGTH];
+	};
+
+	// the object arrays of the file, in the layout of the arrays
+	// of SceneObjects, followed by the values of the draw records
+	struct OBJECT_ARRAYS
+	{
+		glm::vec3* scales;
+		glm::vec3* rotationsDegrees;
+		glm::vec3* positions;
+		glm::mat4* models;
+		BOUNDING_VOLUME* bounds;
+		MESH_TYPE* meshes;
+		int* materialIndices;
+		int* groups;
+		int* lodLevels;
+		uint8_t* visible;
+		uint8_t* transformDirty;
+		// index into the textures of the file, or -1
+		int* textureIndices;
+		glm::vec2* UVscales;
+	};
+
+private:
+	// one object line of the text file
+	struct SOURCE_OBJECT
+	{
+		MESH_TYPE mesh;
+		glm::vec3 scaleXYZ;
+		glm::vec3 rotationDegrees;
+		glm::vec3 positionXYZ;
+		int textureIndex;
+		int materialIndex;
+		int group;
+		glm::vec2 UVscale;
+	};
+
+	// the values of the text file before they are cooked
+	struct SCENE_SOURCE
+	{
+		std::vector<TEXTURE_ENTRY> textures;
+		std::vector<MATERIAL_ENTRY> materials;
+		std::vector<GROUP_ENTRY> groups;
+		std::vector<SOURCE_OBJECT> objects;
+	};
+
+	// start of the cooked file, or of the memory it was cooked in
+	unsigned char* m_pData;
+	size_t m_dataSize;
+	// true when the data is a mapping of the cooked file rather
+	// than memory that was allocated
+	bool m_bMapped;
+
+	const TEXTURE_ENTRY* m_textures;
+	const MATERIAL_ENTRY* m_materials;
+	const GROUP_ENTRY* m_groups;
+	OBJECT_ARRAYS m_objectArrays;
+	int m_textureCount;
+	int m_materialCount;
+	int m_groupCount;
+	int m_objectCount;
+
+	// parse the text form of a scene
+	bool Parse(const std::string& filename, SCENE_SOURCE& source);
+	// lay out the cooked form of a parsed scene in memory, with the
+	// model matrices and bounds built
+	bool Cook(
+		const SCENE_SOURCE& source,
+		const ShapeGeometry* pGeometry,
+		uint64_t sourceSize,
+		int64_t sourceTime,
+		uint64_t meshBoundsHash);
+	// map a cooked file into memory
+	bool Map(const std::string& path);
+	// check the header of the data and point at its sections
+	bool ReadSections(uint64_t sourceSize, int64_t sourceTime, uint64_t meshBoundsHash);
+
+	// hash the mesh bounds the cooked bounds are built from
+	static uint64_t HashMeshBounds(const ShapeGeometry* pGeometry);
+	// get the cooked file of a scene file
+	static std::string GetCookedPath(const std::string& directory, const std::string& filename);
+
+public:
+	// open a scene file, cooking it again when the cooked file in
+	// the cache directory is missing or stale
+	bool Open(
+		const std::string& filename,
+		const std::string& cacheDirectory,
+		const ShapeGeometry* pGeometry);
+	// unmap the cooked file
+	void Close();
+
+	int GetTextureCount() const;
+	const TEXTURE_ENTRY& GetTexture(int index) const;
+	int GetMaterialCount() const;
+	const MATERIAL_ENTRY& GetMaterial(int index) const;
+	int GetGroupCount() const;
+	const GROUP_ENTRY& GetGroup(int index) const;
+	int GetObjectCount() const;
+	const OBJECT_ARRAYS& GetObjectArrays() const;
+};
@@ -1,1482 +1,4093 @@
-﻿///////////////////////////////////////////////////////////////////////////////
-// SceneManager.cpp
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-// 
-// *** Modified by Connie Knupp on 10/06/2024   ***
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager* pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-void SceneManager::DefineObjectMaterials()
-{
-	OBJECT_MATERIAL metalMaterial;
-	metalMaterial.diffuseColor = glm::vec3(0.41f, 0.41f, 0.41f);
-	metalMaterial.specularColor = glm::vec3(0.502f, 0.502f, 0.502f);
-	metalMaterial.shininess = 22.0;
-	metalMaterial.tag = "metal";
-	m_objectMaterials.push_back(metalMaterial);
-
-	OBJECT_MATERIAL pumpkinMaterial;
-	pumpkinMaterial.diffuseColor = glm::vec3(1.0f, 0.65f, 0.0f);
-	pumpkinMaterial.specularColor = glm::vec3(1.0f, 0.85f, 0.0f);
-	pumpkinMaterial.shininess = 12.0;
-	pumpkinMaterial.tag = "pumpkin";
-	m_objectMaterials.push_back(pumpkinMaterial);
-
-
-	OBJECT_MATERIAL potionMaterial;
-	potionMaterial.diffuseColor = glm::vec3(0.0f, 0.89f, 0.0f);
-	potionMaterial.specularColor = glm::vec3(0.0f, 1.0f, 0.0f);
-	potionMaterial.shininess = 15.0;
-	potionMaterial.tag = "potion";
-	m_objectMaterials.push_back(potionMaterial);
-
-	OBJECT_MATERIAL strawMaterial;
-	strawMaterial.diffuseColor = glm::vec3(0.10f, 0.089f, 0.071f);
-	strawMaterial.specularColor = glm::vec3(0.10f, 0.089f, 0.0f);
-	strawMaterial.shininess = 2.0;
-	strawMaterial.tag = "straw";
-	m_objectMaterials.push_back(strawMaterial);
-
-	OBJECT_MATERIAL clothMaterial;
-	clothMaterial.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	clothMaterial.specularColor = glm::vec3(0.15f, 0.15f, 0.15f);
-	clothMaterial.shininess = 2.0;
-	clothMaterial.tag = "cloth";
-	m_objectMaterials.push_back(clothMaterial);
-
-	OBJECT_MATERIAL cementMaterial;
-	cementMaterial.diffuseColor = glm::vec3(0.5f, 0.5f, 0.5f);
-	cementMaterial.specularColor = glm::vec3(0.4f, 0.4f, 0.4f);
-	cementMaterial.shininess = 0.5;
-	cementMaterial.tag = "cement";
-	m_objectMaterials.push_back(cementMaterial);
-
-	OBJECT_MATERIAL woodMaterial;
-	woodMaterial.diffuseColor = glm::vec3(0.82f, 0.71f, 0.55f);
-	woodMaterial.specularColor = glm::vec3(0.96f, 0.87f, 0.70f);
-	woodMaterial.shininess = 0.3;
-	woodMaterial.tag = "wood";
-	m_objectMaterials.push_back(woodMaterial);
-
-	OBJECT_MATERIAL stemMaterial;
-	stemMaterial.diffuseColor = glm::vec3(0.55f, 0.27f, 0.075f);
-	stemMaterial.specularColor = glm::vec3(0.55f, 0.27f, 0.075f);
-	stemMaterial.shininess = 0.2;
-	stemMaterial.tag = "stem";
-	m_objectMaterials.push_back(stemMaterial);
-
- }
-
-
-/***********************************************************
- *  LoadSceneTextures()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
- ***********************************************************/
-void SceneManager::LoadSceneTextures()
-{
-	/*** Connie Knupp added the code BELOW for loading the textures that ***/
-	/*** will be used for mapping to objects in the 3D scene. Up to  ***/
-	/*** 16 textures can be loaded per scene.  Code from OpenGLSample used ***/
-	/*** as a template.   ***/
-
-	bool bReturn = false;
-
-	bReturn = CreateGLTexture(
-		"../textures/bat_face.jpg",
-		"bat_face");
-
-	bReturn = CreateGLTexture(
-		"../textures/black_brim.jpg",
-		"black_brim");
-
-	bReturn = CreateGLTexture(
-		"../textures/treebark1.jpg",
-		"stem");
-
-	bReturn = CreateGLTexture(
-		"../textures/black_fur.jpg",
-		"black_fur");
-
-	bReturn = CreateGLTexture(
-		"../textures/cauldron3.jpg",
-		"cauldron");
-
-	bReturn = CreateGLTexture(
-		"../textures/pumpkin2.jpg",
-		"pumpkin");
-
-	bReturn = CreateGLTexture(
-		"../textures/straw1.jpg",
-		"straw_ends");
-
-	bReturn = CreateGLTexture(
-		"../textures/potion.jpg",
-		"potion");
-
-	bReturn = CreateGLTexture(
-		"../textures/pavers.jpg",
-		"pavers");
-
-	bReturn = CreateGLTexture(
-		"../textures/wood_planks.jpg",
-		"wood_planks");
-
-
-	// after the texture image data is loaded into memory, the
-	// loaded textures need to be bound to texture slots - there
-	// are a total of 16 available slots for scene textures
-	BindGLTextures();
-}
-
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationX * rotationY * rotationZ * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			//commented out to work with Apporto fragmentShader
-			//m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			//m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-
-
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	// load the texture image files for the textures applied
-	// to objects in the 3D scene
-	LoadSceneTextures();
-
-	// define the materials that will be used for the objects
-	// in the 3D scene
-	DefineObjectMaterials();
-
-	// add and defile the light sources for the 3D scene
-	SetupSceneLights();
-
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadBoxMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadConeMesh();
-	m_basicMeshes->LoadPrismMesh();
-	m_basicMeshes->LoadSphereMesh();
-	m_basicMeshes->LoadTaperedCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
-}
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-
-void SceneManager::RenderScene()
-{
-	RenderBackground();
-	RenderCauldron();
-	RenderStrawBale();
-	RenderFirstPumpkin();
-	RenderSecondPumpkin();
-	RenderWitchHat();
-	RenderBat();
-
-}
-
-/***********************************************************
- *  RenderBackground()
- *
- *  This method is used for rendering the floor and backdrop
- * for the scene.
- ***********************************************************/
-
-void SceneManager::RenderBackground()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh ***/
-	/*** for the floor.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("pavers");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("cement");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	/***Set needed transformations before drawing the basic mesh for background.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(20.0f, 100.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 10.0f, -10.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("wood_planks");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("wood");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-}
-
-/***********************************************************
- *  RenderCauldron()
- *
- *  This method is used for rendering the CAULDRON
- ***********************************************************/
-void SceneManager::RenderCauldron()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-
-	/*** Set needed transformations before drawing the half-sphere ***/
-	/*** for the base of the cauldron.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.5f, 2.5f, 2.5f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 180.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-4.5f, 2.88F, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("cauldron");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("metal");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawHalfSphereMesh();
-
-	/*** Set needed transformations before drawing the half-sphere ***/
-	/*** for the base of the cauldron.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.5f, 0.5f, 2.5f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 180.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-4.5f, 2.88F, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("potion");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("potion");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-	/**************************************************************/
-	/*** Set needed transformations before drawing the torus ***/
-	/*** for the RIM of the cauldron.*** /
-	/**************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.2f, 2.2f, 2.2f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-4.5f, 2.88f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("cauldron");
-
-	//set the material
-	SetShaderMaterial("metal");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTorusMesh();
-
-	/***********************************************************/
-	/*** Set needed transformations before drawing the first ***/
-	/*** leg for the cauldron.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.35f, 0.9f, 0.35f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 180.0f;
-	YrotationDegrees = -10.0f;
-	ZrotationDegrees = 20.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-5.8f, 0.9f, 0.25f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("cauldron");
-
-	//set the material
-	SetShaderMaterial("metal");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-	/************************************************************/
-	/*** Set needed transformations before drawing the second ***/
-	/*** leg for the cauldron.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.35f, 0.9f, 0.35f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 180.0f;
-	YrotationDegrees = 110.0f;
-	ZrotationDegrees = 20.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-4.5f, 0.9f, -1.3f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("cauldron");
-
-	//set the material
-	SetShaderMaterial("metal");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-	/************************************************************/
-	/*** Set needed transformations before drawing the third ***/
-	/*** leg for the cauldron.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.35f, 0.9f, 0.35f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 180.0f;
-	YrotationDegrees = 230.0f;
-	ZrotationDegrees = 20.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-3.5f, 0.9f, 1.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("cauldron");
-
-	//set the material
-	SetShaderMaterial("metal");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTaperedCylinderMesh();
-}
-
-/***********************************************************
- *  RenderStrawBale()
- *
- *  This method is used for rendering the CAULDRON
- ***********************************************************/
-void SceneManager::RenderStrawBale()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-
-	/*** Set needed transformations before drawing the half-sphere ***/
-	/*** for the base of the cauldron.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(4.0, 8.0f, 4.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 125.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.5f, 2.001F, -1.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("straw_ends");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("straw");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-}
-/***********************************************************
- *  RenderFirstPumpkin()
- *
- *  This method is used for rendering the first pumpkin
- ***********************************************************/
-void SceneManager::RenderFirstPumpkin()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-
-	/*** Set needed transformations before drawing the sphere ***/
-	/*** for the base of the pumpkin.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.6, 1.4f, 1.6f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(1.5f, 5.251F, 1.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("pumpkin");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("pumpkin");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-
-	/*** Set needed transformations before drawing the sphere ***/
-	/*** for the stem of the pumpkin.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.3, 0.6f, 0.3f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 180.0f;
-	ZrotationDegrees = 15.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(1.5f, 6.551F, 1.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("stem");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("stem");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-}
-
-/***********************************************************
- *  RenderSecondPumpkin()
- *
- *  This method is used for rendering the second pumpkin
- ***********************************************************/
-void SceneManager::RenderSecondPumpkin()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-
-	/*** Set needed transformations before drawing the sphere ***/
-	/*** for the base of the pumpkin.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.9, 1.5f, 1.9f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 45.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.25f, 5.451F, -2.1);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("pumpkin");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("pumpkin");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-}
-
-/***********************************************************
- *  RenderWitchHat()
- *
- *  This method is used for rendering the witch hat
- ***********************************************************/
-void SceneManager::RenderWitchHat()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-
-	/*** Set needed transformations before drawing  ***/
-	/*** the cone of the hat *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.2, 3.7f, 1.2f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 180.0f;
-	ZrotationDegrees = -7.5f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.2f, 6.8F, -2.3);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("black_brim");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("cloth");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawConeMesh();
-
-	/*** Set needed transformations before drawing  ***/
-	/*** the brim of the hat *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.25, 0.1f, 2.25f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 180.0f;
-	ZrotationDegrees = -7.5f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.2f, 6.8F, -2.3);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("black_brim");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("cloth");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-}
-
-/***********************************************************
- *  RenderBat()
- *
- *  This method is used for rendering the bat
- ***********************************************************/
-void SceneManager::RenderBat() 
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-
-	/*** Set needed transformations before drawing the sphere ***/
-	/*** for the head of the bat.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.75, 0.5f, 0.62f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 20.0f;
-	YrotationDegrees = 25.0f;
-	ZrotationDegrees = 20.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3( -7.3f, 9.88F, -3.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("bat_face");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("cloth");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-
-	/*** Set needed transformations before drawing the sphere ***/
-	/*** for the body of the bat.*** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.25, 1.0f, 1.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 20.0f;
-	YrotationDegrees = 20.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-7.0f, 9.2F, -3.95f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//Set the texture for the basic mesh
-	SetShaderTexture("black_fur");
-	SetTextureUVScale(1.0, 1.0);
-
-	//set the material
-	SetShaderMaterial("cloth");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-
-	
-	/*** Set needed transformations before drawing the prism ***/
-	/*** for the first part of the bat's left wing *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.6f, 0.15f, 1.6f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 155.0f;
-	YrotationDegrees = 25.0f;
-	ZrotationDegrees = -30.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-5.7f, 9.9F, -3.85f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-
-	/*** Set needed transformations before drawing the prism ***/
-	/*** for the second part of the bat's left wing *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.9f, 0.15f, 1.9f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 155.0f;
-	YrotationDegrees = 35.0f;
-	ZrotationDegrees = -30.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-4.7f, 10.58F, -3.65f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-	
-	/*** Set needed transformations before drawing the prism ***/
-	/*** for the THIRD part of the bat's left wing *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.1f, 0.15f, 1.9f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 155.0f;
-	YrotationDegrees = 50.0f;
-	ZrotationDegrees = -30.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-3.7f, 11.5f, -3.15f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-
-	/*** Set needed transformations before drawing the prism ***/
-	/*** for the first part of the bat's right wing *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.65f, 0.15f, 1.6f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 140.0f;
-	YrotationDegrees = -23.0f;
-	ZrotationDegrees = -25.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-8.65f, 8.6f, -3.6f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-
-	/*** Set needed transformations before drawing the prism ***/
-	/*** for the second part of the bat's right wing *** /
-	/******************************************************************/
-
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.9f, 0.15f, 1.9f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 140.0f;
-	YrotationDegrees = -27.0f;
-	ZrotationDegrees = -25.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-9.6f, 8.45f, -3.1f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-
-	/*** Set needed transformations before drawing the prism ***/
-	/*** for the THIRD part of the bat's right wing *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.1f, 0.15f, 1.9f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 140.0f;
-	YrotationDegrees = -35.0f;
-	ZrotationDegrees = -25.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-10.8f, 8.45f, -2.2f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPrismMesh();
-
-	/*** Set needed transformations before drawing the tapered ***/
-	/*** cylinder for the bat's left leg *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.1, 0.5f, 0.1f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0;
-	YrotationDegrees = 45.0f;
-	ZrotationDegrees = 55.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-5.8f, 8.4f, -4.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-
-	/*** Set needed transformations before drawing the tapered ***/
-	/*** cylinder for the bat's right leg *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.1, 0.5f, 0.1f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0;
-	YrotationDegrees = 135.0f;
-	ZrotationDegrees = 25.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-7.3f, 7.8f, -4.2f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-	/*** Set needed transformations before drawing the ***/
-	/*** Half Sphere for the bat's left ear *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.28, 0.25f, 0.78f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = -50.0;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 20.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-6.9f, 10.25f, -2.85f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawHalfSphereMesh();
-
-	/*** Set needed transformations before drawing the ***/
-	/*** Half Sphere for the bat's right ear *** /
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.28, 0.25f, 0.78f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = -25.0;
-	YrotationDegrees = -60.0f;
-	ZrotationDegrees = 60.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-7.8f, 9.9f, -2.55f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawHalfSphereMesh();
-}
-
-
-
-/***********************************************************
-*  SetupSceneLights()
-*
-*  This method is called to add and configure the light
-*  sources for the 3D scene.  There are up to 4 light sources.
-***********************************************************/
-void SceneManager::SetupSceneLights()
-{
-	// this line of code is NEEDED for telling the shaders to render 
-	// the 3D scene with custom lighting - to use the default rendered 
-	// lighting then comment out the following line
-	m_pShaderManager->setBoolValue(g_UseLightingName, true);
-	
-	//directional lighting to emulate moonlight coming into the scene. 
-	m_pShaderManager->setVec3Value("directionalLight.direction", -0.05f, -0.03f, -10.1f);
-	m_pShaderManager->setVec3Value("directionalLight.ambient", 0.282f, 0.239f, 0.54f);
-	m_pShaderManager->setVec3Value("directionalLight.diffuse", 0.06f, 0.06f, 0.06f);
-	m_pShaderManager->setVec3Value("directionalLight.specular", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setBoolValue("directionalLight.bActive", true);
-
-	//point light 1
-	m_pShaderManager->setVec3Value("pointLights[0].direction", 5.0, 14.0f, 0.0f);
-	m_pShaderManager->setVec3Value("pointLights[0].ambient", 0.0f, 0.003f, 0.0);
-	m_pShaderManager->setVec3Value("pointLights[0].diffuse", 0.01f, 0.05f, 0.01f);
-	m_pShaderManager->setVec3Value("pointLights[0].specular", 0.1f, 0.3f, 0.1f);
-	m_pShaderManager->setBoolValue("pointLights[0].bActive", true);
-
-	//spotlight
-	m_pShaderManager->setVec3Value("spotlight.ambient", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setVec3Value("spotlight.diffuse", 1.0f, 1.0f, 1.0f);
-	m_pShaderManager->setVec3Value("spotlight.specular", 0.7f, 0.7f, 0.7f);
-	m_pShaderManager->setFloatValue("spotlight.constant", 1.0f);
-	m_pShaderManager->setFloatValue("spotlight.linear", 0.09f);
-	m_pShaderManager->setFloatValue("spotlight.quadratic", 0.032f);
-	m_pShaderManager->setFloatValue("spotlight.cutOff", glm::cos(glm::radians(42.5f)));
-	m_pShaderManager->setFloatValue("spotlight.outerCutoff", glm::cos(glm::radians(48.0f)));
-	m_pShaderManager->setBoolValue("spotlight.bActive", true);
-
-
-}
-
+﻿///////////////////////////////////////////////////////////////////////////////
+// SceneManager.cpp
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+// 
+// *** Modified by Connie Knupp on 10/06/2024   ***
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "SimdKernels.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// the shader manager takes the names as strings, so they are
+	// made once instead of for every uniform set in a frame
+	const std::string g_ModelName = "model";
+	const std::string g_ColorValueName = "objectColor";
+	const std::string g_TextureValueName = "objectTextures";
+	const std::string g_TextureLayerName = "textureLayer";
+	const std::string g_UseTextureName = "bUseTexture";
+	const std::string g_UseLightingName = "bUseLighting";
+	const std::string g_UseInstancingName = "bUseInstancing";
+	const std::string g_UVscaleName = "UVscale";
+
+	// directory holding the compressed copies of the scene textures
+	const char* g_TextureCacheDirectory = "../texture_cache";
+	// scene file loaded unless another one is chosen, and the
+	// directory holding the cooked copies of the scene files
+	const char* g_SceneFilename = "../scenes/halloween.scene";
+	const char* g_SceneCacheDirectory = "../scene_cache";
+	// compute shader that culls the objects of the GPU driven path
+	const char* g_CullShaderFilename = "../shaders/cullCompute.glsl";
+	const char* g_LightClusterShaderFilename = "../shaders/lightClusterCompute.glsl";
+	const char* g_ShadowMapName = "shadowMap";
+
+	// slope and constant depth offset of the shadow casters, and the
+	// bias the lighting shader subtracts as it compares the depth
+	const float g_ShadowSlopeOffset = 2.0f;
+	const float g_ShadowConstantOffset = 4.0f;
+	const float g_ShadowDepthBias = 0.0005f;
+
+	// projected radius, as a fraction of half the view height, below
+	// which each coarser level of detail is used
+	const float g_LodScreenSizes[ShapeGeometry::LOD_LEVELS - 1] = { 0.12f, 0.04f };
+	// fraction a size must pass a threshold by before the level changes,
+	// so an object sitting on a threshold does not switch every frame
+	const float g_LodHysteresis = 0.15f;
+
+	// draw records and object groups handled by each chunk of the
+	// loops run on the job system
+	const int g_RecordChunkSize = 512;
+	const int g_GroupChunkSize = 32;
+	// records whose spheres are tested in one call of the kernel
+	const int g_SphereTestBlock = 256;
+
+	// starting size of the frame arena, which grows to fit
+	const size_t g_FrameArenaBytes = 1 << 20;
+
+	/***********************************************************
+	 *  GetLodForSize()
+	 *
+	 *  Get the level of detail for a projected size with each
+	 *  threshold scaled by the passed in factor.
+	 ***********************************************************/
+	int GetLodForSize(float screenSize, float thresholdScale, int lodCount)
+	{
+		int lod = 0;
+		while ((lod < lodCount - 1) && (screenSize < g_LodScreenSizes[lod] * thresholdScale))
+		{
+			lod++;
+		}
+
+		return(lod);
+	}
+
+	/***********************************************************
+	 *  MakeInstanceData()
+	 *
+	 *  Fill the per-instance values for a draw record.
+	 ***********************************************************/
+	ShapeGeometry::INSTANCE_DATA MakeInstanceData(
+		const SceneObjects& objects,
+		const SceneManager::DRAW_RECORD& record,
+		int recordIndex)
+	{
+		ShapeGeometry::INSTANCE_DATA instance;
+		int materialIndex = objects.materialIndices[recordIndex];
+
+		instance.model = objects.models[recordIndex];
+		instance.materialIndex = (materialIndex >= 0) ? materialIndex : 0;
+		instance.textureLayer = (record.textureLayer >= 0) ? record.textureLayer : 0;
+		instance.UVscale = record.UVscale;
+
+		return(instance);
+	}
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(
+	ShaderManager* pShaderManager,
+	UniformBufferManager* pUniformBuffers)
+{
+	m_pShaderManager = pShaderManager;
+	m_pUniformBuffers = pUniformBuffers;
+	m_basicMeshes = new ShapeMeshes();
+	m_shapeGeometry = new ShapeGeometry();
+	m_textureArrays = new TextureArrayManager();
+	m_textureLoader = new TextureLoader();
+	m_loadedTextures = 0;
+	m_transformUpdates = 0;
+	m_sceneFilename = g_SceneFilename;
+	m_sceneFile = NULL;
+	m_bCheckTags = false;
+	m_bUseInstancing = true;
+	m_bUseCulling = true;
+	m_bUseLod = true;
+	m_staticGeometry = new StaticGeometry();
+	m_bUseStaticBatching = true;
+	m_bStaticDirty = false;
+	m_gpuRenderer = NULL;
+	m_bUseGpuDriven = false;
+	m_lightClusters = NULL;
+	m_bUseClusteredLighting = true;
+	m_shadowMaps = NULL;
+	m_bUseShadows = true;
+	m_shadowData = {};
+	m_frameArena = new FrameArena(g_FrameArenaBytes);
+	m_renderQueue = new RenderQueue(m_frameArena);
+	for (int view = 0; view < ViewManager::MAX_VIEWS; view++)
+	{
+		m_views[view].camera = {};
+		m_views[view].visible = NULL;
+		m_views[view].lodLevels = NULL;
+		m_views[view].renderQueue = new RenderQueue(m_frameArena);
+		m_views[view].depthQueue = new RenderQueue(m_frameArena);
+	}
+	m_frameViews.viewCount = 0;
+	m_viewCount = 1;
+	m_pView = &m_views[0];
+	for (int i = 0; i < 4; i++)
+	{
+		m_frameViewport[i] = 0;
+	}
+	m_jobSystem = NULL;
+	m_bUseParallelRecording = true;
+	m_pShaderCache = NULL;
+	for (int variant = 0; variant < TOTAL_PROGRAM_VARIANTS; variant++)
+	{
+		m_programVariants[variant] = -1;
+	}
+	m_bInstancingPass = false;
+	m_bUseDepthPrepass = false;
+	m_bDepthPass = false;
+	ResetRenderState();
+	m_renderStats.drawCalls = 0;
+	m_renderStats.triangles = 0;
+	m_renderStats.uniformUploads = 0;
+	m_renderStats.stateChanges = 0;
+	m_renderStats.stateChangesSkipped = 0;
+	m_renderStats.objectsCulled = 0;
+	m_pProfiler = NULL;
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	m_pShaderManager = NULL;
+	m_pUniformBuffers = NULL;
+	m_pProfiler = NULL;
+	m_pShaderCache = NULL;
+	delete m_basicMeshes;
+	m_basicMeshes = NULL;
+	delete m_shapeGeometry;
+	m_shapeGeometry = NULL;
+	delete m_staticGeometry;
+	m_staticGeometry = NULL;
+	if (NULL != m_gpuRenderer)
+	{
+		delete m_gpuRenderer;
+		m_gpuRenderer = NULL;
+	}
+	if (NULL != m_lightClusters)
+	{
+		delete m_lightClusters;
+		m_lightClusters = NULL;
+	}
+	if (NULL != m_shadowMaps)
+	{
+		delete m_shadowMaps;
+		m_shadowMaps = NULL;
+	}
+	delete m_renderQueue;
+	m_renderQueue = NULL;
+	for (int view = 0; view < ViewManager::MAX_VIEWS; view++)
+	{
+		delete m_views[view].renderQueue;
+		m_views[view].renderQueue = NULL;
+		delete m_views[view].depthQueue;
+		m_views[view].depthQueue = NULL;
+	}
+	m_pView = NULL;
+	delete m_frameArena;
+	m_frameArena = NULL;
+	if (NULL != m_jobSystem)
+	{
+		delete m_jobSystem;
+		m_jobSystem = NULL;
+	}
+	// the workers must finish before the arrays are freed
+	delete m_textureLoader;
+	m_textureLoader = NULL;
+	// the object arrays point into the scene file
+	m_objects.Clear();
+	if (NULL != m_sceneFile)
+	{
+		delete m_sceneFile;
+		m_sceneFile = NULL;
+	}
+	delete m_textureArrays;
+	m_textureArrays = NULL;
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for creating the texture arrays for
+ *  the reserved textures and binding them for the shader.
+ *  Textures of the same size share one array, so the number
+ *  of loaded textures is no longer limited by the texture
+ *  units.  The queued images then start decoding on worker
+ *  threads, and each is uploaded as it finishes.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	m_textureArrays->BuildArrays();
+
+	// connect the arrays to the sampler of the active program
+	GLint programID = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	m_textureArrays->BindProgram(programID, g_TextureValueName.c_str());
+
+	// compressed arrays are filled from the texture cache
+	m_textureLoader->SetTextureCache(g_TextureCacheDirectory, m_textureArrays->GetCompressedFormat());
+	m_textureLoader->Start();
+}
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method is used for reserving a texture for an image
+ *  file and queueing the file to be decoded.  Only the image
+ *  header is read here, which is enough to place the texture
+ *  in the array for its size.  Until it is uploaded, the
+ *  texture is drawn with a placeholder.
+ ***********************************************************/
+bool SceneManager::CreateGLTexture(const char* filename, const std::string& tag)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	// try to read the image size from the specified image file
+	if (stbi_info(filename, &width, &height, &colorChannels))
+	{
+		int texture = m_textureArrays->ReserveImage(width, height);
+		m_textureLoader->QueueImage(texture, filename);
+
+		// register the reserved texture and associate it with the special tag string
+		TEXTURE_INFO textureInfo;
+		textureInfo.ID = 0;
+		textureInfo.tag = tag;
+		m_textureIDs.push_back(textureInfo);
+		m_textureLookup[tag] = texture;
+		m_textureResolveCounts.push_back(0);
+		m_loadedTextures++;
+
+		return true;
+	}
+
+	std::cout << "Could not load image:" << filename << std::endl;
+
+	// Error loading the image
+	return false;
+}
+
+/***********************************************************
+ *  UploadLoadedTextures()
+ *
+ *  This method is used for uploading every texture image that
+ *  finished decoding since the last frame.  The draw records
+ *  are then pointed at the new layers.  With compressed arrays,
+ *  an image that was not in the texture cache is compressed
+ *  here and written to the cache for the next run.
+ ***********************************************************/
+void SceneManager::UploadLoadedTextures()
+{
+	bool bUploaded = false;
+	TextureLoader::DECODED_IMAGE image;
+
+	while (m_textureLoader->PopDecodedImage(image) == true)
+	{
+		if (image.levels.size() == 0)
+		{
+			std::cout << "Could not load image:" << image.filename << std::endl;
+			continue;
+		}
+
+		std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << image.colorChannels
+			<< (image.bCompressed ? ", from the texture cache" : "") << std::endl;
+
+		bool bImageUploaded = false;
+		if (0 == m_textureArrays->GetCompressedFormat())
+		{
+			bImageUploaded = m_textureArrays->UploadImage(image.texture, image.levels, image.width, image.height);
+		}
+		else
+		{
+			if (image.bCompressed == false)
+			{
+				TextureCache::MIP_LEVELS compressedLevels;
+				if (m_textureArrays->CompressImage(image.levels, image.width, image.height, compressedLevels) == true)
+				{
+					if (TextureCache::WriteCache(image.cachePath, m_textureArrays->GetCompressedFormat(), image.width, image.height, compressedLevels) == false)
+					{
+						std::cout << "Could not write texture cache:" << image.cachePath << std::endl;
+					}
+				}
+				else
+				{
+					std::cout << "Could not compress image:" << image.filename << std::endl;
+				}
+				image.levels.swap(compressedLevels);
+			}
+			bImageUploaded = m_textureArrays->UploadCompressedImage(image.texture, image.levels, image.width, image.height);
+		}
+
+		if (bImageUploaded == true)
+		{
+			m_textureIDs[image.texture].ID = m_textureArrays->GetArrayID(
+				m_textureArrays->GetTextureLayer(image.texture).arrayIndex);
+			bUploaded = true;
+		}
+
+		// free the image data from local memory
+		TextureLoader::FreeImage(image);
+	}
+
+	if (bUploaded == true)
+	{
+		RefreshTextureLayers();
+	}
+}
+
+/***********************************************************
+ *  RefreshTextureLayers()
+ *
+ *  This method is used for resolving the texture array and
+ *  layer of every draw record again after textures have been
+ *  uploaded, and regrouping the instanced batches to match.
+ ***********************************************************/
+void SceneManager::RefreshTextureLayers()
+{
+	for (int index = 0; index < m_drawRecords.size(); index++)
+	{
+		DRAW_RECORD& record = m_drawRecords[index];
+
+		if (record.textureSlot >= 0)
+		{
+			record.textureArray = m_textureArrays->GetTextureLayer(record.textureSlot).arrayIndex;
+			record.textureLayer = m_textureArrays->GetTextureLayer(record.textureSlot).layer;
+		}
+	}
+
+	BuildInstanceBatches();
+	// the baked vertices hold the texture layers as well
+	m_bStaticDirty = true;
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory in all the
+ *  used texture arrays.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	m_textureArrays->DestroyArrays();
+	m_textureIDs.clear();
+	m_textureLookup.clear();
+	m_textureResolveCounts.clear();
+	m_loadedTextures = 0;
+}
+
+/***********************************************************
+ *  FindTextureID()
+ *
+ *  This method is used for getting an ID for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureID(const std::string& tag)
+{
+	int textureID = -1;
+	int textureSlot = FindTextureSlot(tag);
+
+	if (textureSlot >= 0)
+	{
+		textureID = m_textureIDs[textureSlot].ID;
+	}
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag.  The
+ *  slot is the handle that the render path uses for the texture.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(const std::string& tag)
+{
+	int textureSlot = -1;
+
+	std::unordered_map<std::string, int>::const_iterator found = m_textureLookup.find(tag);
+	if (found != m_textureLookup.end())
+	{
+		textureSlot = found->second;
+		m_textureResolveCounts[textureSlot]++;
+	}
+	else
+	{
+		std::cout << "Could not find texture with tag:" << tag << std::endl;
+		m_missedTags.push_back(tag);
+	}
+
+	return(textureSlot);
+}
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method is used for getting a material from the previously
+ *  defined materials list that is associated with the passed in tag.
+ ***********************************************************/
+bool SceneManager::FindMaterial(const std::string& tag, OBJECT_MATERIAL& material)
+{
+	int materialIndex = FindMaterialIndex(tag);
+
+	if (materialIndex < 0)
+	{
+		return(false);
+	}
+
+	material = m_objectMaterials[materialIndex];
+
+	return(true);
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index of a material
+ *  in the previously defined materials list that is
+ *  associated with the passed in tag.  The index is the
+ *  handle that the render path uses for the material.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(const std::string& tag)
+{
+	int materialIndex = -1;
+
+	std::unordered_map<std::string, int>::const_iterator found = m_materialLookup.find(tag);
+	if (found != m_materialLookup.end())
+	{
+		materialIndex = found->second;
+		m_materialResolveCounts[materialIndex]++;
+	}
+	else
+	{
+		std::cout << "Could not find material with tag:" << tag << std::endl;
+		m_missedTags.push_back(tag);
+	}
+
+	return(materialIndex);
+}
+
+/***********************************************************
+ *  BuildMaterialLookup()
+ *
+ *  This method is used for indexing the defined materials by
+ *  tag so that they can be resolved to handles at load time.
+ ***********************************************************/
+void SceneManager::BuildMaterialLookup()
+{
+	m_materialLookup.clear();
+	m_materialResolveCounts.assign(m_objectMaterials.size(), 0);
+
+	for (int index = 0; index < m_objectMaterials.size(); index++)
+	{
+		m_materialLookup[m_objectMaterials[index].tag] = index;
+	}
+}
+
+/***********************************************************
+ *  EnableTagCheck()
+ *
+ *  This method is used for turning on the debug report of
+ *  tags that were never resolved after the scene is prepared.
+ ***********************************************************/
+void SceneManager::EnableTagCheck(bool bEnable)
+{
+	m_bCheckTags = bEnable;
+}
+
+/***********************************************************
+ *  ReportUnresolvedTags()
+ *
+ *  This method is used for reporting the loaded textures and
+ *  defined materials that no object ever resolved, along with
+ *  any requested tags that did not match anything.
+ ***********************************************************/
+void SceneManager::ReportUnresolvedTags()
+{
+	int totalUnresolved = 0;
+
+	std::cout << "\n*** TAG CHECK: ***\n";
+	for (int index = 0; index < m_loadedTextures; index++)
+	{
+		if (m_textureResolveCounts[index] == 0)
+		{
+			std::cout << "Texture never resolved:" << m_textureIDs[index].tag << std::endl;
+			totalUnresolved++;
+		}
+	}
+	for (int index = 0; index < m_objectMaterials.size(); index++)
+	{
+		if (m_materialResolveCounts[index] == 0)
+		{
+			std::cout << "Material never resolved:" << m_objectMaterials[index].tag << std::endl;
+			totalUnresolved++;
+		}
+	}
+	for (int index = 0; index < m_missedTags.size(); index++)
+	{
+		std::cout << "Tag requested but not found:" << m_missedTags[index] << std::endl;
+		totalUnresolved++;
+	}
+	std::cout << totalUnresolved << " unresolved tags\n" << std::endl;
+}
+
+void SceneManager::DefineObjectMaterials()
+{
+	OBJECT_MATERIAL metalMaterial;
+	metalMaterial.diffuseColor = glm::vec3(0.41f, 0.41f, 0.41f);
+	metalMaterial.specularColor = glm::vec3(0.502f, 0.502f, 0.502f);
+	metalMaterial.shininess = 22.0;
+	metalMaterial.tag = "metal";
+	m_objectMaterials.push_back(metalMaterial);
+
+	OBJECT_MATERIAL pumpkinMaterial;
+	pumpkinMaterial.diffuseColor = glm::vec3(1.0f, 0.65f, 0.0f);
+	pumpkinMaterial.specularColor = glm::vec3(1.0f, 0.85f, 0.0f);
+	pumpkinMaterial.shininess = 12.0;
+	pumpkinMaterial.tag = "pumpkin";
+	m_objectMaterials.push_back(pumpkinMaterial);
+
+
+	OBJECT_MATERIAL potionMaterial;
+	potionMaterial.diffuseColor = glm::vec3(0.0f, 0.89f, 0.0f);
+	potionMaterial.specularColor = glm::vec3(0.0f, 1.0f, 0.0f);
+	potionMaterial.shininess = 15.0;
+	potionMaterial.tag = "potion";
+	m_objectMaterials.push_back(potionMaterial);
+
+	OBJECT_MATERIAL strawMaterial;
+	strawMaterial.diffuseColor = glm::vec3(0.10f, 0.089f, 0.071f);
+	strawMaterial.specularColor = glm::vec3(0.10f, 0.089f, 0.0f);
+	strawMaterial.shininess = 2.0;
+	strawMaterial.tag = "straw";
+	m_objectMaterials.push_back(strawMaterial);
+
+	OBJECT_MATERIAL clothMaterial;
+	clothMaterial.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	clothMaterial.specularColor = glm::vec3(0.15f, 0.15f, 0.15f);
+	clothMaterial.shininess = 2.0;
+	clothMaterial.tag = "cloth";
+	m_objectMaterials.push_back(clothMaterial);
+
+	OBJECT_MATERIAL cementMaterial;
+	cementMaterial.diffuseColor = glm::vec3(0.5f, 0.5f, 0.5f);
+	cementMaterial.specularColor = glm::vec3(0.4f, 0.4f, 0.4f);
+	cementMaterial.shininess = 0.5;
+	cementMaterial.tag = "cement";
+	m_objectMaterials.push_back(cementMaterial);
+
+	OBJECT_MATERIAL woodMaterial;
+	woodMaterial.diffuseColor = glm::vec3(0.82f, 0.71f, 0.55f);
+	woodMaterial.specularColor = glm::vec3(0.96f, 0.87f, 0.70f);
+	woodMaterial.shininess = 0.3;
+	woodMaterial.tag = "wood";
+	m_objectMaterials.push_back(woodMaterial);
+
+	OBJECT_MATERIAL stemMaterial;
+	stemMaterial.diffuseColor = glm::vec3(0.55f, 0.27f, 0.075f);
+	stemMaterial.specularColor = glm::vec3(0.55f, 0.27f, 0.075f);
+	stemMaterial.shininess = 0.2;
+	stemMaterial.tag = "stem";
+	m_objectMaterials.push_back(stemMaterial);
+
+ }
+
+
+/***********************************************************
+ *  LoadSceneTextures()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering
+ ***********************************************************/
+void SceneManager::LoadSceneTextures()
+{
+	/*** Connie Knupp added the code BELOW for loading the textures that ***/
+	/*** will be used for mapping to objects in the 3D scene. Textures ***/
+	/*** of the same size share a texture array.  Code from OpenGLSample used ***/
+	/*** as a template.   ***/
+
+	bool bReturn = false;
+
+	bReturn = CreateGLTexture(
+		"../textures/bat_face.jpg",
+		"bat_face");
+
+	bReturn = CreateGLTexture(
+		"../textures/black_brim.jpg",
+		"black_brim");
+
+	bReturn = CreateGLTexture(
+		"../textures/treebark1.jpg",
+		"stem");
+
+	bReturn = CreateGLTexture(
+		"../textures/black_fur.jpg",
+		"black_fur");
+
+	bReturn = CreateGLTexture(
+		"../textures/cauldron3.jpg",
+		"cauldron");
+
+	bReturn = CreateGLTexture(
+		"../textures/pumpkin2.jpg",
+		"pumpkin");
+
+	bReturn = CreateGLTexture(
+		"../textures/straw1.jpg",
+		"straw_ends");
+
+	bReturn = CreateGLTexture(
+		"../textures/potion.jpg",
+		"potion");
+
+	bReturn = CreateGLTexture(
+		"../textures/pavers.jpg",
+		"pavers");
+
+	bReturn = CreateGLTexture(
+		"../textures/wood_planks.jpg",
+		"wood_planks");
+
+
+	// after the texture sizes are known, the texture arrays are
+	// created and bound - the images are decoded in the background
+	// and are drawn as they arrive
+	BindGLTextures();
+}
+
+
+/***********************************************************
+ *  ComposeModelMatrix()
+ *
+ *  This method is used for building a model matrix from the
+ *  passed in transformation values.  The X, Y and Z rotations
+ *  are composed directly into one rotation basis which is then
+ *  scaled and translated, which gives the same result as
+ *  translation * rotationX * rotationY * rotationZ * scale
+ *  without building and multiplying five full matrices.
+ ***********************************************************/
+glm::mat4 SceneManager::ComposeModelMatrix(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	// variables for this method
+	glm::mat4 modelView;
+
+	float cx = glm::cos(glm::radians(XrotationDegrees));
+	float sx = glm::sin(glm::radians(XrotationDegrees));
+	float cy = glm::cos(glm::radians(YrotationDegrees));
+	float sy = glm::sin(glm::radians(YrotationDegrees));
+	float cz = glm::cos(glm::radians(ZrotationDegrees));
+	float sz = glm::sin(glm::radians(ZrotationDegrees));
+
+	// each column is one rotated axis scaled by its scale value
+	modelView[0] = glm::vec4(
+		cy * cz,
+		cx * sz + sx * sy * cz,
+		sx * sz - cx * sy * cz,
+		0.0f) * scaleXYZ.x;
+	modelView[1] = glm::vec4(
+		-cy * sz,
+		cx * cz - sx * sy * sz,
+		sx * cz + cx * sy * sz,
+		0.0f) * scaleXYZ.y;
+	modelView[2] = glm::vec4(
+		sy,
+		-sx * cy,
+		cx * cy,
+		0.0f) * scaleXYZ.z;
+	// the last column holds the translation
+	modelView[3] = glm::vec4(positionXYZ, 1.0f);
+
+	return(modelView);
+}
+
+/***********************************************************
+ *  SetObjectTransform()
+ *
+ *  This method is used for changing the transformation values
+ *  of an object in the scene graph.  The model matrix is only
+ *  flagged for recalculation when a value actually changes.
+ ***********************************************************/
+void SceneManager::SetObjectTransform(
+	int recordIndex,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	if ((recordIndex < 0) || (recordIndex >= m_drawRecords.size()))
+	{
+		return;
+	}
+
+	glm::vec3 rotationDegrees(XrotationDegrees, YrotationDegrees, ZrotationDegrees);
+
+	if ((m_objects.scales[recordIndex] == scaleXYZ) &&
+		(m_objects.rotationsDegrees[recordIndex] == rotationDegrees) &&
+		(m_objects.positions[recordIndex] == positionXYZ))
+	{
+		return;
+	}
+
+	m_objects.scales[recordIndex] = scaleXYZ;
+	m_objects.rotationsDegrees[recordIndex] = rotationDegrees;
+	m_objects.positions[recordIndex] = positionXYZ;
+
+	// a moved object is drawn with the instances from now on, and
+	// the static geometry is baked again without it
+	if (m_drawRecords[recordIndex].bStatic == true)
+	{
+		m_drawRecords[recordIndex].bStatic = false;
+		m_bStaticDirty = true;
+	}
+
+	// only queue the object once no matter how many times it
+	// is changed before the next update
+	if (m_objects.transformDirty[recordIndex] == 0)
+	{
+		m_objects.transformDirty[recordIndex] = 1;
+		m_dirtyRecords.push_back(recordIndex);
+	}
+}
+
+/***********************************************************
+ *  UpdateTransforms()
+ *
+ *  This method is used for recalculating the model matrices
+ *  of the objects that were changed since the last update.
+ *  Objects that have not moved are never touched.  The
+ *  matrices and bounds are built on the job system, with the
+ *  matrices of each chunk built by the vectorized kernel, and
+ *  the buffer updates that need OpenGL follow on this thread.
+ *  The shadows are drawn again where a moved object was and
+ *  where it is now.
+ ***********************************************************/
+void SceneManager::UpdateTransforms()
+{
+	m_transformUpdates = (int)m_dirtyRecords.size();
+
+	if (NULL != m_shadowMaps)
+	{
+		for (size_t index = 0; index < m_dirtyRecords.size(); index++)
+		{
+			m_shadowMaps->InvalidateBounds(m_objects.bounds[m_dirtyRecords[index]]);
+		}
+	}
+
+	JobSystem::Run(m_jobSystem, (int)m_dirtyRecords.size(), g_RecordChunkSize, [this](int begin, int end, int worker)
+	{
+		SimdKernels::ComposeModelMatrices(
+			&m_objects.scales[0],
+			&m_objects.rotationsDegrees[0],
+			&m_objects.positions[0],
+			&m_dirtyRecords[begin],
+			end - begin,
+			&m_objects.models[0]);
+
+		for (int index = begin; index < end; index++)
+		{
+			int object = m_dirtyRecords[index];
+			m_objects.transformDirty[object] = 0;
+
+			// the bounds follow the model matrix
+			m_objects.bounds[object] = ViewFrustum::TransformBounds(
+				m_shapeGeometry->GetMeshBounds(m_objects.meshes[object]),
+				m_objects.models[object]);
+		}
+	});
+
+	for (size_t index = 0; index < m_dirtyRecords.size(); index++)
+	{
+		// the group around the record is rebuilt once all have moved
+		DRAW_RECORD& record = m_drawRecords[m_dirtyRecords[index]];
+		int group = m_objects.groups[m_dirtyRecords[index]];
+		if (group >= 0)
+		{
+			m_objectGroups[group].bDirty = true;
+		}
+
+		UpdateInstance(m_dirtyRecords[index]);
+
+		if (NULL != m_shadowMaps)
+		{
+			m_shadowMaps->InvalidateBounds(m_objects.bounds[m_dirtyRecords[index]]);
+		}
+
+		if ((NULL != m_gpuRenderer) && (record.gpuObject >= 0))
+		{
+			const BOUNDING_VOLUME& bounds = m_objects.bounds[m_dirtyRecords[index]];
+			GpuDrivenRenderer::OBJECT_DATA& object = m_gpuObjects[record.gpuObject];
+			object.centerRadius = glm::vec4(bounds.center, bounds.radius);
+			object.extents = glm::vec4(bounds.extents, 0.0f);
+			m_gpuRenderer->UpdateObject(record.gpuObject, object);
+		}
+	}
+
+	for (int group = 0; group < m_objectGroups.size(); group++)
+	{
+		if (m_objectGroups[group].bDirty == true)
+		{
+			UpdateGroupBounds(group);
+		}
+	}
+
+	m_dirtyRecords.clear();
+}
+
+/***********************************************************
+ *  BeginObjectGroup()
+ *
+ *  This method is used for starting a group of draw records.
+ *  Every record added until EndObjectGroup() is called is
+ *  culled together with the others of the group, and gets
+ *  the group name as its debug name.
+ ***********************************************************/
+void SceneManager::BeginObjectGroup(const char* name)
+{
+	OBJECT_GROUP group;
+
+	group.firstRecord = (int)m_drawRecords.size();
+	group.recordCount = 0;
+	group.bounds = ViewFrustum::MakeBounds(glm::vec3(0.0f), glm::vec3(0.0f));
+	group.bDirty = false;
+
+	m_objectGroups.push_back(group);
+	m_groupNames.push_back(name);
+}
+
+/***********************************************************
+ *  EndObjectGroup()
+ *
+ *  This method is used for ending the current group of draw
+ *  records and building the bounds around them.
+ ***********************************************************/
+void SceneManager::EndObjectGroup()
+{
+	if (m_objectGroups.size() == 0)
+	{
+		return;
+	}
+
+	int group = (int)m_objectGroups.size() - 1;
+	OBJECT_GROUP& objectGroup = m_objectGroups[group];
+	objectGroup.recordCount = (int)m_drawRecords.size() - objectGroup.firstRecord;
+	for (int index = objectGroup.firstRecord; index < m_drawRecords.size(); index++)
+	{
+		m_objects.groups[index] = group;
+		m_objects.names[index] = m_groupNames[group];
+	}
+
+	UpdateGroupBounds(group);
+}
+
+/***********************************************************
+ *  UpdateGroupBounds()
+ *
+ *  This method is used for rebuilding the bounds of a group
+ *  so that they hold the bounds of every one of its records.
+ ***********************************************************/
+void SceneManager::UpdateGroupBounds(int group)
+{
+	OBJECT_GROUP& objectGroup = m_objectGroups[group];
+
+	objectGroup.bDirty = false;
+	if (objectGroup.recordCount <= 0)
+	{
+		return;
+	}
+
+	objectGroup.bounds = m_objects.bounds[objectGroup.firstRecord];
+	for (int index = 1; index < objectGroup.recordCount; index++)
+	{
+		objectGroup.bounds = ViewFrustum::MergeBounds(
+			objectGroup.bounds,
+			m_objects.bounds[objectGroup.firstRecord + index]);
+	}
+}
+
+/***********************************************************
+ *  CullDrawRecords()
+ *
+ *  This method is used for flagging the draw records whose
+ *  bounds are inside the camera view.  Each group is tested
+ *  first - a group fully outside or fully inside the view
+ *  settles all of its records without testing them, and the
+ *  records of a group crossing the view have their spheres
+ *  tested by the vectorized kernel, so only the ones whose
+ *  sphere crosses a plane test their box.  The records and
+ *  groups are split across the job system, and each worker
+ *  counts the records it culled on its own.  Every view is
+ *  tested in the same pass, so the bounds of a record or a
+ *  group are read once however many views there are.
+ ***********************************************************/
+void SceneManager::CullDrawRecords()
+{
+	m_renderStats.objectsCulled = 0;
+
+	if ((m_bUseCulling == false) || (NULL == m_pUniformBuffers))
+	{
+		for (int view = 0; view < m_viewCount; view++)
+		{
+			std::fill(m_views[view].visible, m_views[view].visible + m_drawRecords.size(), (uint8_t)1);
+		}
+		return;
+	}
+
+	int workerCount = JobSystem::GetWorkerCount(m_jobSystem);
+	int* workerCulled = m_frameArena->AllocateArray<int>(workerCount);
+	std::fill(workerCulled, workerCulled + workerCount, 0);
+
+	JobSystem::Run(m_jobSystem, (int)m_drawRecords.size(), g_RecordChunkSize, [this, workerCulled](int begin, int end, int worker)
+	{
+		int culled = 0;
+		for (int index = begin; index < end; index++)
+		{
+			if (m_objects.groups[index] < 0)
+			{
+				const BOUNDING_VOLUME& bounds = m_objects.bounds[index];
+				for (int view = 0; view < m_viewCount; view++)
+				{
+					bool bVisible = (m_views[view].frustum.TestBounds(bounds) != ViewFrustum::OUTSIDE);
+					m_views[view].visible[index] = bVisible ? 1 : 0;
+					culled += (bVisible == false) ? 1 : 0;
+				}
+			}
+		}
+		workerCulled[worker] += culled;
+	});
+
+	JobSystem::Run(m_jobSystem, (int)m_objectGroups.size(), g_GroupChunkSize, [this, workerCulled](int begin, int end, int worker)
+	{
+		int culled = 0;
+		for (int group = begin; group < end; group++)
+		{
+			const OBJECT_GROUP& objectGroup = m_objectGroups[group];
+			int groupEnd = objectGroup.firstRecord + objectGroup.recordCount;
+
+			for (int view = 0; view < m_viewCount; view++)
+			{
+				VIEW_STATE& viewState = m_views[view];
+				ViewFrustum::TEST_RESULT groupResult = viewState.frustum.TestBounds(objectGroup.bounds);
+
+				if (ViewFrustum::INTERSECTS != groupResult)
+				{
+					uint8_t visible = (ViewFrustum::INSIDE == groupResult) ? 1 : 0;
+					std::fill(viewState.visible + objectGroup.firstRecord, viewState.visible + groupEnd, visible);
+					culled += (visible == 0) ? objectGroup.recordCount : 0;
+					continue;
+				}
+
+				for (int blockStart = objectGroup.firstRecord; blockStart < groupEnd; blockStart += g_SphereTestBlock)
+				{
+					uint8_t results[g_SphereTestBlock];
+					int blockCount = std::min(g_SphereTestBlock, groupEnd - blockStart);
+					SimdKernels::TestSpheres(&m_objects.bounds[blockStart], blockCount, viewState.planes, results);
+
+					for (int index = 0; index < blockCount; index++)
+					{
+						bool bVisible = (SimdKernels::SPHERE_INSIDE == results[index]);
+						if (SimdKernels::SPHERE_CROSSING == results[index])
+						{
+							bVisible = (viewState.frustum.TestBounds(m_objects.bounds[blockStart + index]) != ViewFrustum::OUTSIDE);
+						}
+						viewState.visible[blockStart + index] = bVisible ? 1 : 0;
+						culled += (bVisible == false) ? 1 : 0;
+					}
+				}
+			}
+		}
+		workerCulled[worker] += culled;
+	});
+
+	for (int worker = 0; worker < workerCount; worker++)
+	{
+		m_renderStats.objectsCulled += workerCulled[worker];
+	}
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	// variables for this method
+	glm::mat4 modelView;
+
+	modelView = ComposeModelMatrix(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	if (NULL != m_pShaderManager)
+	{
+		m_pShaderManager->setMat4Value(g_ModelName, modelView);
+	}
+}
+
+/***********************************************************
+ *  SetShaderColor()
+ *
+ *  This method is used for setting the passed in color
+ *  into the shader for the next draw command
+ ***********************************************************/
+void SceneManager::SetShaderColor(
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	// variables for this method
+	glm::vec4 currentColor;
+
+	currentColor.r = redColorValue;
+	currentColor.g = greenColorValue;
+	currentColor.b = blueColorValue;
+	currentColor.a = alphaValue;
+
+	if (NULL != m_pShaderManager)
+	{
+		SelectProgramVariant(UNTEXTURED_VARIANT);
+		m_pShaderManager->setIntValue(g_UseTextureName, false);
+		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
+		m_currentTextureArray = -1;
+		m_renderStats.uniformUploads += 2;
+	}
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in ID into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	const std::string& textureTag)
+{
+	SetShaderTexture(FindTextureSlot(textureTag));
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture array and
+ *  layer for an already resolved texture slot into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	int textureSlot)
+{
+	// a texture slot below zero means no texture
+	if ((textureSlot < 0) || (textureSlot >= m_loadedTextures))
+	{
+		SetShaderTextureArray(-1);
+		return;
+	}
+
+	const TextureArrayManager::TEXTURE_LAYER& textureLayer =
+		m_textureArrays->GetTextureLayer(textureSlot);
+
+	SetShaderTextureArray(textureLayer.arrayIndex);
+	SetTextureLayer(textureLayer.layer);
+}
+
+/***********************************************************
+ *  SetShaderTextureArray()
+ *
+ *  This method is used for setting the texture array that the
+ *  next draw samples from into the shader.  An array index
+ *  below zero turns texturing off.
+ ***********************************************************/
+void SceneManager::SetShaderTextureArray(
+	int textureArray)
+{
+	// the depth pre-pass samples no textures
+	if (m_bDepthPass == true)
+	{
+		SelectProgramVariant(DEPTH_ONLY_VARIANT);
+		return;
+	}
+
+	if (textureArray < 0)
+	{
+		textureArray = -1;
+	}
+
+	// skip the change when the array is already set
+	if (textureArray == m_currentTextureArray)
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
+	}
+
+	if (NULL != m_pShaderManager)
+	{
+		// textured and untextured draws use their own variants
+		SelectProgramVariant((textureArray >= 0) ? TEXTURED_VARIANT : UNTEXTURED_VARIANT);
+		m_currentTextureArray = textureArray;
+		m_renderStats.stateChanges++;
+
+		if (textureArray >= 0)
+		{
+			m_pShaderManager->setIntValue(g_UseTextureName, true);
+			m_textureArrays->SetShaderArray(textureArray);
+			m_renderStats.uniformUploads += 2;
+		}
+		else
+		{
+			m_pShaderManager->setIntValue(g_UseTextureName, false);
+			m_renderStats.uniformUploads++;
+		}
+	}
+}
+
+/***********************************************************
+ *  SetTextureLayer()
+ *
+ *  This method is used for setting the layer of the texture
+ *  array that the next draw samples from into the shader.
+ ***********************************************************/
+void SceneManager::SetTextureLayer(
+	int textureLayer)
+{
+	if (m_bDepthPass == true)
+	{
+		return;
+	}
+
+	// skip the change when the layer is already set
+	if (textureLayer == m_currentTextureLayer)
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
+	}
+
+	if (NULL != m_pShaderManager)
+	{
+		m_pShaderManager->setIntValue(g_TextureLayerName, textureLayer);
+		m_currentTextureLayer = textureLayer;
+		m_renderStats.stateChanges++;
+		m_renderStats.uniformUploads++;
+	}
+}
+
+/***********************************************************
+ *  SetTextureUVScale()
+ *
+ *  This method is used for setting the texture UV scale
+ *  values into the shader.
+ ***********************************************************/
+void SceneManager::SetTextureUVScale(float u, float v)
+{
+	glm::vec2 UVscale(u, v);
+
+	if (m_bDepthPass == true)
+	{
+		return;
+	}
+
+	// skip the change when the scale is already set
+	if (UVscale == m_currentUVscale)
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
+	}
+
+	if (NULL != m_pShaderManager)
+	{
+		m_pShaderManager->setVec2Value(g_UVscaleName, UVscale);
+		m_currentUVscale = UVscale;
+		m_renderStats.stateChanges++;
+		m_renderStats.uniformUploads++;
+	}
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for passing the material values
+ *  into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	const std::string& materialTag)
+{
+	SetShaderMaterial(FindMaterialIndex(materialTag));
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for selecting an already resolved
+ *  material index in the shader.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	int materialIndex)
+{
+	if ((NULL == m_pUniformBuffers) ||
+		(m_bDepthPass == true) ||
+		(materialIndex < 0) ||
+		(materialIndex >= m_objectMaterials.size()))
+	{
+		return;
+	}
+
+	// skip the change when the material is already selected
+	if (materialIndex == m_currentMaterialIndex)
+	{
+		m_renderStats.stateChangesSkipped++;
+		return;
+	}
+
+	m_pUniformBuffers->SetMaterialIndex(materialIndex);
+	m_currentMaterialIndex = materialIndex;
+	m_renderStats.stateChanges++;
+	m_renderStats.uniformUploads++;
+}
+
+/***********************************************************
+ *  UploadObjectMaterials()
+ *
+ *  This method is used for writing all of the defined materials
+ *  into the materials uniform block.  A draw then only needs to
+ *  select its material by index.  The staged block comes from
+ *  the frame arena.
+ ***********************************************************/
+void SceneManager::UploadObjectMaterials()
+{
+	if (NULL == m_pUniformBuffers)
+	{
+		return;
+	}
+
+	int count = (int)m_objectMaterials.size();
+	UniformBufferManager::MATERIAL_DATA* materials =
+		m_frameArena->AllocateArray<UniformBufferManager::MATERIAL_DATA>(count);
+	for (int index = 0; index < count; index++)
+	{
+		materials[index].diffuseColor = m_objectMaterials[index].diffuseColor;
+		materials[index].padding0 = 0.0f;
+		materials[index].specularColor = m_objectMaterials[index].specularColor;
+		materials[index].shininess = m_objectMaterials[index].shininess;
+	}
+
+	if (count > 0)
+	{
+		m_pUniformBuffers->UpdateMaterials(materials, count);
+	}
+}
+
+/***********************************************************
+ *  SelectLodLevels()
+ *
+ *  This method is used for picking the level of detail of
+ *  each visible draw record from the radius of its bounds
+ *  projected onto the screen.  A record only moves to a new
+ *  level once its size is past the threshold by the margin
+ *  of the hysteresis, which keeps it from popping back and
+ *  forth while the camera sits near a threshold.
+ ***********************************************************/
+void SceneManager::SelectLodLevels()
+{
+	if ((m_bUseLod == false) || (NULL == m_pUniformBuffers))
+	{
+		for (int view = 0; view < m_viewCount; view++)
+		{
+			std::fill(m_views[view].lodLevels, m_views[view].lodLevels + m_drawRecords.size(), 0);
+		}
+		return;
+	}
+
+	JobSystem::Run(m_jobSystem, (int)m_drawRecords.size(), g_RecordChunkSize, [this](int begin, int end, int worker)
+	{
+		for (int index = begin; index < end; index++)
+		{
+			int lodCount = m_shapeGeometry->GetLodCount(m_objects.meshes[index]);
+			if (lodCount <= 1)
+			{
+				continue;
+			}
+
+			const BOUNDING_VOLUME& bounds = m_objects.bounds[index];
+			for (int view = 0; view < m_viewCount; view++)
+			{
+				VIEW_STATE& viewState = m_views[view];
+				if (viewState.visible[index] == 0)
+				{
+					continue;
+				}
+
+				// a perspective projection has -1 here and divides by distance
+				const UniformBufferManager::CAMERA_DATA& camera = viewState.camera;
+				float screenSize = bounds.radius * camera.projection[1][1];
+				if (camera.projection[2][3] != 0.0f)
+				{
+					float distance = glm::length(bounds.center - camera.viewPosition);
+					screenSize /= std::max(distance, 0.001f);
+				}
+
+				// the level is kept while it is between the finest level the
+				// lowered thresholds give and the coarsest the raised ones give
+				int coarsestLod = GetLodForSize(screenSize, 1.0f + g_LodHysteresis, lodCount);
+				int finestLod = GetLodForSize(screenSize, 1.0f - g_LodHysteresis, lodCount);
+				viewState.lodLevels[index] = glm::clamp(viewState.lodLevels[index], finestLod, coarsestLod);
+			}
+		}
+	});
+}
+
+/***********************************************************
+ *  MakeDrawRecord()
+ *
+ *  This method is used for building the draw record of an
+ *  object that was just added, with its texture layer looked
+ *  up from the texture slot.
+ ***********************************************************/
+SceneManager::DRAW_RECORD SceneManager::MakeDrawRecord(int textureSlot, glm::vec2 UVscale)
+{
+	DRAW_RECORD record;
+
+	record.textureSlot = textureSlot;
+	record.textureArray = -1;
+	record.textureLayer = -1;
+	if (record.textureSlot >= 0)
+	{
+		record.textureArray = m_textureArrays->GetTextureLayer(record.textureSlot).arrayIndex;
+		record.textureLayer = m_textureArrays->GetTextureLayer(record.textureSlot).layer;
+	}
+	record.UVscale = UVscale;
+	record.instanceIndex = -1;
+	record.bStatic = true;
+	record.bBaked = false;
+	for (int lod = 0; lod < ShapeGeometry::LOD_LEVELS; lod++)
+	{
+		record.staticRanges[lod].firstIndex = 0;
+		record.staticRanges[lod].indexCount = 0;
+	}
+	record.gpuObject = -1;
+
+	return(record);
+}
+
+/***********************************************************
+ *  AddDrawRecord()
+ *
+ *  This method is used for adding a mesh to the retained
+ *  scene graph.  The model matrix, texture slot and material
+ *  index are resolved here one time so that RenderScene()
+ *  does not need to rebuild them every frame.
+ ***********************************************************/
+void SceneManager::AddDrawRecord(
+	MESH_TYPE mesh,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ,
+	const std::string& textureTag,
+	const std::string& materialTag,
+	glm::vec2 UVscale)
+{
+	glm::mat4 model = ComposeModelMatrix(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	m_objects.Add(
+		mesh,
+		scaleXYZ,
+		glm::vec3(XrotationDegrees, YrotationDegrees, ZrotationDegrees),
+		positionXYZ,
+		model,
+		ViewFrustum::TransformBounds(m_shapeGeometry->GetMeshBounds(mesh), model),
+		FindMaterialIndex(materialTag));
+
+	DRAW_RECORD record = MakeDrawRecord(FindTextureSlot(textureTag), UVscale);
+
+	m_drawRecords.push_back(record);
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing the basic shape mesh
+ *  that is referenced by a draw record.
+ ***********************************************************/
+void SceneManager::DrawMesh(MESH_TYPE mesh)
+{
+	switch (mesh)
+	{
+	case MESH_BOX:
+		m_basicMeshes->DrawBoxMesh();
+		break;
+	case MESH_CONE:
+		m_basicMeshes->DrawConeMesh();
+		break;
+	case MESH_CYLINDER:
+		m_basicMeshes->DrawCylinderMesh();
+		break;
+	case MESH_HALF_SPHERE:
+		m_basicMeshes->DrawHalfSphereMesh();
+		break;
+	case MESH_PLANE:
+		m_basicMeshes->DrawPlaneMesh();
+		break;
+	case MESH_PRISM:
+		m_basicMeshes->DrawPrismMesh();
+		break;
+	case MESH_SPHERE:
+		m_basicMeshes->DrawSphereMesh();
+		break;
+	case MESH_TAPERED_CYLINDER:
+		m_basicMeshes->DrawTaperedCylinderMesh();
+		break;
+	case MESH_TORUS:
+		m_basicMeshes->DrawTorusMesh();
+		break;
+	default:
+		break;
+	}
+}
+
+/***********************************************************
+ *  BuildInstanceBatches()
+ *
+ *  This method is used for grouping the draw records that use
+ *  the same mesh and texture array into batches.  Each
+ *  batch gets a contiguous range of the instance buffer so it
+ *  can be drawn with one instanced draw call.
+ ***********************************************************/
+void SceneManager::BuildInstanceBatches()
+{
+	std::vector<int> order(m_drawRecords.size());
+	for (int index = 0; index < order.size(); index++)
+	{
+		order[index] = index;
+	}
+
+	// order the records so that batch members are next to each other
+	const std::vector<DRAW_RECORD>& records = m_drawRecords;
+	const SceneArray<MESH_TYPE>& meshes = m_objects.meshes;
+	std::stable_sort(order.begin(), order.end(), [&records, &meshes](int a, int b)
+	{
+		if (meshes[a] != meshes[b])
+			return(meshes[a] < meshes[b]);
+		return(records[a].textureArray < records[b].textureArray);
+	});
+
+	m_instanceBatches.clear();
+	m_instanceRecords = order;
+	for (int position = 0; position < order.size(); position++)
+	{
+		DRAW_RECORD& record = m_drawRecords[order[position]];
+		MESH_TYPE mesh = m_objects.meshes[order[position]];
+		record.instanceIndex = position;
+
+		// start a new batch when the mesh or texture array changes
+		if ((m_instanceBatches.size() == 0) ||
+			(m_instanceBatches.back().mesh != mesh) ||
+			(m_instanceBatches.back().textureArray != record.textureArray))
+		{
+			INSTANCE_BATCH batch;
+			batch.mesh = mesh;
+			batch.textureArray = record.textureArray;
+			batch.firstInstance = position;
+			batch.instanceCount = 0;
+			m_instanceBatches.push_back(batch);
+		}
+		m_instanceBatches.back().instanceCount++;
+	}
+
+	// write the values of every instance into the instance buffer
+	std::vector<ShapeGeometry::INSTANCE_DATA> instances(m_drawRecords.size());
+	for (int index = 0; index < m_drawRecords.size(); index++)
+	{
+		instances[m_drawRecords[index].instanceIndex] = MakeInstanceData(m_objects, m_drawRecords[index], index);
+	}
+	if (instances.size() > 0)
+	{
+		m_shapeGeometry->ResizeInstanceBuffer((int)instances.size());
+		m_shapeGeometry->UpdateInstances(&instances[0], 0, (int)instances.size());
+	}
+
+	// the GPU driven path reads the instances by their new positions
+	if (NULL != m_gpuRenderer)
+	{
+		BuildGpuObjects();
+	}
+}
+
+/***********************************************************
+ *  UpdateInstance()
+ *
+ *  This method is used for writing the model matrix and
+ *  material index of a draw record into the instance buffer.
+ ***********************************************************/
+void SceneManager::UpdateInstance(int recordIndex)
+{
+	const DRAW_RECORD& record = m_drawRecords[recordIndex];
+
+	if (record.instanceIndex < 0)
+	{
+		return;
+	}
+
+	ShapeGeometry::INSTANCE_DATA instance = MakeInstanceData(m_objects, record, recordIndex);
+	m_shapeGeometry->UpdateInstances(&instance, record.instanceIndex, 1);
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+
+/***********************************************************
+ *  SetSceneFile()
+ *
+ *  This method is used for choosing the scene file that is
+ *  loaded by PrepareScene().
+ ***********************************************************/
+void SceneManager::SetSceneFile(const char* filename)
+{
+	m_sceneFilename = filename;
+}
+
+/***********************************************************
+ *  OpenSceneFile()
+ *
+ *  This method is used for opening the scene file, which is
+ *  mapped from its cooked copy when that is up to date.  The
+ *  scene built in code is used when the file cannot be read.
+ ***********************************************************/
+bool SceneManager::OpenSceneFile()
+{
+	if (NULL != m_sceneFile)
+	{
+		m_objects.Clear();
+		delete m_sceneFile;
+		m_sceneFile = NULL;
+	}
+	if (m_sceneFilename.empty() == true)
+	{
+		return(false);
+	}
+
+	m_sceneFile = new SceneFile();
+	if (m_sceneFile->Open(m_sceneFilename, g_SceneCacheDirectory, m_shapeGeometry) == false)
+	{
+		std::cout << "Using the scene built in code in place of:" << m_sceneFilename << std::endl;
+		delete m_sceneFile;
+		m_sceneFile = NULL;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  LoadSceneFileTextures()
+ *
+ *  This method is used for loading the textures listed in
+ *  the scene file, in the same way as LoadSceneTextures().
+ ***********************************************************/
+void SceneManager::LoadSceneFileTextures()
+{
+	for (int index = 0; index < m_sceneFile->GetTextureCount(); index++)
+	{
+		const SceneFile::TEXTURE_ENTRY& texture = m_sceneFile->GetTexture(index);
+		CreateGLTexture(texture.filename, texture.tag);
+	}
+
+	BindGLTextures();
+}
+
+/***********************************************************
+ *  DefineSceneFileMaterials()
+ *
+ *  This method is used for defining the materials listed in
+ *  the scene file.  They are kept in the order of the file,
+ *  so the material indices cooked into it stay valid.
+ ***********************************************************/
+void SceneManager::DefineSceneFileMaterials()
+{
+	for (int index = 0; index < m_sceneFile->GetMaterialCount(); index++)
+	{
+		const SceneFile::MATERIAL_ENTRY& entry = m_sceneFile->GetMaterial(index);
+
+		OBJECT_MATERIAL material = {};
+		material.diffuseColor = entry.diffuseColor;
+		material.specularColor = entry.specularColor;
+		material.shininess = entry.shininess;
+		material.tag = entry.tag;
+		m_objectMaterials.push_back(material);
+	}
+}
+
+/***********************************************************
+ *  AddSceneFileObjects()
+ *
+ *  This method is used for using the objects of the scene
+ *  file as the scene graph.  The object arrays point straight
+ *  into the cooked file, with the model matrices and bounds
+ *  already built, so only the draw records, whose texture
+ *  layers are known once the textures are reserved, are made
+ *  here.
+ ***********************************************************/
+void SceneManager::AddSceneFileObjects()
+{
+	const SceneFile::OBJECT_ARRAYS& arrays = m_sceneFile->GetObjectArrays();
+	int objectCount = m_sceneFile->GetObjectCount();
+
+	std::vector<int> textureSlots(m_sceneFile->GetTextureCount());
+	for (int index = 0; index < textureSlots.size(); index++)
+	{
+		textureSlots[index] = FindTextureSlot(m_sceneFile->GetTexture(index).tag);
+	}
+
+	m_objects.Attach(arrays, objectCount);
+	m_drawRecords.reserve(objectCount);
+	for (int index = 0; index < objectCount; index++)
+	{
+		int texture = arrays.textureIndices[index];
+		m_drawRecords.push_back(MakeDrawRecord(
+			(texture >= 0) ? textureSlots[texture] : -1,
+			arrays.UVscales[index]));
+	}
+
+	for (int index = 0; index < m_sceneFile->GetGroupCount(); index++)
+	{
+		const SceneFile::GROUP_ENTRY& entry = m_sceneFile->GetGroup(index);
+
+		OBJECT_GROUP group;
+		group.firstRecord = entry.firstObject;
+		group.recordCount = entry.objectCount;
+		group.bounds = entry.bounds;
+		group.bDirty = false;
+		m_objectGroups.push_back(group);
+		m_groupNames.push_back(entry.name);
+	}
+}
+
+/***********************************************************
+ *  BuildSceneInCode()
+ *
+ *  This method is used for building the scene from the
+ *  Define methods when there is no scene file to load.
+ ***********************************************************/
+void SceneManager::BuildSceneInCode()
+{
+	BeginObjectGroup("background");
+	DefineBackground();
+	EndObjectGroup();
+	BeginObjectGroup("cauldron");
+	DefineCauldron();
+	EndObjectGroup();
+	BeginObjectGroup("straw bale");
+	DefineStrawBale();
+	EndObjectGroup();
+	BeginObjectGroup("first pumpkin");
+	DefineFirstPumpkin();
+	EndObjectGroup();
+	BeginObjectGroup("second pumpkin");
+	DefineSecondPumpkin();
+	EndObjectGroup();
+	BeginObjectGroup("witch hat");
+	DefineWitchHat();
+	EndObjectGroup();
+	BeginObjectGroup("bat");
+	DefineBat();
+	EndObjectGroup();
+}
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering
+ ***********************************************************/
+void SceneManager::PrepareScene()
+{
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene - the meshes are loaded first,
+	// since the bounds of a cooked scene file are built from them
+	m_basicMeshes->LoadPlaneMesh();
+	m_basicMeshes->LoadBoxMesh();
+	m_basicMeshes->LoadCylinderMesh();
+	m_basicMeshes->LoadConeMesh();
+	m_basicMeshes->LoadPrismMesh();
+	m_basicMeshes->LoadSphereMesh();
+	m_basicMeshes->LoadTaperedCylinderMesh();
+	m_basicMeshes->LoadTorusMesh();
+
+	// the generated copies of the shapes support instanced drawing
+	m_shapeGeometry->LoadMeshes();
+
+	// the scene is loaded from its scene file, and only built by
+	// the code below when the file cannot be opened
+	bool bSceneFile = OpenSceneFile();
+
+	// load the texture image files for the textures applied
+	// to objects in the 3D scene
+	if (bSceneFile == true)
+	{
+		LoadSceneFileTextures();
+	}
+	else
+	{
+		LoadSceneTextures();
+	}
+
+	// define the materials that will be used for the objects
+	// in the 3D scene
+	if (bSceneFile == true)
+	{
+		DefineSceneFileMaterials();
+	}
+	else
+	{
+		DefineObjectMaterials();
+	}
+	BuildMaterialLookup();
+	UploadObjectMaterials();
+
+	// add and defile the light sources for the 3D scene
+	SetupSceneLights();
+
+	// build the retained scene graph of draw records one time
+	// so that nothing needs to be recalculated while rendering -
+	// each prop is its own group so it can be culled in one test
+	m_drawRecords.clear();
+	m_objects.Clear();
+	m_objectGroups.clear();
+	m_groupNames.clear();
+	if (bSceneFile == true)
+	{
+		AddSceneFileObjects();
+	}
+	else
+	{
+		BuildSceneInCode();
+	}
+
+	// the GPU driven path draws every object itself, so nothing is baked
+	if (m_bUseGpuDriven == true)
+	{
+		m_gpuRenderer = new GpuDrivenRenderer();
+		if (m_gpuRenderer->Initialize(g_CullShaderFilename, m_shapeGeometry) == true)
+		{
+			m_bUseStaticBatching = false;
+		}
+		else
+		{
+			delete m_gpuRenderer;
+			m_gpuRenderer = NULL;
+		}
+	}
+
+	// the per-record loops of each frame are split across workers
+	if ((m_bUseParallelRecording == true) && (NULL == m_jobSystem))
+	{
+		m_jobSystem = new JobSystem(0);
+	}
+
+	// group records with the same mesh and texture for instancing
+	BuildInstanceBatches();
+	// bake the objects that never move into the merged buffers
+	BuildStaticBatches();
+
+	// optionally report any tags that were never resolved
+	if (m_bCheckTags == true)
+	{
+		ReportUnresolvedTags();
+	}
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by walking
+ *  the draw records that were built in PrepareScene()
+ ***********************************************************/
+
+void SceneManager::RenderScene()
+{
+	if (NULL == m_pShaderManager)
+	{
+		return;
+	}
+
+	// start the counts for this frame
+	m_renderStats.drawCalls = 0;
+	m_renderStats.triangles = 0;
+	m_renderStats.uniformUploads = 0;
+	m_renderStats.stateChanges = 0;
+	m_renderStats.stateChangesSkipped = 0;
+	m_renderStats.objectsCulled = 0;
+	ResetRenderState();
+
+	// upload any textures that finished decoding
+	{
+		FrameProfiler::ScopedTimer timer(m_pProfiler, "Textures");
+		UploadLoadedTextures();
+	}
+
+	// recalculate the model matrices of any objects that moved
+	{
+		FrameProfiler::ScopedTimer timer(m_pProfiler, "Transforms");
+		UpdateTransforms();
+
+		// bake again once any record changed since the last bake
+		if (m_bStaticDirty == true)
+		{
+			BuildStaticBatches();
+		}
+	}
+
+	// skip the objects outside of the camera views and pick the
+	// level of detail of the ones inside them - the GPU driven path
+	// culls each view of several just before it is drawn
+	{
+		FrameProfiler::ScopedTimer timer(m_pProfiler, "Cull");
+		PrepareViews();
+		if (NULL != m_gpuRenderer)
+		{
+			if (m_viewCount == 1)
+			{
+				CullOnGpu();
+			}
+		}
+		else
+		{
+			CullDrawRecords();
+			SelectLodLevels();
+		}
+	}
+
+	// bring the cached shadow cascades up to date with the view
+	// and the objects that moved
+	if (NULL != m_shadowMaps)
+	{
+		FrameProfiler::ScopedTimer timer(m_pProfiler, "Shadows");
+		RenderShadowMaps();
+	}
+
+	// list the point lights that reach each cluster of the view,
+	// which is done for each view of several as it is drawn
+	if ((NULL != m_lightClusters) && (m_viewCount == 1))
+	{
+		FrameProfiler::ScopedTimer timer(m_pProfiler, "Lights");
+		UpdateLightClusters();
+	}
+
+	// the pre-pass needs its shader variant, which is only built
+	// with the shader cache
+	bool bDepthPrepass = (m_bUseDepthPrepass == true) && (m_programVariants[DEPTH_ONLY_VARIANT] >= 0);
+
+	// sort the draws of this frame, once for both passes
+	{
+		FrameProfiler::ScopedTimer timer(m_pProfiler, "Queue");
+		if (NULL == m_gpuRenderer)
+		{
+			if (m_bUseInstancing == true)
+			{
+				QueueInstanceBatches();
+			}
+			else
+			{
+				QueueDrawRecords(bDepthPrepass);
+			}
+		}
+	}
+
+	// lay down the depth of the opaque geometry without shading,
+	// so the lighting below runs once per pixel - the two scopes
+	// are timed apart to show what the pre-pass saves
+	if (bDepthPrepass == true)
+	{
+		FrameProfiler::ScopedTimer timer(m_pProfiler, "Depth");
+		for (int view = 0; view < m_viewCount; view++)
+		{
+			BeginView(view);
+			BeginDepthPrepass();
+			SubmitDraws();
+			EndDepthPrepass();
+		}
+	}
+
+	{
+		FrameProfiler::ScopedTimer timer(m_pProfiler, "Draw");
+		for (int view = 0; view < m_viewCount; view++)
+		{
+			BeginView(view);
+			if ((NULL != m_lightClusters) && (m_viewCount > 1))
+			{
+				UpdateLightClusters();
+			}
+			SubmitDraws();
+		}
+	}
+
+	if (bDepthPrepass == true)
+	{
+		glDepthFunc(GL_LESS);
+		glDepthMask(GL_TRUE);
+	}
+
+	// the passes after the scene draw over the whole frame
+	if (m_viewCount > 1)
+	{
+		glViewport(m_frameViewport[0], m_frameViewport[1], m_frameViewport[2], m_frameViewport[3]);
+		if (NULL != m_pUniformBuffers)
+		{
+			const UniformBufferManager::CAMERA_DATA& camera = m_views[0].camera;
+			m_pUniformBuffers->UpdateCamera(camera.view, camera.projection, camera.viewPosition);
+		}
+	}
+}
+
+/***********************************************************
+ *  SetViews()
+ *
+ *  This method is used for setting the views the next frames
+ *  are drawn from.  The objects are culled, sorted and drawn
+ *  for each view, while the transforms, the instance buffer,
+ *  the shadow cascades and the batches are shared by all of
+ *  them.  The shadows are fitted to the first view.
+ ***********************************************************/
+void SceneManager::SetViews(const ViewManager::FRAME_VIEWS& views)
+{
+	m_frameViews = views;
+	m_frameViews.viewCount = std::min(std::max(views.viewCount, 0), (int)ViewManager::MAX_VIEWS);
+}
+
+/***********************************************************
+ *  PrepareViews()
+ *
+ *  This method is used for setting up the state of every view
+ *  for this frame, placing the views in the viewport bound for
+ *  the frame.  Without any views set, the frame has one view
+ *  of the camera block over the whole viewport.  The arrays
+ *  of the views after the first keep their size between the
+ *  frames, so they are only allocated when the scene grows.
+ ***********************************************************/
+void SceneManager::PrepareViews()
+{
+	glGetIntegerv(GL_VIEWPORT, m_frameViewport);
+	m_viewCount = std::max(m_frameViews.viewCount, 1);
+
+	for (int view = 0; view < m_viewCount; view++)
+	{
+		VIEW_STATE& viewState = m_views[view];
+		glm::vec4 fraction(0.0f, 0.0f, 1.0f, 1.0f);
+
+		if (m_frameViews.viewCount > 0)
+		{
+			viewState.camera = m_frameViews.cameras[view];
+			fraction = m_frameViews.viewports[view];
+		}
+		else if (NULL != m_pUniformBuffers)
+		{
+			viewState.camera = m_pUniformBuffers->GetCameraData();
+		}
+
+		viewState.viewport[0] = m_frameViewport[0] + (GLint)(fraction.x * m_frameViewport[2] + 0.5f);
+		viewState.viewport[1] = m_frameViewport[1] + (GLint)(fraction.y * m_frameViewport[3] + 0.5f);
+		viewState.viewport[2] = std::max((GLint)(fraction.z * m_frameViewport[2] + 0.5f), 1);
+		viewState.viewport[3] = std::max((GLint)(fraction.w * m_frameViewport[3] + 0.5f), 1);
+
+		viewState.frustum.ExtractPlanes(viewState.camera.projection * viewState.camera.view);
+		for (int plane = 0; plane < ViewFrustum::TOTAL_PLANES; plane++)
+		{
+			viewState.planes[plane] = viewState.frustum.GetPlane(plane);
+		}
+
+		if (view == 0)
+		{
+			viewState.visible = m_objects.visible.begin();
+			viewState.lodLevels = m_objects.lodLevels.begin();
+		}
+		else
+		{
+			if (viewState.visibleArray.size() != m_drawRecords.size())
+			{
+				viewState.visibleArray.resize(m_drawRecords.size(), 1);
+				viewState.lodArray.resize(m_drawRecords.size(), 0);
+			}
+			viewState.visible = viewState.visibleArray.data();
+			viewState.lodLevels = viewState.lodArray.data();
+		}
+	}
+
+	m_pView = &m_views[0];
+}
+
+/***********************************************************
+ *  BeginView()
+ *
+ *  This method is used for binding the viewport and, when the
+ *  frame has several views, the camera of a view before its
+ *  draws.  The GPU driven path culls each view of several
+ *  here, since its commands only hold one view at a time.
+ ***********************************************************/
+void SceneManager::BeginView(int view)
+{
+	m_pView = &m_views[view];
+	if (m_viewCount == 1)
+	{
+		return;
+	}
+
+	glViewport(m_pView->viewport[0], m_pView->viewport[1], m_pView->viewport[2], m_pView->viewport[3]);
+	if (NULL != m_pUniformBuffers)
+	{
+		const UniformBufferManager::CAMERA_DATA& camera = m_pView->camera;
+		m_pUniformBuffers->UpdateCamera(camera.view, camera.projection, camera.viewPosition);
+	}
+	if (NULL != m_gpuRenderer)
+	{
+		CullOnGpu();
+	}
+}
+
+/***********************************************************
+ *  SubmitDraws()
+ *
+ *  This method is used for issuing the draws that were queued
+ *  for this frame through the active draw path.
+ ***********************************************************/
+void SceneManager::SubmitDraws()
+{
+	if (NULL != m_gpuRenderer)
+	{
+		RenderGpuDriven();
+	}
+	else if (m_bUseInstancing == true)
+	{
+		RenderInstanceBatches();
+	}
+	else
+	{
+		RenderDrawRecords();
+	}
+}
+
+/***********************************************************
+ *  BeginDepthPrepass()
+ *
+ *  This method is used for starting the depth pre-pass, which
+ *  draws with the depth only variant and no color writes.
+ ***********************************************************/
+void SceneManager::BeginDepthPrepass()
+{
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+
+	m_bDepthPass = true;
+	ResetRenderState();
+	SelectProgramVariant(DEPTH_ONLY_VARIANT);
+}
+
+/***********************************************************
+ *  EndDepthPrepass()
+ *
+ *  This method is used for ending the depth pre-pass.  The
+ *  shading pass only passes the depth test where its depth
+ *  equals what the pre-pass kept, and needs no depth writes.
+ ***********************************************************/
+void SceneManager::EndDepthPrepass()
+{
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glDepthFunc(GL_EQUAL);
+	glDepthMask(GL_FALSE);
+
+	m_bDepthPass = false;
+	ResetRenderState();
+}
+
+/***********************************************************
+ *  ResetRenderState()
+ *
+ *  This method is used for forgetting the shader state that
+ *  was last set so that the next values are always applied.
+ ***********************************************************/
+void SceneManager::ResetRenderState()
+{
+	m_currentVariant = -1;
+	m_currentTextureArray = -2;
+	m_currentTextureLayer = -1;
+	m_currentUVscale = glm::vec2(-1.0f, -1.0f);
+	m_currentMaterialIndex = -1;
+}
+
+/***********************************************************
+ *  QueueDrawRecords()
+ *
+ *  This method is used for sorting the visible draw records
+ *  by render state, then near to far.  Each worker of the
+ *  job system queues its share of the records into their
+ *  slots.  For a depth pre-pass the records are also queued
+ *  front to back, since that pass only changes the mesh and
+ *  gains the most from early depth rejection.  Each view has
+ *  its own queues, which are filled in the same pass.
+ ***********************************************************/
+void SceneManager::QueueDrawRecords(bool bDepthOrder)
+{
+	// queue every visible record with its state and distance into
+	// the queues of each view it is visible in
+	for (int view = 0; view < m_viewCount; view++)
+	{
+		m_views[view].renderQueue->BeginRecording((int)m_drawRecords.size());
+		m_views[view].depthQueue->BeginRecording(bDepthOrder ? (int)m_drawRecords.size() : 0);
+	}
+	JobSystem::Run(m_jobSystem, (int)m_drawRecords.size(), g_RecordChunkSize, [this, bDepthOrder](int begin, int end, int worker)
+	{
+		for (int index = begin; index < end; index++)
+		{
+			int variant = (m_drawRecords[index].textureArray >= 0) ? TEXTURED_VARIANT : UNTEXTURED_VARIANT;
+
+			for (int view = 0; view < m_viewCount; view++)
+			{
+				VIEW_STATE& viewState = m_views[view];
+				if (viewState.visible[index] == 0)
+				{
+					continue;
+				}
+
+				float distance = glm::length(m_objects.positions[index] - viewState.camera.viewPosition);
+				viewState.renderQueue->Push(
+					index,
+					RenderQueue::MakeSortKey(
+						variant,
+						m_objects.meshes[index],
+						m_drawRecords[index].textureArray,
+						m_objects.materialIndices[index],
+						distance),
+					index);
+				if (bDepthOrder == true)
+				{
+					viewState.depthQueue->Push(
+						index,
+						RenderQueue::MakeDepthSortKey(m_objects.meshes[index], distance),
+						index);
+				}
+			}
+		}
+	});
+	for (int view = 0; view < m_viewCount; view++)
+	{
+		m_views[view].renderQueue->Sort(m_jobSystem);
+		if (bDepthOrder == true)
+		{
+			m_views[view].depthQueue->Sort(m_jobSystem);
+		}
+	}
+}
+
+/***********************************************************
+ *  RenderDrawRecords()
+ *
+ *  This method is used for drawing every queued draw record
+ *  with its own draw call through the basic shape meshes.
+ *  Only the draw calls are issued from this thread, and the
+ *  depth pre-pass draws the records front to back.
+ ***********************************************************/
+void SceneManager::RenderDrawRecords()
+{
+	const RenderQueue* pQueue = (m_bDepthPass == true) ? m_pView->depthQueue : m_pView->renderQueue;
+
+	SetShaderInstancing(false);
+
+	for (int index = 0; index < pQueue->GetCount(); index++)
+	{
+		int object = pQueue->GetItem(index).itemIndex;
+		const DRAW_RECORD& record = m_drawRecords[object];
+
+		// set the resolved texture and material handles, which
+		// may switch the shader variant
+		SetShaderTexture(record.textureSlot);
+		SetTextureUVScale(record.UVscale.x, record.UVscale.y);
+		SetShaderMaterial(m_objects.materialIndices[object]);
+
+		// set the cached model matrix into the shader
+		m_pShaderManager->setMat4Value(g_ModelName, m_objects.models[object]);
+		m_renderStats.uniformUploads++;
+
+		// draw the mesh with the recorded values
+		DrawMesh(m_objects.meshes[object]);
+		m_renderStats.drawCalls++;
+		m_renderStats.triangles += (int)m_shapeGeometry->GetMeshData(m_objects.meshes[object]).indices.size() / 3;
+	}
+}
+
+/***********************************************************
+ *  QueueInstanceBatches()
+ *
+ *  This method is used for sorting the instanced batches by
+ *  their render state.
+ ***********************************************************/
+void SceneManager::QueueInstanceBatches()
+{
+	// queue every batch by its state - the material, texture layer
+	// and UV scale come from the instances so they are not part of the key
+	m_renderQueue->BeginRecording((int)m_instanceBatches.size());
+	for (int index = 0; index < m_instanceBatches.size(); index++)
+	{
+		const INSTANCE_BATCH& batch = m_instanceBatches[index];
+
+		m_renderQueue->Push(
+			index,
+			RenderQueue::MakeSortKey(
+				(batch.textureArray >= 0) ? TEXTURED_VARIANT : UNTEXTURED_VARIANT,
+				batch.mesh,
+				batch.textureArray,
+				-1,
+				0.0f),
+			index);
+	}
+	m_renderQueue->Sort();
+}
+
+/***********************************************************
+ *  RenderInstanceBatches()
+ *
+ *  This method is used for drawing each queued batch of draw
+ *  records with a single instanced draw call.  The model
+ *  matrix and material of each object come from the instance
+ *  buffer.
+ ***********************************************************/
+void SceneManager::RenderInstanceBatches()
+{
+	SetShaderInstancing(true);
+
+	// the baked objects read the same per-instance attributes
+	RenderStaticBatches();
+
+	for (int index = 0; index < m_renderQueue->GetCount(); index++)
+	{
+		const INSTANCE_BATCH& batch = m_instanceBatches[m_renderQueue->GetItem(index).itemIndex];
+
+		int batchEnd = batch.firstInstance + batch.instanceCount;
+
+		// draw each run of visible instances that share a level of
+		// detail - the members of a group sit next to each other and
+		// are about as far away, so a culled group leaves one gap and
+		// a group mostly changes level as a whole
+		int position = batch.firstInstance;
+		while (position < batchEnd)
+		{
+			int object = m_instanceRecords[position];
+			if ((m_pView->visible[object] == 0) || (m_drawRecords[object].bBaked == true))
+			{
+				position++;
+				continue;
+			}
+
+			int runStart = position;
+			int lodLevel = m_pView->lodLevels[object];
+			while (position < batchEnd)
+			{
+				object = m_instanceRecords[position];
+				if ((m_pView->visible[object] == 0) ||
+					(m_drawRecords[object].bBaked == true) ||
+					(m_pView->lodLevels[object] != lodLevel))
+				{
+					break;
+				}
+				position++;
+			}
+
+			SetShaderTextureArray(batch.textureArray);
+			m_shapeGeometry->DrawMeshInstanced(
+				batch.mesh,
+				runStart,
+				position - runStart,
+				lodLevel);
+			m_renderStats.drawCalls++;
+			m_renderStats.triangles +=
+				(int)m_shapeGeometry->GetMeshData(batch.mesh, lodLevel).indices.size() / 3 * (position - runStart);
+		}
+	}
+
+	SetShaderInstancing(false);
+}
+
+/***********************************************************
+ *  BuildStaticBatches()
+ *
+ *  This method is used for baking every static draw record
+ *  into the merged buffers of the static geometry.  Records
+ *  are ordered by texture array and then as they were added,
+ *  so the members of a group sit next to each other, and each
+ *  level of detail is baked for all records in turn so that
+ *  neighbours at the same level form one range.
+ ***********************************************************/
+void SceneManager::BuildStaticBatches()
+{
+	m_bStaticDirty = false;
+	m_staticBatches.clear();
+	m_staticGeometry->Clear();
+
+	for (int index = 0; index < m_drawRecords.size(); index++)
+	{
+		m_drawRecords[index].bBaked = false;
+	}
+	if (m_bUseStaticBatching == false)
+	{
+		m_staticGeometry->Upload();
+		return;
+	}
+
+	std::vector<int> order;
+	for (int index = 0; index < m_drawRecords.size(); index++)
+	{
+		if (m_drawRecords[index].bStatic == true)
+		{
+			order.push_back(index);
+		}
+	}
+
+	const std::vector<DRAW_RECORD>& records = m_drawRecords;
+	std::stable_sort(order.begin(), order.end(), [&records](int a, int b)
+	{
+		return(records[a].textureArray < records[b].textureArray);
+	});
+
+	for (int position = 0; position < order.size(); position++)
+	{
+		const DRAW_RECORD& record = m_drawRecords[order[position]];
+
+		if ((m_staticBatches.size() == 0) ||
+			(m_staticBatches.back().textureArray != record.textureArray))
+		{
+			STATIC_BATCH batch;
+			batch.textureArray = record.textureArray;
+			m_staticBatches.push_back(batch);
+		}
+		m_staticBatches.back().records.push_back(order[position]);
+	}
+
+	for (int batch = 0; batch < m_staticBatches.size(); batch++)
+	{
+		const std::vector<int>& batchRecords = m_staticBatches[batch].records;
+
+		for (int lod = 0; lod < ShapeGeometry::LOD_LEVELS; lod++)
+		{
+			for (int index = 0; index < batchRecords.size(); index++)
+			{
+				int object = batchRecords[index];
+				DRAW_RECORD& record = m_drawRecords[object];
+				if (lod >= m_shapeGeometry->GetLodCount(m_objects.meshes[object]))
+				{
+					continue;
+				}
+
+				record.staticRanges[lod] = m_staticGeometry->AddMesh(
+					m_shapeGeometry->GetMeshData(m_objects.meshes[object], lod),
+					m_objects.models[object],
+					m_objects.materialIndices[object],
+					record.textureLayer,
+					record.UVscale);
+				record.bBaked = true;
+			}
+		}
+	}
+
+	m_staticGeometry->Upload();
+}
+
+/***********************************************************
+ *  RenderStaticBatches()
+ *
+ *  This method is used for drawing the visible baked records
+ *  of each static batch with one multi-draw call.
+ ***********************************************************/
+void SceneManager::RenderStaticBatches()
+{
+	for (int batch = 0; batch < m_staticBatches.size(); batch++)
+	{
+		const std::vector<int>& batchRecords = m_staticBatches[batch].records;
+		int triangles = 0;
+
+		m_staticGeometry->BeginDraw();
+		for (int index = 0; index < batchRecords.size(); index++)
+		{
+			int object = batchRecords[index];
+			const DRAW_RECORD& record = m_drawRecords[object];
+			if (m_pView->visible[object] == 0)
+			{
+				continue;
+			}
+
+			int lod = glm::clamp(m_pView->lodLevels[object], 0, m_shapeGeometry->GetLodCount(m_objects.meshes[object]) - 1);
+			m_staticGeometry->AddDrawRange(record.staticRanges[lod]);
+			triangles += record.staticRanges[lod].indexCount / 3;
+		}
+
+		if (triangles > 0)
+		{
+			SetShaderTextureArray(m_staticBatches[batch].textureArray);
+			m_renderStats.drawCalls += m_staticGeometry->EndDraw();
+			m_renderStats.triangles += triangles;
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildGpuObjects()
+ *
+ *  This method is used for writing every draw record as an
+ *  object of the GPU driven path.  The objects are ordered by
+ *  texture array, and each texture array gets its own section
+ *  of the command buffer so it can be drawn with one call.
+ ***********************************************************/
+void SceneManager::BuildGpuObjects()
+{
+	std::vector<int> order(m_drawRecords.size());
+	for (int index = 0; index < order.size(); index++)
+	{
+		order[index] = index;
+	}
+
+	const std::vector<DRAW_RECORD>& records = m_drawRecords;
+	std::stable_sort(order.begin(), order.end(), [&records](int a, int b)
+	{
+		return(records[a].textureArray < records[b].textureArray);
+	});
+
+	std::vector<GpuDrivenRenderer::SECTION> sections;
+	m_gpuObjects.resize(order.size());
+	for (int position = 0; position < order.size(); position++)
+	{
+		DRAW_RECORD& record = m_drawRecords[order[position]];
+		const BOUNDING_VOLUME& bounds = m_objects.bounds[order[position]];
+
+		if ((sections.size() == 0) || (sections.back().textureArray != record.textureArray))
+		{
+			GpuDrivenRenderer::SECTION section;
+			section.textureArray = record.textureArray;
+			section.firstCommand = position;
+			section.commandCount = 0;
+			sections.push_back(section);
+		}
+		sections.back().commandCount++;
+
+		GpuDrivenRenderer::OBJECT_DATA& object = m_gpuObjects[position];
+		object.centerRadius = glm::vec4(bounds.center, bounds.radius);
+		object.extents = glm::vec4(bounds.extents, 0.0f);
+		object.mesh = (GLuint)m_objects.meshes[order[position]];
+		object.lodLevel = (GLuint)m_objects.lodLevels[order[position]];
+		object.section = (GLuint)(sections.size() - 1);
+		object.instanceIndex = (GLuint)record.instanceIndex;
+		object.commandSlot = (GLuint)position;
+		object.padding[0] = 0;
+		object.padding[1] = 0;
+		object.padding[2] = 0;
+		record.gpuObject = position;
+	}
+
+	m_gpuRenderer->SetObjects(m_gpuObjects, sections);
+}
+
+/***********************************************************
+ *  CullOnGpu()
+ *
+ *  This method is used for running the culling pass of the
+ *  GPU driven path with the culling and level of detail
+ *  settings of the CPU path.
+ ***********************************************************/
+void SceneManager::CullOnGpu()
+{
+	if (NULL == m_pUniformBuffers)
+	{
+		return;
+	}
+
+	const UniformBufferManager::CAMERA_DATA& camera = m_pUniformBuffers->GetCameraData();
+	GpuDrivenRenderer::CULL_PARAMETERS parameters;
+
+	parameters.viewProjection = camera.projection * camera.view;
+	parameters.projection = camera.projection;
+	parameters.viewPosition = camera.viewPosition;
+	parameters.bUseCulling = m_bUseCulling;
+	parameters.bUseLod = m_bUseLod;
+	parameters.lodScreenSizes = glm::vec2(g_LodScreenSizes[0], g_LodScreenSizes[1]);
+	parameters.lodHysteresis = g_LodHysteresis;
+
+	m_gpuRenderer->Cull(parameters);
+}
+
+/***********************************************************
+ *  UpdateLightClusters()
+ *
+ *  This method is used for binning the point lights into the
+ *  clusters of the camera view written for this frame.
+ ***********************************************************/
+void SceneManager::UpdateLightClusters()
+{
+	if (NULL == m_pUniformBuffers)
+	{
+		return;
+	}
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	const UniformBufferManager::CAMERA_DATA& camera = m_pUniformBuffers->GetCameraData();
+	m_lightClusters->Update(
+		camera.view,
+		camera.projection,
+		glm::vec4(viewport[0], viewport[1], viewport[2], viewport[3]));
+}
+
+/***********************************************************
+ *  RenderShadowMaps()
+ *
+ *  This method is used for fitting the shadow cascades to the
+ *  camera view written for this frame and drawing the parts
+ *  of them that are stale.  The casters are every instance,
+ *  visible or not, drawn whole by batch with the depth only
+ *  variant while the camera block holds the light.  Frames
+ *  where nothing moved draw nothing here.
+ ***********************************************************/
+void SceneManager::RenderShadowMaps()
+{
+	if (NULL == m_pUniformBuffers)
+	{
+		return;
+	}
+
+	// a copy, since the camera block is rewritten for the light
+	const UniformBufferManager::CAMERA_DATA camera = m_pUniformBuffers->GetCameraData();
+
+	BOUNDING_VOLUME sceneBounds = {};
+	for (int index = 0; index < m_drawRecords.size(); index++)
+	{
+		sceneBounds = (0 == index) ? m_objects.bounds[index] : ViewFrustum::MergeBounds(sceneBounds, m_objects.bounds[index]);
+	}
+	m_shadowMaps->FitCascades(camera.view, camera.projection, sceneBounds);
+
+	// the lighting shader only gets the cascades again once they move
+	UniformBufferManager::SHADOW_DATA shadows = {};
+	bool bMoved = false;
+	for (int cascade = 0; cascade < ShadowMaps::CASCADE_COUNT; cascade++)
+	{
+		const ShadowMaps::CASCADE& fitted = m_shadowMaps->GetCascade(cascade);
+		shadows.lightViewProjection[cascade] = fitted.lightViewProjection;
+		shadows.cascadeSplits[cascade] = fitted.splitDepth;
+		bMoved = bMoved ||
+			(shadows.lightViewProjection[cascade] != m_shadowData.lightViewProjection[cascade]) ||
+			(shadows.cascadeSplits[cascade] != m_shadowData.cascadeSplits[cascade]);
+	}
+	shadows.parameters = glm::vec4(1.0f / ShadowMaps::MAP_SIZE, g_ShadowDepthBias, 0.0f, 0.0f);
+	if (bMoved == true)
+	{
+		m_shadowData = shadows;
+		m_pUniformBuffers->UpdateShadows(m_shadowData);
+	}
+
+	if (m_shadowMaps->IsDirty() == true)
+	{
+		m_shadowMaps->BeginCascades();
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(g_ShadowSlopeOffset, g_ShadowConstantOffset);
+
+		m_bDepthPass = true;
+		ResetRenderState();
+		SelectProgramVariant(DEPTH_ONLY_VARIANT);
+		SetShaderInstancing(true);
+
+		for (int cascade = 0; cascade < ShadowMaps::CASCADE_COUNT; cascade++)
+		{
+			if (m_shadowMaps->IsCascadeDirty(cascade) == false)
+			{
+				continue;
+			}
+
+			const ShadowMaps::CASCADE& fitted = m_shadowMaps->GetCascade(cascade);
+			m_pUniformBuffers->UpdateCamera(fitted.lightView, fitted.lightProjection, camera.viewPosition);
+			m_shadowMaps->BeginCascade(cascade);
+
+			// the baked records are still in the instance buffer, so
+			// the batches hold every caster
+			for (int index = 0; index < m_instanceBatches.size(); index++)
+			{
+				const INSTANCE_BATCH& batch = m_instanceBatches[index];
+				m_shapeGeometry->DrawMeshInstanced(batch.mesh, batch.firstInstance, batch.instanceCount, 0);
+				m_renderStats.drawCalls++;
+				m_renderStats.triangles +=
+					(int)m_shapeGeometry->GetMeshData(batch.mesh, 0).indices.size() / 3 * batch.instanceCount;
+			}
+		}
+
+		SetShaderInstancing(false);
+		m_bDepthPass = false;
+		ResetRenderState();
+
+		glDisable(GL_POLYGON_OFFSET_FILL);
+		m_shadowMaps->EndCascades();
+		m_pUniformBuffers->UpdateCamera(camera.view, camera.projection, camera.viewPosition);
+	}
+
+	m_shadowMaps->BindTexture();
+}
+
+/***********************************************************
+ *  RenderGpuDriven()
+ *
+ *  This method is used for drawing the commands written by
+ *  the culling pass with one indirect call per texture array.
+ *  The culled objects and triangles are only known on the
+ *  GPU, so they are not part of the frame counts.
+ ***********************************************************/
+void SceneManager::RenderGpuDriven()
+{
+	SetShaderInstancing(true);
+
+	m_shapeGeometry->BindMeshPool();
+
+	const std::vector<GpuDrivenRenderer::SECTION>& sections = m_gpuRenderer->GetSections();
+	for (int section = 0; section < sections.size(); section++)
+	{
+		SetShaderTextureArray(sections[section].textureArray);
+		m_renderStats.drawCalls += m_gpuRenderer->DrawSection(section);
+	}
+
+	glBindVertexArray(0);
+
+	SetShaderInstancing(false);
+}
+
+/***********************************************************
+ *  GetRenderStats()
+ *
+ *  This method is used for getting the number of draw calls
+ *  and the state changes issued and skipped in the last frame.
+ ***********************************************************/
+const SceneManager::RENDER_STATS& SceneManager::GetRenderStats() const
+{
+	return(m_renderStats);
+}
+
+/***********************************************************
+ *  SetProfiler()
+ *
+ *  This method is used for timing the texture uploads, the
+ *  transform updates and the draws with a frame profiler.
+ *  Passing NULL turns the timing off.
+ ***********************************************************/
+void SceneManager::SetProfiler(FrameProfiler* pProfiler)
+{
+	m_pProfiler = pProfiler;
+}
+
+/***********************************************************
+ *  IsLoadingTextures()
+ *
+ *  This method is used for checking whether any texture is
+ *  still waiting to be decoded or uploaded, so the scene is
+ *  still drawn with placeholder textures.
+ ***********************************************************/
+bool SceneManager::IsLoadingTextures()
+{
+	return(m_textureLoader->GetPendingCount() > 0);
+}
+
+/***********************************************************
+ *  IsSceneChanging()
+ *
+ *  This method is used for checking whether the next frame
+ *  would differ from the last one with the same camera, which
+ *  is while textures are loading or when objects were moved
+ *  by an animation since the last frame.
+ ***********************************************************/
+bool SceneManager::IsSceneChanging()
+{
+	return((IsLoadingTextures() == true) || (m_dirtyRecords.size() > 0));
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for giving back everything the frame
+ *  took from the frame arena.  It is called once the buffers
+ *  are swapped, when nothing drawn still refers to it.
+ ***********************************************************/
+void SceneManager::EndFrame()
+{
+	m_frameArena->Reset();
+}
+
+/***********************************************************
+ *  BindProgram()
+ *
+ *  This method is used for pointing the texture arrays at a
+ *  rebuilt shader program and setting the values that are
+ *  only set into a program one time.
+ ***********************************************************/
+void SceneManager::BindProgram(GLuint programID)
+{
+	// the variants were rebuilt along with the plain program
+	for (int variant = 0; variant < TOTAL_PROGRAM_VARIANTS; variant++)
+	{
+		if (m_programVariants[variant] >= 0)
+		{
+			GLuint variantProgram = m_pShaderCache->GetProgram(m_programVariants[variant]);
+			m_pUniformBuffers->BindProgramBlocks(variantProgram);
+			if (DEPTH_ONLY_VARIANT == variant)
+			{
+				continue;
+			}
+			m_textureArrays->BindProgram(variantProgram, g_TextureValueName.c_str());
+			if (NULL != m_lightClusters)
+			{
+				m_lightClusters->BindProgram(variantProgram);
+			}
+		}
+	}
+	if (NULL != m_pUniformBuffers)
+	{
+		m_pUniformBuffers->SelectProgram(programID);
+	}
+
+	m_textureArrays->BindProgram(programID, g_TextureValueName.c_str());
+	m_pShaderManager->setBoolValue(g_UseLightingName, true);
+	ResetRenderState();
+}
+
+/***********************************************************
+ *  SetShaderCache()
+ *
+ *  This method is used for setting the shader cache that the
+ *  specialized variants of the lighting shader are built
+ *  with when the scene lights are set up.  Without one every
+ *  draw uses the plain program.
+ ***********************************************************/
+void SceneManager::SetShaderCache(ShaderCache* pShaderCache)
+{
+	m_pShaderCache = pShaderCache;
+}
+
+/***********************************************************
+ *  BuildProgramVariants()
+ *
+ *  This method is used for building a variant of the shader
+ *  for textured and for untextured draws, with the lights
+ *  that are on compiled in, and one for the depth pre-pass.  The fragments then skip the
+ *  tests of inactive lights and the texture flag, and a
+ *  variant that fails to build falls back to the plain
+ *  program.  The active point lights must be packed at the
+ *  start of the array.  With clustered lighting the point
+ *  lights come from the clusters instead, and when those
+ *  variants cannot be built the lights block is used.  The
+ *  lit variants also sample the shadow cascades when there
+ *  are any, and are built again without them on failure.
+ ***********************************************************/
+void SceneManager::BuildProgramVariants(const UniformBufferManager::LIGHTS_DATA& lights)
+{
+	if ((NULL == m_pShaderCache) || (NULL == m_pUniformBuffers))
+	{
+		return;
+	}
+
+	int pointLightCount = 0;
+	while ((pointLightCount < UniformBufferManager::TOTAL_POINT_LIGHTS) &&
+		(lights.pointLights[pointLightCount].bActive != 0))
+	{
+		pointLightCount++;
+	}
+
+	for (int variant = 0; variant < TOTAL_PROGRAM_VARIANTS; variant++)
+	{
+		// the depth only variant reads no lights
+		bool bDepthOnly = (DEPTH_ONLY_VARIANT == variant);
+		bool bClustered = (NULL != m_lightClusters) && (bDepthOnly == false);
+		bool bShadowed = (NULL != m_shadowMaps) && (bDepthOnly == false);
+		std::string defines =
+			"#define VARIANT 1\n"
+			"#define VARIANT_DEPTH_ONLY " + std::to_string(bDepthOnly ? 1 : 0) + "\n"
+			"#define VARIANT_LIGHTING 1\n"
+			"#define VARIANT_TEXTURED " + std::to_string((TEXTURED_VARIANT == variant) ? 1 : 0) + "\n"
+			"#define VARIANT_DIRECTIONAL_LIGHT " + std::to_string((lights.directionalLight.bActive != 0) ? 1 : 0) + "\n"
+			"#define VARIANT_SPOT_LIGHT " + std::to_string((lights.spotLight.bActive != 0) ? 1 : 0) + "\n"
+			"#define VARIANT_POINT_LIGHTS " + std::to_string(pointLightCount) + "\n"
+			"#define VARIANT_CLUSTERED_LIGHTS " + std::to_string(bClustered ? 1 : 0) + "\n"
+			"#define VARIANT_SHADOWS " + std::to_string(bShadowed ? 1 : 0) + "\n";
+
+		m_programVariants[variant] = m_pShaderCache->LoadVariant(defines);
+		if ((m_programVariants[variant] < 0) && (bShadowed == true))
+		{
+			// start over with every variant drawn without shadows
+			std::cout << "Shadowed lighting shader could not be built, drawing without shadows" << std::endl;
+			delete m_shadowMaps;
+			m_shadowMaps = NULL;
+			variant = -1;
+			continue;
+		}
+		if ((m_programVariants[variant] < 0) && (bClustered == true))
+		{
+			// start over with every variant reading the lights block
+			std::cout << "Clustered lighting shader could not be built, using the lights block" << std::endl;
+			delete m_lightClusters;
+			m_lightClusters = NULL;
+			variant = -1;
+			continue;
+		}
+		if (m_programVariants[variant] < 0)
+		{
+			std::cout << "Shader variant " << variant << " could not be built, using the plain program" << std::endl;
+			continue;
+		}
+
+		GLuint program = m_pShaderCache->GetProgram(m_programVariants[variant]);
+		m_pUniformBuffers->BindProgramBlocks(program);
+		if (bDepthOnly == true)
+		{
+			continue;
+		}
+		m_textureArrays->BindProgram(program, g_TextureValueName.c_str());
+		if (bClustered == true)
+		{
+			m_lightClusters->BindProgram(program);
+		}
+	}
+
+	// the plain program stays selected until a draw picks a variant
+	m_pUniformBuffers->SelectProgram(m_pShaderManager->m_programID);
+	m_textureArrays->SelectProgram(m_pShaderManager->m_programID, g_TextureValueName.c_str());
+	ResetRenderState();
+}
+
+/***********************************************************
+ *  GetVariantProgram()
+ *
+ *  This method is used for getting the program that draws
+ *  with a variant, which is the plain program when the
+ *  variant was not built.
+ ***********************************************************/
+GLuint SceneManager::GetVariantProgram(int variant)
+{
+	GLuint program = 0;
+
+	if (NULL != m_pShaderCache)
+	{
+		if (m_programVariants[variant] >= 0)
+		{
+			program = m_pShaderCache->GetProgram(m_programVariants[variant]);
+		}
+		if (0 == program)
+		{
+			program = m_pShaderCache->GetProgram();
+		}
+	}
+	if (0 == program)
+	{
+		program = m_pShaderManager->m_programID;
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  SelectProgramVariant()
+ *
+ *  This method is used for switching to the program of a
+ *  shader variant.  Uniforms belong to each program, so the
+ *  instancing flag is set again and the cached layer, UV
+ *  scale and material are forgotten so the next draw sets
+ *  them in the new program.
+ ***********************************************************/
+void SceneManager::SelectProgramVariant(int variant)
+{
+	if (variant == m_currentVariant)
+	{
+		return;
+	}
+
+	GLuint program = GetVariantProgram(variant);
+	bool bSameProgram = (m_currentVariant >= 0) && (program == m_pShaderManager->m_programID);
+	m_currentVariant = variant;
+	if (bSameProgram == true)
+	{
+		return;
+	}
+
+	m_pShaderManager->m_programID = program;
+	m_pShaderManager->use();
+	if (NULL != m_pUniformBuffers)
+	{
+		m_pUniformBuffers->SelectProgram(program);
+	}
+	m_textureArrays->SelectProgram(program, g_TextureValueName.c_str());
+	m_pShaderManager->setBoolValue(g_UseInstancingName, m_bInstancingPass);
+	if (NULL != m_shadowMaps)
+	{
+		m_pShaderManager->setIntValue(g_ShadowMapName, ShadowMaps::TEXTURE_UNIT);
+	}
+
+	m_currentTextureLayer = -1;
+	m_currentUVscale = glm::vec2(-1.0f, -1.0f);
+	m_currentMaterialIndex = -1;
+	m_renderStats.stateChanges++;
+	m_renderStats.uniformUploads++;
+}
+
+/***********************************************************
+ *  SetShaderInstancing()
+ *
+ *  This method is used for telling the shader whether the
+ *  next draws read the per-instance values.  The flag is
+ *  kept so a variant switched to later gets it as well.
+ ***********************************************************/
+void SceneManager::SetShaderInstancing(bool bInstancing)
+{
+	m_bInstancingPass = bInstancing;
+	m_pShaderManager->setBoolValue(g_UseInstancingName, bInstancing);
+	m_renderStats.uniformUploads++;
+}
+
+/***********************************************************
+ *  EnableTextureCache()
+ *
+ *  This method is used for choosing whether the textures are
+ *  stored block compressed and loaded from the texture cache.
+ *  It must be called before PrepareScene().
+ ***********************************************************/
+void SceneManager::EnableTextureCache(bool bEnable)
+{
+	m_textureArrays->EnableCompression(bEnable);
+}
+
+/***********************************************************
+ *  EnableCulling()
+ *
+ *  This method is used for choosing whether the objects
+ *  outside of the camera view are skipped when drawing.
+ ***********************************************************/
+void SceneManager::EnableCulling(bool bEnable)
+{
+	m_bUseCulling = bEnable;
+}
+
+/***********************************************************
+ *  EnableLod()
+ *
+ *  This method is used for choosing whether distant curved
+ *  shapes are drawn with their coarser levels of detail.
+ *  Only the instanced path has the coarser meshes, since the
+ *  per-object path draws through ShapeMeshes.
+ ***********************************************************/
+void SceneManager::EnableLod(bool bEnable)
+{
+	m_bUseLod = bEnable;
+}
+
+/***********************************************************
+ *  EnableStaticBatching()
+ *
+ *  This method is used for choosing whether the objects that
+ *  never move are baked into the merged buffers and drawn
+ *  with multi-draw calls.  The baked geometry is only drawn by
+ *  the instanced path.
+ ***********************************************************/
+void SceneManager::EnableStaticBatching(bool bEnable)
+{
+	m_bUseStaticBatching = bEnable;
+	m_bStaticDirty = true;
+}
+
+/***********************************************************
+ *  EnableDepthPrepass()
+ *
+ *  This method is used for choosing whether the opaque
+ *  geometry is drawn depth only first, so the shading pass
+ *  lights each pixel once.  It needs the shader cache and
+ *  can be changed between frames to compare the timings.
+ ***********************************************************/
+void SceneManager::EnableDepthPrepass(bool bEnable)
+{
+	m_bUseDepthPrepass = bEnable;
+}
+
+/***********************************************************
+ *  EnableClusteredLighting()
+ *
+ *  This method is used for choosing whether the point lights
+ *  are binned into the clusters of the view, so each fragment
+ *  only lights itself with the lights that reach it.  It must
+ *  be called before PrepareScene(), and the scene falls back
+ *  to the lights block when the driver cannot do it.
+ ***********************************************************/
+void SceneManager::EnableClusteredLighting(bool bEnable)
+{
+	m_bUseClusteredLighting = bEnable;
+}
+
+/***********************************************************
+ *  EnableShadows()
+ *
+ *  This method is used for choosing whether the directional
+ *  light casts shadows from cached cascades.  It must be
+ *  called before PrepareScene(), and the scene is drawn
+ *  without shadows when the shader variants cannot be built.
+ ***********************************************************/
+void SceneManager::EnableShadows(bool bEnable)
+{
+	m_bUseShadows = bEnable;
+}
+
+/***********************************************************
+ *  EnableCompactVertices()
+ *
+ *  This method is used for choosing whether the shape meshes
+ *  are uploaded with the compact vertex layout.  It must be
+ *  called before PrepareScene().
+ ***********************************************************/
+void SceneManager::EnableCompactVertices(bool bEnable)
+{
+	m_shapeGeometry->EnableCompactVertices(bEnable);
+}
+
+/***********************************************************
+ *  EnableGpuDriven()
+ *
+ *  This method is used for choosing whether the objects are
+ *  culled on the GPU and drawn with indirect commands.  It
+ *  must be called before PrepareScene(), and the scene falls
+ *  back to the instanced path when the driver cannot do it.
+ ***********************************************************/
+void SceneManager::EnableGpuDriven(bool bEnable)
+{
+	m_bUseGpuDriven = bEnable;
+}
+
+/***********************************************************
+ *  EnableInstancing()
+ *
+ *  This method is used for choosing whether the scene is drawn
+ *  with the instanced batches or one draw call per object.
+ ***********************************************************/
+void SceneManager::EnableInstancing(bool bEnable)
+{
+	m_bUseInstancing = bEnable;
+}
+
+/***********************************************************
+ *  EnableParallelRecording()
+ *
+ *  This method is used for choosing whether the per-record
+ *  loops of each frame are split across worker threads.  It
+ *  must be called before PrepareScene().
+ ***********************************************************/
+void SceneManager::EnableParallelRecording(bool bEnable)
+{
+	m_bUseParallelRecording = bEnable;
+}
+
+/***********************************************************
+ *  DefineBackground()
+ *
+ *  This method is used for defining the floor and backdrop
+ * for the scene.
+ ***********************************************************/
+
+void SceneManager::DefineBackground()
+{
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+	/*** Set needed transformations before drawing the basic mesh ***/
+	/*** for the floor.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_PLANE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"pavers",
+		"cement");
+
+	/***Set needed transformations before drawing the basic mesh for background.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(20.0f, 100.0f, 10.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, 10.0f, -10.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_PLANE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"wood_planks",
+		"wood");
+}
+
+/***********************************************************
+ *  DefineCauldron()
+ *
+ *  This method is used for defining the CAULDRON
+ ***********************************************************/
+void SceneManager::DefineCauldron()
+{
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+
+	/*** Set needed transformations before drawing the half-sphere ***/
+	/*** for the base of the cauldron.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.5f, 2.5f, 2.5f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 180.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-4.5f, 2.88F, 0.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_HALF_SPHERE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"cauldron",
+		"metal");
+
+	/*** Set needed transformations before drawing the half-sphere ***/
+	/*** for the base of the cauldron.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.5f, 0.5f, 2.5f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 180.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-4.5f, 2.88F, 0.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_TAPERED_CYLINDER,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"potion",
+		"potion");
+
+	/**************************************************************/
+	/*** Set needed transformations before drawing the torus ***/
+	/*** for the RIM of the cauldron.*** /
+	/**************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.2f, 2.2f, 2.2f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-4.5f, 2.88f, 0.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_TORUS,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"cauldron",
+		"metal");
+
+	/***********************************************************/
+	/*** Set needed transformations before drawing the first ***/
+	/*** leg for the cauldron.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.35f, 0.9f, 0.35f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 180.0f;
+	YrotationDegrees = -10.0f;
+	ZrotationDegrees = 20.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-5.8f, 0.9f, 0.25f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_TAPERED_CYLINDER,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"cauldron",
+		"metal");
+
+	/************************************************************/
+	/*** Set needed transformations before drawing the second ***/
+	/*** leg for the cauldron.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.35f, 0.9f, 0.35f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 180.0f;
+	YrotationDegrees = 110.0f;
+	ZrotationDegrees = 20.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-4.5f, 0.9f, -1.3f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_TAPERED_CYLINDER,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"cauldron",
+		"metal");
+
+	/************************************************************/
+	/*** Set needed transformations before drawing the third ***/
+	/*** leg for the cauldron.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.35f, 0.9f, 0.35f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 180.0f;
+	YrotationDegrees = 230.0f;
+	ZrotationDegrees = 20.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-3.5f, 0.9f, 1.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_TAPERED_CYLINDER,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"cauldron",
+		"metal");
+}
+
+/***********************************************************
+ *  DefineStrawBale()
+ *
+ *  This method is used for defining the CAULDRON
+ ***********************************************************/
+void SceneManager::DefineStrawBale()
+{
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+
+	/*** Set needed transformations before drawing the half-sphere ***/
+	/*** for the base of the cauldron.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(4.0, 8.0f, 4.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 125.0f;
+	ZrotationDegrees = 90.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.5f, 2.001F, -1.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_BOX,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"straw_ends",
+		"straw");
+}
+/***********************************************************
+ *  DefineFirstPumpkin()
+ *
+ *  This method is used for defining the first pumpkin
+ ***********************************************************/
+void SceneManager::DefineFirstPumpkin()
+{
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+
+	/*** Set needed transformations before drawing the sphere ***/
+	/*** for the base of the pumpkin.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.6, 1.4f, 1.6f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(1.5f, 5.251F, 1.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_SPHERE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"pumpkin",
+		"pumpkin");
+
+	/*** Set needed transformations before drawing the sphere ***/
+	/*** for the stem of the pumpkin.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.3, 0.6f, 0.3f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 180.0f;
+	ZrotationDegrees = 15.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(1.5f, 6.551F, 1.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_TAPERED_CYLINDER,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"stem",
+		"stem");
+
+}
+
+/***********************************************************
+ *  DefineSecondPumpkin()
+ *
+ *  This method is used for defining the second pumpkin
+ ***********************************************************/
+void SceneManager::DefineSecondPumpkin()
+{
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+
+	/*** Set needed transformations before drawing the sphere ***/
+	/*** for the base of the pumpkin.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.9, 1.5f, 1.9f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 45.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.25f, 5.451F, -2.1);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_SPHERE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"pumpkin",
+		"pumpkin");
+}
+
+/***********************************************************
+ *  DefineWitchHat()
+ *
+ *  This method is used for defining the witch hat
+ ***********************************************************/
+void SceneManager::DefineWitchHat()
+{
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+
+	/*** Set needed transformations before drawing  ***/
+	/*** the cone of the hat *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.2, 3.7f, 1.2f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 180.0f;
+	ZrotationDegrees = -7.5f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.2f, 6.8F, -2.3);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_CONE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_brim",
+		"cloth");
+
+	/*** Set needed transformations before drawing  ***/
+	/*** the brim of the hat *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.25, 0.1f, 2.25f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 180.0f;
+	ZrotationDegrees = -7.5f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.2f, 6.8F, -2.3);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_CYLINDER,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_brim",
+		"cloth");
+}
+
+/***********************************************************
+ *  DefineBat()
+ *
+ *  This method is used for defining the bat
+ ***********************************************************/
+void SceneManager::DefineBat() 
+{
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+
+	/*** Set needed transformations before drawing the sphere ***/
+	/*** for the head of the bat.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.75, 0.5f, 0.62f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 20.0f;
+	YrotationDegrees = 25.0f;
+	ZrotationDegrees = 20.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3( -7.3f, 9.88F, -3.0f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_SPHERE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"bat_face",
+		"cloth");
+
+	/*** Set needed transformations before drawing the sphere ***/
+	/*** for the body of the bat.*** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.25, 1.0f, 1.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 20.0f;
+	YrotationDegrees = 20.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-7.0f, 9.2F, -3.95f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_SPHERE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+
+	
+	/*** Set needed transformations before drawing the prism ***/
+	/*** for the first part of the bat's left wing *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.6f, 0.15f, 1.6f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 155.0f;
+	YrotationDegrees = 25.0f;
+	ZrotationDegrees = -30.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-5.7f, 9.9F, -3.85f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_PRISM,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+
+	/*** Set needed transformations before drawing the prism ***/
+	/*** for the second part of the bat's left wing *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.9f, 0.15f, 1.9f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 155.0f;
+	YrotationDegrees = 35.0f;
+	ZrotationDegrees = -30.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-4.7f, 10.58F, -3.65f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_PRISM,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+	
+	/*** Set needed transformations before drawing the prism ***/
+	/*** for the THIRD part of the bat's left wing *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.1f, 0.15f, 1.9f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 155.0f;
+	YrotationDegrees = 50.0f;
+	ZrotationDegrees = -30.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-3.7f, 11.5f, -3.15f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_PRISM,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+
+	/*** Set needed transformations before drawing the prism ***/
+	/*** for the first part of the bat's right wing *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.65f, 0.15f, 1.6f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 140.0f;
+	YrotationDegrees = -23.0f;
+	ZrotationDegrees = -25.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-8.65f, 8.6f, -3.6f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_PRISM,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+
+	/*** Set needed transformations before drawing the prism ***/
+	/*** for the second part of the bat's right wing *** /
+	/******************************************************************/
+
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.9f, 0.15f, 1.9f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 140.0f;
+	YrotationDegrees = -27.0f;
+	ZrotationDegrees = -25.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-9.6f, 8.45f, -3.1f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_PRISM,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+
+	/*** Set needed transformations before drawing the prism ***/
+	/*** for the THIRD part of the bat's right wing *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.1f, 0.15f, 1.9f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 140.0f;
+	YrotationDegrees = -35.0f;
+	ZrotationDegrees = -25.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-10.8f, 8.45f, -2.2f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_PRISM,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+
+	/*** Set needed transformations before drawing the tapered ***/
+	/*** cylinder for the bat's left leg *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.1, 0.5f, 0.1f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0;
+	YrotationDegrees = 45.0f;
+	ZrotationDegrees = 55.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-5.8f, 8.4f, -4.5f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_TAPERED_CYLINDER,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+
+
+	/*** Set needed transformations before drawing the tapered ***/
+	/*** cylinder for the bat's right leg *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.1, 0.5f, 0.1f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0;
+	YrotationDegrees = 135.0f;
+	ZrotationDegrees = 25.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-7.3f, 7.8f, -4.2f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_TAPERED_CYLINDER,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+
+	/*** Set needed transformations before drawing the ***/
+	/*** Half Sphere for the bat's left ear *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.28, 0.25f, 0.78f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = -50.0;
+	YrotationDegrees = 30.0f;
+	ZrotationDegrees = 20.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-6.9f, 10.25f, -2.85f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_HALF_SPHERE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+
+	/*** Set needed transformations before drawing the ***/
+	/*** Half Sphere for the bat's right ear *** /
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.28, 0.25f, 0.78f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = -25.0;
+	YrotationDegrees = -60.0f;
+	ZrotationDegrees = 60.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-7.8f, 9.9f, -2.55f);
+
+	// add the mesh with its transformation, texture and material
+	// values to the scene graph
+	AddDrawRecord(
+		MESH_HALF_SPHERE,
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ,
+		"black_fur",
+		"cloth");
+}
+
+
+
+/***********************************************************
+*  SetupSceneLights()
+*
+*  This method is called to add and configure the light
+*  sources for the 3D scene.  The lights are written into the
+*  lights uniform block one time since they never change.
+*  Every point light is also binned by the light clusters,
+*  while the lights block only holds the first few of them.
+***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	// this line of code is NEEDED for telling the shaders to render 
+	// the 3D scene with custom lighting - to use the default rendered 
+	// lighting then comment out the following line
+	m_pShaderManager->setBoolValue(g_UseLightingName, true);
+
+	if (NULL == m_pUniformBuffers)
+	{
+		return;
+	}
+
+	// every light that is not set below stays inactive
+	UniformBufferManager::LIGHTS_DATA lights = {};
+
+	//directional lighting to emulate moonlight coming into the scene. 
+	lights.directionalLight.direction = glm::vec3(-0.05f, -0.03f, -10.1f);
+	lights.directionalLight.ambient = glm::vec3(0.282f, 0.239f, 0.54f);
+	lights.directionalLight.diffuse = glm::vec3(0.06f, 0.06f, 0.06f);
+	lights.directionalLight.specular = glm::vec3(0.2f, 0.2f, 0.2f);
+	lights.directionalLight.bActive = true;
+
+	m_pointLights.clear();
+
+	//point light 1 - the position was previously written to a
+	//"direction" field that the point light does not have, so
+	//the light has always been at the origin, and it has no range
+	AddPointLight(
+		glm::vec3(0.0f, 0.0f, 0.0f),
+		0.0f,
+		glm::vec3(0.0f, 0.003f, 0.0),
+		glm::vec3(0.01f, 0.05f, 0.01f),
+		glm::vec3(0.1f, 0.3f, 0.1f));
+
+	//the candle glow of each jack-o'-lantern, which fades out a
+	//short way from its pumpkin
+	AddPointLight(
+		glm::vec3(1.5f, 5.5f, 1.0f),
+		3.0f,
+		glm::vec3(0.0f, 0.0f, 0.0f),
+		glm::vec3(0.6f, 0.3f, 0.05f),
+		glm::vec3(0.2f, 0.1f, 0.02f));
+	AddPointLight(
+		glm::vec3(0.25f, 5.7f, -2.1f),
+		3.0f,
+		glm::vec3(0.0f, 0.0f, 0.0f),
+		glm::vec3(0.6f, 0.3f, 0.05f),
+		glm::vec3(0.2f, 0.1f, 0.02f));
+
+	//spotlight - the values were previously set on "spotlight" while
+	//the shader names it "spotLight", so it never reached the shader.
+	//It has no position or direction yet, so it is left inactive to
+	//keep the scene lit the same way.
+	lights.spotLight.ambient = glm::vec3(0.8f, 0.8f, 0.8f);
+	lights.spotLight.diffuse = glm::vec3(1.0f, 1.0f, 1.0f);
+	lights.spotLight.specular = glm::vec3(0.7f, 0.7f, 0.7f);
+	lights.spotLight.constant = 1.0f;
+	lights.spotLight.linear = 0.09f;
+	lights.spotLight.quadratic = 0.032f;
+	lights.spotLight.cutOff = glm::cos(glm::radians(42.5f));
+	lights.spotLight.outerCutOff = glm::cos(glm::radians(48.0f));
+	lights.spotLight.bActive = false;
+
+	// the lights block gets the first point lights packed at the
+	// start of its array, so the shader variants only loop over
+	// the ones that are on
+	for (int i = 0; (i < m_pointLights.size()) && (i < UniformBufferManager::TOTAL_POINT_LIGHTS); i++)
+	{
+		const LightClusters::POINT_LIGHT& pointLight = m_pointLights[i];
+
+		lights.pointLights[i].position = glm::vec3(pointLight.positionRange);
+		lights.pointLights[i].range = pointLight.positionRange.w;
+		lights.pointLights[i].ambient = glm::vec3(pointLight.ambient);
+		lights.pointLights[i].diffuse = glm::vec3(pointLight.diffuse);
+		lights.pointLights[i].specular = glm::vec3(pointLight.specular);
+		lights.pointLights[i].bActive = true;
+	}
+	m_pUniformBuffers->UpdateLights(lights);
+
+	// every point light is binned into the clusters of the view
+	// when the driver can run the binning pass - only the shader
+	// variants read the clusters, so they need the shader cache
+	if ((m_bUseClusteredLighting == true) && (NULL != m_pShaderCache) && (NULL == m_lightClusters))
+	{
+		m_lightClusters = new LightClusters();
+		if (m_lightClusters->Initialize(g_LightClusterShaderFilename) == false)
+		{
+			delete m_lightClusters;
+			m_lightClusters = NULL;
+		}
+	}
+	if (NULL != m_lightClusters)
+	{
+		m_lightClusters->SetLights(m_pointLights);
+	}
+
+	// the moonlight casts shadows from cascades that are cached
+	// between frames, which like the clusters only the shader
+	// variants read - the spotlight is off, so it casts none
+	if ((m_bUseShadows == true) && (NULL != m_pShaderCache) &&
+		(lights.directionalLight.bActive != 0) && (NULL == m_shadowMaps))
+	{
+		m_shadowMaps = new ShadowMaps();
+		if (m_shadowMaps->Initialize() == false)
+		{
+			delete m_shadowMaps;
+			m_shadowMaps = NULL;
+		}
+	}
+	if (NULL != m_shadowMaps)
+	{
+		m_shadowMaps->SetLightDirection(lights.directionalLight.direction);
+	}
+
+	BuildProgramVariants(lights);
+
+	if ((NULL == m_lightClusters) && (m_pointLights.size() > UniformBufferManager::TOTAL_POINT_LIGHTS))
+	{
+		std::cout << "Only the first " << UniformBufferManager::TOTAL_POINT_LIGHTS << " of " << m_pointLights.size() << " point lights are drawn without clustered lighting" << std::endl;
+	}
+}
+
+/***********************************************************
+*  AddPointLight()
+*
+*  This method is called to add a point light to the scene.
+*  A range of zero keeps the light from ever fading out.
+***********************************************************/
+void SceneManager::AddPointLight(
+	glm::vec3 position,
+	float range,
+	glm::vec3 ambient,
+	glm::vec3 diffuse,
+	glm::vec3 specular)
+{
+	LightClusters::POINT_LIGHT pointLight;
+
+	pointLight.positionRange = glm::vec4(position, range);
+	pointLight.ambient = glm::vec4(ambient, 1.0f);
+	pointLight.diffuse = glm::vec4(diffuse, 1.0f);
+	pointLight.specular = glm::vec4(specular, 1.0f);
+	m_pointLights.push_back(pointLight);
+}
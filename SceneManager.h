@@ -1,119 +1,524 @@
-///////////////////////////////////////////////////////////////////////////////
-// SceneManager.h
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager* pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		float ambientStrength;
-		glm::vec3 ambientColor;
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	void DefineObjectMaterials();
-
-	void LoadSceneTextures();
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-public:
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	void PrepareScene();
-	void RenderScene();
-	void RenderBackground();
-	void RenderCauldron();
-	void RenderStrawBale();
-	void RenderFirstPumpkin();
-	void RenderSecondPumpkin();
-	void RenderWitchHat();
-	void RenderBat();
-	void SetupSceneLights();
-
+///////////////////////////////////////////////////////////////////////////////
+// SceneManager.h
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "ShaderCache.h"
+#include "ShapeMeshes.h"
+#include "ShapeGeometry.h"
+#include "UniformBufferManager.h"
+#include "RenderQueue.h"
+#include "TextureArrayManager.h"
+#include "TextureLoader.h"
+#include "FrameProfiler.h"
+#include "ViewFrustum.h"
+#include "StaticGeometry.h"
+#include "GpuDrivenRenderer.h"
+#include "LightClusters.h"
+#include "ShadowMaps.h"
+#include "JobSystem.h"
+#include "SceneObjects.h"
+#include "SceneFile.h"
+#include "ViewManager.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(
+		ShaderManager* pShaderManager,
+		UniformBufferManager* pUniformBuffers);
+	// destructor
+	~SceneManager();
+
+	// ID is the OpenGL texture array holding the texture
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		uint32_t ID;
+	};
+
+	struct OBJECT_MATERIAL
+	{
+		float ambientStrength;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		std::string tag;
+	};
+
+	// one entry in the retained scene graph, resolved when
+	// the scene is prepared and reused on every frame - the
+	// values the frame passes read, such as the transform,
+	// bounds and visibility, live in the scene object arrays
+	// at the same index
+	struct DRAW_RECORD
+	{
+		int textureSlot;
+		// texture array and layer resolved from the texture slot
+		int textureArray;
+		int textureLayer;
+		glm::vec2 UVscale;
+		// position of the object in the instance buffer
+		int instanceIndex;
+		// true until the object is moved, so it can be baked
+		bool bStatic;
+		// true when the record is drawn from the static geometry
+		bool bBaked;
+		// ranges of the static geometry holding each level of detail
+		StaticGeometry::DRAW_RANGE staticRanges[ShapeGeometry::LOD_LEVELS];
+		// object of the GPU driven path, or -1
+		int gpuObject;
+	};
+
+	// baked draw records sharing a texture array, drawn with one
+	// multi-draw call over the ranges of the ones in view
+	struct STATIC_BATCH
+	{
+		int textureArray;
+		std::vector<int> records;
+	};
+
+	// the draw records of one prop, such as the cauldron or the
+	// bat, with bounds around all of them so that a prop out of
+	// view is dropped with one test
+	struct OBJECT_GROUP
+	{
+		int firstRecord;
+		int recordCount;
+		BOUNDING_VOLUME bounds;
+		// true when a member moved and the bounds are stale
+		bool bDirty;
+	};
+
+	// a run of instances that share the same mesh and texture
+	// array and are drawn together with one draw call - the
+	// texture layer and UV scale come from each instance
+	struct INSTANCE_BATCH
+	{
+		MESH_TYPE mesh;
+		int textureArray;
+		int firstInstance;
+		int instanceCount;
+	};
+
+	// per-frame counts of the draws and the shader state changes
+	// that were issued or skipped because the value was current
+	struct RENDER_STATS
+	{
+		int drawCalls;
+		int triangles;
+		int uniformUploads;
+		int stateChanges;
+		int stateChangesSkipped;
+		int objectsCulled;
+	};
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to the shared uniform buffer blocks
+	UniformBufferManager* m_pUniformBuffers;
+	// pointer to basic shapes object
+	ShapeMeshes* m_basicMeshes;
+	// pointer to the generated shapes used for instanced drawing
+	ShapeGeometry* m_shapeGeometry;
+	// pointer to the texture arrays holding the loaded textures
+	TextureArrayManager* m_textureArrays;
+	// pointer to the worker threads decoding the texture images
+	TextureLoader* m_textureLoader;
+	// total number of loaded textures
+	int m_loadedTextures;
+	// loaded textures info
+	std::vector<TEXTURE_INFO> m_textureIDs;
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// texture slot and material index handles by tag
+	std::unordered_map<std::string, int> m_textureLookup;
+	std::unordered_map<std::string, int> m_materialLookup;
+	// number of times each handle was resolved, for the tag check
+	std::vector<int> m_textureResolveCounts;
+	std::vector<int> m_materialResolveCounts;
+	// requested tags that did not match a texture or material
+	std::vector<std::string> m_missedTags;
+	// true when unresolved tags are reported after preparing
+	bool m_bCheckTags;
+	// retained scene graph built in PrepareScene()
+	std::vector<DRAW_RECORD> m_drawRecords;
+	// per-frame values of each draw record, by the same index
+	SceneObjects m_objects;
+	// names of the object groups for debugging
+	std::vector<std::string> m_groupNames;
+	// scene file the objects are loaded from, and the opened file
+	// the object arrays point into, NULL when the scene is built
+	// by the Define methods
+	std::string m_sceneFilename;
+	SceneFile* m_sceneFile;
+	// indices of the draw records with a dirty transform
+	std::vector<int> m_dirtyRecords;
+	// groups of draw records that are culled together
+	std::vector<OBJECT_GROUP> m_objectGroups;
+	// true when objects outside the view are skipped
+	bool m_bUseCulling;
+	// true when distant curved shapes use coarser meshes
+	bool m_bUseLod;
+	// number of model matrices rebuilt in the last frame
+	int m_transformUpdates;
+	// batches of draw records drawn with instancing
+	std::vector<INSTANCE_BATCH> m_instanceBatches;
+	// draw record held at each position of the instance buffer
+	std::vector<int> m_instanceRecords;
+	// merged world space meshes of the objects that never move
+	StaticGeometry* m_staticGeometry;
+	// batches of the baked draw records by texture array
+	std::vector<STATIC_BATCH> m_staticBatches;
+	// true when the static objects are baked into merged buffers
+	bool m_bUseStaticBatching;
+	// true when an object stopped being static since it was baked
+	bool m_bStaticDirty;
+	// culling and indirect draws on the GPU, NULL when not used
+	GpuDrivenRenderer* m_gpuRenderer;
+	// objects of the GPU driven path as last written
+	std::vector<GpuDrivenRenderer::OBJECT_DATA> m_gpuObjects;
+	// true when the GPU driven path is requested
+	bool m_bUseGpuDriven;
+	// binning of the point lights into the clusters of the
+	// view, NULL when not used
+	LightClusters* m_lightClusters;
+	// true when clustered lighting is requested
+	bool m_bUseClusteredLighting;
+	// every point light of the scene
+	std::vector<LightClusters::POINT_LIGHT> m_pointLights;
+	// cached shadow cascades of the directional light, NULL when
+	// not used
+	ShadowMaps* m_shadowMaps;
+	// true when shadows are requested
+	bool m_bUseShadows;
+	// cascades as last written into the lights block
+	UniformBufferManager::SHADOW_DATA m_shadowData;
+	// true when the scene is drawn with the instanced batches
+	bool m_bUseInstancing;
+	// memory for the data that only lives until the frame ends
+	FrameArena* m_frameArena;
+	// instanced batches of the current frame sorted by render
+	// state, which is the same order for every view
+	RenderQueue* m_renderQueue;
+
+	// the per view state of one view of the frame - everything
+	// else about the objects is shared by the views
+	struct VIEW_STATE
+	{
+		UniformBufferManager::CAMERA_DATA camera;
+		// part of the framebuffer the view is drawn into, in pixels
+		GLint viewport[4];
+		// planes of the camera view for the current frame
+		ViewFrustum frustum;
+		glm::vec4 planes[ViewFrustum::TOTAL_PLANES];
+		// visibility and level of detail of each draw record in
+		// the view - the first view points at the arrays of the
+		// scene objects, and the others at the arrays below
+		uint8_t* visible;
+		int* lodLevels;
+		std::vector<uint8_t> visibleArray;
+		std::vector<int> lodArray;
+		// draw records of the view sorted by render state, and
+		// front to back for the depth pre-pass
+		RenderQueue* renderQueue;
+		RenderQueue* depthQueue;
+	};
+
+	// views as last set, which are all drawn by RenderScene()
+	ViewManager::FRAME_VIEWS m_frameViews;
+	// state of each view of the frame and the number in use
+	VIEW_STATE m_views[ViewManager::MAX_VIEWS];
+	int m_viewCount;
+	// view being drawn
+	VIEW_STATE* m_pView;
+	// viewport the views are placed in, as bound for the frame
+	GLint m_frameViewport[4];
+	// workers splitting the per-record loops, NULL when not used
+	JobSystem* m_jobSystem;
+	// true when the per-record loops run on the job system
+	bool m_bUseParallelRecording;
+	// builds of the lighting shader specialized for the scene
+	enum PROGRAM_VARIANT
+	{
+		UNTEXTURED_VARIANT = 0,
+		TEXTURED_VARIANT,
+		DEPTH_ONLY_VARIANT,
+		TOTAL_PROGRAM_VARIANTS
+	};
+
+	// cache the shader variants are built with, NULL when not used
+	ShaderCache* m_pShaderCache;
+	// index of each variant in the shader cache, -1 when the
+	// variant could not be built and the plain program is used
+	int m_programVariants[TOTAL_PROGRAM_VARIANTS];
+	// true while the draws read the per-instance values
+	bool m_bInstancingPass;
+	// true when the depth pre-pass is requested, and while the
+	// draws of the pre-pass are issued
+	bool m_bUseDepthPrepass;
+	bool m_bDepthPass;
+	// shader state that was last set, to skip redundant changes
+	int m_currentVariant;
+	int m_currentTextureArray;
+	int m_currentTextureLayer;
+	glm::vec2 m_currentUVscale;
+	int m_currentMaterialIndex;
+	// counts for the last rendered frame
+	RENDER_STATS m_renderStats;
+	// pointer to the frame profiler, NULL when not profiling
+	FrameProfiler* m_pProfiler;
+
+	// reserve a texture and queue its image file to be decoded
+	bool CreateGLTexture(const char* filename, const std::string& tag);
+	// create the texture arrays, bind them and start decoding
+	void BindGLTextures();
+	// upload the textures that finished decoding since last frame
+	void UploadLoadedTextures();
+	// point the draw records at the layers of uploaded textures
+	void RefreshTextureLayers();
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// find a loaded texture by tag
+	int FindTextureID(const std::string& tag);
+	int FindTextureSlot(const std::string& tag);
+	// find a defined material by tag
+	bool FindMaterial(const std::string& tag, OBJECT_MATERIAL& material);
+	int FindMaterialIndex(const std::string& tag);
+	// index the defined materials by tag
+	void BuildMaterialLookup();
+	// report the tags that were never resolved
+	void ReportUnresolvedTags();
+
+	void DefineObjectMaterials();
+
+	void LoadSceneTextures();
+
+	// open the scene file, falling back to the scene built in code
+	bool OpenSceneFile();
+	// load the textures and define the materials of the scene file
+	void LoadSceneFileTextures();
+	void DefineSceneFileMaterials();
+	// use the objects of the scene file as the scene graph
+	void AddSceneFileObjects();
+	// build the scene graph with the Define methods
+	void BuildSceneInCode();
+
+	// build a model matrix from the transformation values
+	glm::mat4 ComposeModelMatrix(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// recalculate the model matrices of the moved objects
+	void UpdateTransforms();
+
+	// start and end the group that new draw records are added to
+	void BeginObjectGroup(const char* name);
+	void EndObjectGroup();
+	// rebuild the bounds of a group from its draw records
+	void UpdateGroupBounds(int group);
+	// set up the state of every view for this frame
+	void PrepareViews();
+	// bind the viewport and camera of a view for its draws
+	void BeginView(int view);
+	// flag the draw records inside each camera view as visible
+	void CullDrawRecords();
+	// pick the level of detail of each visible draw record
+	void SelectLodLevels();
+
+	// set the transformation values 
+	// into the transform buffer
+	void SetTransformations(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the color values into the shader
+	void SetShaderColor(
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+
+	// set the texture data into the shader
+	void SetShaderTexture(
+		const std::string& textureTag);
+	void SetShaderTexture(
+		int textureSlot);
+	// set the texture array and layer for the next draw
+	void SetShaderTextureArray(
+		int textureArray);
+	void SetTextureLayer(
+		int textureLayer);
+
+	// set the UV scale for the texture mapping
+	void SetTextureUVScale(
+		float u, float v);
+
+	// set the object material into the shader
+	void SetShaderMaterial(
+		const std::string& materialTag);
+	void SetShaderMaterial(
+		int materialIndex);
+
+	// write the defined materials into the materials block
+	void UploadObjectMaterials();
+
+	// build the draw record values of an added object
+	DRAW_RECORD MakeDrawRecord(int textureSlot, glm::vec2 UVscale);
+	// add a mesh to the retained scene graph
+	void AddDrawRecord(
+		MESH_TYPE mesh,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ,
+		const std::string& textureTag,
+		const std::string& materialTag,
+		glm::vec2 UVscale = glm::vec2(1.0f, 1.0f));
+
+	// draw the basic shape mesh referenced by a draw record
+	void DrawMesh(MESH_TYPE mesh);
+
+	// group the draw records into instanced batches
+	void BuildInstanceBatches();
+	// write the instance values of one draw record
+	void UpdateInstance(int recordIndex);
+	// build the shader variants for the active scene lights
+	void BuildProgramVariants(const UniformBufferManager::LIGHTS_DATA& lights);
+	// get the program drawn with for a shader variant
+	GLuint GetVariantProgram(int variant);
+	// switch to the shader variant for the next draw
+	void SelectProgramVariant(int variant);
+	// tell the shader whether the draws are instanced
+	void SetShaderInstancing(bool bInstancing);
+	// forget the shader state so the next values are always set
+	void ResetRenderState();
+	// sort and draw the scene one record at a time
+	void QueueDrawRecords(bool bDepthOrder);
+	void RenderDrawRecords();
+	// sort and draw the scene with one draw call per batch
+	void QueueInstanceBatches();
+	void RenderInstanceBatches();
+	// issue the queued draws through the active draw path
+	void SubmitDraws();
+	// start and end the depth only drawing of the pre-pass
+	void BeginDepthPrepass();
+	void EndDepthPrepass();
+	// bake the static draw records into the merged buffers
+	void BuildStaticBatches();
+	// draw the baked records with one call per texture array
+	void RenderStaticBatches();
+	// write every draw record as an object of the GPU driven path
+	void BuildGpuObjects();
+	// cull on the GPU and draw one indirect call per texture array
+	void CullOnGpu();
+	void RenderGpuDriven();
+	// list the point lights that reach each cluster of the view
+	void UpdateLightClusters();
+	// fit the shadow cascades to the view and draw their stale parts
+	void RenderShadowMaps();
+	// add a point light that fades out at its range
+	void AddPointLight(
+		glm::vec3 position,
+		float range,
+		glm::vec3 ambient,
+		glm::vec3 diffuse,
+		glm::vec3 specular);
+
+public:
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	void PrepareScene();
+	void RenderScene();
+	void DefineBackground();
+	void DefineCauldron();
+	void DefineStrawBale();
+	void DefineFirstPumpkin();
+	void DefineSecondPumpkin();
+	void DefineWitchHat();
+	void DefineBat();
+	void SetupSceneLights();
+
+	// turn on the debug report of unresolved tags
+	void EnableTagCheck(bool bEnable);
+	// choose between instanced batches and one draw per object
+	void EnableInstancing(bool bEnable);
+	// choose whether the per-record loops run on worker threads
+	void EnableParallelRecording(bool bEnable);
+	// choose whether textures are compressed and cached on disk
+	void EnableTextureCache(bool bEnable);
+	// choose whether objects outside the camera view are skipped
+	void EnableCulling(bool bEnable);
+	// choose whether distant shapes are drawn with coarser meshes
+	void EnableLod(bool bEnable);
+	// choose whether the static objects are baked into merged buffers
+	void EnableStaticBatching(bool bEnable);
+	// choose whether culling and draw submission run on the GPU
+	void EnableGpuDriven(bool bEnable);
+	// choose whether the point lights are binned into clusters
+	void EnableClusteredLighting(bool bEnable);
+	// choose whether the depth is laid down before shading
+	void EnableDepthPrepass(bool bEnable);
+	// choose whether the directional light casts shadows
+	void EnableShadows(bool bEnable);
+	// choose whether the shape meshes use the compact vertex layout
+	void EnableCompactVertices(bool bEnable);
+	// choose the scene file loaded by PrepareScene()
+	void SetSceneFile(const char* filename);
+	// set the views the next frames are drawn from - without any,
+	// the frame is drawn from the camera block over the viewport
+	void SetViews(const ViewManager::FRAME_VIEWS& views);
+	// get the draw and state change counts of the last frame
+	const RENDER_STATS& GetRenderStats() const;
+	// time the parts of RenderScene() with a frame profiler
+	void SetProfiler(FrameProfiler* pProfiler);
+	// true while textures are still being decoded or uploaded
+	bool IsLoadingTextures();
+	// true while the scene changes without the camera moving
+	bool IsSceneChanging();
+	// free the data of the frame once its buffers are swapped
+	void EndFrame();
+	// connect a rebuilt shader program to the scene
+	void BindProgram(GLuint programID);
+	// build specialized shader variants with a shader cache,
+	// which must be set before the scene is prepared
+	void SetShaderCache(ShaderCache* pShaderCache);
+
+	// change the transformation values of a scene object
+	void SetObjectTransform(
+		int recordIndex,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
 };
\ No newline at end of file
@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneObjects.cpp
+// ============
+// keep the per-frame values of the scene objects in parallel arrays
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneObjects.h"
+
+/***********************************************************
+ *  SceneObjects()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneObjects::SceneObjects()
+{
+}
+
+/***********************************************************
+ *  ~SceneObjects()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneObjects::~SceneObjects()
+{
+	Clear();
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for appending one object to every
+ *  array.  The object starts out visible, at the finest
+ *  level of detail and outside of any group.
+ ***********************************************************/
+int SceneObjects::Add(
+	MESH_TYPE mesh,
+	glm::vec3 scaleXYZ,
+	glm::vec3 rotationDegrees,
+	glm::vec3 positionXYZ,
+	const glm::mat4& model,
+	const BOUNDING_VOLUME& worldBounds,
+	int materialIndex)
+{
+	scales.push_back(scaleXYZ);
+	rotationsDegrees.push_back(rotationDegrees);
+	positions.push_back(positionXYZ);
+	models.push_back(model);
+	bounds.push_back(worldBounds);
+	meshes.push_back(mesh);
+	materialIndices.push_back(materialIndex);
+	groups.push_back(-1);
+	lodLevels.push_back(0);
+	visible.push_back(1);
+	transformDirty.push_back(0);
+	names.push_back(std::string());
+
+	return((int)meshes.size() - 1);
+}
+
+/***********************************************************
+ *  Attach()
+ *
+ *  This method is used for pointing every array at the ones
+ *  of a mapped scene file.  Moving or adding objects later
+ *  only writes to the private pages of the mapping or to
+ *  copies, so the file itself is never changed.
+ ***********************************************************/
+void SceneObjects::Attach(const SceneFile::OBJECT_ARRAYS& arrays, int count)
+{
+	Clear();
+
+	scales.Attach(arrays.scales, count);
+	rotationsDegrees.Attach(arrays.rotationsDegrees, count);
+	positions.Attach(arrays.positions, count);
+	models.Attach(arrays.models, count);
+	bounds.Attach(arrays.bounds, count);
+	meshes.Attach(arrays.meshes, count);
+	materialIndices.Attach(arrays.materialIndices, count);
+	groups.Attach(arrays.groups, count);
+	lodLevels.Attach(arrays.lodLevels, count);
+	visible.Attach(arrays.visible, count);
+	transformDirty.Attach(arrays.transformDirty, count);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every object.
+ ***********************************************************/
+void SceneObjects::Clear()
+{
+	scales.clear();
+	rotationsDegrees.clear();
+	positions.clear();
+	models.clear();
+	bounds.clear();
+	meshes.clear();
+	materialIndices.clear();
+	groups.clear();
+	lodLevels.clear();
+	visible.clear();
+	transformDirty.clear();
+	names.clear();
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method is used for getting the number of objects.
+ ***********************************************************/
+int SceneObjects::GetCount() const
+{
+	return((int)meshes.size());
+}
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+// SceneObjects.h
+// ============
+// keep the per-frame values of the scene objects in parallel arrays
+//
+//  Each value the frame passes read, such as the model matrices, bounds or
+//  visibility flags, has its own array with one entry per object, so a
+//  pass only streams through the values it uses.  The model matrices are
+//  kept 16-byte aligned for SIMD loads, and the names, which are only
+//  read when debugging, are kept apart from the rest.  The arrays can also
+//  point straight into a mapped scene file, so a cooked scene is used in
+//  place without being copied or parsed.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneFile.h"
+#include "ShapeGeometry.h"
+#include "ViewFrustum.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  AlignedAllocator
+ *
+ *  This allocator is used for giving a vector storage that
+ *  starts on the passed in alignment.
+ ***********************************************************/
+template <typename T, size_t ALIGNMENT>
+class AlignedAllocator
+{
+public:
+	typedef T value_type;
+
+	template <typename U>
+	struct rebind
+	{
+		typedef AlignedAllocator<U, ALIGNMENT> other;
+	};
+
+	AlignedAllocator() {}
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U, ALIGNMENT>&) {}
+
+	// the block is over-allocated and the pointer malloc gave
+	// is kept just in front of the aligned address
+	T* allocate(size_t count)
+	{
+		void* pBlock = malloc(count * sizeof(T) + ALIGNMENT + sizeof(void*));
+		if (NULL == pBlock)
+		{
+			throw std::bad_alloc();
+		}
+
+		uintptr_t address = ((uintptr_t)pBlock + sizeof(void*) + ALIGNMENT - 1) & ~(uintptr_t)(ALIGNMENT - 1);
+		((void**)address)[-1] = pBlock;
+		return((T*)address);
+	}
+
+	void deallocate(T* pData, size_t count)
+	{
+		if (NULL != pData)
+		{
+			free(((void**)pData)[-1]);
+		}
+	}
+
+	template <typename U>
+	bool operator==(const AlignedAllocator<U, ALIGNMENT>&) const { return(true); }
+	template <typename U>
+	bool operator!=(const AlignedAllocator<U, ALIGNMENT>&) const { return(false); }
+};
+
+/***********************************************************
+ *  SceneArray
+ *
+ *  This class is used for one array of object values.  The
+ *  values are either held in its own storage, or in memory
+ *  owned by someone else, such as a mapped scene file, that
+ *  must outlive the array.  Adding a value to the memory of
+ *  someone else first copies it into the own storage.
+ ***********************************************************/
+template <typename T, typename ALLOCATOR = std::allocator<T>>
+class SceneArray
+{
+public:
+	SceneArray() : m_pData(NULL), m_count(0), m_bAttached(false) {}
+
+	T& operator[](size_t index) { return(m_pData[index]); }
+	const T& operator[](size_t index) const { return(m_pData[index]); }
+
+	T* begin() { return(m_pData); }
+	T* end() { return(m_pData + m_count); }
+	const T* begin() const { return(m_pData); }
+	const T* end() const { return(m_pData + m_count); }
+	size_t size() const { return(m_count); }
+
+	void push_back(const T& value)
+	{
+		if (m_bAttached == true)
+		{
+			m_storage.assign(m_pData, m_pData + m_count);
+			m_bAttached = false;
+		}
+		m_storage.push_back(value);
+		m_pData = m_storage.data();
+		m_count = m_storage.size();
+	}
+
+	void clear()
+	{
+		m_storage.clear();
+		m_pData = NULL;
+		m_count = 0;
+		m_bAttached = false;
+	}
+
+	// use values held by someone else in place of the own ones
+	void Attach(T* pData, size_t count)
+	{
+		clear();
+		m_pData = pData;
+		m_count = count;
+		m_bAttached = true;
+	}
+
+private:
+	std::vector<T, ALLOCATOR> m_storage;
+	T* m_pData;
+	size_t m_count;
+	// true when the values are not in the own storage
+	bool m_bAttached;
+
+	// the pointer would be shared by a copy
+	SceneArray(const SceneArray&);
+	SceneArray& operator=(const SceneArray&);
+};
+
+/***********************************************************
+ *  SceneObjects
+ *
+ *  This class contains the arrays of the per-frame object
+ *  values.  The arrays are public so that the frame passes
+ *  can walk them directly, and every array always has one
+ *  entry per object.
+ ***********************************************************/
+class SceneObjects
+{
+public:
+	// constructor
+	SceneObjects();
+	// destructor
+	~SceneObjects();
+
+	typedef SceneArray<glm::mat4, AlignedAllocator<glm::mat4, 16>> MATRIX_ARRAY;
+
+	// transformation values and the model matrix built from them
+	SceneArray<glm::vec3> scales;
+	SceneArray<glm::vec3> rotationsDegrees;
+	SceneArray<glm::vec3> positions;
+	MATRIX_ARRAY models;
+	// world space bounds of the transformed meshes
+	SceneArray<BOUNDING_VOLUME> bounds;
+	// mesh, material and object group of each object
+	SceneArray<MESH_TYPE> meshes;
+	SceneArray<int> materialIndices;
+	SceneArray<int> groups;
+	// level of detail of the mesh that is drawn
+	SceneArray<int> lodLevels;
+	// 1 when the object passed the culling of this frame
+	SceneArray<uint8_t> visible;
+	// 1 when the transformation changed and the model is stale
+	SceneArray<uint8_t> transformDirty;
+
+	// names for debugging, which the frame passes never read -
+	// empty for the objects of a mapped scene file
+	std::vector<std::string> names;
+
+	// add an object with its model matrix and bounds, and
+	// return its index
+	int Add(
+		MESH_TYPE mesh,
+		glm::vec3 scaleXYZ,
+		glm::vec3 rotationDegrees,
+		glm::vec3 positionXYZ,
+		const glm::mat4& model,
+		const BOUNDING_VOLUME& worldBounds,
+		int materialIndex);
+	// use the arrays of a mapped scene file in place of the own
+	// ones, which must stay mapped while the objects are used
+	void Attach(const SceneFile::OBJECT_ARRAYS& arrays, int count);
+	// remove every object
+	void Clear();
+	// get the number of objects
+	int GetCount() const;
+};
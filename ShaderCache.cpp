@@ -0,0 +1,730 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShaderCache.cpp
+// ============
+// keep linked shader programs on disk and rebuild them when edited
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderCache.h"
+#include "TextureCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// "SPRG" at the start of every program binary file
+	const uint32_t g_BinaryMagic = 0x47525053;
+	// how often the watcher checks the source files
+	const int g_WatchMilliseconds = 250;
+	// driver strings that go into the hash of a cache file
+	const GLenum g_DriverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+
+	// the values written ahead of a program binary
+	struct BINARY_HEADER
+	{
+		uint32_t magic;
+		uint32_t format;
+		uint32_t length;
+	};
+
+	/***********************************************************
+	 *  MakeDirectory()
+	 *
+	 *  Create the directory that holds a file if it is missing.
+	 ***********************************************************/
+	void MakeDirectory(const std::string& path)
+	{
+		size_t separator = path.find_last_of("/\\");
+		if (std::string::npos == separator)
+		{
+			return;
+		}
+
+		std::string directory = path.substr(0, separator);
+#ifdef _WIN32
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+	}
+
+	/***********************************************************
+	 *  ElapsedMilliseconds()
+	 *
+	 *  Get the milliseconds since a clock reading.
+	 ***********************************************************/
+	double ElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+	{
+		return(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+}
+
+/***********************************************************
+ *  ShaderCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderCache::ShaderCache(const char* cacheDirectory)
+{
+	m_cacheDirectory = cacheDirectory;
+	m_bRebuilding = false;
+	m_bParallelCompile = false;
+	m_bStopping = false;
+	m_bSourcesChanged = false;
+
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		m_modifiedTimes[stage] = 0;
+	}
+}
+
+/***********************************************************
+ *  ~ShaderCache()
+ *
+ *  The destructor for the class.  The programs belong to the
+ *  OpenGL context and are freed with it.
+ ***********************************************************/
+ShaderCache::~ShaderCache()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_watchMutex);
+		m_bStopping = true;
+	}
+	m_wakeWatcher.notify_all();
+
+	if (m_watcher.joinable() == true)
+	{
+		m_watcher.join();
+	}
+}
+
+/***********************************************************
+ *  IsBinarySupported()
+ *
+ *  This method is used for checking whether the driver can
+ *  hand out the binary of a linked program and load it back.
+ ***********************************************************/
+bool ShaderCache::IsBinarySupported()
+{
+	GLint formatCount = 0;
+
+	if (GLEW_ARB_get_program_binary == false)
+	{
+		return(false);
+	}
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+
+	return(formatCount > 0);
+}
+
+/***********************************************************
+ *  ReadFile()
+ *
+ *  This method is used for reading a whole source file.
+ ***********************************************************/
+bool ShaderCache::ReadFile(const std::string& filename, std::string& contents)
+{
+	std::ifstream file(filename.c_str());
+	if (file.is_open() == false)
+	{
+		std::cout << "Could not open shader:" << filename << std::endl;
+		return(false);
+	}
+
+	std::stringstream source;
+	source << file.rdbuf();
+	contents = source.str();
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetModifiedTime()
+ *
+ *  This method is used for getting when a file was last
+ *  written, which is 0 when the file cannot be found.
+ ***********************************************************/
+time_t ShaderCache::GetModifiedTime(const std::string& filename)
+{
+	struct stat status;
+	if (stat(filename.c_str(), &status) != 0)
+	{
+		return(0);
+	}
+
+	return(status.st_mtime);
+}
+
+/***********************************************************
+ *  InjectDefines()
+ *
+ *  This method is used for placing the #define lines of a
+ *  variant right after the #version line, which must stay
+ *  the first line of the source.
+ ***********************************************************/
+std::string ShaderCache::InjectDefines(const std::string& source, const std::string& defines)
+{
+	if (defines.empty() == true)
+	{
+		return(source);
+	}
+
+	size_t version = source.find("#version");
+	size_t lineEnd = (std::string::npos != version) ? source.find('\n', version) : std::string::npos;
+	if (std::string::npos == lineEnd)
+	{
+		return(defines + source);
+	}
+
+	return(source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1));
+}
+
+/***********************************************************
+ *  GetCachePath()
+ *
+ *  This method is used for getting the cache file for the
+ *  sources of the program.  The hash also covers the driver
+ *  strings, since a binary only loads on the driver that
+ *  made it.
+ ***********************************************************/
+std::string ShaderCache::GetCachePath(const std::string sources[TOTAL_STAGES]) const
+{
+	std::string key;
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		key += sources[stage];
+		key += '\0';
+	}
+	for (int i = 0; i < (int)(sizeof(g_DriverStrings) / sizeof(g_DriverStrings[0])); i++)
+	{
+		const GLubyte* pValue = glGetString(g_DriverStrings[i]);
+		if (NULL != pValue)
+		{
+			key += (const char*)pValue;
+		}
+		key += '\0';
+	}
+
+	char name[64];
+	snprintf(
+		name,
+		sizeof(name),
+		"%016llx.bin",
+		(unsigned long long)TextureCache::HashData((const unsigned char*)key.data(), key.size()));
+
+	return(m_cacheDirectory + "/" + name);
+}
+
+/***********************************************************
+ *  LoadBinary()
+ *
+ *  This method is used for creating a program from a cached
+ *  binary.  A missing file, or one the driver will not link,
+ *  gives 0 so the program is built from its sources.
+ ***********************************************************/
+GLuint ShaderCache::LoadBinary(const std::string& path)
+{
+	if (IsBinarySupported() == false)
+	{
+		return(0);
+	}
+
+	FILE* file = fopen(path.c_str(), "rb");
+	if (NULL == file)
+	{
+		return(0);
+	}
+
+	BINARY_HEADER header;
+	std::vector<unsigned char> binary;
+	bool bValid =
+		(fread(&header, sizeof(header), 1, file) == 1) &&
+		(header.magic == g_BinaryMagic) &&
+		(header.length > 0);
+	if (bValid == true)
+	{
+		binary.resize(header.length);
+		bValid = (fread(&binary[0], header.length, 1, file) == 1);
+	}
+	fclose(file);
+
+	if (bValid == false)
+	{
+		return(0);
+	}
+
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, header.format, &binary[0], (GLsizei)header.length);
+
+	GLint bLinked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &bLinked);
+	if (GL_TRUE != bLinked)
+	{
+		std::cout << "Cached shader program was rejected by the driver, rebuilding:" << path << std::endl;
+		glDeleteProgram(program);
+		return(0);
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  SaveBinary()
+ *
+ *  This method is used for writing the binary of a linked
+ *  program into its cache file.
+ ***********************************************************/
+bool ShaderCache::SaveBinary(GLuint program, const std::string& path)
+{
+	if (IsBinarySupported() == false)
+	{
+		return(false);
+	}
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+	{
+		return(false);
+	}
+
+	BINARY_HEADER header;
+	GLenum format = 0;
+	GLsizei written = 0;
+	std::vector<unsigned char> binary(length);
+	glGetProgramBinary(program, length, &written, &format, &binary[0]);
+
+	header.magic = g_BinaryMagic;
+	header.format = format;
+	header.length = (uint32_t)written;
+
+	MakeDirectory(path);
+	FILE* file = fopen(path.c_str(), "wb");
+	if (NULL == file)
+	{
+		std::cout << "Could not write shader cache:" << path << std::endl;
+		return(false);
+	}
+
+	bool bWritten =
+		(fwrite(&header, sizeof(header), 1, file) == 1) &&
+		(fwrite(&binary[0], written, 1, file) == 1);
+	fclose(file);
+
+	return(bWritten);
+}
+
+/***********************************************************
+ *  StartBuild()
+ *
+ *  This method is used for compiling each stage and linking
+ *  them into a new program.  With parallel compiling the
+ *  calls return before the driver is done, so the result is
+ *  only checked by FinishBuild().
+ ***********************************************************/
+GLuint ShaderCache::StartBuild(const std::string sources[TOTAL_STAGES], GLuint shaders[TOTAL_STAGES])
+{
+	const GLenum shaderTypes[TOTAL_STAGES] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+	GLuint program = glCreateProgram();
+
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		const char* pSource = sources[stage].c_str();
+
+		shaders[stage] = glCreateShader(shaderTypes[stage]);
+		glShaderSource(shaders[stage], 1, &pSource, NULL);
+		glCompileShader(shaders[stage]);
+		glAttachShader(program, shaders[stage]);
+	}
+
+	// the driver only keeps a binary it was asked to keep
+	if (IsBinarySupported() == true)
+	{
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	glLinkProgram(program);
+
+	return(program);
+}
+
+/***********************************************************
+ *  FinishBuild()
+ *
+ *  This method is used for checking that each stage compiled
+ *  and the program linked, writing the log of any that did
+ *  not.  The stages are freed either way, and the program is
+ *  freed when the build failed.
+ ***********************************************************/
+bool ShaderCache::FinishBuild(GLuint program, GLuint shaders[TOTAL_STAGES])
+{
+	char log[1024];
+	GLint bSuccess = GL_FALSE;
+	bool bBuilt = true;
+
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		glGetShaderiv(shaders[stage], GL_COMPILE_STATUS, &bSuccess);
+		if (GL_TRUE != bSuccess)
+		{
+			glGetShaderInfoLog(shaders[stage], sizeof(log), NULL, log);
+			std::cout << "Could not compile shader:" << m_filenames[stage] << "\n" << log << std::endl;
+			bBuilt = false;
+		}
+	}
+
+	if (bBuilt == true)
+	{
+		glGetProgramiv(program, GL_LINK_STATUS, &bSuccess);
+		if (GL_TRUE != bSuccess)
+		{
+			glGetProgramInfoLog(program, sizeof(log), NULL, log);
+			std::cout << "Could not link shader program:\n" << log << std::endl;
+			bBuilt = false;
+		}
+	}
+
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		glDetachShader(program, shaders[stage]);
+		glDeleteShader(shaders[stage]);
+		shaders[stage] = 0;
+	}
+	if (bBuilt == false)
+	{
+		glDeleteProgram(program);
+	}
+
+	return(bBuilt);
+}
+
+/***********************************************************
+ *  LoadVariantProgram()
+ *
+ *  This method is used for getting the program for one set
+ *  of defines.  The cached binary for the sources is used
+ *  when there is one, and otherwise the program is built and
+ *  its binary is saved for the next run.  0 means it could
+ *  not be built.
+ ***********************************************************/
+GLuint ShaderCache::LoadVariantProgram(const std::string sources[TOTAL_STAGES], const std::string& defines)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::string variantSources[TOTAL_STAGES];
+
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		variantSources[stage] = InjectDefines(sources[stage], defines);
+	}
+
+	std::string cachePath = GetCachePath(variantSources);
+	GLuint program = LoadBinary(cachePath);
+	if (0 != program)
+	{
+		std::cout << "INFO: Shader program loaded from the cache in " << ElapsedMilliseconds(start) << " ms" << std::endl;
+		return(program);
+	}
+
+	GLuint shaders[TOTAL_STAGES];
+	program = StartBuild(variantSources, shaders);
+	if (FinishBuild(program, shaders) == false)
+	{
+		return(0);
+	}
+	SaveBinary(program, cachePath);
+	std::cout << "INFO: Shader program built in " << ElapsedMilliseconds(start) << " ms" << std::endl;
+
+	return(program);
+}
+
+/***********************************************************
+ *  LoadProgram()
+ *
+ *  This method is used for reading the source files and
+ *  getting the plain program, without any defines, from the
+ *  cache or by building it.  0 means it could not be built.
+ ***********************************************************/
+GLuint ShaderCache::LoadProgram(const char* vertexFilename, const char* fragmentFilename)
+{
+	m_filenames[VERTEX_STAGE] = vertexFilename;
+	m_filenames[FRAGMENT_STAGE] = fragmentFilename;
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		m_modifiedTimes[stage] = GetModifiedTime(m_filenames[stage]);
+		if (ReadFile(m_filenames[stage], m_sources[stage]) == false)
+		{
+			return(0);
+		}
+	}
+
+	m_variants.clear();
+	GLuint program = LoadVariantProgram(m_sources, "");
+	if (0 != program)
+	{
+		AddVariant("", program);
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  LoadVariant()
+ *
+ *  This method is used for getting a variant of the program
+ *  with a block of #define lines, so the shader can compile
+ *  out the cases the variant never has.  The variant is kept
+ *  and rebuilt with the others when the sources are edited.
+ ***********************************************************/
+int ShaderCache::LoadVariant(const std::string& defines)
+{
+	// variants are made from the sources of the plain program
+	if ((m_variants.empty() == true) || (m_bRebuilding == true))
+	{
+		return(-1);
+	}
+
+	GLuint program = LoadVariantProgram(m_sources, defines);
+	if (0 == program)
+	{
+		return(-1);
+	}
+
+	return(AddVariant(defines, program));
+}
+
+/***********************************************************
+ *  AddVariant()
+ *
+ *  This method is used for keeping a built program with the
+ *  defines it was built from, which returns its index.
+ ***********************************************************/
+int ShaderCache::AddVariant(const std::string& defines, GLuint program)
+{
+	VARIANT variant;
+	variant.defines = defines;
+	variant.program = program;
+	variant.pendingProgram = 0;
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		variant.pendingShaders[stage] = 0;
+	}
+	m_variants.push_back(variant);
+
+	return((int)m_variants.size() - 1);
+}
+
+/***********************************************************
+ *  StartWatching()
+ *
+ *  This method is used for starting the thread that checks
+ *  the source files, so an edited shader is rebuilt while
+ *  the application runs.
+ ***********************************************************/
+void ShaderCache::StartWatching()
+{
+	if (m_watcher.joinable() == true)
+	{
+		return;
+	}
+
+	// let the driver compile the rebuilt programs on its own
+	// threads, so a frame never waits on the compiler
+	m_bParallelCompile = GLEW_KHR_parallel_shader_compile;
+	if (m_bParallelCompile == true)
+	{
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+	}
+
+	m_watcher = std::thread(&ShaderCache::WatchFiles, this);
+}
+
+/***********************************************************
+ *  WatchFiles()
+ *
+ *  This method is run on the watcher thread.  It compares the
+ *  write time of each source file with the last one seen, and
+ *  flags the program for a rebuild when any changed.  Files
+ *  are only read by the thread rebuilding the program.
+ ***********************************************************/
+void ShaderCache::WatchFiles()
+{
+	std::unique_lock<std::mutex> lock(m_watchMutex);
+
+	while (m_bStopping == false)
+	{
+		m_wakeWatcher.wait_for(lock, std::chrono::milliseconds(g_WatchMilliseconds));
+
+		for (int stage = 0; stage < TOTAL_STAGES; stage++)
+		{
+			time_t modifiedTime = GetModifiedTime(m_filenames[stage]);
+			if ((0 != modifiedTime) && (modifiedTime != m_modifiedTimes[stage]))
+			{
+				m_modifiedTimes[stage] = modifiedTime;
+				m_bSourcesChanged = true;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  StartRebuild()
+ *
+ *  This method is used for reading the edited sources and
+ *  starting to build every variant from them.
+ ***********************************************************/
+void ShaderCache::StartRebuild()
+{
+	std::string sources[TOTAL_STAGES];
+
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		if (ReadFile(m_filenames[stage], sources[stage]) == false)
+		{
+			return;
+		}
+	}
+
+	std::cout << "INFO: Shader source changed, rebuilding the programs" << std::endl;
+	for (int index = 0; index < m_variants.size(); index++)
+	{
+		VARIANT& variant = m_variants[index];
+		std::string variantSources[TOTAL_STAGES];
+
+		for (int stage = 0; stage < TOTAL_STAGES; stage++)
+		{
+			variantSources[stage] = InjectDefines(sources[stage], variant.defines);
+		}
+		variant.pendingCachePath = GetCachePath(variantSources);
+		variant.pendingProgram = StartBuild(variantSources, variant.pendingShaders);
+	}
+
+	for (int stage = 0; stage < TOTAL_STAGES; stage++)
+	{
+		m_sources[stage] = sources[stage];
+	}
+	m_bRebuilding = true;
+}
+
+/***********************************************************
+ *  CancelRebuild()
+ *
+ *  This method is used for freeing the programs of a rebuild
+ *  that failed, so every variant keeps the program in use.
+ ***********************************************************/
+void ShaderCache::CancelRebuild()
+{
+	for (int index = 0; index < m_variants.size(); index++)
+	{
+		if (0 != m_variants[index].pendingProgram)
+		{
+			glDeleteProgram(m_variants[index].pendingProgram);
+			m_variants[index].pendingProgram = 0;
+		}
+	}
+	m_bRebuilding = false;
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for moving a rebuild along and is
+ *  called once a frame on the thread with the OpenGL context.
+ *  Programs still being compiled by the driver are left for
+ *  a later frame.  Once they are all done they replace the
+ *  programs in use together, or are dropped with their logs
+ *  when any failed, so a typo never leaves the scene without
+ *  a program.
+ ***********************************************************/
+bool ShaderCache::Update()
+{
+	if (m_bRebuilding == false)
+	{
+		if (m_bSourcesChanged.exchange(false) == true)
+		{
+			StartRebuild();
+		}
+		return(false);
+	}
+
+	if (m_bParallelCompile == true)
+	{
+		for (int index = 0; index < m_variants.size(); index++)
+		{
+			GLint bCompleted = GL_FALSE;
+			glGetProgramiv(m_variants[index].pendingProgram, GL_COMPLETION_STATUS_KHR, &bCompleted);
+			if (GL_FALSE == bCompleted)
+			{
+				return(false);
+			}
+		}
+	}
+
+	bool bBuilt = true;
+	for (int index = 0; index < m_variants.size(); index++)
+	{
+		VARIANT& variant = m_variants[index];
+		if (FinishBuild(variant.pendingProgram, variant.pendingShaders) == false)
+		{
+			// the failed program was freed by FinishBuild()
+			variant.pendingProgram = 0;
+			bBuilt = false;
+		}
+	}
+	if (bBuilt == false)
+	{
+		std::cout << "Keeping the last shader programs" << std::endl;
+		CancelRebuild();
+		return(false);
+	}
+
+	for (int index = 0; index < m_variants.size(); index++)
+	{
+		VARIANT& variant = m_variants[index];
+
+		SaveBinary(variant.pendingProgram, variant.pendingCachePath);
+		glDeleteProgram(variant.program);
+		variant.program = variant.pendingProgram;
+		variant.pendingProgram = 0;
+	}
+	m_bRebuilding = false;
+	std::cout << "INFO: Shader programs reloaded" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsUpdatePending()
+ *
+ *  This method is used for checking whether a source file
+ *  was edited and the rebuilt programs have not been swapped
+ *  in by Update() yet.
+ ***********************************************************/
+bool ShaderCache::IsUpdatePending() const
+{
+	return((m_bRebuilding == true) || (m_bSourcesChanged.load() == true));
+}
+
+/***********************************************************
+ *  GetProgram()
+ *
+ *  This method is used for getting the program in use for a
+ *  variant, which is 0 when there is no such variant.
+ ***********************************************************/
+GLuint ShaderCache::GetProgram(int variant) const
+{
+	if ((variant < 0) || (variant >= m_variants.size()))
+	{
+		return(0);
+	}
+
+	return(m_variants[variant].program);
+}
@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShaderCache.h
+// ============
+// keep linked shader programs on disk and rebuild them when edited
+//
+//  Linking the scene program from GLSL takes hundreds of milliseconds on
+//  some drivers.  Once it is linked, the driver's binary of the program is
+//  saved in a file named after a hash of the sources and the driver
+//  strings, so later runs load it without compiling anything.  An updated
+//  driver or an edited source gets a new hash, and a binary the driver
+//  rejects is simply rebuilt.  During development a watcher thread checks
+//  the source files, and an edited program is rebuilt while the old one
+//  keeps drawing, on the driver's own threads when it offers them.
+//  Variants of the program are built from the same files with a block of
+//  #defines placed after the #version line, and are cached and rebuilt
+//  along with it.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  ShaderCache
+ *
+ *  This class contains the code for loading, saving and
+ *  rebuilding the scene shader program.
+ ***********************************************************/
+class ShaderCache
+{
+public:
+	// constructor
+	ShaderCache(const char* cacheDirectory);
+	// destructor
+	~ShaderCache();
+
+private:
+	// the shader stages of the program
+	enum SHADER_STAGE
+	{
+		VERTEX_STAGE = 0,
+		FRAGMENT_STAGE,
+		TOTAL_STAGES
+	};
+
+	// one build of the program - variant 0 has no defines
+	struct VARIANT
+	{
+		std::string defines;
+		// the program in use
+		GLuint program;
+		// program being rebuilt from edited sources, 0 when
+		// none, and the cache file it is saved to once linked
+		GLuint pendingProgram;
+		GLuint pendingShaders[TOTAL_STAGES];
+		std::string pendingCachePath;
+	};
+
+	// directory holding the program binaries
+	std::string m_cacheDirectory;
+	// source file of each stage, when it was last changed and
+	// the source the programs in use were built from
+	std::string m_filenames[TOTAL_STAGES];
+	time_t m_modifiedTimes[TOTAL_STAGES];
+	std::string m_sources[TOTAL_STAGES];
+	// every build of the program, with the plain one first
+	std::vector<VARIANT> m_variants;
+	// true while the variants are being rebuilt
+	bool m_bRebuilding;
+	// true when the driver compiles on its own threads
+	bool m_bParallelCompile;
+
+	// thread checking the source files for edits
+	std::thread m_watcher;
+	std::mutex m_watchMutex;
+	std::condition_variable m_wakeWatcher;
+	bool m_bStopping;
+	// set by the watcher once a source file changed
+	std::atomic<bool> m_bSourcesChanged;
+
+	// read a whole source file
+	static bool ReadFile(const std::string& filename, std::string& contents);
+	// get when a file was last changed, or 0 when it is missing
+	static time_t GetModifiedTime(const std::string& filename);
+	// place the defines of a variant after the #version line
+	static std::string InjectDefines(const std::string& source, const std::string& defines);
+	// get the cache file for the sources on this driver
+	std::string GetCachePath(const std::string sources[TOTAL_STAGES]) const;
+
+	// create a program from a cached binary, 0 when there is none
+	GLuint LoadBinary(const std::string& path);
+	// write the binary of a linked program into a cache file
+	bool SaveBinary(GLuint program, const std::string& path);
+	// start compiling the stages and linking them into a program
+	GLuint StartBuild(const std::string sources[TOTAL_STAGES], GLuint shaders[TOTAL_STAGES]);
+	// check a started build, freeing it when it failed
+	bool FinishBuild(GLuint program, GLuint shaders[TOTAL_STAGES]);
+	// load or build one variant from the passed in sources
+	GLuint LoadVariantProgram(const std::string sources[TOTAL_STAGES], const std::string& defines);
+	// keep a built variant, which returns its index
+	int AddVariant(const std::string& defines, GLuint program);
+	// start rebuilding every variant from the edited sources
+	void StartRebuild();
+	// free the rebuilt programs, keeping the ones in use
+	void CancelRebuild();
+
+	// check the source files until stopped
+	void WatchFiles();
+
+public:
+	// load the program from the cache, or build it and save it
+	GLuint LoadProgram(const char* vertexFilename, const char* fragmentFilename);
+	// load or build a variant with a block of #define lines,
+	// which returns its index or -1 when it could not be built
+	int LoadVariant(const std::string& defines);
+	// start checking the source files for edits
+	void StartWatching();
+	// start or finish a rebuild, which returns true once the
+	// edited programs have replaced the old ones
+	bool Update();
+	// true when an edit is waiting to be built or swapped in
+	bool IsUpdatePending() const;
+
+	// get the program in use for a variant, 0 being the plain one
+	GLuint GetProgram(int variant = 0) const;
+	// true when the driver can save and load program binaries
+	static bool IsBinarySupported();
+};
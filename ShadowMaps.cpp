@@ -0,0 +1,471 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShadowMaps.cpp
+// ============
+// cache the cascaded shadow maps of the directional light
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShadowMaps.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// view depth the last cascade ends at
+	const float g_ShadowDistance = 40.0f;
+	// closest depth the split scheme starts at, so an orthographic
+	// view with its near plane at or behind the camera still splits
+	const float g_MinSplitDepth = 0.1f;
+	// blend between the log and the even split of the depth, the
+	// log split gives the near cascades more of the texels
+	const float g_SplitBlend = 0.75f;
+	// the cascade spheres grow in steps so floating point noise as
+	// the camera turns never moves a cascade
+	const float g_RadiusSteps = 8.0f;
+	// texels the cascade centers snap by, which the cascades are
+	// padded with so the view stays inside while it travels a step
+	const int g_SnapTexels = 64;
+	// depth added in front of and behind the scene bounds, and the
+	// depth ranges are rounded out to whole units
+	const float g_DepthPadding = 1.0f;
+	// texels around a moved caster that are also drawn again, for
+	// the filter taps of the lighting shader
+	const float g_FilterTexels = 2.0f;
+}
+
+/***********************************************************
+ *  ShadowMaps()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShadowMaps::ShadowMaps()
+{
+	m_depthTexture = 0;
+	for (int i = 0; i < CASCADE_COUNT; i++)
+	{
+		m_framebuffers[i] = 0;
+		m_cascades[i].lightView = glm::mat4(1.0f);
+		m_cascades[i].lightProjection = glm::mat4(1.0f);
+		m_cascades[i].lightViewProjection = glm::mat4(1.0f);
+		m_cascades[i].splitDepth = 0.0f;
+		m_cascades[i].center = glm::vec2(0.0f);
+		m_cascades[i].halfSize = 0.0f;
+		m_cascades[i].nearDepth = 0.0f;
+		m_cascades[i].farDepth = 0.0f;
+		InvalidateCascade(i);
+	}
+	m_lightRotation = glm::mat4(1.0f);
+	m_bFitted = false;
+	m_savedFramebuffer = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		m_savedViewport[i] = 0;
+	}
+	m_bSavedScissor = GL_FALSE;
+}
+
+/***********************************************************
+ *  ~ShadowMaps()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShadowMaps::~ShadowMaps()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the depth texture array
+ *  with a layer per cascade, and a framebuffer that draws
+ *  into each layer.  The texture compares the depth as it is
+ *  sampled, and everything outside of it is lit.
+ ***********************************************************/
+bool ShadowMaps::Initialize()
+{
+	glGenTextures(1, &m_depthTexture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_depthTexture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, MAP_SIZE, MAP_SIZE, CASCADE_COUNT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	const float border[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	GLint currentFramebuffer = 0;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &currentFramebuffer);
+
+	bool bComplete = true;
+	glGenFramebuffers(CASCADE_COUNT, m_framebuffers);
+	for (int i = 0; i < CASCADE_COUNT; i++)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[i]);
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_depthTexture, 0, i);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			bComplete = false;
+		}
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)currentFramebuffer);
+
+	if (bComplete == false)
+	{
+		std::cout << "Could not create the shadow map framebuffers" << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the depth texture array
+ *  and the framebuffers.
+ ***********************************************************/
+void ShadowMaps::Destroy()
+{
+	if (0 != m_framebuffers[0])
+	{
+		glDeleteFramebuffers(CASCADE_COUNT, m_framebuffers);
+		for (int i = 0; i < CASCADE_COUNT; i++)
+		{
+			m_framebuffers[i] = 0;
+		}
+	}
+	if (0 != m_depthTexture)
+	{
+		glDeleteTextures(1, &m_depthTexture);
+		m_depthTexture = 0;
+	}
+	m_bFitted = false;
+}
+
+/***********************************************************
+ *  SetLightDirection()
+ *
+ *  This method is used for setting the direction the light
+ *  shines in.  Every cascade is drawn again on the next fit.
+ ***********************************************************/
+void ShadowMaps::SetLightDirection(const glm::vec3& direction)
+{
+	glm::vec3 forward = glm::normalize(direction);
+	glm::vec3 up = (std::fabs(forward.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+	m_lightRotation = glm::lookAt(glm::vec3(0.0f), forward, up);
+	m_bFitted = false;
+}
+
+/***********************************************************
+ *  FitCascades()
+ *
+ *  This method is used for splitting the view out to the
+ *  shadow distance and fitting a cascade around each slice.
+ *  Each slice gets the sphere around its corners, which has
+ *  the same size however the camera turns, and the center is
+ *  snapped to a grid of texels in light space so the shadow
+ *  edges do not crawl.  The depth range covers the whole
+ *  scene, so casters outside of the view still cast into it.
+ *  A cascade whose bounds changed is drawn again in full.
+ ***********************************************************/
+void ShadowMaps::FitCascades(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const BOUNDING_VOLUME& sceneBounds)
+{
+	// read the clip planes back out of the projection
+	float nearDepth = 0.0f;
+	float farDepth = 0.0f;
+	if (projection[2][3] != 0.0f)
+	{
+		nearDepth = projection[3][2] / (projection[2][2] - 1.0f);
+		farDepth = projection[3][2] / (projection[2][2] + 1.0f);
+	}
+	else
+	{
+		nearDepth = (projection[3][2] + 1.0f) / projection[2][2];
+		farDepth = (projection[3][2] - 1.0f) / projection[2][2];
+	}
+	float splitNear = std::max(nearDepth, g_MinSplitDepth);
+	float shadowDistance = std::max(std::min(farDepth, g_ShadowDistance), splitNear * 2.0f);
+
+	// the corners of the view on its near and far planes, which the
+	// view depth changes evenly between
+	glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+	glm::vec3 nearCorners[4];
+	glm::vec3 farCorners[4];
+	for (int i = 0; i < 4; i++)
+	{
+		float x = ((i & 1) == 0) ? -1.0f : 1.0f;
+		float y = ((i & 2) == 0) ? -1.0f : 1.0f;
+		glm::vec4 nearCorner = inverseViewProjection * glm::vec4(x, y, -1.0f, 1.0f);
+		glm::vec4 farCorner = inverseViewProjection * glm::vec4(x, y, 1.0f, 1.0f);
+		nearCorners[i] = glm::vec3(nearCorner) / nearCorner.w;
+		farCorners[i] = glm::vec3(farCorner) / farCorner.w;
+	}
+
+	// the depth range of the scene along the light, rounded out so
+	// a caster moving inside the scene leaves the cascades alone
+	glm::vec3 sceneCenter = glm::vec3(m_lightRotation * glm::vec4(sceneBounds.center, 1.0f));
+	float lightNear = std::floor(-sceneCenter.z - sceneBounds.radius - g_DepthPadding);
+	float lightFar = std::ceil(-sceneCenter.z + sceneBounds.radius + g_DepthPadding);
+
+	float sliceStart = nearDepth;
+	for (int cascade = 0; cascade < CASCADE_COUNT; cascade++)
+	{
+		float ratio = (float)(cascade + 1) / CASCADE_COUNT;
+		float logSplit = splitNear * std::pow(shadowDistance / splitNear, ratio);
+		float evenSplit = splitNear + (shadowDistance - splitNear) * ratio;
+		float sliceEnd = g_SplitBlend * logSplit + (1.0f - g_SplitBlend) * evenSplit;
+
+		// the corners of the slice and the sphere around them
+		float startRatio = (sliceStart - nearDepth) / (farDepth - nearDepth);
+		float endRatio = (sliceEnd - nearDepth) / (farDepth - nearDepth);
+		glm::vec3 corners[8];
+		glm::vec3 centroid(0.0f);
+		for (int i = 0; i < 4; i++)
+		{
+			glm::vec3 edge = farCorners[i] - nearCorners[i];
+			corners[i] = nearCorners[i] + edge * startRatio;
+			corners[i + 4] = nearCorners[i] + edge * endRatio;
+			centroid += corners[i] + corners[i + 4];
+		}
+		centroid = centroid / 8.0f;
+		float radius = 0.0f;
+		for (int i = 0; i < 8; i++)
+		{
+			radius = std::max(radius, glm::length(corners[i] - centroid));
+		}
+		radius = std::ceil(radius * g_RadiusSteps) / g_RadiusSteps;
+
+		// snap the center in light space and pad the cascade by the
+		// snap step so the sphere always stays inside
+		float texelSize = 2.0f * radius / (MAP_SIZE - 2 * g_SnapTexels);
+		float snapStep = g_SnapTexels * texelSize;
+		float halfSize = radius + snapStep;
+		glm::vec3 lightCenter = glm::vec3(m_lightRotation * glm::vec4(centroid, 1.0f));
+		glm::vec2 center(
+			std::floor(lightCenter.x / snapStep + 0.5f) * snapStep,
+			std::floor(lightCenter.y / snapStep + 0.5f) * snapStep);
+
+		CASCADE& fitted = m_cascades[cascade];
+		fitted.splitDepth = sliceEnd;
+		sliceStart = sliceEnd;
+
+		if ((m_bFitted == true) &&
+			(fitted.center == center) &&
+			(fitted.halfSize == halfSize) &&
+			(fitted.nearDepth == lightNear) &&
+			(fitted.farDepth == lightFar))
+		{
+			continue;
+		}
+
+		fitted.center = center;
+		fitted.halfSize = halfSize;
+		fitted.nearDepth = lightNear;
+		fitted.farDepth = lightFar;
+		fitted.lightView = glm::translate(glm::vec3(-center.x, -center.y, 0.0f)) * m_lightRotation;
+		fitted.lightProjection = glm::ortho(-halfSize, halfSize, -halfSize, halfSize, lightNear, lightFar);
+		fitted.lightViewProjection = fitted.lightProjection * fitted.lightView;
+		InvalidateCascade(cascade);
+	}
+
+	m_bFitted = true;
+}
+
+/***********************************************************
+ *  InvalidateCascade()
+ *
+ *  This method is used for flagging every texel of a cascade
+ *  as stale.
+ ***********************************************************/
+void ShadowMaps::InvalidateCascade(int cascade)
+{
+	m_cascades[cascade].dirtyMin[0] = 0;
+	m_cascades[cascade].dirtyMin[1] = 0;
+	m_cascades[cascade].dirtyMax[0] = MAP_SIZE;
+	m_cascades[cascade].dirtyMax[1] = MAP_SIZE;
+}
+
+/***********************************************************
+ *  InvalidateBounds()
+ *
+ *  This method is used for flagging the texels that a caster
+ *  covers as seen from the light.  A moved caster is passed
+ *  in at both the bounds it left and the ones it moved to, so
+ *  its old shadow is cleared and its new one is drawn.
+ ***********************************************************/
+void ShadowMaps::InvalidateBounds(const BOUNDING_VOLUME& bounds)
+{
+	if (m_bFitted == false)
+	{
+		return;
+	}
+
+	for (int cascade = 0; cascade < CASCADE_COUNT; cascade++)
+	{
+		CASCADE& fitted = m_cascades[cascade];
+
+		glm::vec3 center = glm::vec3(fitted.lightView * glm::vec4(bounds.center, 1.0f));
+		float texelsPerUnit = MAP_SIZE / (2.0f * fitted.halfSize);
+		float x = (center.x + fitted.halfSize) * texelsPerUnit;
+		float y = (center.y + fitted.halfSize) * texelsPerUnit;
+		float radius = bounds.radius * texelsPerUnit + g_FilterTexels;
+
+		int minX = std::max((int)std::floor(x - radius), 0);
+		int minY = std::max((int)std::floor(y - radius), 0);
+		int maxX = std::min((int)std::ceil(x + radius), MAP_SIZE);
+		int maxY = std::min((int)std::ceil(y + radius), MAP_SIZE);
+		if ((minX >= maxX) || (minY >= maxY))
+		{
+			continue;
+		}
+
+		fitted.dirtyMin[0] = std::min(fitted.dirtyMin[0], minX);
+		fitted.dirtyMin[1] = std::min(fitted.dirtyMin[1], minY);
+		fitted.dirtyMax[0] = std::max(fitted.dirtyMax[0], maxX);
+		fitted.dirtyMax[1] = std::max(fitted.dirtyMax[1], maxY);
+	}
+}
+
+/***********************************************************
+ *  IsDirty()
+ *
+ *  This method is used for checking whether any cascade has
+ *  texels that must be drawn again.
+ ***********************************************************/
+bool ShadowMaps::IsDirty() const
+{
+	for (int cascade = 0; cascade < CASCADE_COUNT; cascade++)
+	{
+		if (IsCascadeDirty(cascade) == true)
+		{
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  IsCascadeDirty()
+ *
+ *  This method is used for checking whether a cascade has
+ *  texels that must be drawn again.
+ ***********************************************************/
+bool ShadowMaps::IsCascadeDirty(int cascade) const
+{
+	const CASCADE& fitted = m_cascades[cascade];
+
+	return((fitted.dirtyMin[0] < fitted.dirtyMax[0]) &&
+		(fitted.dirtyMin[1] < fitted.dirtyMax[1]));
+}
+
+/***********************************************************
+ *  BeginCascades()
+ *
+ *  This method is used for saving the framebuffer, viewport
+ *  and scissor test that the cascades draw over.
+ ***********************************************************/
+void ShadowMaps::BeginCascades()
+{
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_savedFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, m_savedViewport);
+	m_bSavedScissor = glIsEnabled(GL_SCISSOR_TEST);
+}
+
+/***********************************************************
+ *  BeginCascade()
+ *
+ *  This method is used for binding the layer of a cascade
+ *  and clearing its stale texels.  When only part of it is
+ *  stale, the scissor test keeps the draws that follow to
+ *  that part, and the rest of the layer is kept.
+ ***********************************************************/
+void ShadowMaps::BeginCascade(int cascade)
+{
+	CASCADE& fitted = m_cascades[cascade];
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[cascade]);
+	glViewport(0, 0, MAP_SIZE, MAP_SIZE);
+
+	bool bWhole = (fitted.dirtyMin[0] == 0) && (fitted.dirtyMin[1] == 0) &&
+		(fitted.dirtyMax[0] == MAP_SIZE) && (fitted.dirtyMax[1] == MAP_SIZE);
+	if (bWhole == true)
+	{
+		glDisable(GL_SCISSOR_TEST);
+	}
+	else
+	{
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(
+			fitted.dirtyMin[0],
+			fitted.dirtyMin[1],
+			fitted.dirtyMax[0] - fitted.dirtyMin[0],
+			fitted.dirtyMax[1] - fitted.dirtyMin[1]);
+	}
+	glClear(GL_DEPTH_BUFFER_BIT);
+
+	// the cascade is up to date once the caller has drawn into it
+	fitted.dirtyMin[0] = MAP_SIZE;
+	fitted.dirtyMin[1] = MAP_SIZE;
+	fitted.dirtyMax[0] = 0;
+	fitted.dirtyMax[1] = 0;
+}
+
+/***********************************************************
+ *  EndCascades()
+ *
+ *  This method is used for putting back the framebuffer,
+ *  viewport and scissor test saved by BeginCascades().
+ ***********************************************************/
+void ShadowMaps::EndCascades()
+{
+	if (m_bSavedScissor == GL_TRUE)
+	{
+		glEnable(GL_SCISSOR_TEST);
+	}
+	else
+	{
+		glDisable(GL_SCISSOR_TEST);
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)m_savedFramebuffer);
+	glViewport(m_savedViewport[0], m_savedViewport[1], m_savedViewport[2], m_savedViewport[3]);
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for binding the depth texture array
+ *  on the texture unit the lighting shader samples it from.
+ ***********************************************************/
+void ShadowMaps::BindTexture()
+{
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_depthTexture);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  GetCascade()
+ *
+ *  This method is used for getting a cascade as fitted to
+ *  the camera.
+ ***********************************************************/
+const ShadowMaps::CASCADE& ShadowMaps::GetCascade(int cascade) const
+{
+	return(m_cascades[cascade]);
+}
@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShadowMaps.h
+// ============
+// cache the cascaded shadow maps of the directional light
+//
+//  The view out to the shadow distance is split into cascades, and each
+//  one gets a layer of a depth texture array drawn from the light.  The
+//  cascades are fitted to spheres snapped to a coarse grid of texels, so
+//  they only move once the camera has travelled a step.  A cascade is
+//  drawn again when it moves, and otherwise only the texels under the
+//  objects that moved are cleared and drawn again, so a still camera over
+//  a still scene draws no shadows at all.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ViewFrustum.h"
+
+/***********************************************************
+ *  ShadowMaps
+ *
+ *  This class contains the code for fitting the cascades to
+ *  the camera and tracking which parts of them are stale.
+ *  The casters are drawn by the caller between the calls
+ *  that bind each cascade.
+ ***********************************************************/
+class ShadowMaps
+{
+public:
+	// constructor
+	ShadowMaps();
+	// destructor
+	~ShadowMaps();
+
+	// number of cascades and the size of each layer - the count
+	// must match the define in fragmentShader.glsl
+	static const int CASCADE_COUNT = 3;
+	static const int MAP_SIZE = 2048;
+	// texture unit of the shadow map, above the texture arrays
+	static const int TEXTURE_UNIT = 15;
+
+	// one cascade as fitted to the camera
+	struct CASCADE
+	{
+		glm::mat4 lightView;
+		glm::mat4 lightProjection;
+		glm::mat4 lightViewProjection;
+		// view depth the cascade covers out to
+		float splitDepth;
+		// snapped light space center, half size and depth range,
+		// which change only when the cascade moves
+		glm::vec2 center;
+		float halfSize;
+		float nearDepth;
+		float farDepth;
+		// texels that must be drawn again, empty when the minimum
+		// is not below the maximum
+		int dirtyMin[2];
+		int dirtyMax[2];
+	};
+
+private:
+	GLuint m_depthTexture;
+	GLuint m_framebuffers[CASCADE_COUNT];
+	CASCADE m_cascades[CASCADE_COUNT];
+	// rotation from world space into light space
+	glm::mat4 m_lightRotation;
+	// true once the cascades were fitted at least one time
+	bool m_bFitted;
+	// framebuffer, viewport and scissor test to put back once the
+	// cascades are drawn
+	GLint m_savedFramebuffer;
+	GLint m_savedViewport[4];
+	GLboolean m_bSavedScissor;
+
+	// flag every texel of a cascade as stale
+	void InvalidateCascade(int cascade);
+
+public:
+	// create the depth texture array and a framebuffer per layer
+	bool Initialize();
+	// free the texture and the framebuffers
+	void Destroy();
+
+	// set the direction the light shines in
+	void SetLightDirection(const glm::vec3& direction);
+	// fit the cascades to the camera view and the scene bounds
+	void FitCascades(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const BOUNDING_VOLUME& sceneBounds);
+	// flag the texels a caster covers in every cascade as stale
+	void InvalidateBounds(const BOUNDING_VOLUME& bounds);
+
+	// true when any cascade has stale texels
+	bool IsDirty() const;
+	bool IsCascadeDirty(int cascade) const;
+
+	// save the render state before the first cascade is drawn
+	void BeginCascades();
+	// bind a cascade and clear its stale texels for drawing
+	void BeginCascade(int cascade);
+	// put the render state back once the cascades are drawn
+	void EndCascades();
+
+	// bind the depth texture array on its texture unit
+	void BindTexture();
+	// get a cascade as fitted to the camera
+	const CASCADE& GetCascade(int cascade) const;
+};
@@ -0,0 +1,841 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShapeGeometry.cpp
+// ============
+// generate and draw the basic shape meshes with an instanced draw path
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShapeGeometry.h"
+#include "MeshOptimizer.h"
+
+#include <cstddef>
+
+// declaration of global variables
+namespace
+{
+	const float PI = 3.14159265358979f;
+
+	// tessellation of the curved shapes at each level of detail,
+	// where level 0 matches ShapeMeshes
+	const int g_CurveSlices[ShapeGeometry::LOD_LEVELS] = { 36, 18, 10 };
+	const int g_SphereStacks[ShapeGeometry::LOD_LEVELS] = { 18, 9, 5 };
+	const int g_TorusMainSegments[ShapeGeometry::LOD_LEVELS] = { 36, 18, 12 };
+	const int g_TorusTubeSegments[ShapeGeometry::LOD_LEVELS] = { 18, 9, 6 };
+
+	// vertex attribute locations used by vertexShader.glsl
+	const GLuint g_PositionLocation = 0;
+	const GLuint g_NormalLocation = 1;
+	const GLuint g_TextureCoordinateLocation = 2;
+	const GLuint g_InstanceModelLocation = 3;
+	const GLuint g_InstanceMaterialLocation = 7;
+	const GLuint g_InstanceUVscaleLocation = 8;
+
+	/***********************************************************
+	 *  AddVertex()
+	 *
+	 *  Append one vertex to a mesh and return its index.
+	 ***********************************************************/
+	GLuint AddVertex(
+		ShapeGeometry::MESH_DATA& mesh,
+		glm::vec3 position,
+		glm::vec3 normal,
+		glm::vec2 textureCoordinate)
+	{
+		ShapeGeometry::VERTEX vertex;
+
+		vertex.position = position;
+		vertex.normal = normal;
+		vertex.textureCoordinate = textureCoordinate;
+		mesh.vertices.push_back(vertex);
+
+		return((GLuint)(mesh.vertices.size() - 1));
+	}
+
+	/***********************************************************
+	 *  AddQuad()
+	 *
+	 *  Append the two triangles for a quad made of four vertices.
+	 ***********************************************************/
+	void AddQuad(ShapeGeometry::MESH_DATA& mesh, GLuint a, GLuint b, GLuint c, GLuint d)
+	{
+		mesh.indices.push_back(a);
+		mesh.indices.push_back(b);
+		mesh.indices.push_back(c);
+		mesh.indices.push_back(a);
+		mesh.indices.push_back(c);
+		mesh.indices.push_back(d);
+	}
+
+	/***********************************************************
+	 *  AddDisk()
+	 *
+	 *  Append a flat disk facing up or down at the passed in
+	 *  height, used for the caps of the round shapes.
+	 ***********************************************************/
+	void AddDisk(ShapeGeometry::MESH_DATA& mesh, int slices, float radius, float height, bool bFacingUp)
+	{
+		glm::vec3 normal(0.0f, bFacingUp ? 1.0f : -1.0f, 0.0f);
+		GLuint center = AddVertex(mesh, glm::vec3(0.0f, height, 0.0f), normal, glm::vec2(0.5f, 0.5f));
+		GLuint first = (GLuint)mesh.vertices.size();
+
+		for (int i = 0; i <= slices; i++)
+		{
+			float theta = 2.0f * PI * i / slices;
+			float x = glm::cos(theta);
+			float z = glm::sin(theta);
+
+			AddVertex(
+				mesh,
+				glm::vec3(x * radius, height, z * radius),
+				normal,
+				glm::vec2(0.5f + 0.5f * x, 0.5f + 0.5f * z));
+		}
+		for (int i = 0; i < slices; i++)
+		{
+			mesh.indices.push_back(center);
+			mesh.indices.push_back(first + i);
+			mesh.indices.push_back(first + i + 1);
+		}
+	}
+}
+
+/***********************************************************
+ *  ShapeGeometry()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShapeGeometry::ShapeGeometry()
+{
+	for (int i = 0; i < TOTAL_MESH_TYPES; i++)
+	{
+		for (int lod = 0; lod < LOD_LEVELS; lod++)
+		{
+			m_meshes[i][lod].vao = 0;
+			m_meshes[i][lod].vbos[0] = 0;
+			m_meshes[i][lod].vbos[1] = 0;
+			m_meshes[i][lod].nIndices = 0;
+		}
+		m_lodCounts[i] = 1;
+		m_meshBounds[i] = ViewFrustum::MakeBounds(glm::vec3(0.0f), glm::vec3(0.0f));
+	}
+	m_pool.vao = 0;
+	m_pool.vbos[0] = 0;
+	m_pool.vbos[1] = 0;
+	m_pool.nIndices = 0;
+	m_instanceBuffer = 0;
+	m_instanceCapacity = 0;
+	m_bCompactVertices = true;
+}
+
+/***********************************************************
+ *  ~ShapeGeometry()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShapeGeometry::~ShapeGeometry()
+{
+	DestroyMeshes();
+}
+
+/***********************************************************
+ *  BuildBox()
+ *
+ *  This method is used for building a cube that is one unit
+ *  on each side and centered on the origin.
+ ***********************************************************/
+void ShapeGeometry::BuildBox(MESH_DATA& mesh)
+{
+	// the normal, and the two axes spanning each face
+	const glm::vec3 faces[6][3] =
+	{
+		{ glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f) },
+		{ glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) }
+	};
+
+	mesh.vertices.clear();
+	mesh.indices.clear();
+
+	for (int i = 0; i < 6; i++)
+	{
+		glm::vec3 normal = faces[i][0];
+		glm::vec3 u = faces[i][1] * 0.5f;
+		glm::vec3 v = faces[i][2] * 0.5f;
+		glm::vec3 center = normal * 0.5f;
+
+		GLuint a = AddVertex(mesh, center - u - v, normal, glm::vec2(0.0f, 0.0f));
+		GLuint b = AddVertex(mesh, center + u - v, normal, glm::vec2(1.0f, 0.0f));
+		GLuint c = AddVertex(mesh, center + u + v, normal, glm::vec2(1.0f, 1.0f));
+		GLuint d = AddVertex(mesh, center - u + v, normal, glm::vec2(0.0f, 1.0f));
+		AddQuad(mesh, a, b, c, d);
+	}
+
+	OrientTriangles(mesh);
+}
+
+/***********************************************************
+ *  BuildPlane()
+ *
+ *  This method is used for building a flat plane facing up
+ *  that spans from -1 to 1 on the X and Z axes.
+ ***********************************************************/
+void ShapeGeometry::BuildPlane(MESH_DATA& mesh)
+{
+	glm::vec3 normal(0.0f, 1.0f, 0.0f);
+
+	mesh.vertices.clear();
+	mesh.indices.clear();
+
+	GLuint a = AddVertex(mesh, glm::vec3(-1.0f, 0.0f, 1.0f), normal, glm::vec2(0.0f, 0.0f));
+	GLuint b = AddVertex(mesh, glm::vec3(1.0f, 0.0f, 1.0f), normal, glm::vec2(1.0f, 0.0f));
+	GLuint c = AddVertex(mesh, glm::vec3(1.0f, 0.0f, -1.0f), normal, glm::vec2(1.0f, 1.0f));
+	GLuint d = AddVertex(mesh, glm::vec3(-1.0f, 0.0f, -1.0f), normal, glm::vec2(0.0f, 1.0f));
+	AddQuad(mesh, a, b, c, d);
+
+	OrientTriangles(mesh);
+}
+
+/***********************************************************
+ *  BuildPrism()
+ *
+ *  This method is used for building a triangular prism that
+ *  is one unit on each side and centered on the origin, with
+ *  the triangle lying flat on the XZ plane.
+ ***********************************************************/
+void ShapeGeometry::BuildPrism(MESH_DATA& mesh)
+{
+	const glm::vec2 corners[3] =
+	{
+		glm::vec2(-0.5f, 0.5f),
+		glm::vec2(0.5f, 0.5f),
+		glm::vec2(0.0f, -0.5f)
+	};
+
+	mesh.vertices.clear();
+	mesh.indices.clear();
+
+	// top and bottom triangles
+	for (int face = 0; face < 2; face++)
+	{
+		float height = (face == 0) ? 0.5f : -0.5f;
+		glm::vec3 normal(0.0f, (face == 0) ? 1.0f : -1.0f, 0.0f);
+
+		for (int i = 0; i < 3; i++)
+		{
+			mesh.indices.push_back(AddVertex(
+				mesh,
+				glm::vec3(corners[i].x, height, corners[i].y),
+				normal,
+				glm::vec2(corners[i].x + 0.5f, corners[i].y + 0.5f)));
+		}
+	}
+
+	// three side faces
+	for (int i = 0; i < 3; i++)
+	{
+		glm::vec2 start = corners[i];
+		glm::vec2 end = corners[(i + 1) % 3];
+		glm::vec3 edge(end.x - start.x, 0.0f, end.y - start.y);
+		glm::vec3 normal = glm::normalize(glm::cross(edge, glm::vec3(0.0f, 1.0f, 0.0f)));
+
+		GLuint a = AddVertex(mesh, glm::vec3(start.x, -0.5f, start.y), normal, glm::vec2(0.0f, 0.0f));
+		GLuint b = AddVertex(mesh, glm::vec3(end.x, -0.5f, end.y), normal, glm::vec2(1.0f, 0.0f));
+		GLuint c = AddVertex(mesh, glm::vec3(end.x, 0.5f, end.y), normal, glm::vec2(1.0f, 1.0f));
+		GLuint d = AddVertex(mesh, glm::vec3(start.x, 0.5f, start.y), normal, glm::vec2(0.0f, 1.0f));
+		AddQuad(mesh, a, b, c, d);
+	}
+
+	OrientTriangles(mesh);
+}
+
+/***********************************************************
+ *  BuildSphere()
+ *
+ *  This method is used for building a sphere with a radius of
+ *  one centered on the origin.  The half sphere is the upper
+ *  half, closed with a flat disk on the XZ plane.
+ ***********************************************************/
+void ShapeGeometry::BuildSphere(MESH_DATA& mesh, int slices, int stacks, bool bHalfSphere)
+{
+	int totalStacks = bHalfSphere ? (stacks / 2) : stacks;
+
+	mesh.vertices.clear();
+	mesh.indices.clear();
+
+	for (int i = 0; i <= totalStacks; i++)
+	{
+		float phi = PI * i / stacks;
+
+		for (int j = 0; j <= slices; j++)
+		{
+			float theta = 2.0f * PI * j / slices;
+			glm::vec3 normal(
+				glm::sin(phi) * glm::cos(theta),
+				glm::cos(phi),
+				glm::sin(phi) * glm::sin(theta));
+
+			AddVertex(mesh, normal, normal, glm::vec2((float)j / slices, 1.0f - (float)i / stacks));
+		}
+	}
+	for (int i = 0; i < totalStacks; i++)
+	{
+		for (int j = 0; j < slices; j++)
+		{
+			GLuint a = i * (slices + 1) + j;
+			GLuint b = a + slices + 1;
+			AddQuad(mesh, a, b, b + 1, a + 1);
+		}
+	}
+
+	if (bHalfSphere == true)
+	{
+		AddDisk(mesh, slices, 1.0f, 0.0f, false);
+	}
+
+	OrientTriangles(mesh);
+}
+
+/***********************************************************
+ *  BuildCylinder()
+ *
+ *  This method is used for building a round shape with a
+ *  bottom radius of one at Y = 0 and the passed in top radius
+ *  at Y = 1.  A top radius of one gives the cylinder, one half
+ *  gives the tapered cylinder and zero gives the cone.
+ ***********************************************************/
+void ShapeGeometry::BuildCylinder(MESH_DATA& mesh, int slices, float topRadius)
+{
+	// the side normals lean up by how much the side tapers
+	float slope = 1.0f - topRadius;
+
+	mesh.vertices.clear();
+	mesh.indices.clear();
+
+	for (int j = 0; j <= slices; j++)
+	{
+		float theta = 2.0f * PI * j / slices;
+		float x = glm::cos(theta);
+		float z = glm::sin(theta);
+		glm::vec3 normal = glm::normalize(glm::vec3(x, slope, z));
+		float u = (float)j / slices;
+
+		AddVertex(mesh, glm::vec3(x, 0.0f, z), normal, glm::vec2(u, 0.0f));
+		AddVertex(mesh, glm::vec3(x * topRadius, 1.0f, z * topRadius), normal, glm::vec2(u, 1.0f));
+	}
+	for (int j = 0; j < slices; j++)
+	{
+		GLuint a = j * 2;
+		AddQuad(mesh, a, a + 1, a + 3, a + 2);
+	}
+
+	AddDisk(mesh, slices, 1.0f, 0.0f, false);
+	if (topRadius > 0.0f)
+	{
+		AddDisk(mesh, slices, topRadius, 1.0f, true);
+	}
+
+	OrientTriangles(mesh);
+}
+
+/***********************************************************
+ *  BuildTorus()
+ *
+ *  This method is used for building a torus centered on the
+ *  origin with its ring lying on the XY plane.
+ ***********************************************************/
+void ShapeGeometry::BuildTorus(
+	MESH_DATA& mesh,
+	int mainSegments,
+	int tubeSegments,
+	float mainRadius,
+	float tubeRadius)
+{
+	mesh.vertices.clear();
+	mesh.indices.clear();
+
+	for (int i = 0; i <= mainSegments; i++)
+	{
+		float u = 2.0f * PI * i / mainSegments;
+		glm::vec3 ringDirection(glm::cos(u), glm::sin(u), 0.0f);
+
+		for (int j = 0; j <= tubeSegments; j++)
+		{
+			float v = 2.0f * PI * j / tubeSegments;
+			glm::vec3 normal = ringDirection * glm::cos(v) + glm::vec3(0.0f, 0.0f, glm::sin(v));
+
+			AddVertex(
+				mesh,
+				ringDirection * mainRadius + normal * tubeRadius,
+				normal,
+				glm::vec2((float)i / mainSegments, (float)j / tubeSegments));
+		}
+	}
+	for (int i = 0; i < mainSegments; i++)
+	{
+		for (int j = 0; j < tubeSegments; j++)
+		{
+			GLuint a = i * (tubeSegments + 1) + j;
+			GLuint b = a + tubeSegments + 1;
+			AddQuad(mesh, a, b, b + 1, a + 1);
+		}
+	}
+
+	OrientTriangles(mesh);
+}
+
+/***********************************************************
+ *  OrientTriangles()
+ *
+ *  This method is used for flipping any triangle whose
+ *  winding does not face the same way as its vertex normals,
+ *  so that every shape is counter-clockwise from outside.
+ ***********************************************************/
+void ShapeGeometry::OrientTriangles(MESH_DATA& mesh)
+{
+	for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+	{
+		const VERTEX& a = mesh.vertices[mesh.indices[i]];
+		const VERTEX& b = mesh.vertices[mesh.indices[i + 1]];
+		const VERTEX& c = mesh.vertices[mesh.indices[i + 2]];
+
+		glm::vec3 faceNormal = glm::cross(b.position - a.position, c.position - a.position);
+		glm::vec3 vertexNormal = a.normal + b.normal + c.normal;
+
+		if (glm::dot(faceNormal, vertexNormal) < 0.0f)
+		{
+			GLuint swap = mesh.indices[i + 1];
+			mesh.indices[i + 1] = mesh.indices[i + 2];
+			mesh.indices[i + 2] = swap;
+		}
+	}
+}
+
+/***********************************************************
+ *  UploadMesh()
+ *
+ *  This method is used for copying the generated data for a
+ *  mesh into a vertex array object and its buffers.
+ ***********************************************************/
+void ShapeGeometry::UploadMesh(MESH_TYPE mesh, int lod)
+{
+	const MESH_DATA& data = m_meshData[mesh][lod];
+	GL_MESH& glMesh = m_meshes[mesh][lod];
+
+	glGenVertexArrays(1, &glMesh.vao);
+	glBindVertexArray(glMesh.vao);
+
+	glGenBuffers(2, glMesh.vbos);
+	glBindBuffer(GL_ARRAY_BUFFER, glMesh.vbos[0]);
+	UploadVertices(data.vertices);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glMesh.vbos[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(GLuint), &data.indices[0], GL_STATIC_DRAW);
+	glMesh.nIndices = (GLsizei)data.indices.size();
+
+	SetVertexAttributes();
+
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  UploadVertices()
+ *
+ *  This method is used for copying vertices into the bound
+ *  vertex buffer, packed first when the compact layout is
+ *  used.
+ ***********************************************************/
+void ShapeGeometry::UploadVertices(const std::vector<VERTEX>& vertices)
+{
+	if (m_bCompactVertices == true)
+	{
+		std::vector<COMPACT_VERTEX> compactVertices;
+		MeshOptimizer::CompressVertices(vertices, compactVertices);
+		glBufferData(GL_ARRAY_BUFFER, compactVertices.size() * sizeof(COMPACT_VERTEX), &compactVertices[0], GL_STATIC_DRAW);
+	}
+	else
+	{
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(VERTEX), &vertices[0], GL_STATIC_DRAW);
+	}
+}
+
+/***********************************************************
+ *  SetVertexAttributes()
+ *
+ *  This method is used for setting up the vertex attributes
+ *  of the bound vertex array for the bound vertex buffer.
+ ***********************************************************/
+void ShapeGeometry::SetVertexAttributes()
+{
+	if (m_bCompactVertices == true)
+	{
+		glVertexAttribPointer(g_PositionLocation, 4, GL_SHORT, GL_TRUE, sizeof(COMPACT_VERTEX), (void*)offsetof(COMPACT_VERTEX, position));
+		glVertexAttribPointer(g_NormalLocation, 2, GL_SHORT, GL_TRUE, sizeof(COMPACT_VERTEX), (void*)offsetof(COMPACT_VERTEX, normal));
+		glVertexAttribPointer(g_TextureCoordinateLocation, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(COMPACT_VERTEX), (void*)offsetof(COMPACT_VERTEX, textureCoordinate));
+	}
+	else
+	{
+		glVertexAttribPointer(g_PositionLocation, 3, GL_FLOAT, GL_FALSE, sizeof(VERTEX), (void*)offsetof(VERTEX, position));
+		glVertexAttribPointer(g_NormalLocation, 3, GL_FLOAT, GL_FALSE, sizeof(VERTEX), (void*)offsetof(VERTEX, normal));
+		glVertexAttribPointer(g_TextureCoordinateLocation, 2, GL_FLOAT, GL_FALSE, sizeof(VERTEX), (void*)offsetof(VERTEX, textureCoordinate));
+	}
+	glEnableVertexAttribArray(g_PositionLocation);
+	glEnableVertexAttribArray(g_NormalLocation);
+	glEnableVertexAttribArray(g_TextureCoordinateLocation);
+
+	// the instance attributes advance once per instance - they are
+	// pointed at the instance buffer when the mesh is drawn
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glEnableVertexAttribArray(g_InstanceModelLocation + i);
+		glVertexAttribDivisor(g_InstanceModelLocation + i, 1);
+	}
+	glEnableVertexAttribArray(g_InstanceMaterialLocation);
+	glVertexAttribDivisor(g_InstanceMaterialLocation, 1);
+	glEnableVertexAttribArray(g_InstanceUVscaleLocation);
+	glVertexAttribDivisor(g_InstanceUVscaleLocation, 1);
+}
+
+/***********************************************************
+ *  UploadMeshPool()
+ *
+ *  This method is used for copying every level of every mesh
+ *  into one vertex and index buffer.  The indices of each
+ *  level stay relative to its own vertices, and its range
+ *  records the base vertex that is added when drawing.
+ ***********************************************************/
+void ShapeGeometry::UploadMeshPool()
+{
+	std::vector<VERTEX> vertices;
+	std::vector<GLuint> indices;
+
+	for (int i = 0; i < TOTAL_MESH_TYPES; i++)
+	{
+		for (int lod = 0; lod < LOD_LEVELS; lod++)
+		{
+			// a missing level uses the coarsest one that exists
+			if (lod >= m_lodCounts[i])
+			{
+				m_poolRanges[i][lod] = m_poolRanges[i][m_lodCounts[i] - 1];
+				continue;
+			}
+
+			const MESH_DATA& data = m_meshData[i][lod];
+			m_poolRanges[i][lod].indexCount = (GLuint)data.indices.size();
+			m_poolRanges[i][lod].firstIndex = (GLuint)indices.size();
+			m_poolRanges[i][lod].baseVertex = (GLint)vertices.size();
+
+			vertices.insert(vertices.end(), data.vertices.begin(), data.vertices.end());
+			indices.insert(indices.end(), data.indices.begin(), data.indices.end());
+		}
+	}
+
+	glGenVertexArrays(1, &m_pool.vao);
+	glBindVertexArray(m_pool.vao);
+
+	glGenBuffers(2, m_pool.vbos);
+	glBindBuffer(GL_ARRAY_BUFFER, m_pool.vbos[0]);
+	UploadVertices(vertices);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_pool.vbos[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
+	m_pool.nIndices = (GLsizei)indices.size();
+
+	SetVertexAttributes();
+
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  SetInstanceAttributes()
+ *
+ *  This method is used for pointing the instance attributes
+ *  of the bound vertex array at the passed in instance, so
+ *  that each batch can read its own range of the buffer.
+ ***********************************************************/
+void ShapeGeometry::SetInstanceAttributes(int firstInstance)
+{
+	size_t offset = firstInstance * sizeof(INSTANCE_DATA);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glVertexAttribPointer(
+			g_InstanceModelLocation + i,
+			4,
+			GL_FLOAT,
+			GL_FALSE,
+			sizeof(INSTANCE_DATA),
+			(void*)(offset + offsetof(INSTANCE_DATA, model) + sizeof(glm::vec4) * i));
+	}
+	// the material index and texture layer are read as one ivec2
+	glVertexAttribIPointer(
+		g_InstanceMaterialLocation,
+		2,
+		GL_INT,
+		sizeof(INSTANCE_DATA),
+		(void*)(offset + offsetof(INSTANCE_DATA, materialIndex)));
+	glVertexAttribPointer(
+		g_InstanceUVscaleLocation,
+		2,
+		GL_FLOAT,
+		GL_FALSE,
+		sizeof(INSTANCE_DATA),
+		(void*)(offset + offsetof(INSTANCE_DATA, UVscale)));
+}
+
+/***********************************************************
+ *  LoadMeshes()
+ *
+ *  This method is used for generating every shape mesh and
+ *  uploading it into OpenGL.  The flat shapes have a single
+ *  level, and each curved shape gets every level of detail.
+ ***********************************************************/
+void ShapeGeometry::LoadMeshes()
+{
+	BuildBox(m_meshData[MESH_BOX][0]);
+	BuildPlane(m_meshData[MESH_PLANE][0]);
+	BuildPrism(m_meshData[MESH_PRISM][0]);
+	m_lodCounts[MESH_BOX] = 1;
+	m_lodCounts[MESH_PLANE] = 1;
+	m_lodCounts[MESH_PRISM] = 1;
+
+	for (int lod = 0; lod < LOD_LEVELS; lod++)
+	{
+		BuildCylinder(m_meshData[MESH_CONE][lod], g_CurveSlices[lod], 0.0f);
+		BuildCylinder(m_meshData[MESH_CYLINDER][lod], g_CurveSlices[lod], 1.0f);
+		BuildSphere(m_meshData[MESH_HALF_SPHERE][lod], g_CurveSlices[lod], g_SphereStacks[lod], true);
+		BuildSphere(m_meshData[MESH_SPHERE][lod], g_CurveSlices[lod], g_SphereStacks[lod], false);
+		BuildCylinder(m_meshData[MESH_TAPERED_CYLINDER][lod], g_CurveSlices[lod], 0.5f);
+		BuildTorus(m_meshData[MESH_TORUS][lod], g_TorusMainSegments[lod], g_TorusTubeSegments[lod], 1.0f, 0.1f);
+	}
+	m_lodCounts[MESH_CONE] = LOD_LEVELS;
+	m_lodCounts[MESH_CYLINDER] = LOD_LEVELS;
+	m_lodCounts[MESH_HALF_SPHERE] = LOD_LEVELS;
+	m_lodCounts[MESH_SPHERE] = LOD_LEVELS;
+	m_lodCounts[MESH_TAPERED_CYLINDER] = LOD_LEVELS;
+	m_lodCounts[MESH_TORUS] = LOD_LEVELS;
+
+	// reorder the triangles and vertices of every level for the
+	// vertex cache, overdraw and vertex fetch
+	for (int i = 0; i < TOTAL_MESH_TYPES; i++)
+	{
+		for (int lod = 0; lod < m_lodCounts[i]; lod++)
+		{
+			MeshOptimizer::OptimizeMesh(m_meshData[i][lod]);
+		}
+	}
+
+	if (0 == m_instanceBuffer)
+	{
+		glGenBuffers(1, &m_instanceBuffer);
+	}
+	for (int i = 0; i < TOTAL_MESH_TYPES; i++)
+	{
+		// the coarser levels stay inside the bounds of level 0
+		m_meshBounds[i] = ComputeBounds(m_meshData[i][0]);
+		for (int lod = 0; lod < m_lodCounts[i]; lod++)
+		{
+			UploadMesh((MESH_TYPE)i, lod);
+		}
+	}
+	UploadMeshPool();
+}
+
+/***********************************************************
+ *  EnableCompactVertices()
+ *
+ *  This method is used for choosing between the compact and
+ *  the full float vertex layout of the GPU copies.  It must
+ *  be called before the meshes are loaded.
+ ***********************************************************/
+void ShapeGeometry::EnableCompactVertices(bool bEnable)
+{
+	m_bCompactVertices = bEnable;
+}
+
+/***********************************************************
+ *  DestroyMeshes()
+ *
+ *  This method is used for freeing the OpenGL objects for
+ *  the meshes and the instance buffer.
+ ***********************************************************/
+void ShapeGeometry::DestroyMeshes()
+{
+	for (int i = 0; i < TOTAL_MESH_TYPES; i++)
+	{
+		for (int lod = 0; lod < LOD_LEVELS; lod++)
+		{
+			GL_MESH& glMesh = m_meshes[i][lod];
+			if (0 != glMesh.vao)
+			{
+				glDeleteVertexArrays(1, &glMesh.vao);
+				glDeleteBuffers(2, glMesh.vbos);
+				glMesh.vao = 0;
+				glMesh.vbos[0] = 0;
+				glMesh.vbos[1] = 0;
+				glMesh.nIndices = 0;
+			}
+		}
+	}
+	if (0 != m_pool.vao)
+	{
+		glDeleteVertexArrays(1, &m_pool.vao);
+		glDeleteBuffers(2, m_pool.vbos);
+		m_pool.vao = 0;
+		m_pool.vbos[0] = 0;
+		m_pool.vbos[1] = 0;
+		m_pool.nIndices = 0;
+	}
+	if (0 != m_instanceBuffer)
+	{
+		glDeleteBuffers(1, &m_instanceBuffer);
+		m_instanceBuffer = 0;
+		m_instanceCapacity = 0;
+	}
+}
+
+/***********************************************************
+ *  ResizeInstanceBuffer()
+ *
+ *  This method is used for making room in the instance buffer
+ *  for the passed in number of instances.  The contents are
+ *  not kept, so all instances must be written again after.
+ ***********************************************************/
+void ShapeGeometry::ResizeInstanceBuffer(int count)
+{
+	if ((0 == m_instanceBuffer) || (count <= m_instanceCapacity))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(INSTANCE_DATA), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	m_instanceCapacity = count;
+}
+
+/***********************************************************
+ *  UpdateInstances()
+ *
+ *  This method is used for writing a range of per-instance
+ *  values into the instance buffer.
+ ***********************************************************/
+void ShapeGeometry::UpdateInstances(const INSTANCE_DATA* instances, int firstInstance, int count)
+{
+	if ((count <= 0) || (firstInstance + count > m_instanceCapacity))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	glBufferSubData(
+		GL_ARRAY_BUFFER,
+		firstInstance * sizeof(INSTANCE_DATA),
+		count * sizeof(INSTANCE_DATA),
+		instances);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  DrawMeshInstanced()
+ *
+ *  This method is used for drawing a range of instances of a
+ *  level of detail of a mesh with one draw call.
+ ***********************************************************/
+void ShapeGeometry::DrawMeshInstanced(MESH_TYPE mesh, int firstInstance, int count, int lod)
+{
+	lod = glm::clamp(lod, 0, m_lodCounts[mesh] - 1);
+	const GL_MESH& glMesh = m_meshes[mesh][lod];
+
+	if ((0 == glMesh.vao) || (count <= 0))
+	{
+		return;
+	}
+
+	glBindVertexArray(glMesh.vao);
+	SetInstanceAttributes(firstInstance);
+	glDrawElementsInstanced(GL_TRIANGLES, glMesh.nIndices, GL_UNSIGNED_INT, (void*)0, count);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  BindMeshPool()
+ *
+ *  This method is used for binding the merged buffers of every
+ *  mesh for indirect draws.  The instance attributes point at
+ *  the start of the instance buffer, and each indirect command
+ *  picks its instance with its base instance.
+ ***********************************************************/
+void ShapeGeometry::BindMeshPool()
+{
+	glBindVertexArray(m_pool.vao);
+	SetInstanceAttributes(0);
+}
+
+/***********************************************************
+ *  GetPoolRange()
+ *
+ *  This method is used for getting where a level of detail of
+ *  a mesh sits in the merged buffers.
+ ***********************************************************/
+const ShapeGeometry::POOL_RANGE& ShapeGeometry::GetPoolRange(MESH_TYPE mesh, int lod) const
+{
+	return(m_poolRanges[mesh][glm::clamp(lod, 0, LOD_LEVELS - 1)]);
+}
+
+/***********************************************************
+ *  GetMeshData()
+ *
+ *  This method is used for getting the generated vertex and
+ *  index data for a level of detail of a mesh.
+ ***********************************************************/
+const ShapeGeometry::MESH_DATA& ShapeGeometry::GetMeshData(MESH_TYPE mesh, int lod) const
+{
+	return(m_meshData[mesh][glm::clamp(lod, 0, m_lodCounts[mesh] - 1)]);
+}
+
+/***********************************************************
+ *  GetLodCount()
+ *
+ *  This method is used for getting the number of levels of
+ *  detail that were generated for a mesh.
+ ***********************************************************/
+int ShapeGeometry::GetLodCount(MESH_TYPE mesh) const
+{
+	return(m_lodCounts[mesh]);
+}
+
+/***********************************************************
+ *  ComputeBounds()
+ *
+ *  This method is used for finding the box around all of the
+ *  vertices of a mesh.
+ ***********************************************************/
+BOUNDING_VOLUME ShapeGeometry::ComputeBounds(const MESH_DATA& mesh)
+{
+	if (mesh.vertices.size() == 0)
+	{
+		return(ViewFrustum::MakeBounds(glm::vec3(0.0f), glm::vec3(0.0f)));
+	}
+
+	glm::vec3 minimum = mesh.vertices[0].position;
+	glm::vec3 maximum = mesh.vertices[0].position;
+	for (size_t i = 1; i < mesh.vertices.size(); i++)
+	{
+		minimum = glm::min(minimum, mesh.vertices[i].position);
+		maximum = glm::max(maximum, mesh.vertices[i].position);
+	}
+
+	return(ViewFrustum::MakeBounds(minimum, maximum));
+}
+
+/***********************************************************
+ *  GetMeshBounds()
+ *
+ *  This method is used for getting the bounds of a mesh in
+ *  its unit dimensions, before any model matrix is applied.
+ ***********************************************************/
+const BOUNDING_VOLUME& ShapeGeometry::GetMeshBounds(MESH_TYPE mesh) const
+{
+	return(m_meshBounds[mesh]);
+}
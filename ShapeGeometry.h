@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////////////
+// ShapeGeometry.h
+// ============
+// generate and draw the basic shape meshes with an instanced draw path
+//
+//  ShapeMeshes keeps its vertex arrays and buffers private, so the shapes
+//  are generated here a second time with the same unit dimensions.  The
+//  vertex data stays available on the CPU, and every mesh can be drawn
+//  many times in one call from a buffer of per-instance values.  The
+//  curved shapes are also generated at coarser levels of detail, with
+//  level 0 matching the tessellation of ShapeMeshes.  Every mesh is run
+//  through MeshOptimizer before it is uploaded, and by default the GPU
+//  copies use a compact vertex layout.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ViewFrustum.h"
+
+#include <cstdint>
+#include <vector>
+
+// basic shape meshes that can be referenced by a draw record
+enum MESH_TYPE
+{
+	MESH_BOX,
+	MESH_CONE,
+	MESH_CYLINDER,
+	MESH_HALF_SPHERE,
+	MESH_PLANE,
+	MESH_PRISM,
+	MESH_SPHERE,
+	MESH_TAPERED_CYLINDER,
+	MESH_TORUS,
+	TOTAL_MESH_TYPES
+};
+
+/***********************************************************
+ *  ShapeGeometry
+ *
+ *  This class contains the code for generating the basic
+ *  shape meshes and drawing batches of instances of them.
+ ***********************************************************/
+class ShapeGeometry
+{
+public:
+	// constructor
+	ShapeGeometry();
+	// destructor
+	~ShapeGeometry();
+
+	// most levels of detail a mesh can have - flat shapes only
+	// have level 0
+	static const int LOD_LEVELS = 3;
+
+	// vertex layout matching locations 0-2 of vertexShader.glsl
+	struct VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 textureCoordinate;
+	};
+
+	// compact vertex layout of half the size, read by the same
+	// locations - the position is in 16-bit fixed point over a w
+	// below one, which also tells vertexShader.glsl the normal is
+	// an octahedral pair, and the texture coordinate is two half
+	// floats
+	struct COMPACT_VERTEX
+	{
+		int16_t position[4];
+		int16_t normal[2];
+		uint16_t textureCoordinate[2];
+	};
+
+	// generated vertex and index data for one mesh
+	struct MESH_DATA
+	{
+		std::vector<VERTEX> vertices;
+		std::vector<GLuint> indices;
+	};
+
+	// where one level of detail of a mesh sits in the merged
+	// buffers shared by every mesh
+	struct POOL_RANGE
+	{
+		GLuint indexCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+	};
+
+	// per-instance values matching locations 3-8 of vertexShader.glsl
+	struct INSTANCE_DATA
+	{
+		glm::mat4 model;
+		int materialIndex;
+		int textureLayer;
+		glm::vec2 UVscale;
+	};
+
+	// build the vertex and index data for each shape - these do
+	// not need OpenGL and leave the shape in its unit dimensions
+	static void BuildBox(MESH_DATA& mesh);
+	static void BuildPlane(MESH_DATA& mesh);
+	static void BuildPrism(MESH_DATA& mesh);
+	static void BuildSphere(MESH_DATA& mesh, int slices, int stacks, bool bHalfSphere);
+	static void BuildCylinder(MESH_DATA& mesh, int slices, float topRadius);
+	static void BuildTorus(MESH_DATA& mesh, int mainSegments, int tubeSegments, float mainRadius, float tubeRadius);
+
+private:
+	// OpenGL objects for one uploaded mesh
+	struct GL_MESH
+	{
+		GLuint vao;
+		GLuint vbos[2];
+		GLsizei nIndices;
+	};
+
+	// generated data and OpenGL objects for every mesh
+	MESH_DATA m_meshData[TOTAL_MESH_TYPES][LOD_LEVELS];
+	GL_MESH m_meshes[TOTAL_MESH_TYPES][LOD_LEVELS];
+	// number of levels of detail generated for every mesh
+	int m_lodCounts[TOTAL_MESH_TYPES];
+	// every level of every mesh merged into one set of buffers,
+	// so indirect draws of different meshes can share one VAO
+	GL_MESH m_pool;
+	POOL_RANGE m_poolRanges[TOTAL_MESH_TYPES][LOD_LEVELS];
+	// bounds of the generated vertices of every mesh
+	BOUNDING_VOLUME m_meshBounds[TOTAL_MESH_TYPES];
+	// buffer holding the per-instance values for all meshes
+	GLuint m_instanceBuffer;
+	// number of instances the buffer has room for
+	int m_instanceCapacity;
+	// true when the GPU copies use the compact vertex layout
+	bool m_bCompactVertices;
+
+	// make every triangle counter-clockwise around its normals
+	static void OrientTriangles(MESH_DATA& mesh);
+	// find the box around the vertices of a mesh
+	static BOUNDING_VOLUME ComputeBounds(const MESH_DATA& mesh);
+	// upload the generated data for a mesh into OpenGL buffers
+	void UploadMesh(MESH_TYPE mesh, int lod);
+	// copy vertices into the bound vertex buffer in the layout
+	// the GPU copies use
+	void UploadVertices(const std::vector<VERTEX>& vertices);
+	// point the instance attributes of the bound mesh at an instance
+	void SetInstanceAttributes(int firstInstance);
+	// set up the vertex attributes of the bound vertex array
+	void SetVertexAttributes();
+	// upload every mesh into the merged buffers
+	void UploadMeshPool();
+
+public:
+	// generate and upload all of the meshes
+	void LoadMeshes();
+	// free the OpenGL objects for the meshes
+	void DestroyMeshes();
+	// choose whether the GPU copies use the compact vertex layout,
+	// before the meshes are loaded
+	void EnableCompactVertices(bool bEnable);
+
+	// make room in the instance buffer for the passed in count
+	void ResizeInstanceBuffer(int count);
+	// write a range of per-instance values
+	void UpdateInstances(const INSTANCE_DATA* instances, int firstInstance, int count);
+
+	// draw count instances of a mesh starting at firstInstance
+	void DrawMeshInstanced(MESH_TYPE mesh, int firstInstance, int count, int lod = 0);
+
+	// bind the merged buffers of every mesh for indirect draws,
+	// with the instance attributes read from baseInstance
+	void BindMeshPool();
+	// get where a level of detail of a mesh sits in the merged buffers
+	const POOL_RANGE& GetPoolRange(MESH_TYPE mesh, int lod) const;
+
+	// get the generated data for a level of detail of a mesh
+	const MESH_DATA& GetMeshData(MESH_TYPE mesh, int lod = 0) const;
+	// get the number of levels of detail of a mesh
+	int GetLodCount(MESH_TYPE mesh) const;
+	// get the bounds of a mesh in its unit dimensions
+	const BOUNDING_VOLUME& GetMeshBounds(MESH_TYPE mesh) const;
+};
@@ -0,0 +1,368 @@
+///////////////////////////////////////////////////////////////////////////////
+// SimdKernels.cpp
+// ============
+// build model matrices and test bounding spheres several objects at a time
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimdKernels.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_KERNELS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#if defined(__SSE4_1__) || defined(__AVX__)
+#include <smmintrin.h>
+#define SIMD_KERNELS_SSE4
+#endif
+#define SIMD_KERNELS_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SIMD_KERNELS_NEON
+#endif
+
+// declaration of global variables
+namespace
+{
+#if defined(SIMD_KERNELS_AVX2)
+	const int SIMD_WIDTH = 8;
+	const char* g_InstructionSet = "AVX2";
+	typedef __m256 FLOATS;
+	typedef __m256 MASKS;
+
+	inline FLOATS Set(float value) { return(_mm256_set1_ps(value)); }
+	inline FLOATS Load(const float* pValues) { return(_mm256_load_ps(pValues)); }
+	inline void Store(float* pValues, FLOATS values) { _mm256_store_ps(pValues, values); }
+	inline FLOATS Add(FLOATS a, FLOATS b) { return(_mm256_add_ps(a, b)); }
+	inline FLOATS Sub(FLOATS a, FLOATS b) { return(_mm256_sub_ps(a, b)); }
+	inline FLOATS Mul(FLOATS a, FLOATS b) { return(_mm256_mul_ps(a, b)); }
+	inline FLOATS Round(FLOATS a) { return(_mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)); }
+	inline MASKS Less(FLOATS a, FLOATS b) { return(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+	inline MASKS Or(MASKS a, MASKS b) { return(_mm256_or_ps(a, b)); }
+	inline FLOATS Select(MASKS mask, FLOATS a, FLOATS b) { return(_mm256_blendv_ps(b, a, mask)); }
+	inline int MaskBits(MASKS mask) { return(_mm256_movemask_ps(mask)); }
+#elif defined(SIMD_KERNELS_SSE)
+	const int SIMD_WIDTH = 4;
+	typedef __m128 FLOATS;
+	typedef __m128 MASKS;
+
+	inline FLOATS Set(float value) { return(_mm_set1_ps(value)); }
+	inline FLOATS Load(const float* pValues) { return(_mm_load_ps(pValues)); }
+	inline void Store(float* pValues, FLOATS values) { _mm_store_ps(pValues, values); }
+	inline FLOATS Add(FLOATS a, FLOATS b) { return(_mm_add_ps(a, b)); }
+	inline FLOATS Sub(FLOATS a, FLOATS b) { return(_mm_sub_ps(a, b)); }
+	inline FLOATS Mul(FLOATS a, FLOATS b) { return(_mm_mul_ps(a, b)); }
+	inline MASKS Less(FLOATS a, FLOATS b) { return(_mm_cmplt_ps(a, b)); }
+	inline MASKS Or(MASKS a, MASKS b) { return(_mm_or_ps(a, b)); }
+	inline int MaskBits(MASKS mask) { return(_mm_movemask_ps(mask)); }
+#if defined(SIMD_KERNELS_SSE4)
+	const char* g_InstructionSet = "SSE4.1";
+	inline FLOATS Round(FLOATS a) { return(_mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)); }
+	inline FLOATS Select(MASKS mask, FLOATS a, FLOATS b) { return(_mm_blendv_ps(b, a, mask)); }
+#else
+	const char* g_InstructionSet = "SSE2";
+	// the default rounding mode of the conversion is to nearest
+	inline FLOATS Round(FLOATS a) { return(_mm_cvtepi32_ps(_mm_cvtps_epi32(a))); }
+	inline FLOATS Select(MASKS mask, FLOATS a, FLOATS b) { return(_mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b))); }
+#endif
+#elif defined(SIMD_KERNELS_NEON)
+	const int SIMD_WIDTH = 4;
+	const char* g_InstructionSet = "NEON";
+	typedef float32x4_t FLOATS;
+	typedef uint32x4_t MASKS;
+
+	inline FLOATS Set(float value) { return(vdupq_n_f32(value)); }
+	inline FLOATS Load(const float* pValues) { return(vld1q_f32(pValues)); }
+	inline void Store(float* pValues, FLOATS values) { vst1q_f32(pValues, values); }
+	inline FLOATS Add(FLOATS a, FLOATS b) { return(vaddq_f32(a, b)); }
+	inline FLOATS Sub(FLOATS a, FLOATS b) { return(vsubq_f32(a, b)); }
+	inline FLOATS Mul(FLOATS a, FLOATS b) { return(vmulq_f32(a, b)); }
+#if defined(__aarch64__)
+	inline FLOATS Round(FLOATS a) { return(vrndnq_f32(a)); }
+#else
+	// round half away from zero, which is close enough here
+	inline FLOATS Round(FLOATS a)
+	{
+		FLOATS half = vbslq_f32(vcltq_f32(a, vdupq_n_f32(0.0f)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+		return(vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(a, half))));
+	}
+#endif
+	inline MASKS Less(FLOATS a, FLOATS b) { return(vcltq_f32(a, b)); }
+	inline MASKS Or(MASKS a, MASKS b) { return(vorrq_u32(a, b)); }
+	inline FLOATS Select(MASKS mask, FLOATS a, FLOATS b) { return(vbslq_f32(mask, a, b)); }
+	inline int MaskBits(MASKS mask)
+	{
+		uint32_t lanes[4];
+		vst1q_u32(lanes, mask);
+		return((lanes[0] & 1) | ((lanes[1] & 1) << 1) | ((lanes[2] & 1) << 2) | ((lanes[3] & 1) << 3));
+	}
+#else
+	const int SIMD_WIDTH = 1;
+	const char* g_InstructionSet = "scalar";
+	typedef float FLOATS;
+	typedef bool MASKS;
+
+	inline FLOATS Set(float value) { return(value); }
+	inline FLOATS Load(const float* pValues) { return(*pValues); }
+	inline void Store(float* pValues, FLOATS values) { *pValues = values; }
+	inline FLOATS Add(FLOATS a, FLOATS b) { return(a + b); }
+	inline FLOATS Sub(FLOATS a, FLOATS b) { return(a - b); }
+	inline FLOATS Mul(FLOATS a, FLOATS b) { return(a * b); }
+	inline FLOATS Round(FLOATS a) { return(glm::round(a)); }
+	inline MASKS Less(FLOATS a, FLOATS b) { return(a < b); }
+	inline MASKS Or(MASKS a, MASKS b) { return(a || b); }
+	inline FLOATS Select(MASKS mask, FLOATS a, FLOATS b) { return(mask ? a : b); }
+	inline int MaskBits(MASKS mask) { return(mask ? 1 : 0); }
+#endif
+
+	// 2 pi split into a part that multiplies exactly and the rest,
+	// so large angles lose as little as possible when reduced
+	const float g_TwoPiHigh = 6.28125f;
+	const float g_TwoPiLow = 0.0019353071795864769f;
+
+	/***********************************************************
+	 *  SinCos()
+	 *
+	 *  Get the sine and cosine of every lane.  The angle is
+	 *  brought into [-pi, pi] and then folded into [-pi/2, pi/2],
+	 *  where the Taylor series below are within about 1e-7.
+	 ***********************************************************/
+	inline void SinCos(FLOATS angle, FLOATS& sine, FLOATS& cosine)
+	{
+		FLOATS turns = Round(Mul(angle, Set(1.0f / glm::two_pi<float>())));
+		angle = Sub(angle, Mul(turns, Set(g_TwoPiHigh)));
+		angle = Sub(angle, Mul(turns, Set(g_TwoPiLow)));
+
+		// sin(pi - x) is sin(x) and cos(pi - x) is -cos(x)
+		MASKS bHigh = Less(Set(glm::half_pi<float>()), angle);
+		MASKS bLow = Less(angle, Set(-glm::half_pi<float>()));
+		FLOATS folded = Select(bHigh, Sub(Set(glm::pi<float>()), angle),
+			Select(bLow, Sub(Set(-glm::pi<float>()), angle), angle));
+		FLOATS cosineSign = Select(Or(bHigh, bLow), Set(-1.0f), Set(1.0f));
+
+		FLOATS x2 = Mul(folded, folded);
+		FLOATS s = Set(-1.0f / 39916800.0f);
+		s = Add(Mul(s, x2), Set(1.0f / 362880.0f));
+		s = Add(Mul(s, x2), Set(-1.0f / 5040.0f));
+		s = Add(Mul(s, x2), Set(1.0f / 120.0f));
+		s = Add(Mul(s, x2), Set(-1.0f / 6.0f));
+		s = Add(Mul(s, x2), Set(1.0f));
+		sine = Mul(s, folded);
+
+		FLOATS c = Set(1.0f / 479001600.0f);
+		c = Add(Mul(c, x2), Set(-1.0f / 3628800.0f));
+		c = Add(Mul(c, x2), Set(1.0f / 40320.0f));
+		c = Add(Mul(c, x2), Set(-1.0f / 720.0f));
+		c = Add(Mul(c, x2), Set(1.0f / 24.0f));
+		c = Add(Mul(c, x2), Set(-0.5f));
+		c = Add(Mul(c, x2), Set(1.0f));
+		cosine = Mul(c, cosineSign);
+	}
+
+	/***********************************************************
+	 *  ComposeOne()
+	 *
+	 *  Build one model matrix with the scalar math.
+	 ***********************************************************/
+	inline void ComposeOne(glm::vec3 scaleXYZ, glm::vec3 rotationDegrees, glm::vec3 positionXYZ, glm::mat4& model)
+	{
+		float cx = glm::cos(glm::radians(rotationDegrees.x));
+		float sx = glm::sin(glm::radians(rotationDegrees.x));
+		float cy = glm::cos(glm::radians(rotationDegrees.y));
+		float sy = glm::sin(glm::radians(rotationDegrees.y));
+		float cz = glm::cos(glm::radians(rotationDegrees.z));
+		float sz = glm::sin(glm::radians(rotationDegrees.z));
+
+		model[0] = glm::vec4(cy * cz, cx * sz + sx * sy * cz, sx * sz - cx * sy * cz, 0.0f) * scaleXYZ.x;
+		model[1] = glm::vec4(-cy * sz, cx * cz - sx * sy * sz, sx * cz + cx * sy * sz, 0.0f) * scaleXYZ.y;
+		model[2] = glm::vec4(sy, -sx * cy, cx * cy, 0.0f) * scaleXYZ.z;
+		model[3] = glm::vec4(positionXYZ, 1.0f);
+	}
+}
+
+/***********************************************************
+ *  ComposeModelMatrices()
+ *
+ *  This method is used for building the model matrices of
+ *  the indexed objects a full register of objects at a time.
+ *  The inputs are gathered into one array per value, the
+ *  matrix columns are computed on every lane, and the lanes
+ *  are written back to the matrices of their objects.  The
+ *  objects past the end of the last group repeat the last
+ *  object and are never written.
+ ***********************************************************/
+void SimdKernels::ComposeModelMatrices(
+	const glm::vec3* scales,
+	const glm::vec3* rotationsDegrees,
+	const glm::vec3* positions,
+	const int* indices,
+	int count,
+	glm::mat4* models)
+{
+	alignas(32) float inputs[9][SIMD_WIDTH];
+	alignas(32) float outputs[9][SIMD_WIDTH];
+
+	for (int first = 0; first < count; first += SIMD_WIDTH)
+	{
+		int laneCount = std::min(SIMD_WIDTH, count - first);
+
+		for (int lane = 0; lane < SIMD_WIDTH; lane++)
+		{
+			int object = indices[first + std::min(lane, laneCount - 1)];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				inputs[axis][lane] = rotationsDegrees[object][axis];
+				inputs[3 + axis][lane] = scales[object][axis];
+			}
+		}
+
+		FLOATS toRadians = Set(glm::pi<float>() / 180.0f);
+		FLOATS sx, cx, sy, cy, sz, cz;
+		SinCos(Mul(Load(inputs[0]), toRadians), sx, cx);
+		SinCos(Mul(Load(inputs[1]), toRadians), sy, cy);
+		SinCos(Mul(Load(inputs[2]), toRadians), sz, cz);
+
+		FLOATS scaleX = Load(inputs[3]);
+		FLOATS scaleY = Load(inputs[4]);
+		FLOATS scaleZ = Load(inputs[5]);
+		FLOATS sxsy = Mul(sx, sy);
+		FLOATS cxsy = Mul(cx, sy);
+
+		// each column is one rotated axis scaled by its scale value
+		Store(outputs[0], Mul(Mul(cy, cz), scaleX));
+		Store(outputs[1], Mul(Add(Mul(cx, sz), Mul(sxsy, cz)), scaleX));
+		Store(outputs[2], Mul(Sub(Mul(sx, sz), Mul(cxsy, cz)), scaleX));
+		Store(outputs[3], Mul(Sub(Set(0.0f), Mul(cy, sz)), scaleY));
+		Store(outputs[4], Mul(Sub(Mul(cx, cz), Mul(sxsy, sz)), scaleY));
+		Store(outputs[5], Mul(Add(Mul(sx, cz), Mul(cxsy, sz)), scaleY));
+		Store(outputs[6], Mul(sy, scaleZ));
+		Store(outputs[7], Mul(Sub(Set(0.0f), Mul(sx, cy)), scaleZ));
+		Store(outputs[8], Mul(Mul(cx, cy), scaleZ));
+
+		for (int lane = 0; lane < laneCount; lane++)
+		{
+			int object = indices[first + lane];
+			glm::mat4& model = models[object];
+
+			model[0] = glm::vec4(outputs[0][lane], outputs[1][lane], outputs[2][lane], 0.0f);
+			model[1] = glm::vec4(outputs[3][lane], outputs[4][lane], outputs[5][lane], 0.0f);
+			model[2] = glm::vec4(outputs[6][lane], outputs[7][lane], outputs[8][lane], 0.0f);
+			model[3] = glm::vec4(positions[object], 1.0f);
+		}
+	}
+}
+
+/***********************************************************
+ *  ComposeModelMatricesScalar()
+ *
+ *  This method is used for building the model matrices of
+ *  the indexed objects one at a time with the glm functions,
+ *  which the vectorized kernel is compared against.
+ ***********************************************************/
+void SimdKernels::ComposeModelMatricesScalar(
+	const glm::vec3* scales,
+	const glm::vec3* rotationsDegrees,
+	const glm::vec3* positions,
+	const int* indices,
+	int count,
+	glm::mat4* models)
+{
+	for (int index = 0; index < count; index++)
+	{
+		int object = indices[index];
+		ComposeOne(scales[object], rotationsDegrees[object], positions[object], models[object]);
+	}
+}
+
+/***********************************************************
+ *  TestSpheres()
+ *
+ *  This method is used for testing the spheres of the passed
+ *  in bounding volumes against the six planes a register of
+ *  spheres at a time.  A sphere is outside when it is behind
+ *  any plane, and crossing when it is not but reaches across
+ *  one, in which case the caller tests its box.
+ ***********************************************************/
+void SimdKernels::TestSpheres(
+	const BOUNDING_VOLUME* bounds,
+	int count,
+	const glm::vec4* planes,
+	uint8_t* results)
+{
+	alignas(32) float spheres[4][SIMD_WIDTH];
+
+	for (int first = 0; first < count; first += SIMD_WIDTH)
+	{
+		int laneCount = std::min(SIMD_WIDTH, count - first);
+
+		for (int lane = 0; lane < SIMD_WIDTH; lane++)
+		{
+			const BOUNDING_VOLUME& volume = bounds[first + std::min(lane, laneCount - 1)];
+			spheres[0][lane] = volume.center.x;
+			spheres[1][lane] = volume.center.y;
+			spheres[2][lane] = volume.center.z;
+			spheres[3][lane] = volume.radius;
+		}
+
+		FLOATS centerX = Load(spheres[0]);
+		FLOATS centerY = Load(spheres[1]);
+		FLOATS centerZ = Load(spheres[2]);
+		FLOATS radius = Load(spheres[3]);
+		FLOATS negativeRadius = Sub(Set(0.0f), radius);
+
+		MASKS bOutside = Less(Set(1.0f), Set(0.0f));
+		MASKS bCrossing = bOutside;
+		for (int plane = 0; plane < ViewFrustum::TOTAL_PLANES; plane++)
+		{
+			FLOATS distance = Add(
+				Add(Mul(centerX, Set(planes[plane].x)), Mul(centerY, Set(planes[plane].y))),
+				Add(Mul(centerZ, Set(planes[plane].z)), Set(planes[plane].w)));
+			bOutside = Or(bOutside, Less(distance, negativeRadius));
+			bCrossing = Or(bCrossing, Less(distance, radius));
+		}
+
+		int outsideBits = MaskBits(bOutside);
+		int crossingBits = MaskBits(bCrossing);
+		for (int lane = 0; lane < laneCount; lane++)
+		{
+			if ((outsideBits >> lane) & 1)
+			{
+				results[first + lane] = SPHERE_OUTSIDE;
+			}
+			else if ((crossingBits >> lane) & 1)
+			{
+				results[first + lane] = SPHERE_CROSSING;
+			}
+			else
+			{
+				results[first + lane] = SPHERE_INSIDE;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  GetWidth()
+ *
+ *  This method is used for getting the number of objects the
+ *  kernels handle at once.
+ ***********************************************************/
+int SimdKernels::GetWidth()
+{
+	return(SIMD_WIDTH);
+}
+
+/***********************************************************
+ *  GetInstructionSet()
+ *
+ *  This method is used for getting the name of the
+ *  instruction set the kernels were built for.
+ ***********************************************************/
+const char* SimdKernels::GetInstructionSet()
+{
+	return(g_InstructionSet);
+}
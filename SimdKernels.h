@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// SimdKernels.h
+// ============
+// build model matrices and test bounding spheres several objects at a time
+//
+//  The kernels work on as many objects at once as the widest instruction
+//  set the build targets - 8 with AVX2, 4 with SSE or NEON, and 1 in the
+//  scalar fallback - so the same code runs everywhere.  Each group of
+//  objects is gathered into the lanes of the registers, and the sines
+//  and cosines for the rotations are computed with a polynomial on all
+//  of the lanes at once.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ViewFrustum.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+/***********************************************************
+ *  SimdKernels
+ *
+ *  This class contains the vectorized kernels for the frame
+ *  passes over the scene objects.
+ ***********************************************************/
+class SimdKernels
+{
+public:
+	// result of testing a sphere against the view planes
+	enum SPHERE_RESULT
+	{
+		SPHERE_OUTSIDE = 0,
+		SPHERE_INSIDE,
+		// the sphere crosses a plane, so its box must be tested
+		SPHERE_CROSSING
+	};
+
+	// build the model matrix of each indexed object from its
+	// scale, rotation in degrees and position, in the same way
+	// as translation * rotationX * rotationY * rotationZ * scale
+	static void ComposeModelMatrices(
+		const glm::vec3* scales,
+		const glm::vec3* rotationsDegrees,
+		const glm::vec3* positions,
+		const int* indices,
+		int count,
+		glm::mat4* models);
+	// the same as ComposeModelMatrices() one object at a time
+	static void ComposeModelMatricesScalar(
+		const glm::vec3* scales,
+		const glm::vec3* rotationsDegrees,
+		const glm::vec3* positions,
+		const int* indices,
+		int count,
+		glm::mat4* models);
+
+	// test the sphere of each bounding volume against the planes
+	static void TestSpheres(
+		const BOUNDING_VOLUME* bounds,
+		int count,
+		const glm::vec4* planes,
+		uint8_t* results);
+
+	// get the number of objects handled at once and the name of
+	// the instruction set the kernels were built for
+	static int GetWidth();
+	static const char* GetInstructionSet();
+};
@@ -0,0 +1,259 @@
+///////////////////////////////////////////////////////////////////////////////
+// StaticGeometry.cpp
+// ============
+// bake the meshes of objects that never move into one merged buffer
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StaticGeometry.h"
+
+#include <cstddef>
+
+// declaration of global variables
+namespace
+{
+	// vertex attribute locations used by vertexShader.glsl
+	const GLuint g_PositionLocation = 0;
+	const GLuint g_NormalLocation = 1;
+	const GLuint g_TextureCoordinateLocation = 2;
+	const GLuint g_InstanceModelLocation = 3;
+	const GLuint g_InstanceMaterialLocation = 7;
+	const GLuint g_InstanceUVscaleLocation = 8;
+}
+
+/***********************************************************
+ *  StaticGeometry()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+StaticGeometry::StaticGeometry()
+{
+	m_vao = 0;
+	m_vbos[0] = 0;
+	m_vbos[1] = 0;
+	m_vertexCount = 0;
+	m_lastRangeEnd = -1;
+}
+
+/***********************************************************
+ *  ~StaticGeometry()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+StaticGeometry::~StaticGeometry()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for forgetting the baked meshes so
+ *  that the objects can be baked again.
+ ***********************************************************/
+void StaticGeometry::Clear()
+{
+	m_vertices.clear();
+	m_indices.clear();
+}
+
+/***********************************************************
+ *  AddMesh()
+ *
+ *  This method is used for moving the vertices of a mesh into
+ *  world space and appending them to the merged data.  The
+ *  normals are left as they are, since the vertex shader also
+ *  passes the normals of drawn meshes through unchanged.
+ ***********************************************************/
+StaticGeometry::DRAW_RANGE StaticGeometry::AddMesh(
+	const ShapeGeometry::MESH_DATA& mesh,
+	const glm::mat4& model,
+	int materialIndex,
+	int textureLayer,
+	glm::vec2 UVscale)
+{
+	DRAW_RANGE range;
+	GLuint firstVertex = (GLuint)m_vertices.size();
+
+	range.firstIndex = (GLsizei)m_indices.size();
+	range.indexCount = (GLsizei)mesh.indices.size();
+
+	m_vertices.reserve(m_vertices.size() + mesh.vertices.size());
+	for (size_t i = 0; i < mesh.vertices.size(); i++)
+	{
+		const ShapeGeometry::VERTEX& source = mesh.vertices[i];
+		BAKED_VERTEX vertex;
+
+		vertex.position = glm::vec3(model * glm::vec4(source.position, 1.0f));
+		vertex.normal = source.normal;
+		vertex.textureCoordinate = source.textureCoordinate * UVscale;
+		vertex.materialIndex = (materialIndex >= 0) ? materialIndex : 0;
+		vertex.textureLayer = (textureLayer >= 0) ? textureLayer : 0;
+		m_vertices.push_back(vertex);
+	}
+
+	m_indices.reserve(m_indices.size() + mesh.indices.size());
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+	{
+		m_indices.push_back(firstVertex + mesh.indices[i]);
+	}
+
+	return(range);
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for copying the baked meshes into the
+ *  merged vertex and index buffers.  The local copies are
+ *  freed once they are uploaded.
+ ***********************************************************/
+void StaticGeometry::Upload()
+{
+	if (0 == m_vao)
+	{
+		glGenVertexArrays(1, &m_vao);
+		glGenBuffers(2, m_vbos);
+	}
+
+	m_vertexCount = (int)m_vertices.size();
+
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vbos[0]);
+	glBufferData(
+		GL_ARRAY_BUFFER,
+		m_vertices.size() * sizeof(BAKED_VERTEX),
+		(m_vertices.size() > 0) ? &m_vertices[0] : NULL,
+		GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_vbos[1]);
+	glBufferData(
+		GL_ELEMENT_ARRAY_BUFFER,
+		m_indices.size() * sizeof(GLuint),
+		(m_indices.size() > 0) ? &m_indices[0] : NULL,
+		GL_STATIC_DRAW);
+
+	glVertexAttribPointer(g_PositionLocation, 3, GL_FLOAT, GL_FALSE, sizeof(BAKED_VERTEX), (void*)offsetof(BAKED_VERTEX, position));
+	glEnableVertexAttribArray(g_PositionLocation);
+	glVertexAttribPointer(g_NormalLocation, 3, GL_FLOAT, GL_FALSE, sizeof(BAKED_VERTEX), (void*)offsetof(BAKED_VERTEX, normal));
+	glEnableVertexAttribArray(g_NormalLocation);
+	glVertexAttribPointer(g_TextureCoordinateLocation, 2, GL_FLOAT, GL_FALSE, sizeof(BAKED_VERTEX), (void*)offsetof(BAKED_VERTEX, textureCoordinate));
+	glEnableVertexAttribArray(g_TextureCoordinateLocation);
+	// the material index and texture layer are read as one ivec2
+	glVertexAttribIPointer(g_InstanceMaterialLocation, 2, GL_INT, sizeof(BAKED_VERTEX), (void*)offsetof(BAKED_VERTEX, materialIndex));
+	glEnableVertexAttribArray(g_InstanceMaterialLocation);
+
+	// the model matrix and UV scale are not arrays here, so the
+	// shader reads the constant values set when drawing
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glDisableVertexAttribArray(g_InstanceModelLocation + i);
+	}
+	glDisableVertexAttribArray(g_InstanceUVscaleLocation);
+
+	glBindVertexArray(0);
+
+	std::vector<BAKED_VERTEX>().swap(m_vertices);
+	std::vector<GLuint>().swap(m_indices);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the OpenGL objects for
+ *  the merged buffers.
+ ***********************************************************/
+void StaticGeometry::Destroy()
+{
+	if (0 != m_vao)
+	{
+		glDeleteVertexArrays(1, &m_vao);
+		glDeleteBuffers(2, m_vbos);
+		m_vao = 0;
+		m_vbos[0] = 0;
+		m_vbos[1] = 0;
+	}
+	m_vertexCount = 0;
+	Clear();
+}
+
+/***********************************************************
+ *  BeginDraw()
+ *
+ *  This method is used for starting a new list of index
+ *  ranges to draw.
+ ***********************************************************/
+void StaticGeometry::BeginDraw()
+{
+	m_drawCounts.clear();
+	m_drawOffsets.clear();
+	m_lastRangeEnd = -1;
+}
+
+/***********************************************************
+ *  AddDrawRange()
+ *
+ *  This method is used for queueing an index range.  A range
+ *  that starts where the last one ended is merged into it, so
+ *  neighbouring objects in view become one range.
+ ***********************************************************/
+void StaticGeometry::AddDrawRange(const DRAW_RANGE& range)
+{
+	if (range.indexCount <= 0)
+	{
+		return;
+	}
+
+	if ((m_drawCounts.size() > 0) && (m_lastRangeEnd == range.firstIndex))
+	{
+		m_drawCounts.back() += range.indexCount;
+	}
+	else
+	{
+		m_drawCounts.push_back(range.indexCount);
+		m_drawOffsets.push_back((const void*)(range.firstIndex * sizeof(GLuint)));
+	}
+	m_lastRangeEnd = range.firstIndex + range.indexCount;
+}
+
+/***********************************************************
+ *  EndDraw()
+ *
+ *  This method is used for drawing all of the queued index
+ *  ranges with one multi-draw call.
+ ***********************************************************/
+int StaticGeometry::EndDraw()
+{
+	if ((0 == m_vao) || (m_drawCounts.size() == 0))
+	{
+		return(0);
+	}
+
+	glBindVertexArray(m_vao);
+
+	// the baked vertices are already in world space
+	glVertexAttrib4f(g_InstanceModelLocation + 0, 1.0f, 0.0f, 0.0f, 0.0f);
+	glVertexAttrib4f(g_InstanceModelLocation + 1, 0.0f, 1.0f, 0.0f, 0.0f);
+	glVertexAttrib4f(g_InstanceModelLocation + 2, 0.0f, 0.0f, 1.0f, 0.0f);
+	glVertexAttrib4f(g_InstanceModelLocation + 3, 0.0f, 0.0f, 0.0f, 1.0f);
+	glVertexAttrib2f(g_InstanceUVscaleLocation, 1.0f, 1.0f);
+
+	glMultiDrawElements(
+		GL_TRIANGLES,
+		&m_drawCounts[0],
+		GL_UNSIGNED_INT,
+		&m_drawOffsets[0],
+		(GLsizei)m_drawCounts.size());
+	glBindVertexArray(0);
+
+	return(1);
+}
+
+/***********************************************************
+ *  GetVertexCount()
+ *
+ *  This method is used for getting the number of vertices in
+ *  the uploaded buffer.
+ ***********************************************************/
+int StaticGeometry::GetVertexCount() const
+{
+	return(m_vertexCount);
+}
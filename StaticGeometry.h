@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+// StaticGeometry.h
+// ============
+// bake the meshes of objects that never move into one merged buffer
+//
+//  Each baked mesh is moved into world space one time and appended to a
+//  single vertex and index buffer, with the UV scale folded into its
+//  texture coordinates and its material and texture layer stored in every
+//  vertex.  The objects sharing a texture array are then drawn with one
+//  multi-draw call over the index ranges of the ones in view.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ShapeGeometry.h"
+
+#include <vector>
+
+/***********************************************************
+ *  StaticGeometry
+ *
+ *  This class contains the code for baking meshes into the
+ *  merged buffers and drawing ranges of them.
+ ***********************************************************/
+class StaticGeometry
+{
+public:
+	// constructor
+	StaticGeometry();
+	// destructor
+	~StaticGeometry();
+
+	// vertex layout of the merged buffer - locations 0-2 match
+	// ShapeGeometry and location 7 reads the material and layer
+	struct BAKED_VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 textureCoordinate;
+		int materialIndex;
+		int textureLayer;
+	};
+
+	// range of the index buffer holding one baked mesh
+	struct DRAW_RANGE
+	{
+		GLsizei firstIndex;
+		GLsizei indexCount;
+	};
+
+private:
+	// merged vertex and index data, kept until uploaded
+	std::vector<BAKED_VERTEX> m_vertices;
+	std::vector<GLuint> m_indices;
+	// OpenGL objects for the merged buffers
+	GLuint m_vao;
+	GLuint m_vbos[2];
+	// number of vertices in the uploaded buffer
+	int m_vertexCount;
+	// index ranges queued for the next multi-draw call
+	std::vector<GLsizei> m_drawCounts;
+	std::vector<const void*> m_drawOffsets;
+	// end of the last queued range, to merge ranges that touch
+	GLsizei m_lastRangeEnd;
+
+public:
+	// forget the baked meshes so the objects can be baked again
+	void Clear();
+	// move a mesh into world space and append it
+	DRAW_RANGE AddMesh(
+		const ShapeGeometry::MESH_DATA& mesh,
+		const glm::mat4& model,
+		int materialIndex,
+		int textureLayer,
+		glm::vec2 UVscale);
+	// copy the baked meshes into the merged OpenGL buffers
+	void Upload();
+	// free the OpenGL objects for the merged buffers
+	void Destroy();
+
+	// queue index ranges and draw them with one call
+	void BeginDraw();
+	void AddDrawRange(const DRAW_RANGE& range);
+	// returns the number of draw calls issued
+	int EndDraw();
+
+	// get the number of uploaded vertices
+	int GetVertexCount() const;
+};
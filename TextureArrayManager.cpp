@@ -0,0 +1,637 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureArrayManager.cpp
+// ============
+// pack the scene textures into 2D texture arrays
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureArrayManager.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+
+/***********************************************************
+ *  TextureArrayManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureArrayManager::TextureArrayManager()
+{
+	m_maxLayers = 0;
+	m_bBindless = false;
+	m_samplerLocation = -1;
+	m_placeholderLayer.arrayIndex = -1;
+	m_placeholderLayer.layer = 0;
+	m_uploadBuffer = 0;
+	m_bUseCompression = true;
+	m_compressedFormat = 0;
+}
+
+/***********************************************************
+ *  ~TextureArrayManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureArrayManager::~TextureArrayManager()
+{
+	DestroyArrays();
+}
+
+/***********************************************************
+ *  ReserveImage()
+ *
+ *  This method is used for reserving a layer for an image in
+ *  the array holding images of the same size.  The returned
+ *  texture index is used to upload the pixels and to look up
+ *  the layer.
+ ***********************************************************/
+int TextureArrayManager::ReserveImage(int width, int height)
+{
+	if (0 == m_maxLayers)
+	{
+		glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &m_maxLayers);
+	}
+
+	// find an array that is not created yet with the same size
+	// and room for another layer
+	int arrayIndex = -1;
+	for (int i = 0; (i < m_arrays.size()) && (arrayIndex < 0); i++)
+	{
+		if ((m_arrays[i].width == width) &&
+			(m_arrays[i].height == height) &&
+			(0 == m_arrays[i].ID) &&
+			(m_arrays[i].layerCount < m_maxLayers))
+		{
+			arrayIndex = i;
+		}
+	}
+
+	if (arrayIndex < 0)
+	{
+		TEXTURE_ARRAY textureArray;
+		textureArray.width = width;
+		textureArray.height = height;
+		textureArray.layerCount = 0;
+		textureArray.internalFormat = GL_RGBA8;
+		textureArray.ID = 0;
+		textureArray.handle = 0;
+		m_arrays.push_back(textureArray);
+		arrayIndex = (int)m_arrays.size() - 1;
+	}
+
+	TEXTURE_LAYER textureLayer;
+	textureLayer.arrayIndex = arrayIndex;
+	textureLayer.layer = m_arrays[arrayIndex].layerCount;
+	m_arrays[arrayIndex].layerCount++;
+	m_textureLayers.push_back(textureLayer);
+	m_textureReady.push_back(false);
+
+	return((int)m_textureLayers.size() - 1);
+}
+
+/***********************************************************
+ *  AllocateArray()
+ *
+ *  This method is used for creating the OpenGL texture of an
+ *  array with storage for every layer and mipmap level.  The
+ *  whole mipmap chain is allocated here because the storage
+ *  of a texture with a bindless handle cannot change later.
+ ***********************************************************/
+void TextureArrayManager::AllocateArray(TEXTURE_ARRAY& textureArray)
+{
+	GLsizei levels = TextureCache::GetLevelCount(textureArray.width, textureArray.height);
+	bool bCompressed = (GL_RGBA8 != textureArray.internalFormat);
+
+	glGenTextures(1, &textureArray.ID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.ID);
+
+	if (GLEW_ARB_texture_storage == GL_TRUE)
+	{
+		glTexStorage3D(
+			GL_TEXTURE_2D_ARRAY, levels, textureArray.internalFormat,
+			textureArray.width, textureArray.height, textureArray.layerCount);
+	}
+	else
+	{
+		for (GLsizei level = 0; level < levels; level++)
+		{
+			int levelWidth = std::max(textureArray.width >> level, 1);
+			int levelHeight = std::max(textureArray.height >> level, 1);
+
+			if (bCompressed == true)
+			{
+				glCompressedTexImage3D(
+					GL_TEXTURE_2D_ARRAY, level, textureArray.internalFormat,
+					levelWidth, levelHeight, textureArray.layerCount, 0,
+					TextureCache::GetCompressedLevelSize(levelWidth, levelHeight) * textureArray.layerCount,
+					NULL);
+			}
+			else
+			{
+				glTexImage3D(
+					GL_TEXTURE_2D_ARRAY, level, GL_RGBA8,
+					levelWidth, levelHeight, textureArray.layerCount,
+					0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+			}
+		}
+	}
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+/***********************************************************
+ *  BuildArrays()
+ *
+ *  This method is used for creating the arrays for all of
+ *  the reserved layers, followed by a one layer array that
+ *  holds the placeholder.  When bindless textures are
+ *  supported, a handle is created for each array and made
+ *  resident.
+ ***********************************************************/
+bool TextureArrayManager::BuildArrays()
+{
+	m_bBindless = (GLEW_ARB_bindless_texture == GL_TRUE);
+
+	// BC7 keeps the most quality, BC3 is the fallback on older drivers
+	m_compressedFormat = 0;
+	if (m_bUseCompression == true)
+	{
+		if (GLEW_ARB_texture_compression_bptc == GL_TRUE)
+		{
+			m_compressedFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+		}
+		else if (GLEW_EXT_texture_compression_s3tc == GL_TRUE)
+		{
+			m_compressedFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		}
+	}
+	for (int i = 0; i < m_arrays.size(); i++)
+	{
+		if ((0 == m_arrays[i].ID) && (0 != m_compressedFormat))
+		{
+			m_arrays[i].internalFormat = m_compressedFormat;
+		}
+	}
+
+	// the placeholder is a single mid grey texel
+	TEXTURE_ARRAY placeholder;
+	placeholder.width = 1;
+	placeholder.height = 1;
+	placeholder.layerCount = 1;
+	placeholder.internalFormat = GL_RGBA8;
+	placeholder.ID = 0;
+	placeholder.handle = 0;
+	m_arrays.push_back(placeholder);
+	m_placeholderLayer.arrayIndex = (int)m_arrays.size() - 1;
+	m_placeholderLayer.layer = 0;
+
+	for (int i = 0; i < m_arrays.size(); i++)
+	{
+		if (0 != m_arrays[i].ID)
+		{
+			continue;
+		}
+
+		AllocateArray(m_arrays[i]);
+
+		if (m_bBindless == true)
+		{
+			m_arrays[i].handle = glGetTextureHandleARB(m_arrays[i].ID);
+			glMakeTextureHandleResidentARB(m_arrays[i].handle);
+		}
+	}
+
+	const unsigned char placeholderTexel[4] = { 128, 128, 128, 255 };
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[m_placeholderLayer.arrayIndex].ID);
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, 1, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, placeholderTexel);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	glGenBuffers(1, &m_uploadBuffer);
+
+	std::cout << "Reserved " << m_textureLayers.size() << " textures in " << m_arrays.size() - 1
+		<< " texture arrays" << (m_bBindless ? " with bindless handles" : "")
+		<< ((0 != m_compressedFormat) ? ", block compressed" : "") << std::endl;
+
+	return(glGetError() == GL_NO_ERROR);
+}
+
+/***********************************************************
+ *  UploadImage()
+ *
+ *  This method is used for uploading the RGBA level 0 of a
+ *  reserved texture into its layer.  The pixels are copied
+ *  into the pixel buffer and the mipmaps are then regenerated.
+ ***********************************************************/
+bool TextureArrayManager::UploadImage(int texture, const TextureCache::MIP_LEVELS& levels, int width, int height)
+{
+	if ((texture < 0) || (texture >= m_textureLayers.size()) || (levels.size() == 0))
+	{
+		return(false);
+	}
+
+	const TEXTURE_LAYER& textureLayer = m_textureLayers[texture];
+	const TEXTURE_ARRAY& textureArray = m_arrays[textureLayer.arrayIndex];
+
+	// the decoded image must match the size the layer was reserved for
+	if ((textureArray.width != width) || (textureArray.height != height))
+	{
+		std::cout << "Image size " << width << "x" << height << " does not match the reserved "
+			<< textureArray.width << "x" << textureArray.height << " layer" << std::endl;
+		return(false);
+	}
+
+	// an RGBA image cannot be written into a compressed array
+	if (GL_RGBA8 != textureArray.internalFormat)
+	{
+		return(false);
+	}
+
+	// only level 0 is uploaded, the rest are generated below
+	if (FillUploadBuffer(levels, 1) == false)
+	{
+		return(false);
+	}
+
+	// with a pixel buffer bound, the data pointer is an offset into it
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.ID);
+	glTexSubImage3D(
+		GL_TEXTURE_2D_ARRAY, 0,
+		0, 0, textureLayer.layer,
+		textureArray.width, textureArray.height, 1,
+		GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	// generate the texture mipmaps for mapping textures to lower resolutions
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	m_textureReady[texture] = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  FillUploadBuffer()
+ *
+ *  This method is used for copying the first levels of an image
+ *  one after another into the pixel buffer, which is left bound.
+ *  The buffer is re-allocated for each upload, so the copy
+ *  does not have to wait for the previous upload to finish.
+ ***********************************************************/
+bool TextureArrayManager::FillUploadBuffer(const TextureCache::MIP_LEVELS& levels, int levelCount)
+{
+	GLsizeiptr totalSize = 0;
+	for (int level = 0; level < levelCount; level++)
+	{
+		totalSize += (GLsizeiptr)levels[level].size();
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, totalSize, NULL, GL_STREAM_DRAW);
+	unsigned char* mapped = (unsigned char*)glMapBufferRange(
+		GL_PIXEL_UNPACK_BUFFER, 0, totalSize,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (NULL == mapped)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return(false);
+	}
+
+	for (int level = 0; level < levelCount; level++)
+	{
+		memcpy(mapped, &levels[level][0], levels[level].size());
+		mapped += levels[level].size();
+	}
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	return(true);
+}
+
+/***********************************************************
+ *  UploadCompressedImage()
+ *
+ *  This method is used for uploading the compressed mipmap
+ *  levels of a reserved texture into its layer through the
+ *  pixel buffer.  No mipmaps are generated, since the whole
+ *  chain is already in the levels.
+ ***********************************************************/
+bool TextureArrayManager::UploadCompressedImage(
+	int texture,
+	const TextureCache::MIP_LEVELS& levels,
+	int width,
+	int height)
+{
+	if ((texture < 0) || (texture >= m_textureLayers.size()))
+	{
+		return(false);
+	}
+
+	const TEXTURE_LAYER& textureLayer = m_textureLayers[texture];
+	const TEXTURE_ARRAY& textureArray = m_arrays[textureLayer.arrayIndex];
+
+	if ((textureArray.width != width) ||
+		(textureArray.height != height) ||
+		(textureArray.internalFormat != m_compressedFormat) ||
+		(levels.size() != TextureCache::GetLevelCount(width, height)))
+	{
+		return(false);
+	}
+
+	if (FillUploadBuffer(levels, (int)levels.size()) == false)
+	{
+		return(false);
+	}
+
+	// with a pixel buffer bound, the data pointer is an offset into it
+	size_t offset = 0;
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.ID);
+	for (int level = 0; level < levels.size(); level++)
+	{
+		glCompressedTexSubImage3D(
+			GL_TEXTURE_2D_ARRAY, level,
+			0, 0, textureLayer.layer,
+			std::max(width >> level, 1), std::max(height >> level, 1), 1,
+			textureArray.internalFormat,
+			(GLsizei)levels[level].size(),
+			(void*)offset);
+		offset += levels[level].size();
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	m_textureReady[texture] = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  CompressImage()
+ *
+ *  This method is used for having the driver compress every
+ *  level of an RGBA mipmap chain into the compressed format
+ *  of the arrays.  The levels are uploaded into a temporary
+ *  texture and the compressed blocks are read back, so they
+ *  can be written to the texture cache.
+ ***********************************************************/
+bool TextureArrayManager::CompressImage(
+	const TextureCache::MIP_LEVELS& pixelLevels,
+	int width,
+	int height,
+	TextureCache::MIP_LEVELS& compressedLevels)
+{
+	if (0 == m_compressedFormat)
+	{
+		return(false);
+	}
+
+	GLuint textureID = 0;
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)pixelLevels.size() - 1);
+
+	bool bCompressed = true;
+	compressedLevels.resize(pixelLevels.size());
+	for (int level = 0; (level < pixelLevels.size()) && (bCompressed == true); level++)
+	{
+		int levelWidth = std::max(width >> level, 1);
+		int levelHeight = std::max(height >> level, 1);
+
+		glTexImage2D(
+			GL_TEXTURE_2D, level, m_compressedFormat,
+			levelWidth, levelHeight, 0,
+			GL_RGBA, GL_UNSIGNED_BYTE, &pixelLevels[level][0]);
+
+		GLint bIsCompressed = GL_FALSE;
+		GLint compressedSize = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &bIsCompressed);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+
+		bCompressed =
+			(GL_TRUE == bIsCompressed) &&
+			(compressedSize == TextureCache::GetCompressedLevelSize(levelWidth, levelHeight));
+		if (bCompressed == true)
+		{
+			compressedLevels[level].resize(compressedSize);
+			glGetCompressedTexImage(GL_TEXTURE_2D, level, &compressedLevels[level][0]);
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDeleteTextures(1, &textureID);
+
+	if (bCompressed == false)
+	{
+		compressedLevels.clear();
+	}
+
+	return(bCompressed);
+}
+
+/***********************************************************
+ *  BindProgram()
+ *
+ *  This method is used for caching the location of the array
+ *  sampler in a shader program.  Without bindless handles,
+ *  each array is bound to the texture unit of its index.  If
+ *  the shader was not compiled with bindless samplers, the
+ *  handles are released and the texture units are used.
+ ***********************************************************/
+void TextureArrayManager::BindProgram(GLuint programID, const char* samplerName)
+{
+	m_samplerLocation = glGetUniformLocation(programID, samplerName);
+
+	if ((m_bBindless == true) && (m_arrays.size() > 0))
+	{
+		// clear any earlier errors before testing the handle
+		while (glGetError() != GL_NO_ERROR)
+		{
+		}
+
+		glProgramUniformHandleui64ARB(programID, m_samplerLocation, m_arrays[0].handle);
+		if (glGetError() != GL_NO_ERROR)
+		{
+			std::cout << "Shader sampler:" << samplerName << " does not take bindless handles, using texture units" << std::endl;
+			for (int i = 0; i < m_arrays.size(); i++)
+			{
+				glMakeTextureHandleNonResidentARB(m_arrays[i].handle);
+				m_arrays[i].handle = 0;
+			}
+			m_bBindless = false;
+		}
+	}
+
+	if (m_bBindless == false)
+	{
+		GLint maxUnits = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
+		if (m_arrays.size() > maxUnits)
+		{
+			std::cout << "Only the first " << maxUnits << " of " << m_arrays.size() << " texture arrays can be bound" << std::endl;
+		}
+
+		for (int i = 0; (i < m_arrays.size()) && (i < maxUnits); i++)
+		{
+			// bind the arrays on corresponding texture units
+			glActiveTexture(GL_TEXTURE0 + i);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[i].ID);
+		}
+	}
+}
+
+/***********************************************************
+ *  SelectProgram()
+ *
+ *  This method is used for changing the sampler that the
+ *  arrays are set into when the draws switch to another
+ *  program that BindProgram() has already connected.
+ ***********************************************************/
+void TextureArrayManager::SelectProgram(GLuint programID, const char* samplerName)
+{
+	m_samplerLocation = glGetUniformLocation(programID, samplerName);
+}
+
+/***********************************************************
+ *  DestroyArrays()
+ *
+ *  This method is used for freeing the texture arrays.
+ ***********************************************************/
+void TextureArrayManager::DestroyArrays()
+{
+	for (int i = 0; i < m_arrays.size(); i++)
+	{
+		if (0 != m_arrays[i].handle)
+		{
+			glMakeTextureHandleNonResidentARB(m_arrays[i].handle);
+			m_arrays[i].handle = 0;
+		}
+		if (0 != m_arrays[i].ID)
+		{
+			glDeleteTextures(1, &m_arrays[i].ID);
+			m_arrays[i].ID = 0;
+		}
+	}
+	m_arrays.clear();
+	m_textureLayers.clear();
+	m_textureReady.clear();
+	m_placeholderLayer.arrayIndex = -1;
+
+	if (0 != m_uploadBuffer)
+	{
+		glDeleteBuffers(1, &m_uploadBuffer);
+		m_uploadBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  SetShaderArray()
+ *
+ *  This method is used for setting the array that the next
+ *  draw samples from, by handle or by texture unit.
+ ***********************************************************/
+void TextureArrayManager::SetShaderArray(int arrayIndex)
+{
+	if ((arrayIndex < 0) || (arrayIndex >= m_arrays.size()))
+	{
+		return;
+	}
+
+	if (m_bBindless == true)
+	{
+		glUniformHandleui64ARB(m_samplerLocation, m_arrays[arrayIndex].handle);
+	}
+	else
+	{
+		glUniform1i(m_samplerLocation, arrayIndex);
+	}
+}
+
+/***********************************************************
+ *  GetTextureLayer()
+ *
+ *  This method is used for getting the array and layer that
+ *  a texture is drawn with.  Until the pixels of the texture
+ *  are uploaded, this is the placeholder layer.
+ ***********************************************************/
+const TextureArrayManager::TEXTURE_LAYER& TextureArrayManager::GetTextureLayer(int texture) const
+{
+	if (m_textureReady[texture] == false)
+	{
+		return(m_placeholderLayer);
+	}
+
+	return(m_textureLayers[texture]);
+}
+
+/***********************************************************
+ *  IsTextureReady()
+ *
+ *  This method is used for checking whether the pixels of a
+ *  texture are uploaded.
+ ***********************************************************/
+bool TextureArrayManager::IsTextureReady(int texture) const
+{
+	return(m_textureReady[texture]);
+}
+
+/***********************************************************
+ *  GetArrayID()
+ *
+ *  This method is used for getting the OpenGL texture of
+ *  an array.
+ ***********************************************************/
+GLuint TextureArrayManager::GetArrayID(int arrayIndex) const
+{
+	return(m_arrays[arrayIndex].ID);
+}
+
+/***********************************************************
+ *  GetArrayCount()
+ *
+ *  This method is used for getting the number of arrays.
+ ***********************************************************/
+int TextureArrayManager::GetArrayCount() const
+{
+	return((int)m_arrays.size());
+}
+
+/***********************************************************
+ *  IsBindless()
+ *
+ *  This method is used for checking whether the arrays are
+ *  passed to the shader by bindless handle.
+ ***********************************************************/
+bool TextureArrayManager::IsBindless() const
+{
+	return(m_bBindless);
+}
+
+/***********************************************************
+ *  EnableCompression()
+ *
+ *  This method is used for allowing the image arrays to be
+ *  stored block compressed.  It must be called before the
+ *  arrays are built.
+ ***********************************************************/
+void TextureArrayManager::EnableCompression(bool bEnable)
+{
+	m_bUseCompression = bEnable;
+}
+
+/***********************************************************
+ *  GetCompressedFormat()
+ *
+ *  This method is used for getting the compressed format of
+ *  the image arrays, which is zero when they hold RGBA8.
+ ***********************************************************/
+GLenum TextureArrayManager::GetCompressedFormat() const
+{
+	return(m_compressedFormat);
+}
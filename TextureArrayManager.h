@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureArrayManager.h
+// ============
+// pack the scene textures into 2D texture arrays
+//
+//  Textures with the same width and height are stored as layers of one
+//  GL_TEXTURE_2D_ARRAY, so a draw selects its texture by layer instead of
+//  by texture unit.  When the driver supports ARB_bindless_texture, the
+//  arrays are made resident and passed to the shader by handle, so no
+//  texture units are used at all.
+//
+//  The layers are reserved from the image sizes before any pixels are
+//  decoded.  Each layer is uploaded through a pixel buffer when its image
+//  arrives, and until then it is drawn with a 1x1 placeholder.
+//
+//  When the driver supports BC7, or else BC3, the arrays are stored block
+//  compressed.  The levels are then uploaded already compressed, either from
+//  the texture cache or after the driver compresses a decoded image.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureCache.h"
+
+#include <GL/glew.h>
+
+#include <vector>
+
+/***********************************************************
+ *  TextureArrayManager
+ *
+ *  This class contains the code for building, binding and
+ *  freeing the texture arrays that hold the scene textures.
+ ***********************************************************/
+class TextureArrayManager
+{
+public:
+	// constructor
+	TextureArrayManager();
+	// destructor
+	~TextureArrayManager();
+
+	// where a loaded texture lives among the arrays
+	struct TEXTURE_LAYER
+	{
+		int arrayIndex;
+		int layer;
+	};
+
+private:
+	// one texture array and the number of layers reserved in it
+	struct TEXTURE_ARRAY
+	{
+		int width;
+		int height;
+		int layerCount;
+		GLenum internalFormat;
+		GLuint ID;
+		GLuint64 handle;
+	};
+
+	// the texture arrays, one or more for each image size, with
+	// the placeholder array last once the arrays are built
+	std::vector<TEXTURE_ARRAY> m_arrays;
+	// array and layer of every reserved texture
+	std::vector<TEXTURE_LAYER> m_textureLayers;
+	// true for each texture once its pixels are uploaded
+	std::vector<bool> m_textureReady;
+	// array index and layer drawn for textures not uploaded yet
+	TEXTURE_LAYER m_placeholderLayer;
+	// pixel buffer used to stream the layer uploads
+	GLuint m_uploadBuffer;
+	// most layers a single array can hold
+	int m_maxLayers;
+	// true when the arrays are passed to the shader by handle
+	bool m_bBindless;
+	// cached location of the array sampler in the shader
+	GLint m_samplerLocation;
+	// true when the image arrays may be stored compressed
+	bool m_bUseCompression;
+	// compressed format of the image arrays, zero for RGBA8
+	GLenum m_compressedFormat;
+
+	// copy the first levels into the pixel buffer and leave it bound
+	bool FillUploadBuffer(const TextureCache::MIP_LEVELS& levels, int levelCount);
+
+	// create the storage of an array for every mipmap level
+	void AllocateArray(TEXTURE_ARRAY& textureArray);
+
+public:
+	// reserve a layer for an image of the passed in size and get
+	// its texture index
+	int ReserveImage(int width, int height);
+	// create the arrays for the reserved layers and the placeholder
+	bool BuildArrays();
+	// upload the RGBA level 0 of a reserved texture
+	bool UploadImage(int texture, const TextureCache::MIP_LEVELS& levels, int width, int height);
+	// upload the compressed levels of a reserved texture
+	bool UploadCompressedImage(int texture, const TextureCache::MIP_LEVELS& levels, int width, int height);
+	// have the driver compress a chain of RGBA levels
+	bool CompressImage(
+		const TextureCache::MIP_LEVELS& pixelLevels,
+		int width,
+		int height,
+		TextureCache::MIP_LEVELS& compressedLevels);
+
+	// allow the image arrays to be stored compressed
+	void EnableCompression(bool bEnable);
+	// get the compressed format of the image arrays, zero for RGBA8
+	GLenum GetCompressedFormat() const;
+	// connect the array sampler of a shader program
+	void BindProgram(GLuint programID, const char* samplerName);
+	// set the arrays into another already connected program
+	void SelectProgram(GLuint programID, const char* samplerName);
+	// free the arrays
+	void DestroyArrays();
+
+	// set the array used by the next draw into the shader
+	void SetShaderArray(int arrayIndex);
+
+	// get the array and layer to draw a texture with, which is the
+	// placeholder until the texture is uploaded
+	const TEXTURE_LAYER& GetTextureLayer(int texture) const;
+	// true once the pixels of a texture are uploaded
+	bool IsTextureReady(int texture) const;
+	// get the OpenGL texture of an array
+	GLuint GetArrayID(int arrayIndex) const;
+	// get the number of arrays
+	int GetArrayCount() const;
+	// true when the arrays are passed by bindless handle
+	bool IsBindless() const;
+};
@@ -0,0 +1,316 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureCache.cpp
+// ============
+// read and write block compressed textures in an on-disk cache
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// both supported formats store a 4x4 block of texels in 16 bytes
+	const int g_BlockBytes = 16;
+
+	// DDS flags and format codes used by the cache files
+	const uint32_t g_DDSMagic = 0x20534444;	// "DDS "
+	const uint32_t g_DX10FourCC = 0x30315844;	// "DX10"
+	const uint32_t g_DDSHeaderFlags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+	const uint32_t g_DDSPixelFormatFourCC = 0x4;
+	const uint32_t g_DDSCaps = 0x8 | 0x1000 | 0x400000;
+	const uint32_t g_DXGIFormatBC3 = 77;
+	const uint32_t g_DXGIFormatBC7 = 98;
+	const uint32_t g_DX10Texture2D = 3;
+
+	// the DDS file header followed by the DX10 extension header
+	struct DDS_HEADER
+	{
+		uint32_t magic;
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t linearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		uint32_t pixelFormatSize;
+		uint32_t pixelFormatFlags;
+		uint32_t fourCC;
+		uint32_t pixelFormatUnused[5];
+		uint32_t caps;
+		uint32_t caps2;
+		uint32_t caps3;
+		uint32_t caps4;
+		uint32_t reserved2;
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+	static_assert(sizeof(DDS_HEADER) == 4 + 124 + 20, "DDS header must match the file layout");
+
+	/***********************************************************
+	 *  GetDXGIFormat()
+	 *
+	 *  Get the DDS format code for an OpenGL compressed format.
+	 ***********************************************************/
+	uint32_t GetDXGIFormat(GLenum compressedFormat)
+	{
+		if (GL_COMPRESSED_RGBA_BPTC_UNORM == compressedFormat)
+		{
+			return(g_DXGIFormatBC7);
+		}
+		if (GL_COMPRESSED_RGBA_S3TC_DXT5_EXT == compressedFormat)
+		{
+			return(g_DXGIFormatBC3);
+		}
+		return(0);
+	}
+
+	/***********************************************************
+	 *  MakeDirectory()
+	 *
+	 *  Create the directory that holds a file if it is missing.
+	 ***********************************************************/
+	void MakeDirectory(const std::string& path)
+	{
+		size_t separator = path.find_last_of("/\\");
+		if (std::string::npos == separator)
+		{
+			return;
+		}
+
+		std::string directory = path.substr(0, separator);
+#ifdef _WIN32
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+	}
+}
+
+/***********************************************************
+ *  GetLevelCount()
+ *
+ *  This method is used for getting the number of mipmap
+ *  levels from the passed in size down to 1x1.
+ ***********************************************************/
+int TextureCache::GetLevelCount(int width, int height)
+{
+	int levels = 1;
+	while (((width >> levels) > 0) || ((height >> levels) > 0))
+	{
+		levels++;
+	}
+
+	return(levels);
+}
+
+/***********************************************************
+ *  GetCompressedLevelSize()
+ *
+ *  This method is used for getting the size in bytes of a
+ *  compressed mipmap level, which is stored in 4x4 blocks.
+ ***********************************************************/
+int TextureCache::GetCompressedLevelSize(int width, int height)
+{
+	return(((width + 3) / 4) * ((height + 3) / 4) * g_BlockBytes);
+}
+
+/***********************************************************
+ *  HashData()
+ *
+ *  This method is used for hashing the bytes of a source
+ *  image with 64-bit FNV-1a, so an edited image gets a new
+ *  cache file.
+ ***********************************************************/
+uint64_t TextureCache::HashData(const unsigned char* data, size_t size)
+{
+	uint64_t hash = 14695981039346656037ull;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+
+	return(hash);
+}
+
+/***********************************************************
+ *  GetCachePath()
+ *
+ *  This method is used for getting the cache file for the
+ *  hash of a source image and a compressed format.
+ ***********************************************************/
+std::string TextureCache::GetCachePath(
+	const std::string& directory,
+	uint64_t hash,
+	GLenum compressedFormat)
+{
+	char name[64];
+	snprintf(
+		name,
+		sizeof(name),
+		"%016llx_%s.dds",
+		(unsigned long long)hash,
+		(GetDXGIFormat(compressedFormat) == g_DXGIFormatBC7) ? "bc7" : "bc3");
+
+	return(directory + "/" + name);
+}
+
+/***********************************************************
+ *  BuildMipChain()
+ *
+ *  This method is used for adding every mipmap level below
+ *  the RGBA level 0 that is already in the passed in list.
+ *  Each texel of a level is the average of a 2x2 box of the
+ *  level above it, clamped at odd edges.
+ ***********************************************************/
+void TextureCache::BuildMipChain(MIP_LEVELS& levels, int width, int height)
+{
+	int levelCount = GetLevelCount(width, height);
+
+	levels.resize(levelCount);
+	for (int level = 1; level < levelCount; level++)
+	{
+		int sourceWidth = std::max(width >> (level - 1), 1);
+		int sourceHeight = std::max(height >> (level - 1), 1);
+		int levelWidth = std::max(width >> level, 1);
+		int levelHeight = std::max(height >> level, 1);
+		const std::vector<unsigned char>& source = levels[level - 1];
+		std::vector<unsigned char>& target = levels[level];
+
+		target.resize((size_t)levelWidth * levelHeight * 4);
+		for (int y = 0; y < levelHeight; y++)
+		{
+			int y0 = std::min(y * 2, sourceHeight - 1);
+			int y1 = std::min(y * 2 + 1, sourceHeight - 1);
+			for (int x = 0; x < levelWidth; x++)
+			{
+				int x0 = std::min(x * 2, sourceWidth - 1);
+				int x1 = std::min(x * 2 + 1, sourceWidth - 1);
+				for (int channel = 0; channel < 4; channel++)
+				{
+					int sum =
+						source[((size_t)y0 * sourceWidth + x0) * 4 + channel] +
+						source[((size_t)y0 * sourceWidth + x1) * 4 + channel] +
+						source[((size_t)y1 * sourceWidth + x0) * 4 + channel] +
+						source[((size_t)y1 * sourceWidth + x1) * 4 + channel];
+					target[((size_t)y * levelWidth + x) * 4 + channel] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  ReadCache()
+ *
+ *  This method is used for reading the compressed levels of
+ *  a texture from its cache file.  The file is only used if
+ *  its format, size and mipmap count match what is expected.
+ ***********************************************************/
+bool TextureCache::ReadCache(
+	const std::string& path,
+	GLenum compressedFormat,
+	int width,
+	int height,
+	MIP_LEVELS& levels)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (NULL == file)
+	{
+		return(false);
+	}
+
+	DDS_HEADER header;
+	int levelCount = GetLevelCount(width, height);
+	bool bValid =
+		(fread(&header, sizeof(header), 1, file) == 1) &&
+		(header.magic == g_DDSMagic) &&
+		(header.fourCC == g_DX10FourCC) &&
+		(header.dxgiFormat == GetDXGIFormat(compressedFormat)) &&
+		(header.width == (uint32_t)width) &&
+		(header.height == (uint32_t)height) &&
+		(header.mipMapCount == (uint32_t)levelCount);
+
+	levels.clear();
+	for (int level = 0; (level < levelCount) && (bValid == true); level++)
+	{
+		int levelSize = GetCompressedLevelSize(
+			std::max(width >> level, 1),
+			std::max(height >> level, 1));
+
+		levels.push_back(std::vector<unsigned char>(levelSize));
+		bValid = (fread(&levels.back()[0], levelSize, 1, file) == 1);
+	}
+	fclose(file);
+
+	if (bValid == false)
+	{
+		levels.clear();
+	}
+
+	return(bValid);
+}
+
+/***********************************************************
+ *  WriteCache()
+ *
+ *  This method is used for writing the compressed levels of
+ *  a texture into its cache file as a DX10 DDS file.
+ ***********************************************************/
+bool TextureCache::WriteCache(
+	const std::string& path,
+	GLenum compressedFormat,
+	int width,
+	int height,
+	const MIP_LEVELS& levels)
+{
+	MakeDirectory(path);
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (NULL == file)
+	{
+		return(false);
+	}
+
+	DDS_HEADER header;
+	memset(&header, 0, sizeof(header));
+	header.magic = g_DDSMagic;
+	header.size = 124;
+	header.flags = g_DDSHeaderFlags;
+	header.height = height;
+	header.width = width;
+	header.linearSize = GetCompressedLevelSize(width, height);
+	header.mipMapCount = (uint32_t)levels.size();
+	header.pixelFormatSize = 32;
+	header.pixelFormatFlags = g_DDSPixelFormatFourCC;
+	header.fourCC = g_DX10FourCC;
+	header.caps = g_DDSCaps;
+	header.dxgiFormat = GetDXGIFormat(compressedFormat);
+	header.resourceDimension = g_DX10Texture2D;
+	header.arraySize = 1;
+
+	bool bWritten = (fwrite(&header, sizeof(header), 1, file) == 1);
+	for (int level = 0; (level < levels.size()) && (bWritten == true); level++)
+	{
+		bWritten = (fwrite(&levels[level][0], levels[level].size(), 1, file) == 1);
+	}
+	fclose(file);
+
+	return(bWritten);
+}
@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureCache.h
+// ============
+// read and write block compressed textures in an on-disk cache
+//
+//  The first run decodes each texture image, builds its mipmap chain and
+//  has the driver compress every level.  The compressed levels are written
+//  to a DDS file named after a hash of the source image, so later runs load
+//  the blocks directly without decoding or compressing anything.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureCache
+ *
+ *  This class contains the code for hashing source images,
+ *  building mipmap chains and reading and writing the cached
+ *  compressed textures.  It does not need OpenGL, so it can
+ *  be used from the texture loading threads.
+ ***********************************************************/
+class TextureCache
+{
+public:
+	// the pixel data of each mipmap level, largest first
+	typedef std::vector<std::vector<unsigned char> > MIP_LEVELS;
+
+	// get the number of mipmap levels down to 1x1
+	static int GetLevelCount(int width, int height);
+	// get the size in bytes of a compressed mipmap level
+	static int GetCompressedLevelSize(int width, int height);
+
+	// hash the bytes of a source image file
+	static uint64_t HashData(const unsigned char* data, size_t size);
+	// get the cache file for a source image hash and format
+	static std::string GetCachePath(
+		const std::string& directory,
+		uint64_t hash,
+		GLenum compressedFormat);
+
+	// build the RGBA mipmap chain below level 0
+	static void BuildMipChain(MIP_LEVELS& levels, int width, int height);
+
+	// read the compressed levels from a cache file
+	static bool ReadCache(
+		const std::string& path,
+		GLenum compressedFormat,
+		int width,
+		int height,
+		MIP_LEVELS& levels);
+	// write the compressed levels into a cache file
+	static bool WriteCache(
+		const std::string& path,
+		GLenum compressedFormat,
+		int width,
+		int height,
+		const MIP_LEVELS& levels);
+};
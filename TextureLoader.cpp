@@ -0,0 +1,244 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureLoader.cpp
+// ============
+// decode texture image files on a pool of worker threads
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLoader::TextureLoader()
+{
+	m_pendingImages = 0;
+	m_compressedFormat = 0;
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	Stop();
+
+	// free any images that were never collected
+	for (int i = 0; i < m_decodedImages.size(); i++)
+	{
+		FreeImage(m_decodedImages[i]);
+	}
+	m_decodedImages.clear();
+}
+
+/***********************************************************
+ *  QueueImage()
+ *
+ *  This method is used for queueing an image file to be
+ *  decoded for the passed in texture index.
+ ***********************************************************/
+void TextureLoader::QueueImage(int texture, const std::string& filename)
+{
+	IMAGE_JOB job;
+	job.texture = texture;
+	job.filename = filename;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_jobs.push_back(job);
+	m_pendingImages++;
+}
+
+/***********************************************************
+ *  SetTextureCache()
+ *
+ *  This method is used for loading and building compressed
+ *  textures in the passed in cache directory.  It must be
+ *  called before the workers are started.
+ ***********************************************************/
+void TextureLoader::SetTextureCache(const std::string& directory, GLenum compressedFormat)
+{
+	m_cacheDirectory = directory;
+	m_compressedFormat = compressedFormat;
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the worker threads that
+ *  decode the queued images.  One core is left for the GL
+ *  thread, and no more threads are started than there are
+ *  images.
+ ***********************************************************/
+void TextureLoader::Start()
+{
+	int threadCount = (int)std::thread::hardware_concurrency() - 1;
+	threadCount = std::max(threadCount, 1);
+	threadCount = std::min(threadCount, (int)m_jobs.size());
+
+	// the flip flag in stb_image is global, so it is set here
+	// one time before any worker starts decoding
+	stbi_set_flip_vertically_on_load(true);
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		m_workers.push_back(std::thread(&TextureLoader::DecodeImages, this));
+	}
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for waiting for the worker threads
+ *  to finish decoding.
+ ***********************************************************/
+void TextureLoader::Stop()
+{
+	for (int i = 0; i < m_workers.size(); i++)
+	{
+		if (m_workers[i].joinable())
+		{
+			m_workers[i].join();
+		}
+	}
+	m_workers.clear();
+}
+
+/***********************************************************
+ *  DecodeImages()
+ *
+ *  This method is run by each worker thread to decode
+ *  queued images until the queue is empty.  The layers of a
+ *  texture array share one format, so every image is read
+ *  as RGBA.  With a compressed format set, the cache file
+ *  for the hash of the image file is loaded when it exists,
+ *  otherwise the mipmap chain is built for compressing.
+ ***********************************************************/
+void TextureLoader::DecodeImages()
+{
+	while (true)
+	{
+		IMAGE_JOB job;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_jobs.empty())
+			{
+				return;
+			}
+			job = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		DECODED_IMAGE image;
+		image.texture = job.texture;
+		image.filename = job.filename;
+		image.bCompressed = false;
+		image.width = 0;
+		image.height = 0;
+		image.colorChannels = 0;
+
+		// the file is read one time for both the hash and the decode
+		std::ifstream file(job.filename.c_str(), std::ios::binary);
+		std::vector<unsigned char> fileData(
+			(std::istreambuf_iterator<char>(file)),
+			std::istreambuf_iterator<char>());
+
+		if ((fileData.size() > 0) &&
+			stbi_info_from_memory(&fileData[0], (int)fileData.size(), &image.width, &image.height, &image.colorChannels))
+		{
+			if (0 != m_compressedFormat)
+			{
+				image.cachePath = TextureCache::GetCachePath(
+					m_cacheDirectory,
+					TextureCache::HashData(&fileData[0], fileData.size()),
+					m_compressedFormat);
+				image.bCompressed = TextureCache::ReadCache(
+					image.cachePath,
+					m_compressedFormat,
+					image.width,
+					image.height,
+					image.levels);
+			}
+
+			if (image.bCompressed == false)
+			{
+				unsigned char* pixels = stbi_load_from_memory(
+					&fileData[0],
+					(int)fileData.size(),
+					&image.width,
+					&image.height,
+					&image.colorChannels,
+					4);
+				if (NULL != pixels)
+				{
+					image.levels.resize(1);
+					image.levels[0].assign(pixels, pixels + (size_t)image.width * image.height * 4);
+					stbi_image_free(pixels);
+
+					if (0 != m_compressedFormat)
+					{
+						TextureCache::BuildMipChain(image.levels, image.width, image.height);
+					}
+				}
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_decodedImages.push_back(image);
+	}
+}
+
+/***********************************************************
+ *  PopDecodedImage()
+ *
+ *  This method is used for taking the next decoded image
+ *  without waiting.  It returns false when no image is ready.
+ ***********************************************************/
+bool TextureLoader::PopDecodedImage(DECODED_IMAGE& image)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_decodedImages.empty())
+	{
+		return(false);
+	}
+
+	image.levels.clear();
+	std::swap(image, m_decodedImages.front());
+	m_decodedImages.pop_front();
+	m_pendingImages--;
+
+	return(true);
+}
+
+/***********************************************************
+ *  FreeImage()
+ *
+ *  This method is used for freeing the levels of a decoded
+ *  image once they are uploaded.
+ ***********************************************************/
+void TextureLoader::FreeImage(DECODED_IMAGE& image)
+{
+	TextureCache::MIP_LEVELS().swap(image.levels);
+}
+
+/***********************************************************
+ *  GetPendingCount()
+ *
+ *  This method is used for getting the number of queued
+ *  images that have not been handed back yet.
+ ***********************************************************/
+int TextureLoader::GetPendingCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return(m_pendingImages);
+}
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+// TextureLoader.h
+// ============
+// decode texture image files on a pool of worker threads
+//
+//  Decoding a JPEG takes far longer than uploading it, so the images are
+//  decoded away from the GL thread.  The GL thread collects each decoded
+//  image when it is finished and uploads it without waiting for the rest.
+//  When a compressed format is set, a cached compressed copy of the image
+//  is loaded instead of decoding it, and a decoded image gets its whole
+//  mipmap chain built here so the GL thread only has to compress it.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureCache.h"
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class contains the code for decoding queued image
+ *  files on worker threads and handing back the results.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// constructor
+	TextureLoader();
+	// destructor
+	~TextureLoader();
+
+	// one loaded image, levels is empty when it failed - the
+	// levels hold compressed blocks when bCompressed is set and
+	// RGBA pixels otherwise
+	struct DECODED_IMAGE
+	{
+		int texture;
+		std::string filename;
+		std::string cachePath;
+		bool bCompressed;
+		TextureCache::MIP_LEVELS levels;
+		int width;
+		int height;
+		int colorChannels;
+	};
+
+private:
+	// image file waiting to be decoded
+	struct IMAGE_JOB
+	{
+		int texture;
+		std::string filename;
+	};
+
+	// worker threads decoding the queued images
+	std::vector<std::thread> m_workers;
+	// guards the job and result queues
+	std::mutex m_mutex;
+	std::deque<IMAGE_JOB> m_jobs;
+	std::deque<DECODED_IMAGE> m_decodedImages;
+	// images queued and not yet handed back
+	int m_pendingImages;
+	// compressed texture cache, unused when the format is zero
+	std::string m_cacheDirectory;
+	GLenum m_compressedFormat;
+
+	// decode queued images until there are none left
+	void DecodeImages();
+
+public:
+	// queue an image file to be decoded for a texture index
+	void QueueImage(int texture, const std::string& filename);
+	// use the compressed texture cache in the passed in directory
+	void SetTextureCache(const std::string& directory, GLenum compressedFormat);
+	// start decoding the queued images on worker threads
+	void Start();
+	// wait for the worker threads to finish
+	void Stop();
+
+	// take the next decoded image, false when none is ready
+	bool PopDecodedImage(DECODED_IMAGE& image);
+	// free the levels of a decoded image
+	static void FreeImage(DECODED_IMAGE& image);
+
+	// get the number of images that have not been handed back
+	int GetPendingCount();
+};
@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+// UniformBufferManager.cpp
+// ============
+// manage the std140 uniform buffer blocks that are shared by the shaders
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformBufferManager.h"
+
+#include <cstddef>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// uniform block names, in the order of UNIFORM_BLOCK
+	const char* g_BlockNames[] = { "Camera", "Lights", "Materials" };
+	const char* g_MaterialIndexName = "materialIndex";
+
+	// the std140 sizes of the blocks declared in the GLSL files
+	static_assert(sizeof(UniformBufferManager::CAMERA_DATA) == 144, "Camera block must match std140 layout");
+	static_assert(sizeof(UniformBufferManager::DIRECTIONAL_LIGHT_DATA) == 64, "DirectionalLight must match std140 layout");
+	static_assert(sizeof(UniformBufferManager::POINT_LIGHT_DATA) == 64, "PointLight must match std140 layout");
+	static_assert(sizeof(UniformBufferManager::SPOT_LIGHT_DATA) == 96, "SpotLight must match std140 layout");
+	static_assert(sizeof(UniformBufferManager::SHADOW_DATA) == 224, "ShadowCascades must match std140 layout");
+	static_assert(sizeof(UniformBufferManager::LIGHTS_DATA) == 1024, "Lights block must match std140 layout");
+	static_assert(sizeof(UniformBufferManager::MATERIAL_DATA) == 32, "Material must match std140 layout");
+}
+
+/***********************************************************
+ *  UniformBufferManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UniformBufferManager::UniformBufferManager()
+{
+	for (int i = 0; i < TOTAL_UNIFORM_BLOCKS; i++)
+	{
+		m_bufferIDs[i] = 0;
+	}
+	m_programID = 0;
+	m_materialIndexLocation = -1;
+	m_currentMaterialIndex = -1;
+	m_camera.view = glm::mat4(1.0f);
+	m_camera.projection = glm::mat4(1.0f);
+	m_camera.viewPosition = glm::vec3(0.0f, 0.0f, 0.0f);
+	m_camera.padding0 = 0.0f;
+}
+
+/***********************************************************
+ *  ~UniformBufferManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+UniformBufferManager::~UniformBufferManager()
+{
+	DestroyBuffers();
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used for creating one uniform buffer and
+ *  attaching it to the binding point of its block.
+ ***********************************************************/
+void UniformBufferManager::CreateBuffer(UNIFORM_BLOCK block, GLsizeiptr size)
+{
+	glGenBuffers(1, &m_bufferIDs[block]);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferIDs[block]);
+	glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, block, m_bufferIDs[block]);
+}
+
+/***********************************************************
+ *  UpdateBuffer()
+ *
+ *  This method is used for writing data into the buffer for
+ *  a uniform block, at the given offset from its start.
+ ***********************************************************/
+void UniformBufferManager::UpdateBuffer(UNIFORM_BLOCK block, const void* data, GLsizeiptr size, GLintptr offset)
+{
+	if (0 == m_bufferIDs[block])
+	{
+		return;
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferIDs[block]);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+/***********************************************************
+ *  CreateBuffers()
+ *
+ *  This method is used for creating the uniform buffers and
+ *  binding the uniform blocks of the passed in shader program
+ *  to them.  It must be called after OpenGL is initialized.
+ ***********************************************************/
+bool UniformBufferManager::CreateBuffers(GLuint programID)
+{
+	CreateBuffer(CAMERA_BLOCK, sizeof(CAMERA_DATA));
+	CreateBuffer(LIGHTS_BLOCK, sizeof(LIGHTS_DATA));
+	CreateBuffer(MATERIALS_BLOCK, sizeof(MATERIAL_DATA) * TOTAL_MATERIALS);
+
+	BindProgramBlocks(programID);
+
+	return(glGetError() == GL_NO_ERROR);
+}
+
+/***********************************************************
+ *  BindProgramBlocks()
+ *
+ *  This method is used for connecting each uniform block in
+ *  a shader program to the binding point of its buffer.
+ *  Blocks that the program does not declare are skipped.
+ ***********************************************************/
+void UniformBufferManager::BindProgramBlocks(GLuint programID)
+{
+	for (int i = 0; i < TOTAL_UNIFORM_BLOCKS; i++)
+	{
+		GLuint blockIndex = glGetUniformBlockIndex(programID, g_BlockNames[i]);
+		if (GL_INVALID_INDEX != blockIndex)
+		{
+			glUniformBlockBinding(programID, blockIndex, i);
+		}
+		else
+		{
+			std::cout << "Shader program does not use uniform block:" << g_BlockNames[i] << std::endl;
+		}
+	}
+
+	SelectProgram(programID);
+}
+
+/***********************************************************
+ *  SelectProgram()
+ *
+ *  This method is used for pointing the material index at a
+ *  program whose blocks are already bound, when the draws
+ *  switch between variants of the shader.
+ ***********************************************************/
+void UniformBufferManager::SelectProgram(GLuint programID)
+{
+	// the material index location is looked up here one time
+	// so that changing it per draw needs no name lookup
+	m_programID = programID;
+	m_materialIndexLocation = glGetUniformLocation(programID, g_MaterialIndexName);
+	m_currentMaterialIndex = -1;
+}
+
+/***********************************************************
+ *  DestroyBuffers()
+ *
+ *  This method is used for freeing the uniform buffers.
+ ***********************************************************/
+void UniformBufferManager::DestroyBuffers()
+{
+	for (int i = 0; i < TOTAL_UNIFORM_BLOCKS; i++)
+	{
+		if (0 != m_bufferIDs[i])
+		{
+			glDeleteBuffers(1, &m_bufferIDs[i]);
+			m_bufferIDs[i] = 0;
+		}
+	}
+}
+
+/***********************************************************
+ *  UpdateCamera()
+ *
+ *  This method is used for writing the per-frame camera
+ *  values into the camera block.
+ ***********************************************************/
+void UniformBufferManager::UpdateCamera(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const glm::vec3& viewPosition)
+{
+	m_camera.view = view;
+	m_camera.projection = projection;
+	m_camera.viewPosition = viewPosition;
+	m_camera.padding0 = 0.0f;
+
+	UpdateBuffer(CAMERA_BLOCK, &m_camera, sizeof(m_camera));
+}
+
+/***********************************************************
+ *  UpdateLights()
+ *
+ *  This method is used for writing the scene lights into
+ *  the lights block.  The shadows at the end of the block
+ *  change on their own, so they are not written here.
+ ***********************************************************/
+void UniformBufferManager::UpdateLights(const LIGHTS_DATA& lights)
+{
+	UpdateBuffer(LIGHTS_BLOCK, &lights, offsetof(LIGHTS_DATA, shadows));
+}
+
+/***********************************************************
+ *  UpdateShadows()
+ *
+ *  This method is used for writing the shadow cascades into
+ *  the end of the lights block.
+ ***********************************************************/
+void UniformBufferManager::UpdateShadows(const SHADOW_DATA& shadows)
+{
+	UpdateBuffer(LIGHTS_BLOCK, &shadows, sizeof(shadows), offsetof(LIGHTS_DATA, shadows));
+}
+
+/***********************************************************
+ *  UpdateMaterials()
+ *
+ *  This method is used for writing the defined materials
+ *  into the materials block.  The position of a material in
+ *  the passed in list is its material index in the shader.
+ ***********************************************************/
+void UniformBufferManager::UpdateMaterials(const MATERIAL_DATA* materials, int count)
+{
+	if (count > TOTAL_MATERIALS)
+	{
+		std::cout << "Only the first " << TOTAL_MATERIALS << " of " << count << " materials can be used" << std::endl;
+		count = TOTAL_MATERIALS;
+	}
+
+	UpdateBuffer(MATERIALS_BLOCK, materials, sizeof(MATERIAL_DATA) * count);
+}
+
+/***********************************************************
+ *  SetMaterialIndex()
+ *
+ *  This method is used for selecting the material in the
+ *  materials block that the next draw will use.
+ ***********************************************************/
+void UniformBufferManager::SetMaterialIndex(int materialIndex)
+{
+	if ((materialIndex < 0) ||
+		(materialIndex >= TOTAL_MATERIALS) ||
+		(materialIndex == m_currentMaterialIndex))
+	{
+		return;
+	}
+
+	glUniform1i(m_materialIndexLocation, materialIndex);
+	m_currentMaterialIndex = materialIndex;
+}
+
+/***********************************************************
+ *  GetCameraData()
+ *
+ *  This method is used for getting the camera values that
+ *  were written for the current frame.
+ ***********************************************************/
+const UniformBufferManager::CAMERA_DATA& UniformBufferManager::GetCameraData() const
+{
+	return(m_camera);
+}
@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+// UniformBufferManager.h
+// ============
+// manage the std140 uniform buffer blocks that are shared by the shaders
+//
+//  The camera, lights and materials are kept in uniform buffer objects so
+//  that a draw only has to change the material index instead of setting
+//  every value by name through the ShaderManager.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  UniformBufferManager
+ *
+ *  This class contains the code for creating, binding and
+ *  updating the uniform buffer blocks used by the shaders.
+ ***********************************************************/
+class UniformBufferManager
+{
+public:
+	// constructor
+	UniformBufferManager();
+	// destructor
+	~UniformBufferManager();
+
+	// binding points for the uniform blocks - these must
+	// match the block names declared in the GLSL files
+	enum UNIFORM_BLOCK
+	{
+		CAMERA_BLOCK = 0,
+		LIGHTS_BLOCK,
+		MATERIALS_BLOCK,
+		TOTAL_UNIFORM_BLOCKS
+	};
+
+	// these must match the defines in fragmentShader.glsl
+	static const int TOTAL_POINT_LIGHTS = 10;
+	static const int TOTAL_MATERIALS = 32;
+	static const int TOTAL_SHADOW_CASCADES = 3;
+
+	// the following structures are laid out to match the
+	// std140 rules, so the padding members must be kept
+	struct CAMERA_DATA
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 viewPosition;
+		float padding0;
+	};
+
+	struct DIRECTIONAL_LIGHT_DATA
+	{
+		glm::vec3 direction;
+		float padding0;
+		glm::vec3 ambient;
+		float padding1;
+		glm::vec3 diffuse;
+		float padding2;
+		glm::vec3 specular;
+		int bActive;
+	};
+
+	struct POINT_LIGHT_DATA
+	{
+		glm::vec3 position;
+		// distance where the light has faded out, 0 when it never does
+		float range;
+		glm::vec3 ambient;
+		float padding1;
+		glm::vec3 diffuse;
+		float padding2;
+		glm::vec3 specular;
+		int bActive;
+	};
+
+	struct SPOT_LIGHT_DATA
+	{
+		glm::vec3 position;
+		float padding0;
+		glm::vec3 direction;
+		float cutOff;
+		float outerCutOff;
+		float constant;
+		float linear;
+		float quadratic;
+		glm::vec3 ambient;
+		float padding1;
+		glm::vec3 diffuse;
+		float padding2;
+		glm::vec3 specular;
+		int bActive;
+	};
+
+	struct SHADOW_DATA
+	{
+		// light space of each cascade of the directional light
+		glm::mat4 lightViewProjection[TOTAL_SHADOW_CASCADES];
+		// view depth each cascade covers out to
+		glm::vec4 cascadeSplits;
+		// texel size of the shadow map and the depth bias
+		glm::vec4 parameters;
+	};
+
+	struct LIGHTS_DATA
+	{
+		DIRECTIONAL_LIGHT_DATA directionalLight;
+		POINT_LIGHT_DATA pointLights[TOTAL_POINT_LIGHTS];
+		SPOT_LIGHT_DATA spotLight;
+		// written apart from the lights whenever the cascades move
+		SHADOW_DATA shadows;
+	};
+
+	struct MATERIAL_DATA
+	{
+		glm::vec3 diffuseColor;
+		float padding0;
+		glm::vec3 specularColor;
+		float shininess;
+	};
+
+private:
+	// OpenGL buffer objects for each uniform block
+	GLuint m_bufferIDs[TOTAL_UNIFORM_BLOCKS];
+	// shader program the block bindings were made for
+	GLuint m_programID;
+	// cached location of the per-draw material index
+	GLint m_materialIndexLocation;
+	// material index currently set into the shader
+	int m_currentMaterialIndex;
+	// camera values written for the current frame
+	CAMERA_DATA m_camera;
+
+	// create one buffer and attach it to its binding point
+	void CreateBuffer(UNIFORM_BLOCK block, GLsizeiptr size);
+	// write data into a buffer, from the start unless an offset is given
+	void UpdateBuffer(UNIFORM_BLOCK block, const void* data, GLsizeiptr size, GLintptr offset = 0);
+
+public:
+	// create the buffers and bind the blocks of the shader program
+	bool CreateBuffers(GLuint programID);
+	// connect the uniform blocks of a shader program to the buffers
+	void BindProgramBlocks(GLuint programID);
+	// use the material index of another already bound program
+	void SelectProgram(GLuint programID);
+	// free the buffers
+	void DestroyBuffers();
+
+	// write the per-frame camera values
+	void UpdateCamera(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const glm::vec3& viewPosition);
+	// write the scene lights, leaving the shadows as they are
+	void UpdateLights(const LIGHTS_DATA& lights);
+	// write the shadow cascades of the directional light
+	void UpdateShadows(const SHADOW_DATA& shadows);
+	// write the defined materials
+	void UpdateMaterials(const MATERIAL_DATA* materials, int count);
+
+	// select the material used by the next draw
+	void SetMaterialIndex(int materialIndex);
+
+	// get the camera values written for the current frame
+	const CAMERA_DATA& GetCameraData() const;
+};
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+// ViewFrustum.cpp
+// ============
+// test bounding volumes against the planes of the camera view
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewFrustum.h"
+
+/***********************************************************
+ *  ViewFrustum()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewFrustum::ViewFrustum()
+{
+	// until planes are extracted nothing is outside
+	for (int i = 0; i < TOTAL_PLANES; i++)
+	{
+		m_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+/***********************************************************
+ *  MakeBounds()
+ *
+ *  This method is used for making a bounding volume from the
+ *  smallest and largest corners of a box.
+ ***********************************************************/
+BOUNDING_VOLUME ViewFrustum::MakeBounds(glm::vec3 minimum, glm::vec3 maximum)
+{
+	BOUNDING_VOLUME bounds;
+
+	bounds.center = (minimum + maximum) * 0.5f;
+	bounds.extents = (maximum - minimum) * 0.5f;
+	bounds.radius = glm::length(bounds.extents);
+
+	return(bounds);
+}
+
+/***********************************************************
+ *  TransformBounds()
+ *
+ *  This method is used for moving a bounding volume into the
+ *  space of a model matrix.  The new half sizes are the old
+ *  ones projected onto the absolute values of the rotated and
+ *  scaled axes, which is the smallest box around the moved one.
+ ***********************************************************/
+BOUNDING_VOLUME ViewFrustum::TransformBounds(const BOUNDING_VOLUME& bounds, const glm::mat4& model)
+{
+	BOUNDING_VOLUME result;
+
+	glm::vec3 axisX = glm::abs(glm::vec3(model[0]));
+	glm::vec3 axisY = glm::abs(glm::vec3(model[1]));
+	glm::vec3 axisZ = glm::abs(glm::vec3(model[2]));
+
+	result.center = glm::vec3(model * glm::vec4(bounds.center, 1.0f));
+	result.extents = axisX * bounds.extents.x + axisY * bounds.extents.y + axisZ * bounds.extents.z;
+	result.radius = glm::length(result.extents);
+
+	return(result);
+}
+
+/***********************************************************
+ *  MergeBounds()
+ *
+ *  This method is used for making the smallest box that holds
+ *  both of the passed in bounding volumes.
+ ***********************************************************/
+BOUNDING_VOLUME ViewFrustum::MergeBounds(const BOUNDING_VOLUME& first, const BOUNDING_VOLUME& second)
+{
+	return(MakeBounds(
+		glm::min(first.center - first.extents, second.center - second.extents),
+		glm::max(first.center + first.extents, second.center + second.extents)));
+}
+
+/***********************************************************
+ *  ExtractPlanes()
+ *
+ *  This method is used for taking the six view planes from
+ *  the rows of the projection * view matrix.  Each plane is
+ *  normalized so that distances to it are in world units.
+ ***********************************************************/
+void ViewFrustum::ExtractPlanes(const glm::mat4& viewProjection)
+{
+	glm::vec4 rows[4];
+	for (int row = 0; row < 4; row++)
+	{
+		rows[row] = glm::vec4(
+			viewProjection[0][row],
+			viewProjection[1][row],
+			viewProjection[2][row],
+			viewProjection[3][row]);
+	}
+
+	m_planes[0] = rows[3] + rows[0];	// left
+	m_planes[1] = rows[3] - rows[0];	// right
+	m_planes[2] = rows[3] + rows[1];	// bottom
+	m_planes[3] = rows[3] - rows[1];	// top
+	m_planes[4] = rows[3] + rows[2];	// near
+	m_planes[5] = rows[3] - rows[2];	// far
+
+	for (int i = 0; i < TOTAL_PLANES; i++)
+	{
+		float length = glm::length(glm::vec3(m_planes[i]));
+		if (length > 0.0f)
+		{
+			m_planes[i] = m_planes[i] / length;
+		}
+	}
+}
+
+/***********************************************************
+ *  TestBounds()
+ *
+ *  This method is used for testing a bounding volume against
+ *  the view planes.  The sphere settles most volumes that are
+ *  far outside or well inside a plane, and the box is only
+ *  tested against the planes the sphere crosses.
+ ***********************************************************/
+ViewFrustum::TEST_RESULT ViewFrustum::TestBounds(const BOUNDING_VOLUME& bounds) const
+{
+	TEST_RESULT result = INSIDE;
+
+	for (int i = 0; i < TOTAL_PLANES; i++)
+	{
+		glm::vec3 normal = glm::vec3(m_planes[i]);
+		float distance = glm::dot(normal, bounds.center) + m_planes[i].w;
+
+		if (distance < -bounds.radius)
+		{
+			return(OUTSIDE);
+		}
+		if (distance < bounds.radius)
+		{
+			// distance from the center to the box corner
+			// that is furthest along the plane normal
+			float reach = glm::dot(glm::abs(normal), bounds.extents);
+			if (distance < -reach)
+			{
+				return(OUTSIDE);
+			}
+			if (distance < reach)
+			{
+				result = INTERSECTS;
+			}
+		}
+	}
+
+	return(result);
+}
+
+/***********************************************************
+ *  GetPlane()
+ *
+ *  This method is used for getting one of the view planes,
+ *  with its normal facing into the view.
+ ***********************************************************/
+const glm::vec4& ViewFrustum::GetPlane(int plane) const
+{
+	return(m_planes[plane]);
+}
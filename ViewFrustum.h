@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// ViewFrustum.h
+// ============
+// test bounding volumes against the planes of the camera view
+//
+//  The six planes are taken from the rows of projection * view, so they
+//  match whatever perspective or orthographic projection the camera uses.
+//  Each bounding volume is an axis aligned box with a sphere around it;
+//  the sphere is tested first since it is the cheaper test.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+// a world space box given by its center and half sizes, and
+// the radius of the sphere around the box
+struct BOUNDING_VOLUME
+{
+	glm::vec3 center;
+	glm::vec3 extents;
+	float radius;
+};
+
+/***********************************************************
+ *  ViewFrustum
+ *
+ *  This class contains the code for extracting the view
+ *  planes and testing bounding volumes against them.
+ ***********************************************************/
+class ViewFrustum
+{
+public:
+	// constructor
+	ViewFrustum();
+
+	// result of testing a bounding volume against the planes
+	enum TEST_RESULT
+	{
+		OUTSIDE = 0,
+		INTERSECTS,
+		INSIDE
+	};
+
+	// make a bounding volume from the corners of a box
+	static BOUNDING_VOLUME MakeBounds(glm::vec3 minimum, glm::vec3 maximum);
+	// move a bounding volume into the space of a model matrix
+	static BOUNDING_VOLUME TransformBounds(const BOUNDING_VOLUME& bounds, const glm::mat4& model);
+	// make the smallest box holding both bounding volumes
+	static BOUNDING_VOLUME MergeBounds(const BOUNDING_VOLUME& first, const BOUNDING_VOLUME& second);
+
+	// number of view planes
+	static const int TOTAL_PLANES = 6;
+
+private:
+	// planes as (normal, distance), with the normals facing in
+	glm::vec4 m_planes[TOTAL_PLANES];
+
+public:
+	// take the planes from the projection * view matrix
+	void ExtractPlanes(const glm::mat4& viewProjection);
+
+	// test a bounding volume against the planes
+	TEST_RESULT TestBounds(const BOUNDING_VOLUME& bounds) const;
+	// get a plane as (normal, distance) for the GPU culling
+	const glm::vec4& GetPlane(int plane) const;
+};
@@ -1,335 +1,618 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-// 
-// ***Code updated by Connie Knupp on 9/29/2024
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>    
-
-// declaration of the global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	 bool bOrthographicProjection = false;
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// tell GLFW to capture all mouse events
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	//this callback is used to receive mouse scrolls - added by CKnupp
-	glfwSetScrollCallback(window, &ViewManager::Scroll_Callback);
-
-	// this callback is used to receive mouse moving events
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
-{
-	//variable for last camera position
-	float xOffset;
-	float yOffset;
-	// when the first mouse move event is received, this needs to be recorded so that
-	// all subsequent mouse moves can correctly calculate the X position offset and Y
-	// position offset for proper operation
-	if (gFirstMouse)
-	{
-		gLastX = xMousePos;
-		gLastY = yMousePos;
-		gFirstMouse = false;
-		//reset offset if coming back to default perspective view
-		float xOffset = 0.0;
-		float yOffset = 0.0;
-	}
-
-	// calculate the X offset and Y offset values for moving the 3D camera accordingly
-	 xOffset = xMousePos - gLastX;
-	 yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
-
-	// set the current positions into the last position variables
-	gLastX = xMousePos;
-	gLastY = yMousePos;
-
-	// only make camera changes in perspective view
-	if (bOrthographicProjection == false) {
-		// move the 3D camera according to the calculated offsets
-		g_pCamera->ProcessMouseMovement(xOffset, yOffset);
-	}
-}
-/***********************************************************
- *  Scroll_Callback()
- *
- *  This method was added by CK and is called to process any
- *  scroll events that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
-{
-	//check if in prospective view
-	if (bOrthographicProjection == false) {
-		// adjust movement speed of camera based on calculated offset
-		g_pCamera->ProcessMouseScroll(yoffset);
-	}
-}
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	// if the camera object is null, then exit this method
-	if (NULL == g_pCamera)
-	{
-		return;
-	}
-
-	//only make camera changes in perspective view
-	if (bOrthographicProjection == false)
-	{
-		// process camera zooming in and out
-		if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-		{
-			g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
-		}
-		if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-		{
-			g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
-		}
-
-		// process camera panning left and right
-		if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-		{
-			g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
-		}
-		if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-		{
-			g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
-		}
-
-		// process camera panning up and down * pasted from sample assignment *
-		if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-		{
-			g_pCamera->ProcessKeyboard(UP, gDeltaTime);
-		}
-		if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-		{
-			g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
-		}
-
-		// change to orthographic view
-		if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-		{
-			// change to a multi-view orthographic projection 
-			bOrthographicProjection = true;
-
-			g_pCamera->Position = glm::vec3(-5.0f, 0.0f, 5.0f);
-			g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-			g_pCamera->Front = glm::vec3(0.0f, 0.0f, -1.0f);
-
-		}
-
-		// reset perspective view
-		if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-		{
-			SetDefaultPerspectiveView();
-		}
-	}
-	else {
-		// change to perspective view
-		if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-		{
-			SetDefaultPerspectiveView();
-		}
-	}
-}
-
-/***********************************************************
- * SetDefaultPerspectiveView()
- *
- *  This method is used to reset the perspective camera or 
- *	called when switching from orthographic view to perspective 
- *  view. 
- ***********************************************************/
-void ViewManager::SetDefaultPerspectiveView()
-{
-	// change to a multi-view perspective projection
-	bOrthographicProjection = false;
-
-	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-
-	//reset mouse postion
-	gFirstMouse = true;
-	
-}
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	//objects for clip borders
-	float leftClip = -5.0;
-	float rightClip = 11.0;
-	float bottomClip = 0.0005;
-	float topClip = 12.0;
-	float nearClip = 0.1;
-	float farClip = 9.8;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// define the current projection matrix
-	if (bOrthographicProjection == false)
-	{
-		projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-	}
-	else
-	{
-		// front-view orthographic projection 
-		{
-			projection = glm::ortho(leftClip, rightClip, bottomClip, topClip, nearClip, farClip);
-		}
-	}
-
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
-}
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+// 
+// ***Code updated by Connie Knupp on 9/29/2024
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>    
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of the global variables and defines
+namespace
+{
+	// Variables for window width and height
+	const int WINDOW_WIDTH = 1000;
+	const int WINDOW_HEIGHT = 800;
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// these variables are used for mouse movement processing
+	float gLastX = WINDOW_WIDTH / 2.0f;
+	float gLastY = WINDOW_HEIGHT / 2.0f;
+	bool gFirstMouse = true;
+
+	// the following variable is false when orthographic projection
+	// is off and true when it is on
+	 bool bOrthographicProjection = false;
+
+	// the scripted camera circles the scene at this radius and
+	// height while looking at the point above its center
+	const float g_ScriptedRadius = 12.0f;
+	const float g_ScriptedHeight = 5.0f;
+	const glm::vec3 g_ScriptedTarget = glm::vec3(0.0f, 2.0f, 0.0f);
+
+	// true when the window was damaged or resized and must be
+	// painted again even though the camera did not move
+	bool g_bRedrawRequested = false;
+
+	// size of the window's framebuffer, which the perspective
+	// projection takes its aspect ratio from
+	int g_FramebufferWidth = WINDOW_WIDTH;
+	int g_FramebufferHeight = WINDOW_HEIGHT;
+
+	// the fixed front camera looks down the -Z axis with the clip
+	// borders of the orthographic projection around the scene
+	const glm::vec3 g_FrontCameraPosition = glm::vec3(-5.0f, 0.0f, 5.0f);
+	const float g_FrontLeftClip = -5.0f;
+	const float g_FrontRightClip = 11.0f;
+	const float g_FrontBottomClip = 0.0005f;
+	const float g_FrontTopClip = 12.0f;
+	const float g_FrontNearClip = 0.1f;
+	const float g_FrontFarClip = 9.8f;
+	// the fixed top camera looks straight down on the scene, with
+	// half the height of the view it covers
+	const glm::vec3 g_TopCameraPosition = glm::vec3(0.0f, 15.0f, 0.0f);
+	const float g_TopHalfHeight = 8.0f;
+	const float g_TopFarClip = 30.0f;
+	// distance between the eye cameras of a stereo pair
+	const float g_EyeSeparation = 0.1f;
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	ShaderManager *pShaderManager,
+	UniformBufferManager* pUniformBuffers)
+{
+	// initialize the member variables
+	m_pShaderManager = pShaderManager;
+	m_pUniformBuffers = pUniformBuffers;
+	m_pWindow = NULL;
+	m_bScriptedCamera = false;
+	m_scriptedFrame = 0;
+	m_scriptedFrameCount = 1;
+	m_viewCount = 0;
+	g_pCamera = new Camera();
+	// default camera view parameters
+	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// free up allocated memory
+	m_pShaderManager = NULL;
+	m_pUniformBuffers = NULL;
+	m_pWindow = NULL;
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// the benchmark draws offscreen, so its window is never shown
+	if (m_bScriptedCamera == true)
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	}
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		WINDOW_WIDTH,
+		WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// the scripted camera ignores the mouse
+	if (m_bScriptedCamera == false)
+	{
+		// tell GLFW to capture all mouse events
+		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+		//this callback is used to receive mouse scrolls - added by CKnupp
+		glfwSetScrollCallback(window, &ViewManager::Scroll_Callback);
+
+		// this callback is used to receive mouse moving events
+		glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+	}
+
+	// this callback is used to receive the requests to repaint the window
+	glfwSetWindowRefreshCallback(window, &ViewManager::Window_Refresh_Callback);
+
+	// this callback is used to follow the size of the framebuffer,
+	// which differs from the window size on high DPI displays
+	glfwGetFramebufferSize(window, &g_FramebufferWidth, &g_FramebufferHeight);
+	glfwSetFramebufferSizeCallback(window, &ViewManager::Framebuffer_Size_Callback);
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
+{
+	//variable for last camera position
+	float xOffset;
+	float yOffset;
+	// when the first mouse move event is received, this needs to be recorded so that
+	// all subsequent mouse moves can correctly calculate the X position offset and Y
+	// position offset for proper operation
+	if (gFirstMouse)
+	{
+		gLastX = xMousePos;
+		gLastY = yMousePos;
+		gFirstMouse = false;
+		//reset offset if coming back to default perspective view
+		float xOffset = 0.0;
+		float yOffset = 0.0;
+	}
+
+	// calculate the X offset and Y offset values for moving the 3D camera accordingly
+	 xOffset = xMousePos - gLastX;
+	 yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
+
+	// set the current positions into the last position variables
+	gLastX = xMousePos;
+	gLastY = yMousePos;
+
+	// only make camera changes in perspective view
+	if (bOrthographicProjection == false) {
+		// move the 3D camera according to the calculated offsets
+		g_pCamera->ProcessMouseMovement(xOffset, yOffset);
+	}
+}
+/***********************************************************
+ *  Scroll_Callback()
+ *
+ *  This method was added by CK and is called to process any
+ *  scroll events that may be waiting in the event queue.
+ ***********************************************************/
+void ViewManager::Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+	//check if in prospective view
+	if (bOrthographicProjection == false) {
+		// adjust movement speed of camera based on calculated offset
+		g_pCamera->ProcessMouseScroll(yoffset);
+	}
+}
+
+/***********************************************************
+ *  Window_Refresh_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the contents of the window were damaged or it was resized,
+ *  so a frame drawn on demand is drawn again.
+ ***********************************************************/
+void ViewManager::Window_Refresh_Callback(GLFWwindow* window)
+{
+	g_bRedrawRequested = true;
+}
+
+/***********************************************************
+ *  Framebuffer_Size_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the framebuffer of the window is resized.  A minimized
+ *  window has no pixels, so its last size is kept.
+ ***********************************************************/
+void ViewManager::Framebuffer_Size_Callback(GLFWwindow* window, int width, int height)
+{
+	if ((width > 0) && (height > 0))
+	{
+		g_FramebufferWidth = width;
+		g_FramebufferHeight = height;
+		g_bRedrawRequested = true;
+	}
+}
+
+/***********************************************************
+ *  ProcessKeyboardEvents()
+ *
+ *  This method is called to process any keyboard events
+ *  that may be waiting in the event queue, moving the camera
+ *  by the passed in tick length.
+ ***********************************************************/
+void ViewManager::ProcessKeyboardEvents(float deltaTime)
+{
+	// close the window if the escape key has been pressed
+	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	{
+		glfwSetWindowShouldClose(m_pWindow, true);
+	}
+
+	// if the camera object is null, then exit this method
+	if (NULL == g_pCamera)
+	{
+		return;
+	}
+
+	//only make camera changes in perspective view
+	if (bOrthographicProjection == false)
+	{
+		// process camera zooming in and out
+		if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
+		{
+			g_pCamera->ProcessKeyboard(FORWARD, deltaTime);
+		}
+		if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
+		{
+			g_pCamera->ProcessKeyboard(BACKWARD, deltaTime);
+		}
+
+		// process camera panning left and right
+		if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
+		{
+			g_pCamera->ProcessKeyboard(LEFT, deltaTime);
+		}
+		if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
+		{
+			g_pCamera->ProcessKeyboard(RIGHT, deltaTime);
+		}
+
+		// process camera panning up and down * pasted from sample assignment *
+		if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
+		{
+			g_pCamera->ProcessKeyboard(UP, deltaTime);
+		}
+		if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
+		{
+			g_pCamera->ProcessKeyboard(DOWN, deltaTime);
+		}
+
+		// change to orthographic view, which is drawn from the fixed
+		// front camera so the perspective camera is kept as it is
+		if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
+		{
+			bOrthographicProjection = true;
+		}
+
+		// reset perspective view
+		if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
+		{
+			SetDefaultPerspectiveView();
+		}
+	}
+	else {
+		// change back to the perspective view where it was left
+		if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
+		{
+			bOrthographicProjection = false;
+			gFirstMouse = true;
+		}
+	}
+}
+
+/***********************************************************
+ * SetDefaultPerspectiveView()
+ *
+ *  This method is used to reset the perspective camera or 
+ *	called when switching from orthographic view to perspective 
+ *  view. 
+ ***********************************************************/
+void ViewManager::SetDefaultPerspectiveView()
+{
+	// change to a multi-view perspective projection
+	bOrthographicProjection = false;
+
+	// default camera view parameters
+	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+
+	//reset mouse postion
+	gFirstMouse = true;
+	
+}
+
+/***********************************************************
+ *  EnableScriptedCamera()
+ *
+ *  This method is used to make the camera follow the scripted
+ *  benchmark path instead of the keyboard and mouse.
+ ***********************************************************/
+void ViewManager::EnableScriptedCamera(bool bEnable)
+{
+	m_bScriptedCamera = bEnable;
+}
+
+/***********************************************************
+ *  SetScriptedCameraFrame()
+ *
+ *  This method is used to set the frame of the scripted path
+ *  that is drawn next.  The path is one full circle over the
+ *  passed in number of frames.
+ ***********************************************************/
+void ViewManager::SetScriptedCameraFrame(int frame, int frameCount)
+{
+	m_scriptedFrame = frame;
+	m_scriptedFrameCount = (frameCount > 0) ? frameCount : 1;
+}
+
+/***********************************************************
+ *  UpdateScriptedCamera()
+ *
+ *  This method is used to move the camera to its place on
+ *  the scripted path.  The place only depends on the frame,
+ *  not the time, so every run draws the same frames.
+ ***********************************************************/
+void ViewManager::UpdateScriptedCamera()
+{
+	float angle = glm::two_pi<float>() * m_scriptedFrame / m_scriptedFrameCount;
+
+	bOrthographicProjection = false;
+	g_pCamera->Position = glm::vec3(
+		glm::sin(angle) * g_ScriptedRadius,
+		g_ScriptedHeight,
+		glm::cos(angle) * g_ScriptedRadius);
+	g_pCamera->Front = glm::normalize(g_ScriptedTarget - g_pCamera->Position);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+}
+
+/***********************************************************
+ *  UpdateCamera()
+ *
+ *  This method is used for moving the camera by one tick of
+ *  the simulation, from the keyboard or the scripted path.
+ *  It must be called on the thread that polls the events.
+ ***********************************************************/
+void ViewManager::UpdateCamera(float deltaTime)
+{
+	// the scripted camera replaces the keyboard and mouse
+	if (m_bScriptedCamera == true)
+	{
+		UpdateScriptedCamera();
+	}
+	else
+	{
+		// process any keyboard events that may be waiting in the 
+		// event queue
+		ProcessKeyboardEvents(deltaTime);
+	}
+}
+
+/***********************************************************
+ *  GetViewCamera()
+ *
+ *  This method is used for writing the view and projection
+ *  matrices and the view position of one of the cameras for
+ *  a view with the passed in aspect ratio.
+ ***********************************************************/
+void ViewManager::GetViewCamera(
+	VIEW_CAMERA viewCamera,
+	float aspectRatio,
+	UniformBufferManager::CAMERA_DATA& camera) const
+{
+	switch (viewCamera)
+	{
+	case FRONT_CAMERA:
+		// front-view orthographic projection
+		camera.view = glm::lookAt(
+			g_FrontCameraPosition,
+			g_FrontCameraPosition + glm::vec3(0.0f, 0.0f, -1.0f),
+			glm::vec3(0.0f, 1.0f, 0.0f));
+		camera.projection = glm::ortho(
+			g_FrontLeftClip, g_FrontRightClip,
+			g_FrontBottomClip, g_FrontTopClip,
+			g_FrontNearClip, g_FrontFarClip);
+		camera.viewPosition = g_FrontCameraPosition;
+		break;
+
+	case TOP_CAMERA:
+		// top-view orthographic projection, with -Z up the view
+		camera.view = glm::lookAt(
+			g_TopCameraPosition,
+			glm::vec3(g_TopCameraPosition.x, 0.0f, g_TopCameraPosition.z),
+			glm::vec3(0.0f, 0.0f, -1.0f));
+		camera.projection = glm::ortho(
+			-g_TopHalfHeight * aspectRatio, g_TopHalfHeight * aspectRatio,
+			-g_TopHalfHeight, g_TopHalfHeight,
+			0.1f, g_TopFarClip);
+		camera.viewPosition = g_TopCameraPosition;
+		break;
+
+	default:
+		// the perspective camera, moved sideways in its own view
+		// space for the eyes of a stereo pair
+		camera.view = g_pCamera->GetViewMatrix();
+		camera.projection = glm::perspective(glm::radians(g_pCamera->Zoom), aspectRatio, 0.1f, 100.0f);
+		camera.viewPosition = g_pCamera->Position;
+		if ((LEFT_EYE_CAMERA == viewCamera) || (RIGHT_EYE_CAMERA == viewCamera))
+		{
+			float offset = (LEFT_EYE_CAMERA == viewCamera) ? -0.5f * g_EyeSeparation : 0.5f * g_EyeSeparation;
+			camera.view = glm::translate(glm::vec3(-offset, 0.0f, 0.0f)) * camera.view;
+			camera.viewPosition += glm::normalize(glm::cross(g_pCamera->Front, g_pCamera->Up)) * offset;
+		}
+		break;
+	}
+
+	camera.padding0 = 0.0f;
+}
+
+/***********************************************************
+ *  GetCameraData()
+ *
+ *  This method is used for writing the view and projection
+ *  matrices and the view position of the camera.  Nothing is
+ *  sent to OpenGL, so the values can be handed to the thread
+ *  that renders them.
+ ***********************************************************/
+void ViewManager::GetCameraData(UniformBufferManager::CAMERA_DATA& camera) const
+{
+	GetViewCamera(
+		(bOrthographicProjection == true) ? FRONT_CAMERA : PERSPECTIVE_CAMERA,
+		(GLfloat)g_FramebufferWidth / (GLfloat)g_FramebufferHeight,
+		camera);
+}
+
+/***********************************************************
+ *  AddView()
+ *
+ *  This method is used for adding a view drawn every frame
+ *  from one of the cameras.  The viewport is the part of the
+ *  framebuffer it covers, as x, y, width and height fractions
+ *  of the framebuffer size.
+ ***********************************************************/
+int ViewManager::AddView(VIEW_CAMERA viewCamera, const glm::vec4& viewport)
+{
+	if (m_viewCount >= MAX_VIEWS)
+	{
+		std::cout << "Only " << MAX_VIEWS << " views can be drawn in a frame" << std::endl;
+		return(-1);
+	}
+
+	m_viewCameras[m_viewCount] = viewCamera;
+	m_viewports[m_viewCount] = viewport;
+	m_viewCount++;
+
+	return(m_viewCount - 1);
+}
+
+/***********************************************************
+ *  ClearViews()
+ *
+ *  This method is used for removing the added views, so the
+ *  frames are drawn from the single view of the O and P keys.
+ ***********************************************************/
+void ViewManager::ClearViews()
+{
+	m_viewCount = 0;
+}
+
+/***********************************************************
+ *  GetViewCount()
+ *
+ *  This method is used for getting the number of views that
+ *  are drawn each frame.
+ ***********************************************************/
+int ViewManager::GetViewCount() const
+{
+	return((m_viewCount > 0) ? m_viewCount : 1);
+}
+
+/***********************************************************
+ *  GetFrameViews()
+ *
+ *  This method is used for writing the camera values and the
+ *  framebuffer part of every view of the frame.  Without any
+ *  added views, the frame has the one view of the camera over
+ *  the whole framebuffer.
+ ***********************************************************/
+void ViewManager::GetFrameViews(FRAME_VIEWS& views) const
+{
+	if (m_viewCount <= 0)
+	{
+		GetCameraData(views.cameras[0]);
+		views.viewports[0] = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		views.viewCount = 1;
+		return;
+	}
+
+	for (int view = 0; view < m_viewCount; view++)
+	{
+		const glm::vec4& viewport = m_viewports[view];
+		float aspectRatio = (viewport.z * g_FramebufferWidth) /
+			std::max(viewport.w * g_FramebufferHeight, 1.0f);
+
+		GetViewCamera(m_viewCameras[view], aspectRatio, views.cameras[view]);
+		views.viewports[view] = viewport;
+	}
+	views.viewCount = m_viewCount;
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene view from
+ *  the passed in camera values, which are written into the
+ *  camera block for the frame being rendered.
+ ***********************************************************/
+void ViewManager::PrepareSceneView(const UniformBufferManager::CAMERA_DATA& camera)
+{
+	// if the uniform buffer object is valid
+	if (NULL != m_pUniformBuffers)
+	{
+		// write the view and projection matrices and the view position
+		// of the camera into the camera block for proper rendering
+		m_pUniformBuffers->UpdateCamera(camera.view, camera.projection, camera.viewPosition);
+	}
+}
+
+/***********************************************************
+ *  TakeRedrawRequest()
+ *
+ *  This method is used for checking whether the window asked
+ *  to be painted again since the last check.
+ ***********************************************************/
+bool ViewManager::TakeRedrawRequest()
+{
+	bool bRequested = g_bRedrawRequested;
+	g_bRedrawRequested = false;
+	return(bRequested);
+}
+
+/***********************************************************
+ *  GetFramebufferSize()
+ *
+ *  This method is used for getting the size of the window's
+ *  framebuffer in pixels, as of the last events polled.
+ ***********************************************************/
+void ViewManager::GetFramebufferSize(int& width, int& height) const
+{
+	width = g_FramebufferWidth;
+	height = g_FramebufferHeight;
+}
@@ -1,55 +1,135 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-// 
-//  ***Code updated by Connie Knupp on 9/29/2024
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "camera.h"
-
-// GLFW library
-#include "GLFW/glfw3.h" 
-
-class ViewManager
-{
-public:
-	// constructor
-	ViewManager(
-		ShaderManager* pShaderManager);
-	// destructor
-	~ViewManager();
-
-	// mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
-
-	//scroll callback for mouse scroll controlling camera movement speed
-	static void Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset);
-
-
-	static void ProcessMouseScrollEvents(GLFWwindow* window, double xoffset, double yoffset);
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
-	GLFWwindow* m_pWindow;
-
-	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
-
-	void SetDefaultPerspectiveView();
-
-public:
-	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
-	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+// 
+//  ***Code updated by Connie Knupp on 9/29/2024
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "UniformBufferManager.h"
+#include "camera.h"
+
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+class ViewManager
+{
+public:
+	// constructor
+	ViewManager(
+		ShaderManager* pShaderManager,
+		UniformBufferManager* pUniformBuffers);
+	// destructor
+	~ViewManager();
+
+	// mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
+
+	//scroll callback for mouse scroll controlling camera movement speed
+	static void Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset);
+
+
+	static void ProcessMouseScrollEvents(GLFWwindow* window, double xoffset, double yoffset);
+
+	// window refresh callback for repainting a damaged or resized window
+	static void Window_Refresh_Callback(GLFWwindow* window);
+
+	// most views that are drawn in one frame
+	static const int MAX_VIEWS = 4;
+
+	// the cameras a view can be drawn from - the front and top
+	// cameras are fixed orthographic views of the scene, and the
+	// eye cameras sit either side of the perspective camera
+	enum VIEW_CAMERA
+	{
+		PERSPECTIVE_CAMERA = 0,
+		FRONT_CAMERA,
+		TOP_CAMERA,
+		LEFT_EYE_CAMERA,
+		RIGHT_EYE_CAMERA
+	};
+
+	// the views of one frame, each with the part of the framebuffer
+	// it covers as x, y, width and height fractions of its size
+	struct FRAME_VIEWS
+	{
+		UniformBufferManager::CAMERA_DATA cameras[MAX_VIEWS];
+		glm::vec4 viewports[MAX_VIEWS];
+		int viewCount;
+	};
+
+	// framebuffer size callback for keeping the projection and
+	// viewport at the size of a resized window
+	static void Framebuffer_Size_Callback(GLFWwindow* window, int width, int height);
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to the shared uniform buffer blocks
+	UniformBufferManager* m_pUniformBuffers;
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+	// true when the camera follows the scripted benchmark path
+	// instead of the keyboard and mouse
+	bool m_bScriptedCamera;
+	// position of the next frame along the scripted path
+	int m_scriptedFrame;
+	int m_scriptedFrameCount;
+	// cameras and framebuffer parts of the added views, which
+	// replace the single view of the O and P keys when there are any
+	VIEW_CAMERA m_viewCameras[MAX_VIEWS];
+	glm::vec4 m_viewports[MAX_VIEWS];
+	int m_viewCount;
+
+	// process keyboard events for interaction with the 3D scene
+	void ProcessKeyboardEvents(float deltaTime);
+
+	void SetDefaultPerspectiveView();
+
+	// move the camera to its place on the scripted path
+	void UpdateScriptedCamera();
+
+	// get the view values of one of the cameras for a view with
+	// the passed in aspect ratio
+	void GetViewCamera(
+		VIEW_CAMERA viewCamera,
+		float aspectRatio,
+		UniformBufferManager::CAMERA_DATA& camera) const;
+
+public:
+	// create the initial OpenGL display window
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+
+	// use the scripted camera path and a hidden window, which
+	// must be set before the display window is created
+	void EnableScriptedCamera(bool bEnable);
+	// set the frame of the scripted path that is drawn next
+	void SetScriptedCameraFrame(int frame, int frameCount);
+	
+	// move the camera by one fixed tick of the simulation
+	void UpdateCamera(float deltaTime);
+	// get the view values of the camera without touching OpenGL
+	void GetCameraData(UniformBufferManager::CAMERA_DATA& camera) const;
+
+	// add a view drawn from a camera into a part of the framebuffer,
+	// which returns its index or -1 when there are MAX_VIEWS already
+	int AddView(VIEW_CAMERA viewCamera, const glm::vec4& viewport);
+	// remove the added views, going back to the single view
+	void ClearViews();
+	// get the number of views drawn each frame
+	int GetViewCount() const;
+	// get the view values of every view without touching OpenGL
+	void GetFrameViews(FRAME_VIEWS& views) const;
+	// prepare the conversion from 3D object display to 2D scene display
+	void PrepareSceneView(const UniformBufferManager::CAMERA_DATA& camera);
+	// true once when the window asked to be painted again
+	bool TakeRedrawRequest();
+	// get the size of the window's framebuffer in pixels
+	void GetFramebufferSize(int& width, int& height) const;
 };
\ No newline at end of file
@@ -0,0 +1,173 @@
+#version 430 core
+// one invocation per scene object - cull it against the view planes,
+// pick its level of detail and write its indirect draw command
+layout (local_size_x = 64) in;
+
+// must match GpuDrivenRenderer::OBJECT_DATA
+struct ObjectData
+{
+    vec4 centerRadius;
+    vec4 extents;
+    uint mesh;
+    uint lodLevel;
+    uint section;
+    uint instanceIndex;
+    uint commandSlot;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+// must match GpuDrivenRenderer::MESH_RANGE
+struct MeshRange
+{
+    uint indexCount;
+    uint firstIndex;
+    int baseVertex;
+    uint lodCount;
+};
+
+// must match GpuDrivenRenderer::DRAW_COMMAND
+struct DrawCommand
+{
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+const int LOD_LEVELS = 3;
+
+layout (std430, binding = 0) buffer Objects
+{
+    ObjectData objects[];
+};
+layout (std430, binding = 1) readonly buffer Meshes
+{
+    MeshRange meshes[];
+};
+layout (std430, binding = 2) writeonly buffer Commands
+{
+    DrawCommand commands[];
+};
+layout (std430, binding = 3) buffer Counts
+{
+    uint counts[];
+};
+layout (std430, binding = 4) readonly buffer Sections
+{
+    uint sectionStarts[];
+};
+
+uniform uint objectCount;
+uniform vec4 frustumPlanes[6];
+uniform vec3 viewPosition;
+uniform float projectionScale;
+uniform bool bPerspective;
+// true when the visible commands are packed at the start of
+// each section and drawn with a count read from the GPU
+uniform bool bCompact;
+uniform bool bUseCulling;
+uniform bool bUseLod;
+uniform vec2 lodScreenSizes;
+uniform float lodHysteresis;
+
+/***********************************************************
+ *  IsVisible()
+ *
+ *  Test the bounds against the planes, with the sphere first.
+ ***********************************************************/
+bool IsVisible(ObjectData object)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        float distance = dot(frustumPlanes[i].xyz, object.centerRadius.xyz) + frustumPlanes[i].w;
+        if (distance < -object.centerRadius.w)
+        {
+            return false;
+        }
+        if (distance < -dot(abs(frustumPlanes[i].xyz), object.extents.xyz))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/***********************************************************
+ *  GetLodForSize()
+ *
+ *  Get the level of detail with scaled thresholds.
+ ***********************************************************/
+uint GetLodForSize(float screenSize, float thresholdScale, uint lodCount)
+{
+    uint lod = 0;
+    if ((lod < lodCount - 1) && (screenSize < lodScreenSizes.x * thresholdScale))
+    {
+        lod++;
+    }
+    if ((lod < lodCount - 1) && (screenSize < lodScreenSizes.y * thresholdScale))
+    {
+        lod++;
+    }
+    return lod;
+}
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= objectCount)
+    {
+        return;
+    }
+
+    ObjectData object = objects[index];
+    bool bVisible = (bUseCulling == false) || IsVisible(object);
+
+    // the level is kept between the finest level the lowered
+    // thresholds give and the coarsest the raised ones give
+    uint lodCount = meshes[object.mesh * LOD_LEVELS].lodCount;
+    uint lod = 0;
+    if ((bUseLod == true) && (lodCount > 1))
+    {
+        float screenSize = object.centerRadius.w * projectionScale;
+        if (bPerspective == true)
+        {
+            screenSize /= max(length(object.centerRadius.xyz - viewPosition), 0.001f);
+        }
+        uint finestLod = GetLodForSize(screenSize, 1.0f - lodHysteresis, lodCount);
+        uint coarsestLod = GetLodForSize(screenSize, 1.0f + lodHysteresis, lodCount);
+        lod = clamp(object.lodLevel, finestLod, coarsestLod);
+        // only visible objects move, just like on the CPU
+        if (bVisible == true)
+        {
+            objects[index].lodLevel = lod;
+        }
+    }
+
+    MeshRange range = meshes[object.mesh * LOD_LEVELS + lod];
+    DrawCommand command;
+    command.count = range.indexCount;
+    command.instanceCount = bVisible ? 1u : 0u;
+    command.firstIndex = range.firstIndex;
+    command.baseVertex = range.baseVertex;
+    command.baseInstance = object.instanceIndex;
+
+    if (bCompact == true)
+    {
+        // culled objects write nothing, and the visible ones are
+        // packed into the start of their section
+        if (bVisible == true)
+        {
+            uint slot = sectionStarts[object.section] + atomicAdd(counts[object.section], 1u);
+            commands[slot] = command;
+        }
+    }
+    else
+    {
+        // every object keeps its own slot and a culled one draws
+        // zero instances
+        commands[object.commandSlot] = command;
+    }
+}
@@ -0,0 +1,457 @@
+#version 330 core
+// the texture arrays are passed by handle when the driver supports it
+#extension GL_ARB_bindless_texture : enable
+// a variant with clustered lights reads the point lights of its
+// cluster from the storage buffers of LightClusters
+#ifdef VARIANT
+#if (VARIANT_CLUSTERED_LIGHTS != 0)
+#extension GL_ARB_shader_storage_buffer_object : require
+#define CLUSTERED_LIGHTS
+#endif
+// a variant with shadows samples the cascades of ShadowMaps for
+// the directional light
+#if (VARIANT_SHADOWS != 0)
+#define SHADOWS
+#endif
+#endif
+out vec4 fragmentColor;
+
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+flat in int fragmentMaterialIndex;
+flat in int fragmentTextureLayer;
+flat in vec2 fragmentUVscale;
+
+struct Material {
+    vec3 diffuseColor;
+    vec3 specularColor;
+    float shininess;
+}; 
+
+struct DirectionalLight {
+    vec3 direction;
+	
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    bool bActive;
+};
+
+struct PointLight {
+    vec3 position;
+    // distance where the light has faded out, 0 when it never does
+    float range;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    bool bActive;
+};
+
+struct SpotLight {
+    vec3 position;
+    vec3 direction;
+    float cutOff;
+    float outerCutOff;
+  
+    float constant;
+    float linear;
+    float quadratic;
+  
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;       
+
+    bool bActive;
+};
+
+#define TOTAL_POINT_LIGHTS 10
+#define TOTAL_MATERIALS 32
+#define TOTAL_SHADOW_CASCADES 3
+
+// must match UniformBufferManager::SHADOW_DATA
+struct ShadowCascades {
+    mat4 lightViewProjection[TOTAL_SHADOW_CASCADES];
+    vec4 cascadeSplits;
+    // x is the texel size of the shadow map, y the depth bias
+    vec4 parameters;
+};
+
+// per-frame camera values shared by all of the shaders
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPosition;
+};
+
+// scene lights, uploaded once when the lights are set up
+layout (std140) uniform Lights
+{
+    DirectionalLight directionalLight;
+    PointLight pointLights[TOTAL_POINT_LIGHTS];
+    SpotLight spotLight;
+    // rewritten whenever the cascades move with the camera
+    ShadowCascades shadows;
+};
+
+// every defined material, selected per draw by materialIndex
+// or per instance by the instance material index
+layout (std140) uniform Materials
+{
+    Material materials[TOTAL_MATERIALS];
+};
+
+uniform bool bUseTexture=false;
+uniform bool bUseLighting=false;
+uniform vec4 objectColor = vec4(1.0f);
+uniform int materialIndex = 0;
+#ifdef GL_ARB_bindless_texture
+layout (bindless_sampler) uniform sampler2DArray objectTextures;
+#else
+uniform sampler2DArray objectTextures;
+#endif
+uniform int textureLayer = 0;
+uniform vec2 UVscale = vec2(1.0f, 1.0f);
+#ifdef SHADOWS
+// a layer per cascade, compared against the depth as it is sampled
+uniform sampler2DArrayShadow shadowMap;
+#endif
+
+#ifdef CLUSTERED_LIGHTS
+// must match LightClusters.h
+#define CLUSTER_TILES_X 16
+#define CLUSTER_TILES_Y 9
+#define CLUSTER_SLICES 24
+#define MAX_LIGHTS_PER_CLUSTER 128
+
+// must match LightClusters::POINT_LIGHT
+struct ClusterLight
+{
+    vec4 positionRange;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+};
+
+// the binding points are set by LightClusters::BindProgram()
+layout (std430) readonly buffer ClusterLights
+{
+    ClusterLight clusterLights[];
+};
+layout (std430) readonly buffer ClusterGrid
+{
+    vec4 clusterViewport;
+    vec4 clusterDepthSlicing;
+    uint clusterCounts[];
+};
+layout (std430) readonly buffer ClusterIndices
+{
+    uint clusterLightIndices[];
+};
+#endif
+
+// a variant built by ShaderCache::LoadVariant() defines which lights
+// are on and whether the draws are textured, so the branches it never
+// takes are compiled out - without VARIANT every case is decided by the
+// uniforms at run time
+#ifdef VARIANT
+#define IS_TEXTURED (VARIANT_TEXTURED != 0)
+#define IS_LIT (VARIANT_LIGHTING != 0)
+#define IS_DIRECTIONAL_LIGHT_ACTIVE (VARIANT_DIRECTIONAL_LIGHT != 0)
+#define IS_SPOT_LIGHT_ACTIVE (VARIANT_SPOT_LIGHT != 0)
+// the active point lights are packed at the start of the array
+#define POINT_LIGHT_COUNT VARIANT_POINT_LIGHTS
+#define IS_POINT_LIGHT_ACTIVE(i) true
+#else
+#define IS_TEXTURED (bUseTexture == true)
+#define IS_LIT (bUseLighting == true)
+#define IS_DIRECTIONAL_LIGHT_ACTIVE (directionalLight.bActive == true)
+#define IS_SPOT_LIGHT_ACTIVE (spotLight.bActive == true)
+#define POINT_LIGHT_COUNT TOTAL_POINT_LIGHTS
+#define IS_POINT_LIGHT_ACTIVE(i) (pointLights[i].bActive == true)
+#endif
+
+// material for the current draw, copied out of the materials block
+Material material;
+// texture layer and UV scale for the current draw
+int drawTextureLayer;
+vec2 drawUVscale;
+
+// function prototypes
+vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir);
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec4 SampleTexture(vec2 textureCoordinate);
+#ifdef CLUSTERED_LIGHTS
+uint GetCluster();
+#endif
+#ifdef SHADOWS
+float CalcShadow(vec3 fragPos);
+#endif
+
+void main()
+{    
+#ifdef VARIANT
+#if (VARIANT_DEPTH_ONLY != 0)
+    // the depth pre-pass only keeps the depth, so nothing is shaded
+    fragmentColor = vec4(0.0f);
+    return;
+#endif
+#endif
+
+    // instanced draws carry their own material, layer and UV scale
+    if(fragmentMaterialIndex >= 0)
+    {
+        material = materials[fragmentMaterialIndex];
+        drawTextureLayer = fragmentTextureLayer;
+        drawUVscale = fragmentUVscale;
+    }
+    else
+    {
+        material = materials[materialIndex];
+        drawTextureLayer = textureLayer;
+        drawUVscale = UVscale;
+    }
+
+    if(IS_LIT)
+    {
+        vec3 phongResult = vec3(0.0f);
+        // properties
+        vec3 norm = normalize(fragmentVertexNormal);
+        vec3 viewDir = normalize(viewPosition - fragmentPosition);
+    
+        // == =====================================================
+        // Our lighting is set up in 3 phases: directional, point lights and an optional flashlight
+        // For each phase, a calculate function is defined that calculates the corresponding color
+        // per light source. In the main() function we take all the calculated colors and sum them 
+        // up for this fragment's final color.
+        // == =====================================================
+        // phase 1: directional lighting
+        if(IS_DIRECTIONAL_LIGHT_ACTIVE)
+        {
+            phongResult += CalcDirectionalLight(directionalLight, norm, viewDir);
+        }
+        // phase 2: point lights
+#ifdef CLUSTERED_LIGHTS
+        // only the lights listed for the cluster of the fragment
+        uint cluster = GetCluster();
+        uint clusterLightCount = min(clusterCounts[cluster], uint(MAX_LIGHTS_PER_CLUSTER));
+        for(uint i = 0u; i < clusterLightCount; i++)
+        {
+            ClusterLight clusterLight = clusterLights[clusterLightIndices[cluster * uint(MAX_LIGHTS_PER_CLUSTER) + i]];
+            PointLight light;
+            light.position = clusterLight.positionRange.xyz;
+            light.range = clusterLight.positionRange.w;
+            light.ambient = clusterLight.ambient.rgb;
+            light.diffuse = clusterLight.diffuse.rgb;
+            light.specular = clusterLight.specular.rgb;
+            light.bActive = true;
+            phongResult += CalcPointLight(light, norm, fragmentPosition, viewDir);
+        }
+#else
+        for(int i = 0; i < POINT_LIGHT_COUNT; i++)
+        {
+	    if(IS_POINT_LIGHT_ACTIVE(i))
+            {
+                phongResult += CalcPointLight(pointLights[i], norm, fragmentPosition, viewDir);   
+            }
+        } 
+#endif
+        // phase 3: spot light
+        if(IS_SPOT_LIGHT_ACTIVE)
+        {
+            phongResult += CalcSpotLight(spotLight, norm, fragmentPosition, viewDir);    
+        }
+    
+        if(IS_TEXTURED)
+        {
+            fragmentColor = vec4(phongResult, (SampleTexture(fragmentTextureCoordinate)).a);
+        }
+        else
+        {
+            fragmentColor = vec4(phongResult, objectColor.a);
+        }
+    }
+    else
+    {
+        if(IS_TEXTURED)
+        {
+            fragmentColor = SampleTexture(fragmentTextureCoordinate * drawUVscale);
+        }
+        else
+        {
+            fragmentColor = objectColor;
+        }
+    }
+}
+
+// calculates the color when using a directional light.
+vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir)
+{
+    vec3 ambient = vec3(0.0f);
+    vec3 diffuse = vec3(0.0f);
+    vec3 specular = vec3(0.0f);
+
+    vec3 lightDirection = normalize(-light.direction);
+    // diffuse shading
+    float diff = max(dot(normal, lightDirection), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDirection, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // combine results
+    if(IS_TEXTURED)
+    {
+        ambient = light.ambient * vec3(SampleTexture(fragmentTextureCoordinate));
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(SampleTexture(fragmentTextureCoordinate));
+        specular = light.specular * spec * material.specularColor * vec3(SampleTexture(fragmentTextureCoordinate));
+    }
+    else
+    {
+        ambient = light.ambient * vec3(objectColor);
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectColor);
+        specular = light.specular * spec * material.specularColor * vec3(objectColor);
+    }
+#ifdef SHADOWS
+    // the ambient light still reaches the shadowed fragments
+    float shadow = CalcShadow(fragmentPosition);
+    diffuse *= shadow;
+    specular *= shadow;
+#endif
+    
+    return (ambient + diffuse + specular);
+}
+
+// calculates the color when using a point light.
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 ambient = vec3(0.0f);
+    vec3 diffuse = vec3(0.0f);
+    vec3 specular= vec3(0.0f);
+
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    // Calculate specular component
+    float specularComponent = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // a light with a range fades smoothly to nothing at its edge
+    float attenuation = 1.0f;
+    if(light.range > 0.0f)
+    {
+        float ratio = length(light.position - fragPos) / light.range;
+        float window = clamp(1.0f - ratio * ratio * ratio * ratio, 0.0f, 1.0f);
+        attenuation = window * window;
+    }
+   
+    // combine results
+    if(IS_TEXTURED)
+    {
+        ambient = light.ambient * vec3(SampleTexture(fragmentTextureCoordinate));
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(SampleTexture(fragmentTextureCoordinate));
+        specular = light.specular * specularComponent * material.specularColor;
+    }
+    else
+    {
+        ambient = light.ambient * vec3(objectColor);
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectColor);
+        specular = light.specular * specularComponent * material.specularColor;
+    }
+    
+    return (ambient + diffuse + specular) * attenuation;
+}
+
+// calculates the color when using a spot light.
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 ambient = vec3(0.0f);
+    vec3 diffuse = vec3(0.0f);
+    vec3 specular = vec3(0.0f);
+
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
+    // spotlight intensity
+    float theta = dot(lightDir, normalize(-light.direction)); 
+    float epsilon = light.cutOff - light.outerCutOff;
+    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    // combine results
+    if(IS_TEXTURED)
+    {
+        ambient = light.ambient * vec3(SampleTexture(fragmentTextureCoordinate));
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(SampleTexture(fragmentTextureCoordinate));
+        specular = light.specular * spec * material.specularColor * vec3(SampleTexture(fragmentTextureCoordinate));
+    }
+    else
+    {
+        ambient = light.ambient * vec3(objectColor);
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectColor);
+        specular = light.specular * spec * material.specularColor * vec3(objectColor);
+    }
+    
+    ambient *= attenuation * intensity;
+    diffuse *= attenuation * intensity;
+    specular *= attenuation * intensity;
+    return (ambient + diffuse + specular);
+}
+
+#ifdef CLUSTERED_LIGHTS
+// finds the cluster of the fragment from its tile and view depth.
+uint GetCluster()
+{
+    vec2 tiles = vec2(CLUSTER_TILES_X, CLUSTER_TILES_Y);
+    vec2 tile = clamp((gl_FragCoord.xy - clusterViewport.xy) / clusterViewport.zw * tiles, vec2(0.0f), tiles - 1.0f);
+    float viewDepth = max(-(view * vec4(fragmentPosition, 1.0f)).z, 1.0e-4f);
+    float slice = clamp(log(viewDepth) * clusterDepthSlicing.x + clusterDepthSlicing.y, 0.0f, float(CLUSTER_SLICES - 1));
+    return (uint(slice) * uint(CLUSTER_TILES_Y) + uint(tile.y)) * uint(CLUSTER_TILES_X) + uint(tile.x);
+}
+#endif
+
+#ifdef SHADOWS
+// finds how much of the directional light reaches the fragment, with
+// the cascade picked by view depth and a 3x3 filter over its layer.
+float CalcShadow(vec3 fragPos)
+{
+    float viewDepth = -(view * vec4(fragPos, 1.0f)).z;
+    if (viewDepth > shadows.cascadeSplits[TOTAL_SHADOW_CASCADES - 1])
+    {
+        return 1.0f;
+    }
+    int cascade = 0;
+    while ((cascade < TOTAL_SHADOW_CASCADES - 1) && (viewDepth > shadows.cascadeSplits[cascade]))
+    {
+        cascade++;
+    }
+
+    vec4 lightPosition = shadows.lightViewProjection[cascade] * vec4(fragPos, 1.0f);
+    vec3 coords = lightPosition.xyz / lightPosition.w * 0.5f + 0.5f;
+    float depth = coords.z - shadows.parameters.y;
+
+    float lit = 0.0f;
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            vec2 offset = vec2(x, y) * shadows.parameters.x;
+            lit += texture(shadowMap, vec4(coords.xy + offset, float(cascade), depth));
+        }
+    }
+    return lit / 9.0f;
+}
+#endif
+
+// samples the texture layer of the current draw.
+vec4 SampleTexture(vec2 textureCoordinate)
+{
+    return texture(objectTextures, vec3(textureCoordinate, float(drawTextureLayer)));
+}
@@ -0,0 +1,128 @@
+#version 430 core
+// one invocation per cluster of the view - build the bounds of the
+// cluster and list the point lights that reach into it
+layout (local_size_x = 64) in;
+
+// must match LightClusters.h
+#define CLUSTER_TILES_X 16
+#define CLUSTER_TILES_Y 9
+#define CLUSTER_SLICES 24
+#define MAX_LIGHTS_PER_CLUSTER 128
+#define TOTAL_CLUSTERS (CLUSTER_TILES_X * CLUSTER_TILES_Y * CLUSTER_SLICES)
+
+// must match LightClusters::POINT_LIGHT
+struct ClusterLight
+{
+    vec4 positionRange;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+};
+
+layout (std430, binding = 5) readonly buffer ClusterLights
+{
+    ClusterLight lights[];
+};
+layout (std430, binding = 6) buffer ClusterGrid
+{
+    vec4 clusterViewport;
+    vec4 clusterDepthSlicing;
+    uint clusterCounts[];
+};
+layout (std430, binding = 7) writeonly buffer ClusterIndices
+{
+    uint clusterLightIndices[];
+};
+
+uniform mat4 view;
+uniform mat4 inverseProjection;
+// depth of the first and last slice in front of the camera
+uniform vec2 depthRange;
+uniform uint lightCount;
+
+// view space center and range of the lights being tested,
+// loaded once by the work group for all of its clusters
+shared vec4 groupLights[64];
+
+/***********************************************************
+ *  PointAtDepth()
+ *
+ *  Get the point of a tile corner line at a view depth.
+ ***********************************************************/
+vec3 PointAtDepth(vec2 ndc, float depth)
+{
+    vec4 nearPoint = inverseProjection * vec4(ndc, -1.0f, 1.0f);
+    vec4 farPoint = inverseProjection * vec4(ndc, 1.0f, 1.0f);
+    vec3 start = nearPoint.xyz / nearPoint.w;
+    vec3 end = farPoint.xyz / farPoint.w;
+    float t = (-depth - start.z) / (end.z - start.z);
+    return start + (end - start) * t;
+}
+
+void main()
+{
+    uint cluster = gl_GlobalInvocationID.x;
+    bool bValid = cluster < uint(TOTAL_CLUSTERS);
+
+    // view space bounds of the cluster
+    vec3 boxMin = vec3(0.0f);
+    vec3 boxMax = vec3(0.0f);
+    if (bValid)
+    {
+        uint tileX = cluster % uint(CLUSTER_TILES_X);
+        uint tileY = (cluster / uint(CLUSTER_TILES_X)) % uint(CLUSTER_TILES_Y);
+        uint slice = cluster / uint(CLUSTER_TILES_X * CLUSTER_TILES_Y);
+
+        vec2 tiles = vec2(CLUSTER_TILES_X, CLUSTER_TILES_Y);
+        vec2 ndcMin = vec2(tileX, tileY) / tiles * 2.0f - 1.0f;
+        vec2 ndcMax = vec2(tileX + 1u, tileY + 1u) / tiles * 2.0f - 1.0f;
+        float depthRatio = depthRange.y / depthRange.x;
+        float sliceNear = depthRange.x * pow(depthRatio, float(slice) / float(CLUSTER_SLICES));
+        float sliceFar = depthRange.x * pow(depthRatio, float(slice + 1u) / float(CLUSTER_SLICES));
+
+        boxMin = vec3(1.0e30f);
+        boxMax = vec3(-1.0e30f);
+        for (int corner = 0; corner < 4; corner++)
+        {
+            vec2 ndc = vec2(((corner & 1) != 0) ? ndcMax.x : ndcMin.x,
+                            ((corner & 2) != 0) ? ndcMax.y : ndcMin.y);
+            vec3 nearCorner = PointAtDepth(ndc, sliceNear);
+            vec3 farCorner = PointAtDepth(ndc, sliceFar);
+            boxMin = min(boxMin, min(nearCorner, farCorner));
+            boxMax = max(boxMax, max(nearCorner, farCorner));
+        }
+    }
+
+    uint count = 0u;
+    for (uint first = 0u; first < lightCount; first += 64u)
+    {
+        uint loadIndex = first + gl_LocalInvocationIndex;
+        if (loadIndex < lightCount)
+        {
+            vec4 positionRange = lights[loadIndex].positionRange;
+            groupLights[gl_LocalInvocationIndex] = vec4((view * vec4(positionRange.xyz, 1.0f)).xyz, positionRange.w);
+        }
+        barrier();
+
+        uint batchCount = min(64u, lightCount - first);
+        for (uint i = 0u; bValid && (i < batchCount); i++)
+        {
+            // a light without a range reaches every cluster, and the
+            // others when the closest point of the bounds is in range
+            vec4 light = groupLights[i];
+            vec3 offset = clamp(light.xyz, boxMin, boxMax) - light.xyz;
+            bool bReaches = (light.w <= 0.0f) || (dot(offset, offset) <= light.w * light.w);
+            if (bReaches && (count < uint(MAX_LIGHTS_PER_CLUSTER)))
+            {
+                clusterLightIndices[cluster * uint(MAX_LIGHTS_PER_CLUSTER) + count] = first + i;
+                count++;
+            }
+        }
+        barrier();
+    }
+
+    if (bValid)
+    {
+        clusterCounts[cluster] = count;
+    }
+}
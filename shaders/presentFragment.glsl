@@ -0,0 +1,44 @@
+#version 330 core
+// upscale the HDR scene color of RenderTargets to the output and
+// tonemap it
+out vec4 fragmentColor;
+
+in vec2 fragmentTextureCoordinate;
+
+uniform sampler2D sceneColor;
+uniform vec2 UVscale;
+uniform float exposure = 1.0f;
+
+// colors up to the start of the shoulder are kept as they are, so the
+// scene looks as it did when drawn straight to the window, and the
+// brighter ones roll off smoothly towards one instead of clipping
+const float shoulderStart = 0.8f;
+
+float Tonemap(float value)
+{
+    if (value <= shoulderStart)
+    {
+        return value;
+    }
+    float range = 1.0f - shoulderStart;
+    return shoulderStart + (range * (1.0f - exp((shoulderStart - value) / range)));
+}
+
+void main()
+{
+    // the filter must not reach past the part the scene was drawn
+    // into, so the coordinate stops half a texel inside it
+    vec2 maxCoordinate = UVscale - (0.5f / vec2(textureSize(sceneColor, 0)));
+    vec4 color = texture(sceneColor, min(fragmentTextureCoordinate, maxCoordinate));
+
+    // the brightest channel is tonemapped and the others scaled with
+    // it, which keeps the hue of the bright colors
+    vec3 exposed = max(color.rgb * exposure, vec3(0.0f));
+    float brightest = max(max(exposed.r, exposed.g), exposed.b);
+    if (brightest > shoulderStart)
+    {
+        exposed *= Tonemap(brightest) / brightest;
+    }
+
+    fragmentColor = vec4(exposed, 1.0f);
+}
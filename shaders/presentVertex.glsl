@@ -0,0 +1,14 @@
+#version 330 core
+// one triangle covering the viewport, made from the vertex index so
+// the present pass of RenderTargets needs no vertex buffer
+out vec2 fragmentTextureCoordinate;
+
+// fraction of the scene color texture the scene was drawn into
+uniform vec2 UVscale;
+
+void main()
+{
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    fragmentTextureCoordinate = corner * UVscale;
+    gl_Position = vec4((corner * 2.0f) - 1.0f, 0.0f, 1.0f);
+}
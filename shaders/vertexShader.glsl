@@ -0,0 +1,73 @@
+#version 330 core
+// the compact vertex layout of ShapeGeometry stores the position
+// over a w below one, and the normal as an octahedral pair in x
+// and y - full float positions leave w at its default of one
+layout (location = 0) in vec4 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+// per-instance values, only read when bUseInstancing is set
+layout (location = 3) in mat4 inInstanceModel;
+layout (location = 7) in ivec2 inInstanceMaterialLayer;
+layout (location = 8) in vec2 inInstanceUVscale;
+
+// the depth pre-pass and the shading pass link this shader with
+// different fragment shaders, and must write the same depth for
+// the equal depth test of the shading pass
+invariant gl_Position;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+flat out int fragmentMaterialIndex;
+flat out int fragmentTextureLayer;
+flat out vec2 fragmentUVscale;
+
+uniform mat4 model;
+uniform bool bUseInstancing = false;
+
+// per-frame camera values shared by all of the shaders
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPosition;
+};
+
+// unfold a normal from the octahedral pair of the compact layout
+vec3 DecodeOctahedral(vec2 encoded)
+{
+   vec3 normal = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+   if(normal.z < 0.0f)
+   {
+      vec2 signs = vec2(normal.x >= 0.0f ? 1.0f : -1.0f, normal.y >= 0.0f ? 1.0f : -1.0f);
+      normal.xy = (1.0f - abs(normal.yx)) * signs;
+   }
+   return normalize(normal);
+}
+
+void main()
+{
+   mat4 objectModel = model;
+   fragmentMaterialIndex = -1;
+   fragmentTextureLayer = 0;
+   fragmentUVscale = vec2(1.0f, 1.0f);
+   if(bUseInstancing == true)
+   {
+      objectModel = inInstanceModel;
+      fragmentMaterialIndex = inInstanceMaterialLayer.x;
+      fragmentTextureLayer = inInstanceMaterialLayer.y;
+      fragmentUVscale = inInstanceUVscale;
+   }
+
+   vec3 vertexPosition = inVertexPosition.xyz / inVertexPosition.w;
+   vec3 vertexNormal = inVertexNormal;
+   if(inVertexPosition.w < 1.0f)
+   {
+      vertexNormal = DecodeOctahedral(inVertexNormal.xy);
+   }
+
+   fragmentPosition = vec3(objectModel * vec4(vertexPosition, 1.0));
+   gl_Position = projection * view * objectModel * vec4(vertexPosition, 1.0f);
+   fragmentVertexNormal = vertexNormal;
+   fragmentTextureCoordinate = inTextureCoordinate;
+}
\ No newline at end of file